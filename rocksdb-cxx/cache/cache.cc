@@ -76,6 +76,12 @@ static std::unordered_map<std::string, OptionTypeInfo>
           rocksdb_rs::utilities::options_type::OptionType::kBoolean,
           rocksdb_rs::utilities::options_type::OptionVerificationType::kNormal,
           rocksdb_rs::utilities::options_type::OptionTypeFlags::kMutable}},
+        {"persistent_file_path",
+         {offsetof(struct CompressedSecondaryCacheOptions,
+                   persistent_file_path),
+          rocksdb_rs::utilities::options_type::OptionType::kString,
+          rocksdb_rs::utilities::options_type::OptionVerificationType::kNormal,
+          rocksdb_rs::utilities::options_type::OptionTypeFlags::kNone}},
 };
 
 rocksdb_rs::status::Status SecondaryCache::CreateFromString(
@@ -50,6 +50,10 @@ DEFINE_double(resident_ratio, 0.25,
 DEFINE_uint64(ops_per_thread, 2000000U, "Number of operations per thread.");
 DEFINE_uint32(value_bytes, 8 * KiB, "Size of each value added.");
 
+DEFINE_uint32(value_bytes_estimate, 0,
+              "If > 0, overrides estimated_entry_charge or "
+              "min_avg_entry_charge depending on cache_type.");
+
 DEFINE_uint32(skew, 5, "Degree of skew in key selection");
 DEFINE_bool(populate_cache, true, "Populate cache before operations");
 
@@ -192,6 +196,8 @@ struct ThreadState {
   SharedState* shared;
   HistogramImpl latency_ns_hist;
   uint64_t duration_us = 0;
+  uint64_t lookup_count = 0;
+  uint64_t lookup_hits = 0;
 
   ThreadState(uint32_t index, SharedState* _shared)
       : tid(index), rnd(1000 + index), shared(_shared) {}
@@ -311,10 +317,20 @@ class CacheBench {
     if (FLAGS_cache_type == "clock_cache") {
       fprintf(stderr, "Old clock cache implementation has been removed.\n");
       exit(1);
-    } else if (FLAGS_cache_type == "hyper_clock_cache") {
-      cache_ = HyperClockCacheOptions(FLAGS_cache_size, FLAGS_value_bytes,
-                                      FLAGS_num_shard_bits)
-                   .MakeSharedCache();
+    } else if (FLAGS_cache_type == "hyper_clock_cache" ||
+               FLAGS_cache_type == "auto_hyper_clock_cache") {
+      HyperClockCacheOptions opts(FLAGS_cache_size, FLAGS_value_bytes,
+                                  FLAGS_num_shard_bits);
+      if (FLAGS_cache_type == "auto_hyper_clock_cache") {
+        // Table size determined online
+        opts.estimated_entry_charge = 0;
+        if (FLAGS_value_bytes_estimate > 0) {
+          opts.min_avg_entry_charge = FLAGS_value_bytes_estimate;
+        }
+      } else if (FLAGS_value_bytes_estimate > 0) {
+        opts.estimated_entry_charge = FLAGS_value_bytes_estimate;
+      }
+      cache_ = opts.MakeSharedCache();
     } else if (FLAGS_cache_type == "lru_cache") {
       LRUCacheOptions opts(FLAGS_cache_size, FLAGS_num_shard_bits,
                            false /* strict_capacity_limit */,
@@ -408,6 +424,15 @@ class CacheBench {
                                         FLAGS_ops_per_thread / elapsed_secs);
     printf("Thread ops/sec = %u\n", ops_per_sec);
 
+    uint64_t lookup_count = 0;
+    uint64_t lookup_hits = 0;
+    for (uint32_t i = 0; i < FLAGS_threads; i++) {
+      lookup_count += threads[i]->lookup_count;
+      lookup_hits += threads[i]->lookup_hits;
+    }
+    printf("Lookup hit ratio: %g\n",
+           lookup_count > 0 ? 1.0 * lookup_hits / lookup_count : 0.0);
+
     printf("\nOperation latency (ns):\n");
     HistogramImpl combined;
     for (uint32_t i = 0; i < FLAGS_threads; i++) {
@@ -562,7 +587,9 @@ class CacheBench {
         // do lookup
         handle = cache_->Lookup(key, &helper2, /*context*/ nullptr,
                                 Cache::Priority::LOW);
+        ++thread->lookup_count;
         if (handle) {
+          ++thread->lookup_hits;
           if (!FLAGS_lean) {
             // do something with the data
             result += NPHash64(static_cast<char*>(cache_->Value(handle)),
@@ -593,7 +620,9 @@ class CacheBench {
         // do lookup
         handle = cache_->Lookup(key, &helper2, /*context*/ nullptr,
                                 Cache::Priority::LOW);
+        ++thread->lookup_count;
         if (handle) {
+          ++thread->lookup_hits;
           if (!FLAGS_lean) {
             // do something with the data
             result += NPHash64(static_cast<char*>(cache_->Value(handle)),
@@ -640,6 +669,9 @@ class CacheBench {
     printf("Cache size          : %s\n",
            BytesToHumanString(FLAGS_cache_size).c_str());
     printf("Num shard bits      : %u\n", FLAGS_num_shard_bits);
+    printf("Cache type          : %s\n", FLAGS_cache_type.c_str());
+    printf("Value bytes         : %u\n", FLAGS_value_bytes);
+    printf("Value bytes estimate: %u\n", FLAGS_value_bytes_estimate);
     printf("Max key             : %" PRIu64 "\n", max_key_);
     printf("Resident ratio      : %g\n", FLAGS_resident_ratio);
     printf("Skew degree         : %u\n", FLAGS_skew);
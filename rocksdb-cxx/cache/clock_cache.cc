@@ -329,6 +329,186 @@ void ConstApplyToEntriesRange(Func /*const HandleImpl& -> void*/ func,
   }
 }
 
+// Lookup step on a single slot, shared by the table implementations. Returns
+// true iff the slot holds a visible entry for hashed_key, in which case a
+// read reference has been acquired for the caller.
+inline bool TryLookupRef(const rocksdb_rs::unique_id::UniqueId64x2& hashed_key,
+                         ClockHandle& h) {
+  // Mostly branch-free version (similar performance)
+  /*
+  uint64_t old_meta = h.meta.fetch_add(ClockHandle::kAcquireIncrement,
+                               std::memory_order_acquire);
+  bool Shareable = (old_meta >> (ClockHandle::kStateShift + 1)) & 1U;
+  bool visible = (old_meta >> ClockHandle::kStateShift) & 1U;
+  bool match = (h.key == key) & visible;
+  h.meta.fetch_sub(static_cast<uint64_t>(Shareable & !match) <<
+  ClockHandle::kAcquireCounterShift, std::memory_order_release); return
+  match;
+  */
+  // Optimistic lookup should pay off when the table is relatively
+  // sparse.
+  constexpr bool kOptimisticLookup = true;
+  uint64_t old_meta;
+  if (!kOptimisticLookup) {
+    old_meta = h.meta.load(std::memory_order_acquire);
+    if ((old_meta >> ClockHandle::kStateShift) != ClockHandle::kStateVisible) {
+      return false;
+    }
+  }
+  // (Optimistically) increment acquire counter
+  old_meta = h.meta.fetch_add(ClockHandle::kAcquireIncrement,
+                              std::memory_order_acquire);
+  // Check if it's an entry visible to lookups
+  if ((old_meta >> ClockHandle::kStateShift) == ClockHandle::kStateVisible) {
+    // Acquired a read reference
+    if (h.hashed_key == hashed_key) {
+      // Match
+      return true;
+    } else {
+      // Mismatch. Pretend we never took the reference
+      old_meta = h.meta.fetch_sub(ClockHandle::kAcquireIncrement,
+                                  std::memory_order_release);
+    }
+  } else if (UNLIKELY((old_meta >> ClockHandle::kStateShift) ==
+                      ClockHandle::kStateInvisible)) {
+    // Pretend we never took the reference
+    // WART: there's a tiny chance we release last ref to invisible
+    // entry here. If that happens, we let eviction take care of it.
+    old_meta = h.meta.fetch_sub(ClockHandle::kAcquireIncrement,
+                                std::memory_order_release);
+  } else {
+    // For other states, incrementing the acquire counter has no effect
+    // so we don't need to undo it. Furthermore, we cannot safely undo
+    // it because we did not acquire a read reference to lock the
+    // entry in a Shareable state.
+  }
+  (void)old_meta;
+  return false;
+}
+
+// Erase step on a single slot, shared by the table implementations. If the
+// slot holds a visible entry for hashed_key, it is made invisible. Returns
+// true iff this also took ownership of the entry (no other references), in
+// which case the caller must free the entry and reclaim the slot.
+inline bool TryEraseRef(const rocksdb_rs::unique_id::UniqueId64x2& hashed_key,
+                        ClockHandle& h) {
+  // Optimistically increment acquire counter
+  uint64_t old_meta = h.meta.fetch_add(ClockHandle::kAcquireIncrement,
+                                       std::memory_order_acquire);
+  // Check if it's an entry visible to lookups
+  if ((old_meta >> ClockHandle::kStateShift) == ClockHandle::kStateVisible) {
+    // Acquired a read reference
+    if (h.hashed_key == hashed_key) {
+      // Match. Set invisible.
+      old_meta = h.meta.fetch_and(~(uint64_t{ClockHandle::kStateVisibleBit}
+                                    << ClockHandle::kStateShift),
+                                  std::memory_order_acq_rel);
+      // Apply update to local copy
+      old_meta &= ~(uint64_t{ClockHandle::kStateVisibleBit}
+                    << ClockHandle::kStateShift);
+      for (;;) {
+        uint64_t refcount = GetRefcount(old_meta);
+        assert(refcount > 0);
+        if (refcount > 1) {
+          // Not last ref at some point in time during this Erase call
+          // Pretend we never took the reference
+          h.meta.fetch_sub(ClockHandle::kAcquireIncrement,
+                           std::memory_order_release);
+          return false;
+        } else if (h.meta.compare_exchange_weak(
+                       old_meta,
+                       uint64_t{ClockHandle::kStateConstruction}
+                           << ClockHandle::kStateShift,
+                       std::memory_order_acq_rel)) {
+          // Took ownership
+          assert(hashed_key == h.hashed_key);
+          return true;
+        }
+      }
+    } else {
+      // Mismatch. Pretend we never took the reference
+      h.meta.fetch_sub(ClockHandle::kAcquireIncrement,
+                       std::memory_order_release);
+    }
+  } else if (UNLIKELY((old_meta >> ClockHandle::kStateShift) ==
+                      ClockHandle::kStateInvisible)) {
+    // Pretend we never took the reference
+    // WART: there's a tiny chance we release last ref to invisible
+    // entry here. If that happens, we let eviction take care of it.
+    h.meta.fetch_sub(ClockHandle::kAcquireIncrement, std::memory_order_release);
+  } else {
+    // For other states, incrementing the acquire counter has no effect
+    // so we don't need to undo it.
+  }
+  return false;
+}
+
+// Release step shared by the table implementations. Returns true iff the
+// release took ownership of the entry (last reference to an entry that
+// should be erased), in which case the caller must free the entry.
+inline bool TryReleaseTakeOwnership(ClockHandle* h, bool useful,
+                                    bool erase_if_last_ref) {
+  // In contrast with LRUCache's Release, this function won't delete the handle
+  // when the cache is above capacity and the reference is the last one. Space
+  // is only freed up by EvictFromClock (called by Insert when space is needed)
+  // and Erase. We do this to avoid an extra atomic read of the variable usage_.
+
+  uint64_t old_meta;
+  if (useful) {
+    // Increment release counter to indicate was used
+    old_meta = h->meta.fetch_add(ClockHandle::kReleaseIncrement,
+                                 std::memory_order_release);
+  } else {
+    // Decrement acquire counter to pretend it never happened
+    old_meta = h->meta.fetch_sub(ClockHandle::kAcquireIncrement,
+                                 std::memory_order_release);
+  }
+
+  assert((old_meta >> ClockHandle::kStateShift) &
+         ClockHandle::kStateShareableBit);
+  // No underflow
+  assert(((old_meta >> ClockHandle::kAcquireCounterShift) &
+          ClockHandle::kCounterMask) !=
+         ((old_meta >> ClockHandle::kReleaseCounterShift) &
+          ClockHandle::kCounterMask));
+
+  if (erase_if_last_ref || UNLIKELY(old_meta >> ClockHandle::kStateShift ==
+                                    ClockHandle::kStateInvisible)) {
+    // Update for last fetch_add op
+    if (useful) {
+      old_meta += ClockHandle::kReleaseIncrement;
+    } else {
+      old_meta -= ClockHandle::kAcquireIncrement;
+    }
+    // Take ownership if no refs
+    do {
+      if (GetRefcount(old_meta) != 0) {
+        // Not last ref at some point in time during this Release call
+        // Correct for possible (but rare) overflow
+        CorrectNearOverflow(old_meta, h->meta);
+        return false;
+      }
+      if ((old_meta & (uint64_t{ClockHandle::kStateShareableBit}
+                       << ClockHandle::kStateShift)) == 0) {
+        // Someone else took ownership
+        return false;
+      }
+      // Note that there's a small chance that we release, another thread
+      // replaces this entry with another, reaches zero refs, and then we end
+      // up erasing that other entry. That's an acceptable risk / imprecision.
+    } while (!h->meta.compare_exchange_weak(
+        old_meta,
+        uint64_t{ClockHandle::kStateConstruction} << ClockHandle::kStateShift,
+        std::memory_order_acquire));
+    // Took ownership
+    return true;
+  } else {
+    // Correct for possible (but rare) overflow
+    CorrectNearOverflow(old_meta, h->meta);
+    return false;
+  }
+}
+
 }  // namespace
 
 void ClockHandleBasicData::FreeData(MemoryAllocator* allocator) const {
@@ -612,6 +792,22 @@ rocksdb_rs::status::Status BaseClockTable::Insert(
   return rocksdb_rs::status::Status_OkOverwritten();
 }
 
+template <class Table>
+void BaseClockTable::FinishEviction(typename Table::HandleImpl& h) {
+  bool took_ownership = false;
+  if (eviction_callback_) {
+    // For key reconstructed from hash
+    rocksdb_rs::unique_id::UniqueId64x2 unhashed;
+    took_ownership = eviction_callback_(
+        ClockCacheShard<Table>::ReverseHash(h.GetHash(), &unhashed, hash_seed_),
+        reinterpret_cast<Cache::Handle*>(&h));
+  }
+  if (!took_ownership) {
+    h.FreeData(allocator_);
+  }
+  MarkEmpty(h);
+}
+
 void BaseClockTable::Ref(ClockHandle& h) {
   // Increment acquire counter
   uint64_t old_meta = h.meta.fetch_add(ClockHandle::kAcquireIncrement,
@@ -763,61 +959,7 @@ HyperClockTable::HandleImpl* HyperClockTable::DoInsert(
 HyperClockTable::HandleImpl* HyperClockTable::Lookup(
     const rocksdb_rs::unique_id::UniqueId64x2& hashed_key) {
   HandleImpl* e = FindSlot(
-      hashed_key,
-      [&](HandleImpl* h) {
-        // Mostly branch-free version (similar performance)
-        /*
-        uint64_t old_meta = h->meta.fetch_add(ClockHandle::kAcquireIncrement,
-                                     std::memory_order_acquire);
-        bool Shareable = (old_meta >> (ClockHandle::kStateShift + 1)) & 1U;
-        bool visible = (old_meta >> ClockHandle::kStateShift) & 1U;
-        bool match = (h->key == key) & visible;
-        h->meta.fetch_sub(static_cast<uint64_t>(Shareable & !match) <<
-        ClockHandle::kAcquireCounterShift, std::memory_order_release); return
-        match;
-        */
-        // Optimistic lookup should pay off when the table is relatively
-        // sparse.
-        constexpr bool kOptimisticLookup = true;
-        uint64_t old_meta;
-        if (!kOptimisticLookup) {
-          old_meta = h->meta.load(std::memory_order_acquire);
-          if ((old_meta >> ClockHandle::kStateShift) !=
-              ClockHandle::kStateVisible) {
-            return false;
-          }
-        }
-        // (Optimistically) increment acquire counter
-        old_meta = h->meta.fetch_add(ClockHandle::kAcquireIncrement,
-                                     std::memory_order_acquire);
-        // Check if it's an entry visible to lookups
-        if ((old_meta >> ClockHandle::kStateShift) ==
-            ClockHandle::kStateVisible) {
-          // Acquired a read reference
-          if (h->hashed_key == hashed_key) {
-            // Match
-            return true;
-          } else {
-            // Mismatch. Pretend we never took the reference
-            old_meta = h->meta.fetch_sub(ClockHandle::kAcquireIncrement,
-                                         std::memory_order_release);
-          }
-        } else if (UNLIKELY((old_meta >> ClockHandle::kStateShift) ==
-                            ClockHandle::kStateInvisible)) {
-          // Pretend we never took the reference
-          // WART: there's a tiny chance we release last ref to invisible
-          // entry here. If that happens, we let eviction take care of it.
-          old_meta = h->meta.fetch_sub(ClockHandle::kAcquireIncrement,
-                                       std::memory_order_release);
-        } else {
-          // For other states, incrementing the acquire counter has no effect
-          // so we don't need to undo it. Furthermore, we cannot safely undo
-          // it because we did not acquire a read reference to lock the
-          // entry in a Shareable state.
-        }
-        (void)old_meta;
-        return false;
-      },
+      hashed_key, [&](HandleImpl* h) { return TryLookupRef(hashed_key, *h); },
       [&](HandleImpl* h) {
         return h->displacements.load(std::memory_order_relaxed) == 0;
       },
@@ -828,77 +970,23 @@ HyperClockTable::HandleImpl* HyperClockTable::Lookup(
 
 bool HyperClockTable::Release(HandleImpl* h, bool useful,
                               bool erase_if_last_ref) {
-  // In contrast with LRUCache's Release, this function won't delete the handle
-  // when the cache is above capacity and the reference is the last one. Space
-  // is only freed up by EvictFromClock (called by Insert when space is needed)
-  // and Erase. We do this to avoid an extra atomic read of the variable usage_.
-
-  uint64_t old_meta;
-  if (useful) {
-    // Increment release counter to indicate was used
-    old_meta = h->meta.fetch_add(ClockHandle::kReleaseIncrement,
-                                 std::memory_order_release);
-  } else {
-    // Decrement acquire counter to pretend it never happened
-    old_meta = h->meta.fetch_sub(ClockHandle::kAcquireIncrement,
-                                 std::memory_order_release);
+  if (!TryReleaseTakeOwnership(h, useful, erase_if_last_ref)) {
+    return false;
   }
-
-  assert((old_meta >> ClockHandle::kStateShift) &
-         ClockHandle::kStateShareableBit);
-  // No underflow
-  assert(((old_meta >> ClockHandle::kAcquireCounterShift) &
-          ClockHandle::kCounterMask) !=
-         ((old_meta >> ClockHandle::kReleaseCounterShift) &
-          ClockHandle::kCounterMask));
-
-  if (erase_if_last_ref || UNLIKELY(old_meta >> ClockHandle::kStateShift ==
-                                    ClockHandle::kStateInvisible)) {
-    // Update for last fetch_add op
-    if (useful) {
-      old_meta += ClockHandle::kReleaseIncrement;
-    } else {
-      old_meta -= ClockHandle::kAcquireIncrement;
-    }
-    // Take ownership if no refs
-    do {
-      if (GetRefcount(old_meta) != 0) {
-        // Not last ref at some point in time during this Release call
-        // Correct for possible (but rare) overflow
-        CorrectNearOverflow(old_meta, h->meta);
-        return false;
-      }
-      if ((old_meta & (uint64_t{ClockHandle::kStateShareableBit}
-                       << ClockHandle::kStateShift)) == 0) {
-        // Someone else took ownership
-        return false;
-      }
-      // Note that there's a small chance that we release, another thread
-      // replaces this entry with another, reaches zero refs, and then we end
-      // up erasing that other entry. That's an acceptable risk / imprecision.
-    } while (!h->meta.compare_exchange_weak(
-        old_meta,
-        uint64_t{ClockHandle::kStateConstruction} << ClockHandle::kStateShift,
-        std::memory_order_acquire));
-    // Took ownership
-    size_t total_charge = h->GetTotalCharge();
-    if (UNLIKELY(h->IsStandalone())) {
-      h->FreeData(allocator_);
-      // Delete standalone handle
-      delete h;
-      standalone_usage_.fetch_sub(total_charge, std::memory_order_relaxed);
-      usage_.fetch_sub(total_charge, std::memory_order_relaxed);
-    } else {
-      Rollback(h->hashed_key, h);
-      FreeDataMarkEmpty(*h, allocator_);
-      ReclaimEntryUsage(total_charge);
-    }
-    return true;
+  // Took ownership
+  size_t total_charge = h->GetTotalCharge();
+  if (UNLIKELY(h->IsStandalone())) {
+    h->FreeData(allocator_);
+    // Delete standalone handle
+    delete h;
+    standalone_usage_.fetch_sub(total_charge, std::memory_order_relaxed);
+    usage_.fetch_sub(total_charge, std::memory_order_relaxed);
   } else {
-    // Correct for possible (but rare) overflow
-    CorrectNearOverflow(old_meta, h->meta);
-    return false;
+    Rollback(h->hashed_key, h);
+    FreeDataMarkEmpty(*h, allocator_);
+    ReclaimEntryUsage(total_charge);
   }
+  return true;
 }
 
 #ifndef NDEBUG
@@ -919,62 +1007,14 @@ void HyperClockTable::Erase(
       hashed_key,
       [&](HandleImpl* h) {
         // Could be multiple entries in rare cases. Erase them all.
-        // Optimistically increment acquire counter
-        uint64_t old_meta = h->meta.fetch_add(ClockHandle::kAcquireIncrement,
-                                              std::memory_order_acquire);
-        // Check if it's an entry visible to lookups
-        if ((old_meta >> ClockHandle::kStateShift) ==
-            ClockHandle::kStateVisible) {
-          // Acquired a read reference
-          if (h->hashed_key == hashed_key) {
-            // Match. Set invisible.
-            old_meta =
-                h->meta.fetch_and(~(uint64_t{ClockHandle::kStateVisibleBit}
-                                    << ClockHandle::kStateShift),
-                                  std::memory_order_acq_rel);
-            // Apply update to local copy
-            old_meta &= ~(uint64_t{ClockHandle::kStateVisibleBit}
-                          << ClockHandle::kStateShift);
-            for (;;) {
-              uint64_t refcount = GetRefcount(old_meta);
-              assert(refcount > 0);
-              if (refcount > 1) {
-                // Not last ref at some point in time during this Erase call
-                // Pretend we never took the reference
-                h->meta.fetch_sub(ClockHandle::kAcquireIncrement,
-                                  std::memory_order_release);
-                break;
-              } else if (h->meta.compare_exchange_weak(
-                             old_meta,
-                             uint64_t{ClockHandle::kStateConstruction}
-                                 << ClockHandle::kStateShift,
-                             std::memory_order_acq_rel)) {
-                // Took ownership
-                assert(hashed_key == h->hashed_key);
-                size_t total_charge = h->GetTotalCharge();
-                FreeDataMarkEmpty(*h, allocator_);
-                ReclaimEntryUsage(total_charge);
-                // We already have a copy of hashed_key in this case, so OK to
-                // delay Rollback until after releasing the entry
-                Rollback(hashed_key, h);
-                break;
-              }
-            }
-          } else {
-            // Mismatch. Pretend we never took the reference
-            h->meta.fetch_sub(ClockHandle::kAcquireIncrement,
-                              std::memory_order_release);
-          }
-        } else if (UNLIKELY((old_meta >> ClockHandle::kStateShift) ==
-                            ClockHandle::kStateInvisible)) {
-          // Pretend we never took the reference
-          // WART: there's a tiny chance we release last ref to invisible
-          // entry here. If that happens, we let eviction take care of it.
-          h->meta.fetch_sub(ClockHandle::kAcquireIncrement,
-                            std::memory_order_release);
-        } else {
-          // For other states, incrementing the acquire counter has no effect
-          // so we don't need to undo it.
+        if (TryEraseRef(hashed_key, *h)) {
+          // Took ownership
+          size_t total_charge = h->GetTotalCharge();
+          FreeDataMarkEmpty(*h, allocator_);
+          ReclaimEntryUsage(total_charge);
+          // We already have a copy of hashed_key in this case, so OK to
+          // delay Rollback until after releasing the entry
+          Rollback(hashed_key, h);
         }
         return false;
       },
@@ -1084,9 +1124,6 @@ inline void HyperClockTable::Evict(size_t requested_charge,
   uint64_t max_clock_pointer =
       old_clock_pointer + (ClockHandle::kMaxCountdown << length_bits_);
 
-  // For key reconstructed from hash
-  rocksdb_rs::unique_id::UniqueId64x2 unhashed;
-
   for (;;) {
     for (size_t i = 0; i < step_size; i++) {
       HandleImpl& h = array_[ModTableSize(Lower32of64(old_clock_pointer + i))];
@@ -1095,17 +1132,434 @@ inline void HyperClockTable::Evict(size_t requested_charge,
         Rollback(h.hashed_key, &h);
         *freed_charge += h.GetTotalCharge();
         *freed_count += 1;
-        bool took_ownership = false;
-        if (eviction_callback_) {
-          took_ownership =
-              eviction_callback_(ClockCacheShard<HyperClockTable>::ReverseHash(
-                                     h.GetHash(), &unhashed, hash_seed_),
-                                 reinterpret_cast<Cache::Handle*>(&h));
-        }
-        if (!took_ownership) {
-          h.FreeData(allocator_);
-        }
-        MarkEmpty(h);
+        FinishEviction<HyperClockTable>(h);
+      }
+    }
+
+    // Loop exit condition
+    if (*freed_charge >= requested_charge) {
+      return;
+    }
+    if (old_clock_pointer >= max_clock_pointer) {
+      return;
+    }
+
+    // Advance clock pointer (concurrently)
+    old_clock_pointer =
+        clock_pointer_.fetch_add(step_size, std::memory_order_relaxed);
+  }
+}
+
+namespace {
+// Number of hash bits for the largest generation of an AutoHyperClockTable,
+// i.e. as if HyperClockTable were sized for min_avg_value_size.
+int AutoMaxLengthBits(size_t capacity, size_t min_avg_value_size,
+                      CacheMetadataChargePolicy metadata_charge_policy) {
+  return HyperClockTable::CalcHashBits(
+      capacity, std::max(min_avg_value_size, size_t{1}),
+      metadata_charge_policy);
+}
+}  // namespace
+
+AutoHyperClockTable::AutoHyperClockTable(
+    size_t capacity, bool /*strict_capacity_limit*/,
+    CacheMetadataChargePolicy metadata_charge_policy,
+    MemoryAllocator* allocator,
+    const Cache::EvictionCallback* eviction_callback, const uint32_t* hash_seed,
+    const Opts& opts)
+    : BaseClockTable(metadata_charge_policy, allocator, eviction_callback,
+                     hash_seed),
+      initial_length_bits_(
+          std::max(0, AutoMaxLengthBits(capacity, opts.min_avg_value_size,
+                                        metadata_charge_policy) -
+                          (kMaxGenerations - 1))),
+      max_generations_(AutoMaxLengthBits(capacity, opts.min_avg_value_size,
+                                         metadata_charge_policy) -
+                       initial_length_bits_ + 1),
+      occupancy_limit_(0),
+      // Reserve address space for the maximum table size. Memory only
+      // becomes resident as generations are published and used, and
+      // zero-filled memory is a valid (empty) state for all slots.
+      array_mem_(MemMapping::AllocateLazyZeroed(
+          sizeof(HandleImpl) * TableSizeForGenerations(max_generations_))),
+      array_(nullptr),
+      generations_(1) {
+  assert(max_generations_ >= 1 && max_generations_ <= kMaxGenerations);
+  // If the reservation is not possible (e.g. address space or overcommit
+  // limits), settle for a smaller maximum table size.
+  for (;;) {
+    if (array_mem_.Get() != nullptr) {
+      array_ = static_cast<HandleImpl*>(array_mem_.Get());
+      break;
+    }
+    if (max_generations_ == 1) {
+      // Last resort: fixed size table of just the first generation
+      heap_array_.reset(new HandleImpl[TableSizeForGenerations(1)]);
+      array_ = heap_array_.get();
+      break;
+    }
+    --max_generations_;
+    array_mem_ = MemMapping::AllocateLazyZeroed(
+        sizeof(HandleImpl) * TableSizeForGenerations(max_generations_));
+  }
+  occupancy_limit_ = static_cast<size_t>(
+      TableSizeForGenerations(max_generations_) * kStrictLoadFactor);
+
+  if (metadata_charge_policy ==
+      CacheMetadataChargePolicy::kFullChargeCacheMetadata) {
+    // Only charge for generations as they are published
+    usage_ += TableSizeForGenerations(1) * sizeof(HandleImpl);
+  }
+}
+
+AutoHyperClockTable::~AutoHyperClockTable() {
+  // Assumes there are no references or active operations on any slot/element
+  // in the table.
+  const size_t table_size = GetTableSize();
+  for (size_t i = 0; i < table_size; i++) {
+    HandleImpl& h = array_[i];
+    switch (h.meta >> ClockHandle::kStateShift) {
+      case ClockHandle::kStateEmpty:
+        // noop
+        break;
+      case ClockHandle::kStateInvisible:  // rare but possible
+      case ClockHandle::kStateVisible:
+        assert(GetRefcount(h.meta) == 0);
+        h.FreeData(allocator_);
+#ifndef NDEBUG
+        Rollback(h.hashed_key, &h);
+        ReclaimEntryUsage(h.GetTotalCharge(), GenerationOf(&h));
+#endif
+        break;
+      // otherwise
+      default:
+        assert(false);
+        break;
+    }
+  }
+
+#ifndef NDEBUG
+  for (size_t i = 0; i < table_size; i++) {
+    assert(array_[i].displacements.load() == 0);
+  }
+  for (auto& gen_occupancy : generation_occupancy_) {
+    assert(gen_occupancy.load() == 0);
+  }
+#endif
+
+  assert(usage_.load() == 0 ||
+         usage_.load() == table_size * sizeof(HandleImpl));
+  assert(occupancy_ == 0);
+}
+
+void AutoHyperClockTable::StartInsert(InsertState& state) {
+  state.generations = generations_.load(std::memory_order_acquire);
+}
+
+bool AutoHyperClockTable::GrowIfNeeded(size_t new_occupancy,
+                                       InsertState& state) {
+  if (LIKELY(new_occupancy <=
+             static_cast<size_t>(TableSizeForGenerations(state.generations) *
+                                 kLoadFactor))) {
+    // Within normal load factor
+    return true;
+  }
+  // Above normal load factor, so publish more generations if possible.
+  // Generations are published in order, so whichever thread wins the
+  // compare-exchange is responsible for the new generation's metadata
+  // charge.
+  while (state.generations < max_generations_ &&
+         new_occupancy >
+             static_cast<size_t>(TableSizeForGenerations(state.generations) *
+                                 kLoadFactor)) {
+    int expected = state.generations;
+    if (generations_.compare_exchange_strong(expected, expected + 1,
+                                             std::memory_order_acq_rel)) {
+      if (metadata_charge_policy_ ==
+          CacheMetadataChargePolicy::kFullChargeCacheMetadata) {
+        usage_.fetch_add((size_t{1} << (initial_length_bits_ + expected)) *
+                             sizeof(HandleImpl),
+                         std::memory_order_relaxed);
+      }
+      state.generations = expected + 1;
+    } else {
+      // Another thread grew the table; pick up the latest
+      state.generations = expected;
+    }
+  }
+  return new_occupancy <=
+         std::min(occupancy_limit_,
+                  static_cast<size_t>(
+                      TableSizeForGenerations(state.generations) *
+                      kStrictLoadFactor));
+}
+
+size_t AutoHyperClockTable::GetOccupancyLimit() const {
+  return std::min(occupancy_limit_,
+                  static_cast<size_t>(GetTableSize() * kStrictLoadFactor));
+}
+
+AutoHyperClockTable::HandleImpl* AutoHyperClockTable::DoInsert(
+    const ClockHandleBasicData& proto, uint64_t initial_countdown,
+    bool keep_ref, InsertState& state) {
+  // Prefer the newest (largest) generation, but fall back on older ones if
+  // it is at its strict load factor. The first generation is always tried
+  // as a last resort.
+  for (int gen = state.generations - 1; gen >= 0; --gen) {
+    const size_t gen_limit = static_cast<size_t>(
+        (size_t{1} << (initial_length_bits_ + gen)) * kStrictLoadFactor);
+    // Optimistically claim occupancy in the generation
+    size_t old_gen_occupancy =
+        generation_occupancy_[gen].fetch_add(1, std::memory_order_acquire);
+    if (old_gen_occupancy >= gen_limit && gen > 0) {
+      generation_occupancy_[gen].fetch_sub(1, std::memory_order_relaxed);
+      continue;
+    }
+    bool already_matches = false;
+    HandleImpl* e = FindSlot(
+        gen, proto.hashed_key,
+        [&](HandleImpl* h) {
+          return TryInsert(proto, *h, initial_countdown, keep_ref,
+                           &already_matches);
+        },
+        [&](HandleImpl* h) {
+          if (already_matches) {
+            // Stop searching & roll back displacements
+            Rollback(proto.hashed_key, h);
+            return true;
+          } else {
+            // Keep going
+            return false;
+          }
+        },
+        [&](HandleImpl* h, bool is_last) {
+          if (is_last) {
+            // Search is ending. Roll back displacements
+            Rollback(proto.hashed_key, h);
+          } else {
+            h->displacements.fetch_add(1, std::memory_order_relaxed);
+          }
+        });
+    if (e != nullptr) {
+      // Successfully inserted
+      return e;
+    }
+    // Not inserted in this generation
+    generation_occupancy_[gen].fetch_sub(1, std::memory_order_relaxed);
+    if (already_matches) {
+      // Insertion skipped
+      return nullptr;
+    }
+  }
+  // Else, no available slot found. See HyperClockTable::DoInsert.
+  return nullptr;
+}
+
+AutoHyperClockTable::HandleImpl* AutoHyperClockTable::Lookup(
+    const rocksdb_rs::unique_id::UniqueId64x2& hashed_key) {
+  // Newest generations are most likely to hold recently inserted entries
+  for (int gen = generations_.load(std::memory_order_acquire) - 1; gen >= 0;
+       --gen) {
+    if (generation_occupancy_[gen].load(std::memory_order_relaxed) == 0) {
+      continue;
+    }
+    HandleImpl* e = FindSlot(
+        gen, hashed_key,
+        [&](HandleImpl* h) { return TryLookupRef(hashed_key, *h); },
+        [&](HandleImpl* h) {
+          return h->displacements.load(std::memory_order_relaxed) == 0;
+        },
+        [&](HandleImpl* /*h*/, bool /*is_last*/) {});
+    if (e != nullptr) {
+      return e;
+    }
+  }
+  return nullptr;
+}
+
+bool AutoHyperClockTable::Release(HandleImpl* h, bool useful,
+                                  bool erase_if_last_ref) {
+  if (!TryReleaseTakeOwnership(h, useful, erase_if_last_ref)) {
+    return false;
+  }
+  // Took ownership
+  size_t total_charge = h->GetTotalCharge();
+  if (UNLIKELY(h->IsStandalone())) {
+    h->FreeData(allocator_);
+    // Delete standalone handle
+    delete h;
+    standalone_usage_.fetch_sub(total_charge, std::memory_order_relaxed);
+    usage_.fetch_sub(total_charge, std::memory_order_relaxed);
+  } else {
+    Rollback(h->hashed_key, h);
+    FreeDataMarkEmpty(*h, allocator_);
+    ReclaimEntryUsage(total_charge, GenerationOf(h));
+  }
+  return true;
+}
+
+#ifndef NDEBUG
+void AutoHyperClockTable::TEST_ReleaseN(HandleImpl* h, size_t n) {
+  if (n > 0) {
+    // Do n-1 simple releases first
+    TEST_ReleaseNMinus1(h, n);
+
+    // Then the last release might be more involved
+    Release(h, /*useful*/ true, /*erase_if_last_ref*/ false);
+  }
+}
+#endif
+
+void AutoHyperClockTable::Erase(
+    const rocksdb_rs::unique_id::UniqueId64x2& hashed_key) {
+  // An entry could be in any generation
+  for (int gen = generations_.load(std::memory_order_acquire) - 1; gen >= 0;
+       --gen) {
+    if (generation_occupancy_[gen].load(std::memory_order_relaxed) == 0) {
+      continue;
+    }
+    (void)FindSlot(
+        gen, hashed_key,
+        [&](HandleImpl* h) {
+          // Could be multiple entries in rare cases. Erase them all.
+          if (TryEraseRef(hashed_key, *h)) {
+            // Took ownership
+            size_t total_charge = h->GetTotalCharge();
+            FreeDataMarkEmpty(*h, allocator_);
+            ReclaimEntryUsage(total_charge, gen);
+            // We already have a copy of hashed_key in this case, so OK to
+            // delay Rollback until after releasing the entry
+            Rollback(hashed_key, h);
+          }
+          return false;
+        },
+        [&](HandleImpl* h) {
+          return h->displacements.load(std::memory_order_relaxed) == 0;
+        },
+        [&](HandleImpl* /*h*/, bool /*is_last*/) {});
+  }
+}
+
+void AutoHyperClockTable::EraseUnRefEntries() {
+  const size_t table_size = GetTableSize();
+  for (size_t i = 0; i < table_size; i++) {
+    HandleImpl& h = array_[i];
+
+    uint64_t old_meta = h.meta.load(std::memory_order_relaxed);
+    if (old_meta & (uint64_t{ClockHandle::kStateShareableBit}
+                    << ClockHandle::kStateShift) &&
+        GetRefcount(old_meta) == 0 &&
+        h.meta.compare_exchange_strong(old_meta,
+                                       uint64_t{ClockHandle::kStateConstruction}
+                                           << ClockHandle::kStateShift,
+                                       std::memory_order_acquire)) {
+      // Took ownership
+      size_t total_charge = h.GetTotalCharge();
+      Rollback(h.hashed_key, &h);
+      FreeDataMarkEmpty(h, allocator_);
+      ReclaimEntryUsage(total_charge, GenerationOf(&h));
+    }
+  }
+}
+
+inline int AutoHyperClockTable::GenerationOf(const HandleImpl* h) const {
+  // Generation g starts at index ((1 << g) - 1) << initial_length_bits_
+  size_t idx = static_cast<size_t>(h - array_);
+  return FloorLog2((idx >> initial_length_bits_) + 1);
+}
+
+template <typename MatchFn, typename AbortFn, typename UpdateFn>
+inline AutoHyperClockTable::HandleImpl* AutoHyperClockTable::FindSlot(
+    int gen, const rocksdb_rs::unique_id::UniqueId64x2& hashed_key,
+    MatchFn match_fn, AbortFn abort_fn, UpdateFn update_fn) {
+  // Same double-hashing probing as HyperClockTable::FindSlot, within the
+  // generation.
+  HandleImpl* gen_array = &array_[GenerationBegin(gen)];
+  size_t base = static_cast<size_t>(hashed_key.data[1]);
+  size_t increment = static_cast<size_t>(hashed_key.data[0]) | 1U;
+  size_t first = ModGenerationSize(gen, base);
+  size_t current = first;
+  bool is_last;
+  do {
+    HandleImpl* h = &gen_array[current];
+    if (match_fn(h)) {
+      return h;
+    }
+    if (abort_fn(h)) {
+      return nullptr;
+    }
+    current = ModGenerationSize(gen, current + increment);
+    is_last = current == first;
+    update_fn(h, is_last);
+  } while (!is_last);
+  // We looped back.
+  return nullptr;
+}
+
+inline void AutoHyperClockTable::Rollback(
+    const rocksdb_rs::unique_id::UniqueId64x2& hashed_key,
+    const HandleImpl* h) {
+  int gen = GenerationOf(h);
+  HandleImpl* gen_array = &array_[GenerationBegin(gen)];
+  size_t current = ModGenerationSize(gen, hashed_key.data[1]);
+  size_t increment = static_cast<size_t>(hashed_key.data[0]) | 1U;
+  while (&gen_array[current] != h) {
+    gen_array[current].displacements.fetch_sub(1, std::memory_order_relaxed);
+    current = ModGenerationSize(gen, current + increment);
+  }
+}
+
+inline void AutoHyperClockTable::ReclaimEntryUsage(size_t total_charge,
+                                                   int gen) {
+  auto old_gen_occupancy =
+      generation_occupancy_[gen].fetch_sub(1U, std::memory_order_release);
+  (void)old_gen_occupancy;
+  // No underflow
+  assert(old_gen_occupancy > 0);
+  auto old_occupancy = occupancy_.fetch_sub(1U, std::memory_order_release);
+  (void)old_occupancy;
+  // No underflow
+  assert(old_occupancy > 0);
+  auto old_usage = usage_.fetch_sub(total_charge, std::memory_order_relaxed);
+  (void)old_usage;
+  // No underflow
+  assert(old_usage >= total_charge);
+}
+
+inline void AutoHyperClockTable::Evict(size_t requested_charge,
+                                       size_t* freed_charge,
+                                       size_t* freed_count,
+                                       InsertState& state) {
+  // precondition
+  assert(requested_charge > 0);
+
+  // TODO: make a tuning parameter?
+  constexpr size_t step_size = 4;
+
+  // The clock sweeps over all published generations as one array
+  const size_t table_size = TableSizeForGenerations(state.generations);
+
+  // First (concurrent) increment clock pointer
+  uint64_t old_clock_pointer =
+      clock_pointer_.fetch_add(step_size, std::memory_order_relaxed);
+
+  // Cap the eviction effort as in HyperClockTable::Evict
+  uint64_t max_clock_pointer =
+      old_clock_pointer + uint64_t{ClockHandle::kMaxCountdown} * table_size;
+
+  for (;;) {
+    for (size_t i = 0; i < step_size; i++) {
+      HandleImpl& h =
+          array_[static_cast<size_t>((old_clock_pointer + i) % table_size)];
+      bool evicting = ClockUpdate(h);
+      if (evicting) {
+        int gen = GenerationOf(&h);
+        Rollback(h.hashed_key, &h);
+        *freed_charge += h.GetTotalCharge();
+        *freed_count += 1;
+        FinishEviction<AutoHyperClockTable>(h);
+        // Overall occupancy is updated by the caller
+        generation_occupancy_[gen].fetch_sub(1U, std::memory_order_release);
       }
     }
 
@@ -1367,38 +1821,46 @@ size_t ClockCacheShard<Table>::GetTableAddressCount() const {
 
 // Explicit instantiation
 template class ClockCacheShard<HyperClockTable>;
+template class ClockCacheShard<AutoHyperClockTable>;
 
-HyperClockCache::HyperClockCache(const HyperClockCacheOptions& opts)
-    : ShardedCache(opts) {
-  assert(opts.estimated_entry_charge > 0 ||
-         opts.metadata_charge_policy != kDontChargeCacheMetadata);
+template <class Table>
+BaseHyperClockCache<Table>::BaseHyperClockCache(
+    const HyperClockCacheOptions& opts)
+    : ShardedCache<ClockCacheShard<Table>>(opts) {
   // TODO: should not need to go through two levels of pointer indirection to
   // get to table entries
-  size_t per_shard = GetPerShardCapacity();
+  size_t per_shard = this->GetPerShardCapacity();
   MemoryAllocator* alloc = this->memory_allocator();
-  InitShards([&](Shard* cs) {
-    HyperClockTable::Opts table_opts;
-    table_opts.estimated_value_size = opts.estimated_entry_charge;
+  this->InitShards([&](Shard* cs) {
+    typename Table::Opts table_opts{opts};
     new (cs) Shard(per_shard, opts.strict_capacity_limit,
-                   opts.metadata_charge_policy, alloc, &eviction_callback_,
-                   &hash_seed_, table_opts);
+                   opts.metadata_charge_policy, alloc,
+                   &this->eviction_callback_, &this->hash_seed_, table_opts);
   });
 }
 
-Cache::ObjectPtr HyperClockCache::Value(Handle* handle) {
-  return reinterpret_cast<const HandleImpl*>(handle)->value;
+template <class Table>
+Cache::ObjectPtr BaseHyperClockCache<Table>::Value(Handle* handle) {
+  return reinterpret_cast<const typename Table::HandleImpl*>(handle)->value;
 }
 
-size_t HyperClockCache::GetCharge(Handle* handle) const {
-  return reinterpret_cast<const HandleImpl*>(handle)->GetTotalCharge();
+template <class Table>
+size_t BaseHyperClockCache<Table>::GetCharge(Handle* handle) const {
+  return reinterpret_cast<const typename Table::HandleImpl*>(handle)
+      ->GetTotalCharge();
 }
 
-const Cache::CacheItemHelper* HyperClockCache::GetCacheItemHelper(
+template <class Table>
+const Cache::CacheItemHelper* BaseHyperClockCache<Table>::GetCacheItemHelper(
     Handle* handle) const {
-  auto h = reinterpret_cast<const HandleImpl*>(handle);
+  auto h = reinterpret_cast<const typename Table::HandleImpl*>(handle);
   return h->helper;
 }
 
+// Explicit instantiation
+template class BaseHyperClockCache<HyperClockTable>;
+template class BaseHyperClockCache<AutoHyperClockTable>;
+
 namespace {
 
 // For each cache shard, estimate what the table load factor would be if
@@ -1528,6 +1990,45 @@ void HyperClockCache::ReportProblems(
   }
 }
 
+void AutoHyperClockCache::ReportProblems(
+    const std::shared_ptr<Logger>& info_log) const {
+  // With a growable table, the only configuration problem to detect is the
+  // table reaching its maximum size and limiting the number of entries
+  // below what would fit in the cache capacity, i.e. min_avg_entry_charge
+  // is too high for the workload.
+  uint32_t shard_count = GetNumShards();
+  int limited_count = 0;
+  size_t min_recommendation = SIZE_MAX;
+  const_cast<AutoHyperClockCache*>(this)->ForEachShard(
+      [&](AutoHyperClockCache::Shard* shard) {
+        size_t usage = shard->GetUsage() - shard->GetStandaloneUsage();
+        size_t capacity = shard->GetCapacity();
+        size_t occupancy = shard->GetOccupancyCount();
+        if (usage == 0 || occupancy == 0 ||
+            shard->GetTableAddressCount() <
+                shard->GetTable().GetMaxTableSize()) {
+          // Still room to grow
+          return;
+        }
+        if (1.0 * usage / capacity < 0.8 &&
+            1.0 * occupancy / shard->GetOccupancyLimit() > 0.95) {
+          ++limited_count;
+          min_recommendation = std::min(min_recommendation, usage / occupancy);
+        }
+      });
+  if (limited_count > 0) {
+    InfoLogLevel level = limited_count * 5 >= static_cast<int>(shard_count)
+                             ? InfoLogLevel::WARN_LEVEL
+                             : InfoLogLevel::INFO_LEVEL;
+    ROCKS_LOG_AT_LEVEL(
+        info_log, level,
+        "AutoHyperClockCache@%p unable to use full capacity because of full "
+        "occupancy at maximum table size in %d/%u cache shards "
+        "(min_avg_entry_charge too high). Recommend min_avg_entry_charge=%zu",
+        this, limited_count, (unsigned)shard_count, min_recommendation);
+  }
+}
+
 }  // namespace clock_cache
 
 // DEPRECATED (see public API)
@@ -1553,8 +2054,13 @@ std::shared_ptr<Cache> HyperClockCacheOptions::MakeSharedCache() const {
     opts.num_shard_bits =
         GetDefaultCacheShardBits(opts.capacity, min_shard_size);
   }
-  std::shared_ptr<Cache> cache =
-      std::make_shared<clock_cache::HyperClockCache>(opts);
+  std::shared_ptr<Cache> cache;
+  if (opts.estimated_entry_charge == 0) {
+    // Table size determined online (EXPERIMENTAL)
+    cache = std::make_shared<clock_cache::AutoHyperClockCache>(opts);
+  } else {
+    cache = std::make_shared<clock_cache::HyperClockCache>(opts);
+  }
   if (opts.secondary_cache) {
     cache = std::make_shared<CacheWithSecondaryAdapter>(cache,
                                                         opts.secondary_cache);
@@ -22,6 +22,7 @@
 #include "cache/sharded_cache.h"
 #include "port/lang.h"
 #include "port/malloc.h"
+#include "port/mmap.h"
 #include "port/port.h"
 #include "rocksdb/cache.h"
 #include "rocksdb/secondary_cache.h"
@@ -49,9 +50,11 @@ class ClockCacheTest;
 //
 // Costs
 // -----
-// * Hash table is not resizable (for lock-free efficiency) so capacity is not
-// dynamically changeable. Rely on an estimated average value (block) size for
-// space+time efficiency. (See estimated_entry_charge option details.)
+// * With HyperClockTable, the hash table is not resizable (for lock-free
+// efficiency) so capacity is not dynamically changeable. Rely on an estimated
+// average value (block) size for space+time efficiency. (See
+// estimated_entry_charge option details.) AutoHyperClockTable instead grows
+// its table as needed, at some cost to Lookup (see below).
 // * Insert usually does not (but might) overwrite a previous entry associated
 // with a cache key. This is OK for RocksDB uses of Cache.
 // * Only supports keys of exactly 16 bytes, which is what RocksDB uses for
@@ -466,6 +469,15 @@ class BaseClockTable {
                                       bool need_evict_for_occupancy,
                                       typename Table::InsertState& state);
 
+ protected:  // fns
+  // Completes eviction of an entry that the current thread has taken
+  // ownership of (in "under construction" state), by passing it to the
+  // eviction callback or freeing it, and then marking the slot empty. The
+  // probe sequence (displacements) and occupancy / usage accounting are left
+  // to the caller.
+  template <class Table>
+  void FinishEviction(typename Table::HandleImpl& h);
+
  protected:  // data
   // We partition the following members into different cache lines
   // to avoid false sharing among Lookup, Release, Erase and Insert
@@ -509,7 +521,10 @@ class HyperClockTable : public BaseClockTable {
   };  // struct HandleImpl
 
   struct Opts {
-    size_t estimated_value_size;
+    Opts() = default;
+    explicit Opts(const HyperClockCacheOptions& opts)
+        : estimated_value_size(opts.estimated_entry_charge) {}
+    size_t estimated_value_size = 0;
   };
 
   HyperClockTable(size_t capacity, bool strict_capacity_limit,
@@ -551,6 +566,11 @@ class HyperClockTable : public BaseClockTable {
 
   const HandleImpl* HandlePtr(size_t idx) const { return &array_[idx]; }
 
+  // Returns the number of bits used to hash an element in the hash
+  // table.
+  static int CalcHashBits(size_t capacity, size_t estimated_value_size,
+                          CacheMetadataChargePolicy metadata_charge_policy);
+
 #ifndef NDEBUG
   size_t& TEST_MutableOccupancyLimit() const {
     return const_cast<size_t&>(occupancy_limit_);
@@ -594,11 +614,6 @@ class HyperClockTable : public BaseClockTable {
 
   MemoryAllocator* GetAllocator() const { return allocator_; }
 
-  // Returns the number of bits used to hash an element in the hash
-  // table.
-  static int CalcHashBits(size_t capacity, size_t estimated_value_size,
-                          CacheMetadataChargePolicy metadata_charge_policy);
-
  private:  // data
   // Number of hash bits used for table index.
   // The size of the table is 1 << length_bits_.
@@ -614,6 +629,189 @@ class HyperClockTable : public BaseClockTable {
   const std::unique_ptr<HandleImpl[]> array_;
 };  // class HyperClockTable
 
+// A variant of HyperClockTable that does not depend on an estimated average
+// entry charge (estimated_entry_charge == 0). Rather than fixing the table
+// size at creation time, the table grows online (without locking or
+// blocking) as needed to accommodate the number of entries fitting in the
+// cache capacity, up to a maximum implied by min_avg_entry_charge.
+//
+// Growing a lock-free open-addressing table is normally complicated by
+// entries needing to move to new slots, which is not possible here because
+// Cache handles are pointers to slots. Instead, the table is a sequence of
+// "generations," each twice the size of the previous one, laid out
+// contiguously in a lazily-mapped (zero-filled, not yet resident) address
+// range reserved at creation for the maximum table size. Growing the table
+// is just publishing one more generation with a compare-exchange; memory for
+// a generation only becomes resident when it is touched. Each generation is
+// an independent open-addressing table with the same probing scheme (and
+// displacement counters) as HyperClockTable, and an entry stays in the slot
+// where it was inserted for its whole lifetime.
+//
+// Insert favors the newest (largest) generation, falling back on older
+// generations when a generation is at its strict load factor. Lookup probes
+// the generations from newest to oldest, skipping any that are empty. This
+// makes a Lookup miss somewhat more expensive than with HyperClockTable, in
+// proportion to the number of non-empty generations, but that number stays
+// small because the first generation is no smaller than
+// 1/2^(kMaxGenerations - 1) of the largest. Older generations naturally
+// drain as their entries are evicted and replacement entries go to the
+// newest generation. CLOCK eviction sweeps over all published slots of all
+// generations.
+class AutoHyperClockTable : public BaseClockTable {
+ public:
+  // Same slot layout as the fixed-size table
+  using HandleImpl = HyperClockTable::HandleImpl;
+
+  struct Opts {
+    Opts() = default;
+    explicit Opts(const HyperClockCacheOptions& opts)
+        : min_avg_value_size(opts.min_avg_entry_charge) {}
+    // Smallest supported average entry charge, which determines the maximum
+    // table size.
+    size_t min_avg_value_size = 0;
+  };
+
+  // Limit on the number of generations, which bounds the number of probe
+  // sequences for a Lookup miss.
+  static constexpr int kMaxGenerations = 8;
+
+  AutoHyperClockTable(size_t capacity, bool strict_capacity_limit,
+                      CacheMetadataChargePolicy metadata_charge_policy,
+                      MemoryAllocator* allocator,
+                      const Cache::EvictionCallback* eviction_callback,
+                      const uint32_t* hash_seed, const Opts& opts);
+  ~AutoHyperClockTable();
+
+  // For BaseClockTable::Insert
+  struct InsertState {
+    // Number of generations published, as seen by this insert
+    int generations = 0;
+  };
+
+  void StartInsert(InsertState& state);
+
+  // Returns true iff there is room for the proposed number of entries,
+  // growing the table (publishing another generation) if appropriate.
+  bool GrowIfNeeded(size_t new_occupancy, InsertState& state);
+
+  HandleImpl* DoInsert(const ClockHandleBasicData& proto,
+                       uint64_t initial_countdown, bool take_ref,
+                       InsertState& state);
+
+  // Runs the clock eviction algorithm trying to reclaim at least
+  // requested_charge. Returns how much is evicted, which could be less
+  // if it appears impossible to evict the requested amount without blocking.
+  void Evict(size_t requested_charge, size_t* freed_charge, size_t* freed_count,
+             InsertState& state);
+
+  HandleImpl* Lookup(const rocksdb_rs::unique_id::UniqueId64x2& hashed_key);
+
+  bool Release(HandleImpl* handle, bool useful, bool erase_if_last_ref);
+
+  void Erase(const rocksdb_rs::unique_id::UniqueId64x2& hashed_key);
+
+  void EraseUnRefEntries();
+
+  // Number of slots in the currently published generations
+  size_t GetTableSize() const {
+    return TableSizeForGenerations(
+        generations_.load(std::memory_order_acquire));
+  }
+
+  // Occupancy limit for the current table size
+  size_t GetOccupancyLimit() const;
+
+  // Number of generations currently published
+  int GetGenerationCount() const {
+    return generations_.load(std::memory_order_acquire);
+  }
+
+  // Maximum table size, once all generations are published
+  size_t GetMaxTableSize() const {
+    return TableSizeForGenerations(max_generations_);
+  }
+
+  const HandleImpl* HandlePtr(size_t idx) const { return &array_[idx]; }
+
+#ifndef NDEBUG
+  size_t& TEST_MutableOccupancyLimit() const {
+    return const_cast<size_t&>(occupancy_limit_);
+  }
+
+  // Release N references
+  void TEST_ReleaseN(HandleImpl* handle, size_t n);
+#endif
+
+ private:  // functions
+  // Total number of slots in the first `generations` generations
+  inline size_t TableSizeForGenerations(int generations) const {
+    return ((size_t{1} << generations) - 1) << initial_length_bits_;
+  }
+
+  // Index of the first slot of the given generation
+  inline size_t GenerationBegin(int gen) const {
+    return TableSizeForGenerations(gen);
+  }
+
+  // Returns x mod the size of the given generation
+  inline size_t ModGenerationSize(int gen, uint64_t x) const {
+    return static_cast<size_t>(x) &
+           ((size_t{1} << (initial_length_bits_ + gen)) - 1);
+  }
+
+  // Which generation a slot belongs to
+  inline int GenerationOf(const HandleImpl* h) const;
+
+  // Like HyperClockTable::FindSlot, but only over the slots of the given
+  // generation.
+  template <typename MatchFn, typename AbortFn, typename UpdateFn>
+  inline HandleImpl* FindSlot(
+      int gen, const rocksdb_rs::unique_id::UniqueId64x2& hashed_key,
+      MatchFn match_fn, AbortFn abort_fn, UpdateFn update_fn);
+
+  // Re-decrement all displacements in probe path (within the generation of
+  // the given handle) starting from beginning until (not including) the
+  // given handle
+  inline void Rollback(const rocksdb_rs::unique_id::UniqueId64x2& hashed_key,
+                       const HandleImpl* h);
+
+  // Subtracts `total_charge` from `usage_` and 1 from `occupancy_` and the
+  // occupancy of the given generation. See HyperClockTable.
+  inline void ReclaimEntryUsage(size_t total_charge, int gen);
+
+ private:  // data
+  // Size of the first generation is 1 << initial_length_bits_, and each
+  // generation is twice the size of the previous one.
+  const int initial_length_bits_;
+
+  // Number of generations when the table has reached its maximum size.
+  // (Only reduced from the ideal in the constructor, if reserving the
+  // address space fails.)
+  int max_generations_;
+
+  // Maximum number of elements the user can store in the table, at maximum
+  // table size.
+  size_t occupancy_limit_;
+
+  // Reserved (lazily resident) memory for all generations
+  MemMapping array_mem_;
+
+  // Fallback for when array_mem_ could not be reserved, holding only the
+  // first generation
+  std::unique_ptr<HandleImpl[]> heap_array_;
+
+  // Slots of all generations, contiguous in array_mem_ (or heap_array_)
+  HandleImpl* array_;
+
+  // Number of generations published for use. Only ever increases.
+  std::atomic<int> generations_;
+
+  // Number of elements in each generation, which might temporarily
+  // over-count (never under-count) elements while they are inserted or
+  // removed.
+  std::array<std::atomic<size_t>, kMaxGenerations> generation_occupancy_{};
+};  // class AutoHyperClockTable
+
 // A single shard of sharded cache.
 template <class Table>
 class ALIGN_AS(CACHE_LINE_SIZE) ClockCacheShard final : public CacheShardBase {
@@ -699,6 +897,8 @@ class ALIGN_AS(CACHE_LINE_SIZE) ClockCacheShard final : public CacheShardBase {
 
   size_t GetTableAddressCount() const;
 
+  const Table& GetTable() const { return table_; }
+
   void ApplyToSomeEntries(
       const std::function<void(const Slice& key, Cache::ObjectPtr obj,
                                size_t charge,
@@ -736,27 +936,49 @@ class ALIGN_AS(CACHE_LINE_SIZE) ClockCacheShard final : public CacheShardBase {
   std::atomic<bool> strict_capacity_limit_;
 };  // class ClockCacheShard
 
+template <class Table>
+class BaseHyperClockCache : public ShardedCache<ClockCacheShard<Table>> {
+ public:
+  using Shard = ClockCacheShard<Table>;
+  using Handle = Cache::Handle;
+  using CacheItemHelper = Cache::CacheItemHelper;
+
+  explicit BaseHyperClockCache(const HyperClockCacheOptions& opts);
+
+  Cache::ObjectPtr Value(Handle* handle) override;
+
+  size_t GetCharge(Handle* handle) const override;
+
+  const CacheItemHelper* GetCacheItemHelper(Handle* handle) const override;
+};  // class BaseHyperClockCache
+
 class HyperClockCache
 #ifdef NDEBUG
     final
 #endif
-    : public ShardedCache<ClockCacheShard<HyperClockTable>> {
+    : public BaseHyperClockCache<HyperClockTable> {
  public:
-  using Shard = ClockCacheShard<HyperClockTable>;
-
-  explicit HyperClockCache(const HyperClockCacheOptions& opts);
+  using BaseHyperClockCache::BaseHyperClockCache;
 
   const char* Name() const override { return "HyperClockCache"; }
 
-  Cache::ObjectPtr Value(Handle* handle) override;
+  void ReportProblems(
+      const std::shared_ptr<Logger>& /*info_log*/) const override;
+};  // class HyperClockCache
 
-  size_t GetCharge(Handle* handle) const override;
+class AutoHyperClockCache
+#ifdef NDEBUG
+    final
+#endif
+    : public BaseHyperClockCache<AutoHyperClockTable> {
+ public:
+  using BaseHyperClockCache::BaseHyperClockCache;
 
-  const CacheItemHelper* GetCacheItemHelper(Handle* handle) const override;
+  const char* Name() const override { return "AutoHyperClockCache"; }
 
   void ReportProblems(
       const std::shared_ptr<Logger>& /*info_log*/) const override;
-};  // class HyperClockCache
+};  // class AutoHyperClockCache
 
 }  // namespace clock_cache
 
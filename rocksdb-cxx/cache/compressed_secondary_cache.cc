@@ -22,7 +22,23 @@ CompressedSecondaryCache::CompressedSecondaryCache(
       cache_options_(opts),
       cache_res_mgr_(std::make_shared<ConcurrentCacheReservationManager>(
           std::make_shared<CacheReservationManagerImpl<
-              rocksdb_rs::cache::CacheEntryRole::kMisc>>(cache_))) {}
+              rocksdb_rs::cache::CacheEntryRole::kMisc>>(cache_))) {
+  if (!cache_options_.persistent_file_path.empty()) {
+    // The compression settings decide whether the blocks in the file can be
+    // decompressed
+    // On failure, the blocks are kept on the heap
+    rocksdb_rs::status::Status s = MmapCacheArena::Open(
+        cache_options_.persistent_file_path, cache_options_.capacity,
+        cache_options_.compress_format_version, &arena_);
+    if (!s.ok()) {
+      arena_.reset();
+    }
+  }
+  if (arena_) {
+    cache_options_.enable_custom_split_merge = false;
+    RecoverFromArena();
+  }
+}
 
 CompressedSecondaryCache::~CompressedSecondaryCache() {
   assert(cache_res_mgr_->GetTotalReservedCacheSize() == 0);
@@ -49,7 +65,23 @@ std::unique_ptr<SecondaryCacheResultHandle> CompressedSecondaryCache::Lookup(
   CacheAllocationPtr* ptr{nullptr};
   CacheAllocationPtr merged_value;
   size_t handle_value_charge{0};
-  if (cache_options_.enable_custom_split_merge) {
+  rocksdb_rs::compression_type::CompressionType compression_type =
+      cache_options_.do_not_compress_roles.Contains(helper->role)
+          ? rocksdb_rs::compression_type::CompressionType::kNoCompression
+          : cache_options_.compression_type;
+  if (arena_) {
+    uint8_t value_type{0};
+    if (!arena_->Read(*static_cast<uint64_t*>(handle_value), key,
+                      cache_options_.memory_allocator.get(), &merged_value,
+                      &handle_value_charge, &value_type)) {
+      // Overwritten by newer blocks
+      cache_->Release(lru_handle, /*erase_if_last_ref=*/true);
+      return nullptr;
+    }
+    ptr = &merged_value;
+    compression_type =
+        static_cast<rocksdb_rs::compression_type::CompressionType>(value_type);
+  } else if (cache_options_.enable_custom_split_merge) {
     CacheValueChunk* value_chunk_ptr =
         reinterpret_cast<CacheValueChunk*>(handle_value);
     merged_value = MergeChunksIntoValue(value_chunk_ptr, handle_value_charge);
@@ -63,16 +95,15 @@ std::unique_ptr<SecondaryCacheResultHandle> CompressedSecondaryCache::Lookup(
   rocksdb_rs::status::Status s = rocksdb_rs::status::Status_new();
   Cache::ObjectPtr value{nullptr};
   size_t charge{0};
-  if (cache_options_.compression_type ==
-          rocksdb_rs::compression_type::CompressionType::kNoCompression ||
-      cache_options_.do_not_compress_roles.Contains(helper->role)) {
+  if (compression_type ==
+      rocksdb_rs::compression_type::CompressionType::kNoCompression) {
     s = helper->create_cb(Slice(ptr->get(), handle_value_charge),
                           create_context, allocator, &value, &charge);
   } else {
-    UncompressionContext uncompression_context(cache_options_.compression_type);
+    UncompressionContext uncompression_context(compression_type);
     UncompressionInfo uncompression_info(uncompression_context,
                                          UncompressionDict::GetEmptyDict(),
-                                         cache_options_.compression_type);
+                                         compression_type);
 
     size_t uncompressed_size{0};
     CacheAllocationPtr uncompressed = UncompressData(
@@ -136,9 +167,12 @@ rocksdb_rs::status::Status CompressedSecondaryCache::Insert(
   Slice val(ptr.get(), size);
 
   std::string compressed_val;
+  rocksdb_rs::compression_type::CompressionType compression_type =
+      rocksdb_rs::compression_type::CompressionType::kNoCompression;
   if (cache_options_.compression_type !=
           rocksdb_rs::compression_type::CompressionType::kNoCompression &&
       !cache_options_.do_not_compress_roles.Contains(helper->role)) {
+    compression_type = cache_options_.compression_type;
     PERF_COUNTER_ADD(compressed_sec_cache_uncompressed_bytes, size);
     CompressionOptions compression_opts;
     CompressionContext compression_context(cache_options_.compression_type);
@@ -159,14 +193,22 @@ rocksdb_rs::status::Status CompressedSecondaryCache::Insert(
     size = compressed_val.size();
     PERF_COUNTER_ADD(compressed_sec_cache_compressed_bytes, size);
 
-    if (!cache_options_.enable_custom_split_merge) {
+    if (!cache_options_.enable_custom_split_merge && !arena_) {
       ptr = AllocateBlock(size, cache_options_.memory_allocator.get());
       memcpy(ptr.get(), compressed_val.data(), size);
     }
   }
 
   PERF_COUNTER_ADD(compressed_sec_cache_insert_real_count, 1);
-  if (cache_options_.enable_custom_split_merge) {
+  if (arena_) {
+    uint64_t pos{0};
+    if (!arena_->Append(key, val, static_cast<uint8_t>(compression_type),
+                        &pos)) {
+      // Larger than the whole arena; the dummy handle stays
+      return rocksdb_rs::status::Status_OK();
+    }
+    return cache_->Insert(key, new uint64_t(pos), internal_helper, size);
+  } else if (cache_options_.enable_custom_split_merge) {
     size_t charge{0};
     CacheValueChunk* value_chunks_head =
         SplitValueIntoChunks(val, cache_options_.compression_type, charge);
@@ -181,6 +223,10 @@ void CompressedSecondaryCache::Erase(const Slice& key) { cache_->Erase(key); }
 
 rocksdb_rs::status::Status CompressedSecondaryCache::SetCapacity(
     size_t capacity) {
+  if (arena_) {
+    return rocksdb_rs::status::Status_NotSupported(
+        "The capacity of a cache with persistent_file_path is fixed");
+  }
   MutexLock l(&capacity_mutex_);
   cache_options_.capacity = capacity;
   cache_->SetCapacity(capacity);
@@ -206,6 +252,11 @@ std::string CompressedSecondaryCache::GetPrintableOptions() const {
   snprintf(buffer, kBufferSize, "    compress_format_version : %d\n",
            cache_options_.compress_format_version);
   ret.append(buffer);
+  if (!cache_options_.persistent_file_path.empty()) {
+    ret.append("    persistent_file_path : ");
+    ret.append(cache_options_.persistent_file_path);
+    ret.append(arena_ ? "\n" : " (not mapped)\n");
+  }
   return ret;
 }
 
@@ -281,9 +332,24 @@ CacheAllocationPtr CompressedSecondaryCache::MergeChunksIntoValue(
   return ptr;
 }
 
+void CompressedSecondaryCache::RecoverFromArena() {
+  auto internal_helper = GetHelper(/*enable_custom_split_merge=*/false);
+  arena_->Recover([&](const Slice& key, uint64_t pos, size_t value_size) {
+    // A block appended again later replaces the earlier one
+    cache_->Insert(key, new uint64_t(pos), internal_helper, value_size);
+  });
+}
+
 const Cache::CacheItemHelper* CompressedSecondaryCache::GetHelper(
     bool enable_custom_split_merge) const {
-  if (enable_custom_split_merge) {
+  if (arena_) {
+    static const Cache::CacheItemHelper kHelper{
+        rocksdb_rs::cache::CacheEntryRole::kMisc,
+        [](Cache::ObjectPtr obj, MemoryAllocator* /*alloc*/) {
+          delete static_cast<uint64_t*>(obj);
+        }};
+    return &kHelper;
+  } else if (enable_custom_split_merge) {
     static const Cache::CacheItemHelper kHelper{
         rocksdb_rs::cache::CacheEntryRole::kMisc,
         [](Cache::ObjectPtr obj, MemoryAllocator* /*alloc*/) {
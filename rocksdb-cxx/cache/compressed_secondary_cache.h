@@ -11,6 +11,7 @@
 
 #include "cache/cache_reservation_manager.h"
 #include "cache/lru_cache.h"
+#include "cache/mmap_cache_arena.h"
 #include "memory/memory_allocator_impl.h"
 #include "rocksdb-rs/src/status.rs.h"
 #include "rocksdb/secondary_cache.h"
@@ -67,6 +68,11 @@ class CompressedSecondaryCacheResultHandle : public SecondaryCacheResultHandle {
 // std::unique_ptr<rocksdb::SecondaryCache> cache =
 //      NewCompressedSecondaryCache(opts);
 // static_cast<CompressedSecondaryCache*>(cache.get())->Erase(key);
+//
+// With CompressedSecondaryCacheOptions::persistent_file_path, the compressed
+// blocks are stored in a MmapCacheArena, and the entries of the LRU cache
+// only hold their positions in it. The LRU cache is rebuilt from the arena
+// when the cache is created.
 
 class CompressedSecondaryCache : public SecondaryCache {
  public:
@@ -131,12 +137,17 @@ class CompressedSecondaryCache : public SecondaryCache {
   CacheAllocationPtr MergeChunksIntoValue(const void* chunks_head,
                                           size_t& charge);
 
+  // Index the blocks left in the arena by a previous instance
+  void RecoverFromArena();
+
   // TODO: clean up to use cleaner interfaces in typed_cache.h
   const Cache::CacheItemHelper* GetHelper(bool enable_custom_split_merge) const;
   std::shared_ptr<Cache> cache_;
   CompressedSecondaryCacheOptions cache_options_;
   mutable port::Mutex capacity_mutex_;
   std::shared_ptr<ConcurrentCacheReservationManager> cache_res_mgr_;
+  // Only set with persistent_file_path
+  std::unique_ptr<MmapCacheArena> arena_;
 };
 
 }  // namespace rocksdb
@@ -10,6 +10,7 @@
 #include <memory>
 #include <tuple>
 
+#include "cache/mmap_cache_arena.h"
 #include "cache/secondary_cache_adapter.h"
 #include "memory/jemalloc_nodump_allocator.h"
 #include "rocksdb/convenience.h"
@@ -863,6 +864,115 @@ TEST_P(CompressedSecondaryCacheTestWithCompressionParam, FailsTest) {
   FailsTest(sec_cache_is_compressed_);
 }
 
+#ifndef OS_WIN
+TEST_P(CompressedSecondaryCacheTestWithCompressionParam, PersistentFileTest) {
+  CompressedSecondaryCacheOptions opts;
+  opts.capacity = 4096;
+  opts.num_shard_bits = 0;
+  if (!sec_cache_is_compressed_ || !LZ4_Supported()) {
+    opts.compression_type =
+        rocksdb_rs::compression_type::CompressionType::kNoCompression;
+  }
+  opts.persistent_file_path = test::PerThreadDBPath("comp_sec_cache_file");
+  Env::Default()->DeleteFile(opts.persistent_file_path);
+
+  Random rnd(301);
+  std::string str1(rnd.RandomString(1000));
+  TestItem item1(str1.data(), str1.length());
+  std::string str2(rnd.RandomString(1000));
+  TestItem item2(str2.data(), str2.length());
+  {
+    std::shared_ptr<SecondaryCache> sec_cache =
+        NewCompressedSecondaryCache(opts);
+    // The first inserts only add dummy handles
+    for (int i = 0; i < 2; ++i) {
+      ASSERT_OK(sec_cache->Insert(key1, &item1, GetHelper()));
+      ASSERT_OK(sec_cache->Insert(key2, &item2, GetHelper()));
+    }
+  }
+
+  // A new cache on the same file, as after a restart, finds the blocks
+  std::shared_ptr<SecondaryCache> sec_cache = NewCompressedSecondaryCache(opts);
+  bool kept_in_sec_cache{false};
+  std::unique_ptr<SecondaryCacheResultHandle> handle1 =
+      sec_cache->Lookup(key1, GetHelper(), this, true, /*advise_erase=*/false,
+                        kept_in_sec_cache);
+  ASSERT_NE(handle1, nullptr);
+  std::unique_ptr<TestItem> val1 =
+      std::unique_ptr<TestItem>(static_cast<TestItem*>(handle1->Value()));
+  ASSERT_EQ(memcmp(val1->Buf(), item1.Buf(), item1.Size()), 0);
+  std::unique_ptr<SecondaryCacheResultHandle> handle2 =
+      sec_cache->Lookup(key2, GetHelper(), this, true, /*advise_erase=*/false,
+                        kept_in_sec_cache);
+  ASSERT_NE(handle2, nullptr);
+  std::unique_ptr<TestItem> val2 =
+      std::unique_ptr<TestItem>(static_cast<TestItem*>(handle2->Value()));
+  ASSERT_EQ(memcmp(val2->Buf(), item2.Buf(), item2.Size()), 0);
+  ASSERT_TRUE(sec_cache->SetCapacity(8192).IsNotSupported());
+
+  // Once the file is full, the oldest blocks are overwritten
+  std::string str3(rnd.RandomString(2500));
+  TestItem item3(str3.data(), str3.length());
+  ASSERT_OK(sec_cache->Insert(key3, &item3, GetHelper()));
+  ASSERT_OK(sec_cache->Insert(key3, &item3, GetHelper()));
+  std::unique_ptr<SecondaryCacheResultHandle> handle3 =
+      sec_cache->Lookup(key3, GetHelper(), this, true, /*advise_erase=*/false,
+                        kept_in_sec_cache);
+  ASSERT_NE(handle3, nullptr);
+  std::unique_ptr<TestItem> val3 =
+      std::unique_ptr<TestItem>(static_cast<TestItem*>(handle3->Value()));
+  ASSERT_EQ(memcmp(val3->Buf(), item3.Buf(), item3.Size()), 0);
+  handle1 = sec_cache->Lookup(key1, GetHelper(), this, true,
+                              /*advise_erase=*/false, kept_in_sec_cache);
+  ASSERT_EQ(handle1, nullptr);
+
+  // A file written with other settings is not reused
+  sec_cache.reset();
+  opts.compress_format_version = 1;
+  sec_cache = NewCompressedSecondaryCache(opts);
+  handle3 = sec_cache->Lookup(key3, GetHelper(), this, true,
+                              /*advise_erase=*/false, kept_in_sec_cache);
+  ASSERT_EQ(handle3, nullptr);
+
+  sec_cache.reset();
+  ASSERT_OK(Env::Default()->DeleteFile(opts.persistent_file_path));
+}
+
+TEST_P(CompressedSecondaryCacheTestWithCompressionParam,
+       PersistentFileInUseTest) {
+  CompressedSecondaryCacheOptions opts;
+  opts.capacity = 4096;
+  opts.num_shard_bits = 0;
+  opts.persistent_file_path = test::PerThreadDBPath("comp_sec_cache_in_use");
+  Env::Default()->DeleteFile(opts.persistent_file_path);
+
+  // The capacity of a cache can only be changed when its blocks are on the
+  // heap
+  std::shared_ptr<SecondaryCache> sec_cache1 =
+      NewCompressedSecondaryCache(opts);
+  ASSERT_TRUE(sec_cache1->SetCapacity(8192).IsNotSupported());
+
+  // The file is locked by the first cache, so the second one does not use it
+  std::shared_ptr<SecondaryCache> sec_cache2 =
+      NewCompressedSecondaryCache(opts);
+  ASSERT_OK(sec_cache2->SetCapacity(8192));
+
+  std::unique_ptr<MmapCacheArena> arena;
+  ASSERT_TRUE(MmapCacheArena::Open(opts.persistent_file_path, opts.capacity,
+                                   opts.compress_format_version, &arena)
+                  .IsIOError());
+  ASSERT_EQ(arena, nullptr);
+
+  // Released with the first cache
+  sec_cache1.reset();
+  sec_cache2 = NewCompressedSecondaryCache(opts);
+  ASSERT_TRUE(sec_cache2->SetCapacity(8192).IsNotSupported());
+
+  sec_cache2.reset();
+  ASSERT_OK(Env::Default()->DeleteFile(opts.persistent_file_path));
+}
+#endif  // OS_WIN
+
 TEST_P(CompressedSecondaryCacheTestWithCompressionParam,
        BasicIntegrationFailTest) {
   BasicIntegrationFailTest(sec_cache_is_compressed_);
@@ -5,6 +5,7 @@
 
 #include "cache/lru_cache.h"
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
@@ -949,6 +950,129 @@ TEST_F(ClockCacheTest, TableSizesTest) {
   }
 }
 
+// Tests the table growing with the number of entries, with
+// estimated_entry_charge == 0.
+TEST_F(ClockCacheTest, AutoTableGrowthTest) {
+  constexpr size_t kCapacity = 1024 * 1024;
+  constexpr size_t kCharge = 1000;
+  constexpr int kCount = 1000;
+  HyperClockCacheOptions opts(kCapacity, /*estimated_entry_charge*/ 0,
+                              /*num_shard_bits*/ 0,
+                              /*strict_capacity_limit*/ false,
+                              /*memory_allocator*/ nullptr,
+                              kDontChargeCacheMetadata);
+  opts.min_avg_entry_charge = 100;
+  auto cache = opts.MakeSharedCache();
+  EXPECT_EQ(std::string(cache->Name()), "AutoHyperClockCache");
+  size_t initial_table_size = cache->GetTableAddressCount();
+  // Starts well below the size needed for kCount entries
+  EXPECT_LT(initial_table_size, kCount);
+
+  auto make_key = [](int i) {
+    std::string key(16, '\0');
+    rocksdb_rs::coding_lean::EncodeFixed64(&key[0], i);
+    rocksdb_rs::coding_lean::EncodeFixed64(&key[8], i * 12345);
+    return key;
+  };
+  for (int i = 0; i < kCount; ++i) {
+    ASSERT_OK(cache->Insert(make_key(i), nullptr, &kNoopCacheItemHelper,
+                            kCharge));
+  }
+  // Everything fits in capacity, so nothing should have been evicted
+  EXPECT_EQ(cache->GetUsage(), kCount * kCharge);
+  EXPECT_EQ(cache->GetOccupancyCount(), kCount);
+  EXPECT_GE(cache->GetTableAddressCount(), kCount / kLoadFactor);
+  // Grown only while above the load factor, and each generation is one more
+  // than twice the previous table size, so no larger than needed for about
+  // twice as many entries
+  EXPECT_LE(cache->GetTableAddressCount(),
+            2 * kCount / kLoadFactor + initial_table_size);
+
+  // Entries remain findable in any generation
+  for (int i = 0; i < kCount; ++i) {
+    auto h = cache->Lookup(make_key(i));
+    ASSERT_NE(h, nullptr);
+    cache->Release(h);
+  }
+
+  // And erasable
+  for (int i = 0; i < kCount; ++i) {
+    cache->Erase(make_key(i));
+  }
+  EXPECT_EQ(cache->GetUsage(), 0U);
+  EXPECT_EQ(cache->GetOccupancyCount(), 0U);
+  for (int i = 0; i < kCount; ++i) {
+    ASSERT_EQ(cache->Lookup(make_key(i)), nullptr);
+  }
+  // Table does not shrink
+  EXPECT_GE(cache->GetTableAddressCount(), kCount / kLoadFactor);
+}
+
+TEST_F(ClockCacheTest, AutoTableConcurrentGrowthTest) {
+  constexpr size_t kCapacity = 8 * 1024 * 1024;
+  constexpr size_t kCharge = 100;
+  constexpr int kThreads = 8;
+  constexpr int kCountPerThread = 5000;
+  HyperClockCacheOptions opts(kCapacity, /*estimated_entry_charge*/ 0,
+                              /*num_shard_bits*/ 0,
+                              /*strict_capacity_limit*/ false,
+                              /*memory_allocator*/ nullptr,
+                              kDontChargeCacheMetadata);
+  opts.min_avg_entry_charge = kCharge;
+  auto cache = opts.MakeSharedCache();
+  EXPECT_EQ(std::string(cache->Name()), "AutoHyperClockCache");
+  size_t initial_table_size = cache->GetTableAddressCount();
+  EXPECT_LT(initial_table_size, kThreads * kCountPerThread);
+
+  auto make_key = [](int thread, int i) {
+    std::string key(16, '\0');
+    rocksdb_rs::coding_lean::EncodeFixed64(&key[0], thread);
+    rocksdb_rs::coding_lean::EncodeFixed64(&key[8], i);
+    return key;
+  };
+  // Each thread looks up the entries inserted so far by itself and by the
+  // previous thread while the table grows under them. Everything fits in
+  // capacity, so nothing is evicted and every lookup of an inserted entry
+  // hits.
+  std::atomic<int> inserted[kThreads] = {};
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t] {
+      const int other = (t + kThreads - 1) % kThreads;
+      for (int i = 0; i < kCountPerThread; ++i) {
+        ASSERT_OK(cache->Insert(make_key(t, i), nullptr, &kNoopCacheItemHelper,
+                                kCharge));
+        inserted[t].store(i + 1, std::memory_order_release);
+        for (int j : {i, i / 2, 0}) {
+          auto h = cache->Lookup(make_key(t, j));
+          ASSERT_NE(h, nullptr);
+          cache->Release(h);
+        }
+        const int other_count = inserted[other].load(std::memory_order_acquire);
+        if (other_count > 0) {
+          auto h = cache->Lookup(make_key(other, i % other_count));
+          ASSERT_NE(h, nullptr);
+          cache->Release(h);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(cache->GetOccupancyCount(), size_t{kThreads * kCountPerThread});
+  EXPECT_EQ(cache->GetUsage(), size_t{kThreads * kCountPerThread * kCharge});
+  EXPECT_GT(cache->GetTableAddressCount(), initial_table_size);
+  for (int t = 0; t < kThreads; ++t) {
+    for (int i = 0; i < kCountPerThread; ++i) {
+      auto h = cache->Lookup(make_key(t, i));
+      ASSERT_NE(h, nullptr);
+      cache->Release(h);
+    }
+  }
+}
+
 }  // namespace clock_cache
 
 class TestSecondaryCache : public SecondaryCache {
@@ -1438,7 +1562,7 @@ TEST_P(BasicSecondaryCacheTest, FullCapacityTest) {
                       GetHelper(rocksdb_rs::cache::CacheEntryRole::kDataBlock,
                                 /*secondary_compatible=*/false),
                       /*context*/ this, Cache::Priority::LOW);
-    if (strict_capacity_limit || GetParam() == kHyperClock) {
+    if (strict_capacity_limit || IsHyperClock()) {
       ASSERT_NE(handle2, nullptr);
       cache->Release(handle2);
       ASSERT_EQ(secondary_cache->num_inserts(), 1u);
@@ -1468,7 +1592,7 @@ TEST_P(BasicSecondaryCacheTest, FullCapacityTest) {
 // add support for demotion in Release, but that currently causes too much
 // unit test churn.
 TEST_P(DBSecondaryCacheTest, TestSecondaryCacheCorrectness1) {
-  if (GetParam() == kHyperClock) {
+  if (IsHyperClock()) {
     // See CORRECTION above
     ROCKSDB_GTEST_BYPASS("Test depends on LRUCache-specific behaviors");
     return;
@@ -1566,7 +1690,7 @@ TEST_P(DBSecondaryCacheTest, TestSecondaryCacheCorrectness1) {
 // insert and cache block_1 in the block cache (this is the different place
 // from TestSecondaryCacheCorrectness1)
 TEST_P(DBSecondaryCacheTest, TestSecondaryCacheCorrectness2) {
-  if (GetParam() == kHyperClock) {
+  if (IsHyperClock()) {
     ROCKSDB_GTEST_BYPASS("Test depends on LRUCache-specific behaviors");
     return;
   }
@@ -1754,7 +1878,7 @@ TEST_P(DBSecondaryCacheTest, SecondaryCacheIntensiveTesting) {
 // if we try to insert block_1 to the block cache, it will always fails. Only
 // block_2 will be successfully inserted into the block cache.
 TEST_P(DBSecondaryCacheTest, SecondaryCacheFailureTest) {
-  if (GetParam() == kHyperClock) {
+  if (IsHyperClock()) {
     ROCKSDB_GTEST_BYPASS("Test depends on LRUCache-specific behaviors");
     return;
   }
@@ -1864,7 +1988,7 @@ TEST_P(BasicSecondaryCacheTest, BasicWaitAllTest) {
                             str.length()));
   }
   // Force all entries to be evicted to the secondary cache
-  if (GetParam() == kHyperClock) {
+  if (IsHyperClock()) {
     // HCC doesn't respond immediately to SetCapacity
     for (int i = 9000; i < 9030; ++i) {
       ASSERT_OK(cache->Insert(ock.WithOffset(i).AsSlice(), nullptr,
@@ -1919,7 +2043,7 @@ TEST_P(BasicSecondaryCacheTest, BasicWaitAllTest) {
 // a sync point callback in TestSecondaryCache::Lookup. We then control the
 // lookup result by setting the ResultMap.
 TEST_P(DBSecondaryCacheTest, TestSecondaryCacheMultiGet) {
-  if (GetParam() == kHyperClock) {
+  if (IsHyperClock()) {
     ROCKSDB_GTEST_BYPASS("Test depends on LRUCache-specific behaviors");
     return;
   }
@@ -2428,7 +2552,7 @@ TEST_P(DBSecondaryCacheTest, TestSecondaryCacheOptionBasic) {
 // with new options, which set the lowest_used_cache_tier to
 // kNonVolatileBlockTier. So secondary cache will be used.
 TEST_P(DBSecondaryCacheTest, TestSecondaryCacheOptionChange) {
-  if (GetParam() == kHyperClock) {
+  if (IsHyperClock()) {
     ROCKSDB_GTEST_BYPASS("Test depends on LRUCache-specific behaviors");
     return;
   }
@@ -2523,7 +2647,7 @@ TEST_P(DBSecondaryCacheTest, TestSecondaryCacheOptionChange) {
 // Two DB test. We create 2 DBs sharing the same block cache and secondary
 // cache. We diable the secondary cache option for DB2.
 TEST_P(DBSecondaryCacheTest, TestSecondaryCacheOptionTwoDB) {
-  if (GetParam() == kHyperClock) {
+  if (IsHyperClock()) {
     ROCKSDB_GTEST_BYPASS("Test depends on LRUCache-specific behaviors");
     return;
   }
@@ -0,0 +1,263 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/mmap_cache_arena.h"
+
+#include <cassert>
+#include <cstring>
+
+#include "util/coding.h"
+#include "util/crc32c.h"
+#include "util/mutexlock.h"
+
+namespace rocksdb {
+
+namespace {
+
+// File layout:
+//   file header (kFileHeaderSize bytes)
+//     fixed64 magic
+//     fixed32 arena format version
+//     fixed32 format tag
+//     fixed64 file size
+//     fixed64 tail
+//     fixed64 head
+//     padding
+//   data area: a ring buffer of records
+//
+// Record layout (kRecordHeaderSize bytes of header, padded to 8 bytes):
+//   fixed32 masked crc32c of the rest of the record
+//   fixed32 value size
+//   fixed16 key size
+//   char record type
+//   char value type
+//   fixed32 unused
+//   key
+//   value
+//
+// A record never wraps around the end of the data area. When the next one
+// does not fit, a wrap record is written instead, if there is room for its
+// header, and the record is placed at the beginning.
+constexpr uint64_t kMagic = 0x6d6d617063616368ull;
+constexpr uint32_t kArenaFormatVersion = 1;
+constexpr size_t kFileHeaderSize = 64;
+constexpr size_t kMagicOffset = 0;
+constexpr size_t kVersionOffset = 8;
+constexpr size_t kFormatTagOffset = 12;
+constexpr size_t kSizeOffset = 16;
+constexpr size_t kTailOffset = 24;
+constexpr size_t kHeadOffset = 32;
+
+constexpr size_t kRecordHeaderSize = 16;
+constexpr size_t kRecordAlignment = 8;
+constexpr char kEntryRecord = 1;
+constexpr char kWrapRecord = 2;
+
+size_t RecordSize(size_t key_size, size_t value_size) {
+  size_t size = kRecordHeaderSize + key_size + value_size;
+  return (size + kRecordAlignment - 1) & ~(kRecordAlignment - 1);
+}
+
+uint32_t RecordChecksum(const char* record, size_t key_size,
+                        size_t value_size) {
+  return crc32c::Mask(crc32c::Value(
+      record + 4, kRecordHeaderSize - 4 + key_size + value_size));
+}
+
+}  // namespace
+
+rocksdb_rs::status::Status MmapCacheArena::Open(
+    const std::string& path, size_t size, uint32_t format_tag,
+    std::unique_ptr<MmapCacheArena>* arena) {
+#ifdef OS_WIN
+  (void)path;
+  (void)size;
+  (void)format_tag;
+  (void)arena;
+  return rocksdb_rs::status::Status_NotSupported(
+      "Memory mapped cache files are not supported on Windows");
+#else   // OS_WIN -> !OS_WIN
+  if (size < kFileHeaderSize + 2 * kRecordHeaderSize) {
+    return rocksdb_rs::status::Status_InvalidArgument(
+        "Cache file size too small");
+  }
+  MemMapping mapping = MemMapping::MapSharedFile(path, size);
+  if (mapping.Get() == nullptr) {
+    return rocksdb_rs::status::Status_IOError(
+        "Cannot map cache file, or it is in use by another cache", path);
+  }
+  arena->reset(new MmapCacheArena(std::move(mapping), format_tag));
+  return rocksdb_rs::status::Status_OK();
+#endif  // OS_WIN
+}
+
+MmapCacheArena::MmapCacheArena(MemMapping&& mapping, uint32_t format_tag)
+    : mapping_(std::move(mapping)),
+      capacity_((mapping_.Length() - kFileHeaderSize) &
+                ~(kRecordAlignment - 1)) {
+  char* header = static_cast<char*>(mapping_.Get());
+  uint64_t tail = rocksdb_rs::coding_lean::DecodeFixed64(header + kTailOffset);
+  uint64_t head = rocksdb_rs::coding_lean::DecodeFixed64(header + kHeadOffset);
+  if (rocksdb_rs::coding_lean::DecodeFixed64(header + kMagicOffset) ==
+          kMagic &&
+      rocksdb_rs::coding_lean::DecodeFixed32(header + kVersionOffset) ==
+          kArenaFormatVersion &&
+      rocksdb_rs::coding_lean::DecodeFixed32(header + kFormatTagOffset) ==
+          format_tag &&
+      rocksdb_rs::coding_lean::DecodeFixed64(header + kSizeOffset) ==
+          mapping_.Length() &&
+      tail <= head && head - tail <= capacity_) {
+    tail_ = tail;
+    head_ = head;
+    return;
+  }
+  // New or incompatible file. The magic goes last, so that the header is
+  // never valid with other fields left from the previous contents.
+  rocksdb_rs::coding_lean::EncodeFixed64(header + kMagicOffset, 0);
+  rocksdb_rs::coding_lean::EncodeFixed32(header + kVersionOffset,
+                                         kArenaFormatVersion);
+  rocksdb_rs::coding_lean::EncodeFixed32(header + kFormatTagOffset,
+                                         format_tag);
+  rocksdb_rs::coding_lean::EncodeFixed64(header + kSizeOffset,
+                                         mapping_.Length());
+  StoreBounds();
+  rocksdb_rs::coding_lean::EncodeFixed64(header + kMagicOffset, kMagic);
+}
+
+char* MmapCacheArena::DataAt(uint64_t pos) const {
+  return static_cast<char*>(mapping_.Get()) + kFileHeaderSize +
+         pos % capacity_;
+}
+
+void MmapCacheArena::StoreBounds() {
+  char* header = static_cast<char*>(mapping_.Get());
+  rocksdb_rs::coding_lean::EncodeFixed64(header + kTailOffset, tail_);
+  rocksdb_rs::coding_lean::EncodeFixed64(header + kHeadOffset, head_);
+}
+
+void MmapCacheArena::EvictOldest() {
+  assert(tail_ < head_);
+  size_t to_end = capacity_ - tail_ % capacity_;
+  const char* record = DataAt(tail_);
+  if (to_end < kRecordHeaderSize || record[10] == kWrapRecord) {
+    tail_ += to_end;
+  } else {
+    tail_ += RecordSize(rocksdb_rs::coding_lean::DecodeFixed16(record + 8),
+                        rocksdb_rs::coding_lean::DecodeFixed32(record + 4));
+  }
+}
+
+bool MmapCacheArena::Append(const Slice& key, const Slice& value,
+                            uint8_t value_type, uint64_t* pos) {
+  size_t record_size = RecordSize(key.size(), value.size());
+  if (record_size > capacity_ || key.size() > UINT16_MAX ||
+      value.size() > UINT32_MAX) {
+    return false;
+  }
+
+  MutexLock l(&mutex_);
+  uint64_t record_pos = head_;
+  size_t to_end = capacity_ - record_pos % capacity_;
+  size_t skip = to_end < record_size ? to_end : 0;
+  if (record_pos + skip + record_size - tail_ > capacity_) {
+    while (record_pos + skip + record_size - tail_ > capacity_) {
+      if (tail_ == head_) {
+        // Empty, so the record can start at the beginning of the data area
+        // without leaving a wrap record behind
+        record_pos += skip;
+        skip = 0;
+        tail_ = head_ = record_pos;
+        break;
+      }
+      EvictOldest();
+    }
+    // Persist the eviction before overwriting the evicted records
+    StoreBounds();
+  }
+  if (skip > 0) {
+    if (skip >= kRecordHeaderSize) {
+      char* wrap = DataAt(record_pos);
+      memset(wrap, 0, kRecordHeaderSize);
+      wrap[10] = kWrapRecord;
+    }
+    record_pos += skip;
+  }
+
+  char* record = DataAt(record_pos);
+  rocksdb_rs::coding_lean::EncodeFixed32(record + 4,
+                                         static_cast<uint32_t>(value.size()));
+  rocksdb_rs::coding_lean::EncodeFixed16(record + 8,
+                                         static_cast<uint16_t>(key.size()));
+  record[10] = kEntryRecord;
+  record[11] = static_cast<char>(value_type);
+  rocksdb_rs::coding_lean::EncodeFixed32(record + 12, 0);
+  memcpy(record + kRecordHeaderSize, key.data(), key.size());
+  memcpy(record + kRecordHeaderSize + key.size(), value.data(), value.size());
+  rocksdb_rs::coding_lean::EncodeFixed32(
+      record, RecordChecksum(record, key.size(), value.size()));
+
+  head_ = record_pos + record_size;
+  StoreBounds();
+  *pos = record_pos;
+  return true;
+}
+
+bool MmapCacheArena::Read(uint64_t pos, const Slice& key,
+                          MemoryAllocator* allocator,
+                          CacheAllocationPtr* value, size_t* value_size,
+                          uint8_t* value_type) const {
+  MutexLock l(&mutex_);
+  if (pos < tail_ || pos >= head_) {
+    // Overwritten since
+    return false;
+  }
+  const char* record = DataAt(pos);
+  size_t key_size = rocksdb_rs::coding_lean::DecodeFixed16(record + 8);
+  if (record[10] != kEntryRecord ||
+      Slice(record + kRecordHeaderSize, key_size) != key) {
+    return false;
+  }
+  *value_size = rocksdb_rs::coding_lean::DecodeFixed32(record + 4);
+  *value_type = static_cast<uint8_t>(record[11]);
+  *value = AllocateBlock(*value_size, allocator);
+  memcpy(value->get(), record + kRecordHeaderSize + key_size, *value_size);
+  return true;
+}
+
+void MmapCacheArena::Recover(
+    const std::function<void(const Slice& key, uint64_t pos,
+                             size_t value_size)>& fn) {
+  MutexLock l(&mutex_);
+  uint64_t pos = tail_;
+  while (pos < head_) {
+    size_t to_end = capacity_ - pos % capacity_;
+    const char* record = DataAt(pos);
+    if (to_end < kRecordHeaderSize || record[10] == kWrapRecord) {
+      if (to_end > head_ - pos) {
+        break;
+      }
+      pos += to_end;
+      continue;
+    }
+    size_t key_size = rocksdb_rs::coding_lean::DecodeFixed16(record + 8);
+    size_t value_size = rocksdb_rs::coding_lean::DecodeFixed32(record + 4);
+    size_t record_size = RecordSize(key_size, value_size);
+    if (record[10] != kEntryRecord || record_size > to_end ||
+        record_size > head_ - pos ||
+        rocksdb_rs::coding_lean::DecodeFixed32(record) !=
+            RecordChecksum(record, key_size, value_size)) {
+      break;
+    }
+    fn(Slice(record + kRecordHeaderSize, key_size), pos, value_size);
+    pos += record_size;
+  }
+  if (pos != head_) {
+    // Drop the damaged suffix
+    head_ = pos;
+    StoreBounds();
+  }
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,84 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "memory/memory_allocator_impl.h"
+#include "port/mmap.h"
+#include "port/port.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+
+namespace rocksdb {
+
+// MmapCacheArena stores cache entries in a memory mapped file, so that they
+// outlive the process that inserted them. Entries are appended to a ring
+// buffer, overwriting the oldest entries once it is full. The bounds of the
+// live entries are kept in the file, so that an arena opened later on the
+// same file, e.g. by a restarted process, finds the entries again.
+//
+// The arena does not index its entries: each one is addressed by the
+// position Append() returned for it, and Recover() enumerates them. It is
+// thread-safe. The file is locked while an arena has it open, so that two
+// arenas, e.g. in the processes before and after a restart, never write to
+// it at the same time. Not supported on Windows.
+class MmapCacheArena {
+ public:
+  // Maps `size` bytes of file `path`, creating it if needed. The entries in
+  // the file are kept only if it was written by an arena with the same `size`
+  // and `format_tag`. Fails if the file cannot be mapped, including when
+  // another arena has it open.
+  static rocksdb_rs::status::Status Open(
+      const std::string& path, size_t size, uint32_t format_tag,
+      std::unique_ptr<MmapCacheArena>* arena);
+
+  // No copying allowed
+  MmapCacheArena(const MmapCacheArena&) = delete;
+  MmapCacheArena& operator=(const MmapCacheArena&) = delete;
+
+  // Appends an entry with an arbitrary `value_type` tag, evicting the oldest
+  // entries as needed, and sets *pos to its position. Returns false, without
+  // appending, if the entry cannot fit in the arena.
+  bool Append(const Slice& key, const Slice& value, uint8_t value_type,
+              uint64_t* pos);
+
+  // If the entry at `pos` is still live, and has key `key`, copies its value
+  // into a new allocation and returns true.
+  bool Read(uint64_t pos, const Slice& key, MemoryAllocator* allocator,
+            CacheAllocationPtr* value, size_t* value_size,
+            uint8_t* value_type) const;
+
+  // Calls `fn` on every live entry, oldest first. An entry failing its
+  // checksum, e.g. because the process appending it crashed, is dropped
+  // together with all the entries after it. Must not run concurrently with
+  // Append().
+  void Recover(const std::function<void(const Slice& key, uint64_t pos,
+                                        size_t value_size)>& fn);
+
+  // Number of bytes available to entries
+  size_t GetCapacity() const { return capacity_; }
+
+ private:
+  MmapCacheArena(MemMapping&& mapping, uint32_t format_tag);
+
+  char* DataAt(uint64_t pos) const;
+  void EvictOldest();
+  void StoreBounds();
+
+  MemMapping mapping_;
+  size_t capacity_;
+  mutable port::Mutex mutex_;
+  // Positions grow monotonically and map to offset `pos % capacity_` in the
+  // data area. Live entries are in [tail_, head_).
+  uint64_t head_ = 0;
+  uint64_t tail_ = 0;
+};
+
+}  // namespace rocksdb
@@ -72,7 +72,9 @@ rocksdb_rs::status::Status BlobFileReader::Create(
 
   blob_file_reader->reset(
       new BlobFileReader(std::move(file_reader), file_size, compression_type,
-                         immutable_options.clock, statistics));
+                         immutable_options.clock, statistics,
+                         immutable_options.fs.get(),
+                         immutable_options.blob_multiget_coalesce_gap));
 
   return rocksdb_rs::status::Status_OK();
 }
@@ -292,12 +294,15 @@ rocksdb_rs::status::Status BlobFileReader::ReadFromFile(
 BlobFileReader::BlobFileReader(
     std::unique_ptr<RandomAccessFileReader>&& file_reader, uint64_t file_size,
     rocksdb_rs::compression_type::CompressionType compression_type,
-    SystemClock* clock, Statistics* statistics)
+    SystemClock* clock, Statistics* statistics, FileSystem* fs,
+    uint64_t multiget_coalesce_gap)
     : file_reader_(std::move(file_reader)),
       file_size_(file_size),
       compression_type_(compression_type),
       clock_(clock),
-      statistics_(statistics) {
+      statistics_(statistics),
+      fs_(fs),
+      multiget_coalesce_gap_(multiget_coalesce_gap) {
   assert(file_reader_);
 }
 
@@ -363,6 +368,7 @@ rocksdb_rs::status::Status BlobFileReader::GetBlob(
     TEST_SYNC_POINT("BlobFileReader::GetBlob:ReadFromFile");
     PERF_COUNTER_ADD(blob_read_count, 1);
     PERF_COUNTER_ADD(blob_read_byte, record_size);
+    PERF_COUNTER_ADD(blob_read_useful_byte, record_size);
     PERF_TIMER_GUARD(blob_read_time);
     const rocksdb_rs::status::Status s = ReadFromFile(
         file_reader_.get(), read_options, record_offset,
@@ -416,9 +422,14 @@ void BlobFileReader::MultiGetBlob(
   }
 #endif  // !NDEBUG
 
+  // Blob records are read into `read_reqs`; blobs_to_reads[i] is the index of
+  // the read covering blob i, or -1 if the request is invalid. Reads of
+  // blobs within multiget_coalesce_gap_ bytes of each other are merged.
   std::vector<FSReadRequest> read_reqs;
+  autovector<int> blobs_to_reads;
   autovector<uint64_t> adjustments;
   uint64_t total_len = 0;
+  uint64_t useful_len = 0;
   read_reqs.reserve(num_blobs);
   for (size_t i = 0; i < num_blobs; ++i) {
     BlobReadRequest* const req = blob_reqs[i].first;
@@ -426,6 +437,9 @@ void BlobFileReader::MultiGetBlob(
     assert(req->user_key);
     assert(req->status);
 
+    blobs_to_reads.push_back(-1);
+    adjustments.push_back(0);
+
     const size_t key_size = req->user_key->size();
     const uint64_t offset = req->offset;
     const uint64_t value_size = req->len;
@@ -446,12 +460,33 @@ void BlobFileReader::MultiGetBlob(
             ? BlobLogRecord::CalculateAdjustmentForRecordHeader(key_size)
             : 0;
     assert(req->offset >= adjustment);
-    adjustments.push_back(adjustment);
+    adjustments[i] = adjustment;
+
+    const uint64_t record_offset = req->offset - adjustment;
+    const uint64_t record_end = req->offset + req->len;
+    useful_len += record_end - record_offset;
+
+    if (multiget_coalesce_gap_ > 0 && !read_reqs.empty()) {
+      FSReadRequest& last_read = read_reqs.back();
+      const uint64_t last_end = last_read.offset + last_read.len;
+      // Blob offsets are sorted, but with checksum verification the record
+      // header can start before the end of the previous read.
+      if (record_offset >= last_read.offset &&
+          record_offset <= last_end + multiget_coalesce_gap_) {
+        if (record_end > last_end) {
+          total_len += record_end - last_end;
+          last_read.len = static_cast<size_t>(record_end - last_read.offset);
+        }
+        blobs_to_reads[i] = static_cast<int>(read_reqs.size() - 1);
+        continue;
+      }
+    }
 
     FSReadRequest read_req;
-    read_req.offset = req->offset - adjustment;
-    read_req.len = req->len + adjustment;
+    read_req.offset = record_offset;
+    read_req.len = static_cast<size_t>(record_end - record_offset);
     total_len += read_req.len;
+    blobs_to_reads[i] = static_cast<int>(read_reqs.size());
     read_reqs.emplace_back(std::move(read_req));
   }
 
@@ -477,11 +512,22 @@ void BlobFileReader::MultiGetBlob(
   TEST_SYNC_POINT("BlobFileReader::MultiGetBlob:ReadFromFile");
   PERF_COUNTER_ADD(blob_read_count, num_blobs);
   PERF_COUNTER_ADD(blob_read_byte, total_len);
-  s = file_reader_
-          ->MultiRead(IOOptions(), read_reqs.data(), read_reqs.size(),
-                      direct_io ? &aligned_buf : nullptr,
-                      read_options.rate_limiter_priority)
-          .status();
+  PERF_COUNTER_ADD(blob_read_useful_byte, useful_len);
+  bool read_async = false;
+  if (read_options.async_io && !direct_io && fs_ != nullptr) {
+    // Falls back to MultiRead() if the file system has no ReadAsync() support
+    rocksdb_rs::io_status::IOStatus io_s =
+        MultiReadAsync(read_reqs.data(), read_reqs.size());
+    read_async = !io_s.IsNotSupported();
+    s = io_s.status();
+  }
+  if (!read_async) {
+    s = file_reader_
+            ->MultiRead(IOOptions(), read_reqs.data(), read_reqs.size(),
+                        direct_io ? &aligned_buf : nullptr,
+                        read_options.rate_limiter_priority)
+            .status();
+  }
   if (!s.ok()) {
     for (auto& blob_req : blob_reqs) {
       BlobReadRequest* const req = blob_req.first;
@@ -499,7 +545,7 @@ void BlobFileReader::MultiGetBlob(
   assert(s.ok());
 
   uint64_t total_bytes = 0;
-  for (size_t i = 0, j = 0; i < num_blobs; ++i) {
+  for (size_t i = 0; i < num_blobs; ++i) {
     BlobReadRequest* const req = blob_reqs[i].first;
     assert(req);
     assert(req->user_key);
@@ -509,10 +555,10 @@ void BlobFileReader::MultiGetBlob(
       continue;
     }
 
-    assert(j < read_reqs.size());
-    auto& read_req = read_reqs[j++];
-    const auto& record_slice = read_req.result;
-    if (read_req.status.ok() && record_slice.size() != read_req.len) {
+    assert(blobs_to_reads[i] >= 0);
+    assert(static_cast<size_t>(blobs_to_reads[i]) < read_reqs.size());
+    auto& read_req = read_reqs[blobs_to_reads[i]];
+    if (read_req.status.ok() && read_req.result.size() != read_req.len) {
       read_req.status = rocksdb_rs::io_status::IOStatus_Corruption(
           "Failed to read data from blob file");
     }
@@ -522,6 +568,11 @@ void BlobFileReader::MultiGetBlob(
       continue;
     }
 
+    const uint64_t record_offset = req->offset - adjustments[i];
+    const Slice record_slice(
+        read_req.result.data() + (record_offset - read_req.offset),
+        static_cast<size_t>(req->len + adjustments[i]));
+
     // Verify checksums if enabled
     if (read_options.verify_checksums) {
       *req->status = VerifyBlob(record_slice, *req->user_key, req->len);
@@ -545,6 +596,55 @@ void BlobFileReader::MultiGetBlob(
   }
 }
 
+rocksdb_rs::io_status::IOStatus BlobFileReader::MultiReadAsync(
+    FSReadRequest* read_reqs, size_t num_reqs) const {
+  assert(fs_);
+
+  auto callback = [](const FSReadRequest& req, void* cb_arg) {
+    FSReadRequest* const read_req = static_cast<FSReadRequest*>(cb_arg);
+    read_req->result = req.result;
+    read_req->status = req.status.Clone();
+  };
+
+  std::vector<void*> io_handles;
+  std::vector<IOHandleDeleter> del_fns;
+  for (size_t i = 0; i < num_reqs; ++i) {
+    void* io_handle = nullptr;
+    IOHandleDeleter del_fn = nullptr;
+    rocksdb_rs::io_status::IOStatus s =
+        file_reader_->ReadAsync(read_reqs[i], IOOptions(), callback,
+                                &read_reqs[i], &io_handle, &del_fn,
+                                /*aligned_buf=*/nullptr);
+    if (!s.ok()) {
+      if (i == 0 && s.IsNotSupported()) {
+        return s;
+      }
+      // Reported through the blobs of this read
+      read_reqs[i].status = std::move(s);
+      continue;
+    }
+    if (io_handle != nullptr) {
+      io_handles.push_back(io_handle);
+      del_fns.push_back(del_fn);
+    }
+  }
+
+  rocksdb_rs::io_status::IOStatus s = rocksdb_rs::io_status::IOStatus_new();
+  if (!io_handles.empty()) {
+    StopWatch sw(clock_, statistics_, POLL_WAIT_MICROS);
+    s = fs_->Poll(io_handles, io_handles.size());
+    if (!s.ok()) {
+      // Do not release the buffers while reads may still be in flight
+      rocksdb_rs::status::Status abort_s = fs_->AbortIO(io_handles).status();
+      assert(abort_s.ok());
+    }
+    for (size_t i = 0; i < io_handles.size(); ++i) {
+      del_fns[i](io_handles[i]);
+    }
+  }
+  return s;
+}
+
 rocksdb_rs::status::Status BlobFileReader::VerifyBlob(const Slice& record_slice,
                                                       const Slice& user_key,
                                                       uint64_t value_size) {
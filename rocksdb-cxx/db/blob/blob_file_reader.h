@@ -27,6 +27,7 @@ class Slice;
 class FilePrefetchBuffer;
 class BlobContents;
 class Statistics;
+class FileSystem;
 
 class BlobFileReader {
  public:
@@ -49,7 +50,10 @@ class BlobFileReader {
       FilePrefetchBuffer* prefetch_buffer, MemoryAllocator* allocator,
       std::unique_ptr<BlobContents>* result, uint64_t* bytes_read) const;
 
-  // offsets must be sorted in ascending order by caller.
+  // offsets must be sorted in ascending order by caller. Blobs close enough
+  // to each other (see blob_multiget_coalesce_gap) are fetched with a single
+  // read. With ReadOptions::async_io, the reads are submitted through
+  // FileSystem::ReadAsync() and waited on together.
   void MultiGetBlob(
       const ReadOptions& read_options, MemoryAllocator* allocator,
       autovector<std::pair<BlobReadRequest*, std::unique_ptr<BlobContents>>>&
@@ -66,7 +70,8 @@ class BlobFileReader {
   BlobFileReader(std::unique_ptr<RandomAccessFileReader>&& file_reader,
                  uint64_t file_size,
                  rocksdb_rs::compression_type::CompressionType compression_type,
-                 SystemClock* clock, Statistics* statistics);
+                 SystemClock* clock, Statistics* statistics, FileSystem* fs,
+                 uint64_t multiget_coalesce_gap);
 
   static rocksdb_rs::status::Status OpenFile(
       const ImmutableOptions& immutable_options, const FileOptions& file_opts,
@@ -93,6 +98,12 @@ class BlobFileReader {
       Statistics* statistics, Slice* slice, Buffer* buf,
       AlignedBuf* aligned_buf, Env::IOPriority rate_limiter_priority);
 
+  // Reads `read_reqs` with ReadAsync() and waits for all of them to
+  // complete. Returns NotSupported, without reading anything, if the file
+  // system does not support ReadAsync().
+  rocksdb_rs::io_status::IOStatus MultiReadAsync(FSReadRequest* read_reqs,
+                                                 size_t num_reqs) const;
+
   static rocksdb_rs::status::Status VerifyBlob(const Slice& record_slice,
                                                const Slice& user_key,
                                                uint64_t value_size);
@@ -108,6 +119,8 @@ class BlobFileReader {
   rocksdb_rs::compression_type::CompressionType compression_type_;
   SystemClock* clock_;
   Statistics* statistics_;
+  FileSystem* fs_;
+  uint64_t multiget_coalesce_gap_;
 };
 
 }  // namespace rocksdb
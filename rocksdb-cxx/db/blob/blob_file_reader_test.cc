@@ -19,6 +19,8 @@
 #include "rocksdb/env.h"
 #include "rocksdb/file_system.h"
 #include "rocksdb/options.h"
+#include "rocksdb/perf_context.h"
+#include "rocksdb/perf_level.h"
 #include "test_util/sync_point.h"
 #include "test_util/testharness.h"
 #include "util/compression.h"
@@ -459,6 +461,138 @@ TEST_F(BlobFileReaderTest, CreateReaderAndGetBlob) {
   }
 }
 
+TEST_F(BlobFileReaderTest, MultiGetBlobCoalescing) {
+  Options options;
+  options.env = mock_env_.get();
+  options.cf_paths.emplace_back(
+      test::PerThreadDBPath(mock_env_.get(),
+                            "BlobFileReaderTest_MultiGetBlobCoalescing"),
+      0);
+  options.enable_blob_files = true;
+  // Large enough to cover the record header and key between adjacent blobs
+  options.blob_multiget_coalesce_gap = 64;
+
+  ImmutableOptions immutable_options(options);
+
+  constexpr uint32_t column_family_id = 1;
+  constexpr bool has_ttl = false;
+  constexpr ExpirationRange expiration_range;
+  constexpr uint64_t blob_file_number = 1;
+  constexpr size_t num_blobs = 4;
+  const std::vector<std::string> key_strs = {"key1", "key2", "key3", "key4"};
+  const std::vector<std::string> blob_strs = {"blob1", "blob2",
+                                              std::string(1024, 'x'), "blob4"};
+
+  const std::vector<Slice> keys = {key_strs[0], key_strs[1], key_strs[2],
+                                   key_strs[3]};
+  const std::vector<Slice> blobs = {blob_strs[0], blob_strs[1], blob_strs[2],
+                                    blob_strs[3]};
+
+  std::vector<uint64_t> blob_offsets(keys.size());
+  std::vector<uint64_t> blob_sizes(keys.size());
+
+  WriteBlobFile(immutable_options, column_family_id, has_ttl, expiration_range,
+                expiration_range, blob_file_number, keys, blobs,
+                rocksdb_rs::compression_type::CompressionType::kNoCompression,
+                blob_offsets, blob_sizes);
+
+  constexpr HistogramImpl* blob_file_read_hist = nullptr;
+
+  std::unique_ptr<BlobFileReader> reader;
+
+  ReadOptions read_options;
+  ASSERT_OK(BlobFileReader::Create(
+      immutable_options, read_options, FileOptions(), column_family_id,
+      blob_file_read_hist, blob_file_number, nullptr /*IOTracer*/, &reader));
+
+  constexpr MemoryAllocator* allocator = nullptr;
+
+  SetPerfLevel(PerfLevel::kEnableCount);
+
+  for (bool async_io : {false, true}) {
+    read_options.async_io = async_io;
+
+    // Skip the large blob, so the first two and the last blob are read with
+    // two separate requests.
+    const std::array<size_t, 3> indexes = {0, 1, 3};
+
+    rust::Vec<rocksdb_rs::status::Status> statuses_buf =
+        rocksdb_rs::status::Status_new().create_vec(indexes.size());
+    std::array<BlobReadRequest, indexes.size()> requests_buf;
+    autovector<std::pair<BlobReadRequest*, std::unique_ptr<BlobContents>>>
+        blob_reqs;
+
+    uint64_t useful_bytes = 0;
+    for (size_t i = 0; i < indexes.size(); ++i) {
+      const size_t idx = indexes[i];
+      requests_buf[i] = BlobReadRequest(
+          keys[idx], blob_offsets[idx], blob_sizes[idx],
+          rocksdb_rs::compression_type::CompressionType::kNoCompression,
+          nullptr, &statuses_buf[i]);
+      blob_reqs.emplace_back(&requests_buf[i], std::unique_ptr<BlobContents>());
+      useful_bytes += BlobLogRecord::CalculateAdjustmentForRecordHeader(
+                          keys[idx].size()) +
+                      blob_sizes[idx];
+    }
+
+    get_perf_context()->Reset();
+
+    uint64_t bytes_read = 0;
+    reader->MultiGetBlob(read_options, allocator, blob_reqs, &bytes_read);
+
+    for (size_t i = 0; i < indexes.size(); ++i) {
+      ASSERT_OK(statuses_buf[i]);
+      ASSERT_NE(blob_reqs[i].second, nullptr);
+      ASSERT_EQ(blob_reqs[i].second->data(), blobs[indexes[i]]);
+    }
+    ASSERT_EQ(bytes_read, useful_bytes);
+
+    // The first two records are adjacent and read together, the record of
+    // the large blob is not read.
+    ASSERT_EQ(get_perf_context()->blob_read_count, indexes.size());
+    ASSERT_EQ(get_perf_context()->blob_read_useful_byte, useful_bytes);
+    ASSERT_EQ(get_perf_context()->blob_read_byte, useful_bytes);
+  }
+
+  // Without checksum verification the record headers of the adjacent blobs
+  // fall in the gap and are read too.
+  read_options.async_io = false;
+  read_options.verify_checksums = false;
+  {
+    rust::Vec<rocksdb_rs::status::Status> statuses_buf =
+        rocksdb_rs::status::Status_new().create_vec(2);
+    std::array<BlobReadRequest, 2> requests_buf;
+    autovector<std::pair<BlobReadRequest*, std::unique_ptr<BlobContents>>>
+        blob_reqs;
+
+    for (size_t i = 0; i < 2; ++i) {
+      requests_buf[i] = BlobReadRequest(
+          keys[i], blob_offsets[i], blob_sizes[i],
+          rocksdb_rs::compression_type::CompressionType::kNoCompression,
+          nullptr, &statuses_buf[i]);
+      blob_reqs.emplace_back(&requests_buf[i], std::unique_ptr<BlobContents>());
+    }
+
+    get_perf_context()->Reset();
+
+    uint64_t bytes_read = 0;
+    reader->MultiGetBlob(read_options, allocator, blob_reqs, &bytes_read);
+
+    for (size_t i = 0; i < 2; ++i) {
+      ASSERT_OK(statuses_buf[i]);
+      ASSERT_NE(blob_reqs[i].second, nullptr);
+      ASSERT_EQ(blob_reqs[i].second->data(), blobs[i]);
+    }
+    ASSERT_EQ(bytes_read, blob_sizes[0] + blob_sizes[1]);
+    ASSERT_EQ(get_perf_context()->blob_read_useful_byte,
+              blob_sizes[0] + blob_sizes[1]);
+    ASSERT_EQ(get_perf_context()->blob_read_byte,
+              blob_offsets[1] + blob_sizes[1] - blob_offsets[0]);
+  }
+
+  SetPerfLevel(PerfLevel::kDisable);
+}
+
 TEST_F(BlobFileReaderTest, Malformed) {
   // Write a blob file consisting of nothing but a header, and make sure we
   // detect the error when we open it for reading
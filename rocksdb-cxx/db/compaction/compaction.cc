@@ -763,6 +763,15 @@ std::unique_ptr<SstPartitioner> Compaction::CreateSstPartitioner() const {
   context.output_level = output_level_;
   context.smallest_user_key = smallest_user_key_;
   context.largest_user_key = largest_user_key_;
+  context.comparator = immutable_options_.user_comparator;
+  for (const auto& level_inputs : inputs_) {
+    for (const FileMetaData* file : level_inputs.files) {
+      context.input_files.push_back(
+          {file->smallest.user_key(), file->largest.user_key(),
+           file->fd.GetFileSize(),
+           file->stats.num_reads_sampled.load(std::memory_order_relaxed)});
+    }
+  }
   return immutable_options_.sst_partitioner_factory->CreatePartitioner(context);
 }
 
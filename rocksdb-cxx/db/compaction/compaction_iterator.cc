@@ -21,6 +21,31 @@
 #include "test_util/sync_point.h"
 
 namespace rocksdb {
+void SequenceIterWrapper::StartReadahead(size_t n) {
+  assert(n > 0);
+  assert(!readahead());
+  readahead_ = n;
+  FillBuffer();
+}
+
+void SequenceIterWrapper::FillBuffer() {
+  buffer_size_ = 0;
+  buffer_pos_ = 0;
+  ++num_fills_;
+  while (buffer_size_ < readahead_ && inner_iter_->Valid()) {
+    if (buffer_size_ == buffer_.size()) {
+      buffer_.emplace_back();
+    }
+    BufferedEntry& entry = buffer_[buffer_size_++];
+    const Slice key = inner_iter_->key();
+    const Slice value = inner_iter_->value();
+    entry.key.assign(key.data(), key.size());
+    entry.value.assign(value.data(), value.size());
+    entry.is_range_del_sentinel = inner_iter_->IsDeleteRangeSentinelKey();
+    inner_iter_->Next();
+  }
+}
+
 CompactionIterator::CompactionIterator(
     InternalIterator* input, const Comparator* cmp, MergeHelper* merge_helper,
     SequenceNumber last_sequence, std::vector<SequenceNumber>* snapshots,
@@ -147,6 +172,9 @@ void CompactionIterator::ResetRecordCounts() {
 }
 
 void CompactionIterator::SeekToFirst() {
+  if (compaction_filter_ && compaction_filter_->SupportsFilterBatch()) {
+    input_.StartReadahead(kFilterBatchSize);
+  }
   NextFromInput();
   PrepareOutput();
 }
@@ -258,6 +286,10 @@ bool CompactionIterator::InvokeFilterIfNeeded(bool* need_skip,
   {
     StopWatchNano timer(clock_, report_detailed_time_);
 
+    if (ikey_.type == kTypeValue && input_.readahead()) {
+      decision = GetBatchFilterDecision();
+    }
+
     if (ikey_.type == kTypeBlobIndex) {
       decision = compaction_filter_->FilterBlobByKey(
           level_, filter_key, &compaction_filter_value_,
@@ -457,6 +489,66 @@ bool CompactionIterator::InvokeFilterIfNeeded(bool* need_skip,
   return true;
 }
 
+CompactionFilter::Decision CompactionIterator::GetBatchFilterDecision() {
+  assert(input_.Valid());
+  const size_t pos = input_.buffer_pos();
+  if (filter_batch_fill_ != input_.num_fills()) {
+    filter_batch_fill_ = input_.num_fills();
+    filter_batch_positions_.clear();
+    filter_batch_keys_.clear();
+    filter_batch_values_.clear();
+    // Only the first version of each user key gets filtered. Comparing the
+    // user keys with their timestamps may include a few more.
+    Slice prev_user_key;
+    for (size_t i = pos; i < input_.buffer_size(); ++i) {
+      const SequenceIterWrapper::BufferedEntry& entry =
+          input_.buffered_entry(i);
+      ParsedInternalKey ikey;
+      if (entry.is_range_del_sentinel ||
+          !ParseInternalKey(entry.key, &ikey, allow_data_in_errors_).ok()) {
+        continue;
+      }
+      if (ikey.type == kTypeValue &&
+          (i == pos || !cmp_->Equal(ikey.user_key, prev_user_key))) {
+        filter_batch_positions_.push_back(i);
+        filter_batch_keys_.push_back(ikey.user_key);
+        filter_batch_values_.emplace_back(entry.value);
+      }
+      prev_user_key = ikey.user_key;
+    }
+    const size_t n = filter_batch_positions_.size();
+    filter_batch_decisions_.assign(n,
+                                   CompactionFilter::Decision::kUndetermined);
+    if (filter_batch_new_values_.size() < n) {
+      filter_batch_new_values_.resize(n);
+    }
+    for (size_t i = 0; i < n; ++i) {
+      filter_batch_new_values_[i].clear();
+    }
+    compaction_filter_->FilterBatch(
+        level_, n, filter_batch_keys_.data(), filter_batch_values_.data(),
+        filter_batch_decisions_.data(), filter_batch_new_values_.data());
+  }
+
+  auto it = std::lower_bound(filter_batch_positions_.begin(),
+                             filter_batch_positions_.end(), pos);
+  if (it == filter_batch_positions_.end() || *it != pos) {
+    return CompactionFilter::Decision::kUndetermined;
+  }
+  const size_t i = it - filter_batch_positions_.begin();
+  switch (filter_batch_decisions_[i]) {
+    case CompactionFilter::Decision::kKeep:
+    case CompactionFilter::Decision::kRemove:
+    case CompactionFilter::Decision::kPurge:
+      return filter_batch_decisions_[i];
+    case CompactionFilter::Decision::kChangeValue:
+      compaction_filter_value_.swap(filter_batch_new_values_[i]);
+      return CompactionFilter::Decision::kChangeValue;
+    default:
+      return CompactionFilter::Decision::kUndetermined;
+  }
+}
+
 void CompactionIterator::NextFromInput() {
   at_next_ = false;
   validity_info_.Invalidate();
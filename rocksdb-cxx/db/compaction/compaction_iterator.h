@@ -28,35 +28,63 @@ class PrefetchBufferCollection;
 
 // A wrapper of internal iterator whose purpose is to count how
 // many entries there are in the iterator.
+//
+// It can also read the entries ahead of the current one into a buffer, so
+// that they can be inspected before the iteration reaches them, e.g. to
+// filter them in batches. The buffered entries are copies, valid until the
+// wrapper moves past the last one.
 class SequenceIterWrapper : public InternalIterator {
  public:
+  // An entry read ahead
+  struct BufferedEntry {
+    std::string key;
+    std::string value;
+    bool is_range_del_sentinel = false;
+  };
+
   SequenceIterWrapper(InternalIterator* iter, const Comparator* cmp,
                       bool need_count_entries)
       : icmp_(cmp),
         inner_iter_(iter),
         need_count_entries_(need_count_entries) {}
-  bool Valid() const override { return inner_iter_->Valid(); }
+  bool Valid() const override {
+    return readahead_ ? buffer_pos_ < buffer_size_ : inner_iter_->Valid();
+  }
   rocksdb_rs::status::Status status() const override {
+    if (readahead_ && buffer_pos_ < buffer_size_) {
+      return rocksdb_rs::status::Status_OK();
+    }
     return inner_iter_->status();
   }
   void Next() override {
     num_itered_++;
-    inner_iter_->Next();
+    if (!readahead_) {
+      inner_iter_->Next();
+    } else if (++buffer_pos_ == buffer_size_) {
+      FillBuffer();
+    }
   }
   void Seek(const Slice& target) override {
     if (!need_count_entries_) {
       inner_iter_->Seek(target);
+      if (readahead_) {
+        FillBuffer();
+      }
     } else {
       // For flush cases, we need to count total number of entries, so we
       // do Next() rather than Seek().
-      while (inner_iter_->Valid() &&
-             icmp_.Compare(inner_iter_->key(), target) < 0) {
+      while (Valid() && icmp_.Compare(key(), target) < 0) {
         Next();
       }
     }
   }
-  Slice key() const override { return inner_iter_->key(); }
-  Slice value() const override { return inner_iter_->value(); }
+  Slice key() const override {
+    return readahead_ ? Slice(buffer_[buffer_pos_].key) : inner_iter_->key();
+  }
+  Slice value() const override {
+    return readahead_ ? Slice(buffer_[buffer_pos_].value)
+                      : inner_iter_->value();
+  }
 
   // Unused InternalIterator methods
   void SeekToFirst() override { assert(false); }
@@ -67,14 +95,38 @@ class SequenceIterWrapper : public InternalIterator {
   uint64_t num_itered() const { return num_itered_; }
   bool IsDeleteRangeSentinelKey() const override {
     assert(Valid());
-    return inner_iter_->IsDeleteRangeSentinelKey();
+    return readahead_ ? buffer_[buffer_pos_].is_range_del_sentinel
+                      : inner_iter_->IsDeleteRangeSentinelKey();
+  }
+
+  // From now on, buffers up to `n` entries at a time, starting with the
+  // current one. REQUIRES: n > 0.
+  void StartReadahead(size_t n);
+  bool readahead() const { return readahead_ > 0; }
+  // The entries buffered, the current one being at buffer_pos(). They are
+  // replaced when the buffer is refilled, which increments num_fills().
+  const BufferedEntry& buffered_entry(size_t i) const {
+    assert(i < buffer_size_);
+    return buffer_[i];
   }
+  size_t buffer_size() const { return buffer_size_; }
+  size_t buffer_pos() const { return buffer_pos_; }
+  uint64_t num_fills() const { return num_fills_; }
 
  private:
+  void FillBuffer();
+
   InternalKeyComparator icmp_;
   InternalIterator* inner_iter_;  // not owned
   uint64_t num_itered_ = 0;
   bool need_count_entries_;
+  // Maximum number of entries buffered, 0 if not reading ahead
+  size_t readahead_ = 0;
+  // The strings of the entries past buffer_size_ are kept for their capacity
+  std::vector<BufferedEntry> buffer_;
+  size_t buffer_size_ = 0;
+  size_t buffer_pos_ = 0;
+  uint64_t num_fills_ = 0;
 };
 
 class CompactionIterator {
@@ -301,6 +353,15 @@ class CompactionIterator {
   // Return true on success, false on failures (e.g.: kIOError).
   bool InvokeFilterIfNeeded(bool* need_skip, Slice* skip_until);
 
+  // Returns the decision of CompactionFilter::FilterBatch() for the current
+  // key, which must be a plain value, after filtering the entries buffered by
+  // input_ if not done yet. Returns kUndetermined if there is none. The new
+  // value of a kChangeValue decision is moved to compaction_filter_value_.
+  CompactionFilter::Decision GetBatchFilterDecision();
+
+  // Number of entries input_ reads ahead for CompactionFilter::FilterBatch()
+  static constexpr size_t kFilterBatchSize = 64;
+
   // Given a sequence number, return the sequence number of the
   // earliest snapshot that this sequence number is visible in.
   // The snapshots themselves are arranged in ascending order of
@@ -460,6 +521,16 @@ class CompactionIterator {
   PinnableSlice blob_value_;
   std::string compaction_filter_value_;
   InternalKey compaction_filter_skip_until_;
+  // The plain values buffered by input_ that were passed to
+  // CompactionFilter::FilterBatch(), by position in the buffer, and the
+  // decisions made for them. Only valid for fill filter_batch_fill_ of the
+  // buffer.
+  uint64_t filter_batch_fill_ = 0;
+  std::vector<size_t> filter_batch_positions_;
+  std::vector<Slice> filter_batch_keys_;
+  std::vector<Slice> filter_batch_values_;
+  std::vector<CompactionFilter::Decision> filter_batch_decisions_;
+  std::vector<std::string> filter_batch_new_values_;
   // "level_ptrs" holds indices that remember which file of an associated
   // level we were last checking during the last call to compaction->
   // KeyNotExistsBeyondOutputLevel(). This allows future calls to the function
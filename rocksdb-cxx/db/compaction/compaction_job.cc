@@ -33,6 +33,7 @@
 #include "db/range_del_aggregator.h"
 #include "db/version_edit.h"
 #include "db/version_set.h"
+#include "file/file_util.h"
 #include "file/filename.h"
 #include "file/read_write_util.h"
 #include "file/sst_file_manager_impl.h"
@@ -947,6 +948,9 @@ rocksdb_rs::status::Status CompactionJob::Install(
     stream << "file_fsync_nanos" << compaction_job_stats_->file_fsync_nanos;
     stream << "file_prepare_write_nanos"
            << compaction_job_stats_->file_prepare_write_nanos;
+    stream << "file_read_nanos" << compaction_job_stats_->file_read_nanos;
+    stream << "file_read_async_wait_nanos"
+           << compaction_job_stats_->file_read_async_wait_nanos;
   }
 
   stream << "lsm_state";
@@ -1090,6 +1094,11 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
   // (a) concurrent compactions,
   // (b) CompactionFilter::Decision::kRemoveAndSkipUntil.
   read_options.total_order_seek = true;
+  // Read input files asynchronously when asked for and supported, see
+  // DBOptions::compaction_async_io.
+  read_options.async_io =
+      db_options_.compaction_async_io &&
+      CheckFSFeatureSupport(fs_.get(), FSSupportedOps::kAsyncIO);
 
   // Remove the timestamps from boundaries because boundaries created in
   // GenSubcompactionBoundaries doesn't strip away the timestamp.
@@ -1190,6 +1199,8 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
   uint64_t prev_fsync_nanos = 0;
   uint64_t prev_range_sync_nanos = 0;
   uint64_t prev_prepare_write_nanos = 0;
+  uint64_t prev_read_nanos = 0;
+  uint64_t prev_async_read_wait_nanos = 0;
   uint64_t prev_cpu_write_nanos = 0;
   uint64_t prev_cpu_read_nanos = 0;
   if (measure_io_stats_) {
@@ -1199,6 +1210,8 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
     prev_fsync_nanos = IOSTATS(fsync_nanos);
     prev_range_sync_nanos = IOSTATS(range_sync_nanos);
     prev_prepare_write_nanos = IOSTATS(prepare_write_nanos);
+    prev_read_nanos = IOSTATS(read_nanos);
+    prev_async_read_wait_nanos = IOSTATS(async_read_wait_nanos);
     prev_cpu_write_nanos = IOSTATS(cpu_write_nanos);
     prev_cpu_read_nanos = IOSTATS(cpu_read_nanos);
   }
@@ -1399,6 +1412,10 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
         IOSTATS(range_sync_nanos) - prev_range_sync_nanos;
     sub_compact->compaction_job_stats.file_prepare_write_nanos +=
         IOSTATS(prepare_write_nanos) - prev_prepare_write_nanos;
+    sub_compact->compaction_job_stats.file_read_nanos +=
+        IOSTATS(read_nanos) - prev_read_nanos;
+    sub_compact->compaction_job_stats.file_read_async_wait_nanos +=
+        IOSTATS(async_read_wait_nanos) - prev_async_read_wait_nanos;
     sub_compact->compaction_job_stats.cpu_micros -=
         (IOSTATS(cpu_write_nanos) - prev_cpu_write_nanos +
          IOSTATS(cpu_read_nanos) - prev_cpu_read_nanos) /
@@ -671,6 +671,16 @@ static std::unordered_map<std::string, OptionTypeInfo>
           rocksdb_rs::utilities::options_type::OptionType::kUInt64T,
           rocksdb_rs::utilities::options_type::OptionVerificationType::kNormal,
           rocksdb_rs::utilities::options_type::OptionTypeFlags::kNone}},
+        {"file_read_nanos",
+         {offsetof(struct CompactionJobStats, file_read_nanos),
+          rocksdb_rs::utilities::options_type::OptionType::kUInt64T,
+          rocksdb_rs::utilities::options_type::OptionVerificationType::kNormal,
+          rocksdb_rs::utilities::options_type::OptionTypeFlags::kNone}},
+        {"file_read_async_wait_nanos",
+         {offsetof(struct CompactionJobStats, file_read_async_wait_nanos),
+          rocksdb_rs::utilities::options_type::OptionType::kUInt64T,
+          rocksdb_rs::utilities::options_type::OptionVerificationType::kNormal,
+          rocksdb_rs::utilities::options_type::OptionTypeFlags::kNone}},
         {"smallest_output_key_prefix",
          {offsetof(struct CompactionJobStats, smallest_output_key_prefix),
           rocksdb_rs::utilities::options_type::OptionType::kEncodedString,
@@ -949,9 +949,98 @@ TEST_F(CompactionServiceTest, TablePropertiesCollector) {
   ASSERT_TRUE(has_user_property);
 }
 
+#ifndef OS_WIN
+// The path of this test binary, which also runs the workers of
+// NewLocalCompactionService() when given kWorkerFlag
+static std::string test_binary;
+static const char* kWorkerFlag = "--local_compaction_service_worker";
+
+TEST_F(CompactionServiceTest, LocalCompactionService) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.statistics = CreateDBStatistics();
+  LocalCompactionServiceOptions cs_options;
+  cs_options.worker_command = {test_binary, kWorkerFlag};
+  options.compaction_service = NewLocalCompactionService(cs_options);
+  DestroyAndReopen(options);
+  GenerateTestData();
+
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  VerifyTestData();
+  // All the compaction writes happened in the workers
+  ASSERT_EQ(options.statistics->getTickerCount(COMPACT_WRITE_BYTES), 0);
+  ASSERT_GT(options.statistics->getTickerCount(REMOTE_COMPACT_WRITE_BYTES),
+            0);
+
+  // The output directories of the jobs are removed once the service is
+  // destroyed with the DB
+  options.compaction_service.reset();
+  Reopen(options);
+  VerifyTestData();
+  std::vector<std::string> children;
+  ASSERT_OK(env_->GetChildren(dbname_, &children));
+  for (const std::string& child : children) {
+    ASSERT_FALSE(Slice(child).starts_with("compaction_service_")) << child;
+  }
+}
+
+TEST_F(CompactionServiceTest, LocalCompactionServiceTimeout) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  LocalCompactionServiceOptions cs_options;
+  // A worker which never returns a result
+  cs_options.worker_command = {"sleep", "600"};
+  cs_options.worker_timeout_ms = 100;
+  options.compaction_service = NewLocalCompactionService(cs_options);
+  DestroyAndReopen(options);
+  GenerateTestData();
+
+  rocksdb_rs::status::Status s =
+      db_->CompactRange(CompactRangeOptions(), nullptr, nullptr);
+  ASSERT_TRUE(s.IsIncomplete()) << *s.ToString();
+  VerifyTestData();
+  ASSERT_EQ(FilesPerLevel(), "0,10,20");
+}
+
+TEST_F(CompactionServiceTest, LocalCompactionServiceShutdown) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  LocalCompactionServiceOptions cs_options;
+  cs_options.worker_command = {"sleep", "600"};
+  options.compaction_service = NewLocalCompactionService(cs_options);
+  DestroyAndReopen(options);
+  GenerateTestData();
+
+  SyncPoint::GetInstance()->LoadDependency(
+      {{"LocalCompactionService::WaitForCompleteV2:Reading",
+        "CompactionServiceTest::LocalCompactionServiceShutdown:Cancel"}});
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  port::Thread compaction_thread([&] {
+    ASSERT_NOK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  });
+  TEST_SYNC_POINT(
+      "CompactionServiceTest::LocalCompactionServiceShutdown:Cancel");
+  // Returns once the worker is killed, rather than after it exits
+  dbfull()->CancelAllBackgroundWork(/*wait=*/true);
+  compaction_thread.join();
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  Close();
+}
+#endif  // !OS_WIN
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
+#ifndef OS_WIN
+  if (argc > 1 && std::string(argv[1]) == rocksdb::kWorkerFlag) {
+    rocksdb::CompactionServiceOptionsOverride override_options;
+    override_options.table_factory.reset(rocksdb::NewBlockBasedTableFactory());
+    return rocksdb::RunLocalCompactionServiceWorker(override_options);
+  }
+  rocksdb::test_binary = argv[0];
+#endif
   rocksdb::port::InstallStackTraceHandler();
   ::testing::InitGoogleTest(&argc, argv);
   RegisterCustomObjects(argc, argv);
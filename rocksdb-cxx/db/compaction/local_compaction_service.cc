@@ -0,0 +1,396 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#ifndef OS_WIN
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/db.h"
+#include "rocksdb/env.h"
+#include "rocksdb/file_system.h"
+#include "rocksdb/options.h"
+#include "rocksdb/system_clock.h"
+#include "test_util/sync_point.h"
+#include "util/coding.h"
+#include "util/mutexlock.h"
+
+#ifdef __APPLE__
+#include <crt_externs.h>
+#define environ (*_NSGetEnviron())
+#elif !defined(OS_WIN)
+extern char** environ;
+#endif
+
+namespace rocksdb {
+
+#ifndef OS_WIN
+namespace {
+
+#ifdef MSG_NOSIGNAL
+// A worker exiting early must not kill the DB process with SIGPIPE
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+bool SendFully(int fd, const Slice& data) {
+  const char* p = data.data();
+  size_t left = data.size();
+  while (left > 0) {
+    ssize_t n = send(fd, p, left, kSendFlags);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    p += n;
+    left -= static_cast<size_t>(n);
+  }
+  return true;
+}
+
+// Reads from `fd` until the end of the stream. Fails if the stream has not
+// ended by `deadline_us`, in microseconds of SystemClock::Default(), unless
+// it is 0.
+bool ReadFully(int fd, std::string* data, uint64_t deadline_us = 0) {
+  char buf[65536];
+  while (true) {
+    if (deadline_us > 0) {
+      const uint64_t now_us = SystemClock::Default()->NowMicros();
+      if (now_us >= deadline_us) {
+        return false;
+      }
+      struct pollfd pfd = {fd, POLLIN, 0};
+      const uint64_t timeout_ms =
+          std::min<uint64_t>((deadline_us - now_us + 999) / 1000, INT_MAX);
+      const int ret = poll(&pfd, 1, static_cast<int>(timeout_ms));
+      if (ret < 0 && errno != EINTR) {
+        return false;
+      }
+      if (ret <= 0) {
+        continue;
+      }
+    }
+    ssize_t n = read(fd, buf, sizeof(buf));
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    if (n == 0) {
+      return true;
+    }
+    data->append(buf, static_cast<size_t>(n));
+  }
+}
+
+bool SetCloseOnExecAndNoSigPipe(int fd) {
+#ifndef SOCK_CLOEXEC
+  if (fcntl(fd, F_SETFD, FD_CLOEXEC) != 0) {
+    return false;
+  }
+#endif
+#ifdef SO_NOSIGPIPE
+  int on = 1;
+  if (setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on)) != 0) {
+    return false;
+  }
+#endif
+  (void)fd;
+  return true;
+}
+
+class LocalCompactionService : public CompactionService {
+ public:
+  explicit LocalCompactionService(const LocalCompactionServiceOptions& options)
+      : options_(options) {}
+
+  ~LocalCompactionService() override {
+    MutexLock l(&mutex_);
+    for (auto& job : workers_) {
+      kill(job.second.pid, SIGKILL);
+      WaitForExit(job.second.pid);
+      close(job.second.fd);
+      RemoveOutputDir(job.second.output_dir,
+                      /*keep_if_has_table_files=*/false);
+    }
+    workers_.clear();
+    RemoveFinishedOutputDirs();
+  }
+
+  static const char* kClassName() { return "LocalCompactionService"; }
+
+  const char* Name() const override { return kClassName(); }
+
+  CompactionServiceJobStatus StartV2(
+      const CompactionServiceJobInfo& info,
+      const std::string& compaction_service_input) override {
+    {
+      MutexLock l(&mutex_);
+      RemoveFinishedOutputDirs();
+      if (cancelled_sessions_.count(info.db_session_id) > 0) {
+        // The DB is shutting down
+        return CompactionServiceJobStatus::kFailure;
+      }
+    }
+    if (options_.worker_command.empty()) {
+      return CompactionServiceJobStatus::kUseLocal;
+    }
+
+    int fds[2];
+#ifdef SOCK_CLOEXEC
+    // Other workers spawned concurrently must not inherit the sockets, or
+    // they would never see the end of the stream
+    const int type = SOCK_STREAM | SOCK_CLOEXEC;
+#else
+    const int type = SOCK_STREAM;
+#endif
+    if (socketpair(AF_UNIX, type, 0, fds) != 0) {
+      return CompactionServiceJobStatus::kUseLocal;
+    }
+    if (!SetCloseOnExecAndNoSigPipe(fds[0]) ||
+        !SetCloseOnExecAndNoSigPipe(fds[1])) {
+      close(fds[0]);
+      close(fds[1]);
+      return CompactionServiceJobStatus::kUseLocal;
+    }
+
+    const uint64_t start_us = SystemClock::Default()->NowMicros();
+    std::vector<char*> argv;
+    for (const std::string& arg : options_.worker_command) {
+      argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+    posix_spawn_file_actions_t file_actions;
+    posix_spawn_file_actions_init(&file_actions);
+    posix_spawn_file_actions_adddup2(&file_actions, fds[1], STDIN_FILENO);
+    posix_spawn_file_actions_adddup2(&file_actions, fds[1], STDOUT_FILENO);
+    pid_t pid;
+    const int err = posix_spawnp(&pid, argv[0], &file_actions, nullptr,
+                                 argv.data(), environ);
+    posix_spawn_file_actions_destroy(&file_actions);
+    close(fds[1]);
+    if (err != 0) {
+      close(fds[0]);
+      return CompactionServiceJobStatus::kUseLocal;
+    }
+
+    std::string output_dir = info.db_name + "/compaction_service_" +
+                             info.db_session_id + "_" +
+                             std::to_string(info.job_id);
+    std::string job;
+    PutLengthPrefixedSlice(&job, info.db_name);
+    PutLengthPrefixedSlice(&job, output_dir);
+    PutLengthPrefixedSlice(&job, compaction_service_input);
+    if (!SendFully(fds[0], job) || shutdown(fds[0], SHUT_WR) != 0) {
+      // The worker failed before reading the job
+      kill(pid, SIGKILL);
+      WaitForExit(pid);
+      close(fds[0]);
+      return CompactionServiceJobStatus::kUseLocal;
+    }
+
+    const uint64_t deadline_us =
+        options_.worker_timeout_ms > 0
+            ? start_us + options_.worker_timeout_ms * 1000
+            : 0;
+    MutexLock l(&mutex_);
+    if (cancelled_sessions_.count(info.db_session_id) > 0) {
+      kill(pid, SIGKILL);
+      WaitForExit(pid);
+      close(fds[0]);
+      return CompactionServiceJobStatus::kFailure;
+    }
+    workers_[{info.db_session_id, info.job_id}] = {
+        pid, fds[0], std::move(output_dir), deadline_us};
+    return CompactionServiceJobStatus::kSuccess;
+  }
+
+  CompactionServiceJobStatus WaitForCompleteV2(
+      const CompactionServiceJobInfo& info,
+      std::string* compaction_service_result) override {
+    const std::pair<std::string, uint64_t> key{info.db_session_id,
+                                               info.job_id};
+    int fd;
+    uint64_t deadline_us;
+    {
+      MutexLock l(&mutex_);
+      auto it = workers_.find(key);
+      if (it == workers_.end()) {
+        return CompactionServiceJobStatus::kFailure;
+      }
+      fd = it->second.fd;
+      deadline_us = it->second.deadline_us;
+    }
+    TEST_SYNC_POINT("LocalCompactionService::WaitForCompleteV2:Reading");
+
+    // The worker stays in workers_ while it runs, to be killed by
+    // CancelAwaitingJobs(). It is not reaped yet, so its pid is not reused.
+    const bool read_ok = ReadFully(fd, compaction_service_result, deadline_us);
+    Worker worker;
+    {
+      MutexLock l(&mutex_);
+      auto it = workers_.find(key);
+      worker = std::move(it->second);
+      workers_.erase(it);
+    }
+    if (!read_ok) {
+      // Timed out, or cannot read the result anyway
+      kill(worker.pid, SIGKILL);
+    }
+    close(worker.fd);
+    const int wstatus = WaitForExit(worker.pid);
+    if (read_ok && WIFEXITED(wstatus) && WEXITSTATUS(wstatus) == 0) {
+      MutexLock l(&mutex_);
+      finished_output_dirs_.push_back(std::move(worker.output_dir));
+      return CompactionServiceJobStatus::kSuccess;
+    }
+    // The DB does not install the outputs of a failed job. The result, if
+    // any, carries its status.
+    RemoveOutputDir(worker.output_dir, /*keep_if_has_table_files=*/false);
+    return CompactionServiceJobStatus::kFailure;
+  }
+
+  void CancelAwaitingJobs(const std::string& db_session_id) override {
+    MutexLock l(&mutex_);
+    cancelled_sessions_.insert(db_session_id);
+    // The killed workers are reaped by WaitForCompleteV2(), which then fails
+    for (auto it = workers_.lower_bound({db_session_id, 0});
+         it != workers_.end() && it->first.first == db_session_id; ++it) {
+      kill(it->second.pid, SIGKILL);
+    }
+  }
+
+ private:
+  struct Worker {
+    pid_t pid = 0;
+    // Our end of the socket of the standard input and output of the worker
+    int fd = -1;
+    std::string output_dir;
+    // When the worker is killed if still running, 0 for never
+    uint64_t deadline_us = 0;
+  };
+
+  // Returns the wait status of process `pid`
+  static int WaitForExit(pid_t pid) {
+    int wstatus = 0;
+    while (waitpid(pid, &wstatus, 0) < 0 && errno == EINTR) {
+    }
+    return wstatus;
+  }
+
+  // Removes the output directory of a job with its files, unless
+  // `keep_if_has_table_files` and the DB has not moved all the table files
+  // out of it yet, in which case returns false. The other files are left by
+  // the secondary instance of the worker, e.g. its info log.
+  bool RemoveOutputDir(const std::string& dir, bool keep_if_has_table_files) {
+    FileSystem* fs = options_.env->GetFileSystem().get();
+    const IOOptions io_opts;
+    std::vector<std::string> children;
+    if (!fs->GetChildren(dir, io_opts, &children, /*dbg=*/nullptr).ok()) {
+      // Never created, or already removed
+      return true;
+    }
+    if (keep_if_has_table_files) {
+      for (const std::string& child : children) {
+        if (Slice(child).ends_with(".sst")) {
+          return false;
+        }
+      }
+    }
+    for (const std::string& child : children) {
+      fs->DeleteFile(dir + "/" + child, io_opts, /*dbg=*/nullptr);
+    }
+    fs->DeleteDir(dir, io_opts, /*dbg=*/nullptr);
+    return true;
+  }
+
+  // REQUIRES: mutex_ held
+  void RemoveFinishedOutputDirs() {
+    std::vector<std::string> remaining;
+    for (std::string& dir : finished_output_dirs_) {
+      if (!RemoveOutputDir(dir, /*keep_if_has_table_files=*/true)) {
+        remaining.push_back(std::move(dir));
+      }
+    }
+    finished_output_dirs_.swap(remaining);
+  }
+
+  const LocalCompactionServiceOptions options_;
+  port::Mutex mutex_;
+  // The workers of the jobs started but not waited for, by session ID of the
+  // DB and job ID, as the service may be shared by several DBs
+  std::map<std::pair<std::string, uint64_t>, Worker> workers_;
+  std::vector<std::string> finished_output_dirs_;
+  // The session IDs of the DBs shut down, which start no more jobs
+  std::set<std::string> cancelled_sessions_;
+};
+
+}  // namespace
+
+std::shared_ptr<CompactionService> NewLocalCompactionService(
+    const LocalCompactionServiceOptions& options) {
+  return std::make_shared<LocalCompactionService>(options);
+}
+
+int RunLocalCompactionServiceWorker(
+    const CompactionServiceOptionsOverride& override_options) {
+  std::string job;
+  if (!ReadFully(STDIN_FILENO, &job)) {
+    return 1;
+  }
+  Slice input(job);
+  Slice db_name;
+  Slice output_dir;
+  Slice compaction_service_input;
+  if (!GetLengthPrefixedSlice(&input, &db_name) ||
+      !GetLengthPrefixedSlice(&input, &output_dir) ||
+      !GetLengthPrefixedSlice(&input, &compaction_service_input)) {
+    return 1;
+  }
+  std::string compaction_service_result;
+  rocksdb_rs::status::Status s = DB::OpenAndCompact(
+      db_name.ToString(), output_dir.ToString(),
+      compaction_service_input.ToString(), &compaction_service_result,
+      override_options);
+  if (!SendFully(STDOUT_FILENO, compaction_service_result)) {
+    return 1;
+  }
+  return s.ok() ? 0 : 1;
+}
+
+#else  // OS_WIN
+
+std::shared_ptr<CompactionService> NewLocalCompactionService(
+    const LocalCompactionServiceOptions& /*options*/) {
+  return nullptr;
+}
+
+int RunLocalCompactionServiceWorker(
+    const CompactionServiceOptionsOverride& /*override_options*/) {
+  return 1;
+}
+
+#endif  // OS_WIN
+
+}  // namespace rocksdb
@@ -8,6 +8,7 @@
 
 #include <algorithm>
 
+#include "rocksdb/comparator.h"
 #include "rocksdb/utilities/customizable_util.h"
 #include "rocksdb/utilities/object_registry.h"
 #include "rocksdb/utilities/options_type.h"
@@ -57,6 +58,134 @@ std::shared_ptr<SstPartitionerFactory> NewSstPartitionerFixedPrefixFactory(
   return std::make_shared<SstPartitionerFixedPrefixFactory>(prefix_len);
 }
 
+static std::unordered_map<std::string, OptionTypeInfo>
+    sst_load_aware_type_info = {
+        {"hot_file_size",
+         {offsetof(struct SstPartitionerLoadAwareOptions, hot_file_size),
+          rocksdb_rs::utilities::options_type::OptionType::kUInt64T,
+          rocksdb_rs::utilities::options_type::OptionVerificationType::kNormal,
+          rocksdb_rs::utilities::options_type::OptionTypeFlags::kNone}},
+        {"hot_read_density_ratio",
+         {offsetof(struct SstPartitionerLoadAwareOptions,
+                   hot_read_density_ratio),
+          rocksdb_rs::utilities::options_type::OptionType::kDouble,
+          rocksdb_rs::utilities::options_type::OptionVerificationType::kNormal,
+          rocksdb_rs::utilities::options_type::OptionTypeFlags::kNone}},
+        {"min_hot_file_reads",
+         {offsetof(struct SstPartitionerLoadAwareOptions, min_hot_file_reads),
+          rocksdb_rs::utilities::options_type::OptionType::kUInt64T,
+          rocksdb_rs::utilities::options_type::OptionVerificationType::kNormal,
+          rocksdb_rs::utilities::options_type::OptionTypeFlags::kNone}},
+};
+
+SstPartitionerLoadAware::SstPartitionerLoadAware(
+    const SstPartitionerLoadAwareOptions& options,
+    const SstPartitioner::Context& context)
+    : hot_file_size_(options.hot_file_size),
+      comparator_(context.comparator != nullptr ? context.comparator
+                                                : BytewiseComparator()) {
+  uint64_t total_reads = 0;
+  uint64_t total_size = 0;
+  for (const auto& file : context.input_files) {
+    total_reads += file.num_reads_sampled;
+    total_size += file.file_size;
+  }
+  if (total_reads == 0 || total_size == 0) {
+    return;
+  }
+  // A file is hot if reads / file_size >= ratio * total_reads / total_size
+  const double min_hot_density = options.hot_read_density_ratio *
+                                 static_cast<double>(total_reads) /
+                                 static_cast<double>(total_size);
+  for (const auto& file : context.input_files) {
+    if (file.num_reads_sampled >= options.min_hot_file_reads &&
+        file.file_size > 0 &&
+        static_cast<double>(file.num_reads_sampled) /
+                static_cast<double>(file.file_size) >=
+            min_hot_density) {
+      hot_ranges_.emplace_back(file.smallest_user_key.ToString(),
+                               file.largest_user_key.ToString());
+    }
+  }
+
+  // The files of different input levels may overlap
+  std::sort(hot_ranges_.begin(), hot_ranges_.end(),
+            [this](const std::pair<std::string, std::string>& a,
+                   const std::pair<std::string, std::string>& b) {
+              return comparator_->Compare(a.first, b.first) < 0;
+            });
+  size_t num_merged = 0;
+  for (size_t i = 0; i < hot_ranges_.size(); i++) {
+    if (num_merged > 0 &&
+        comparator_->Compare(hot_ranges_[i].first,
+                             hot_ranges_[num_merged - 1].second) <= 0) {
+      if (comparator_->Compare(hot_ranges_[i].second,
+                               hot_ranges_[num_merged - 1].second) > 0) {
+        hot_ranges_[num_merged - 1].second = std::move(hot_ranges_[i].second);
+      }
+    } else {
+      if (num_merged != i) {
+        hot_ranges_[num_merged] = std::move(hot_ranges_[i]);
+      }
+      num_merged++;
+    }
+  }
+  hot_ranges_.resize(num_merged);
+}
+
+bool SstPartitionerLoadAware::IsHot(const Slice& user_key) const {
+  // The last range starting at or before `user_key`
+  auto it = std::upper_bound(
+      hot_ranges_.begin(), hot_ranges_.end(), user_key,
+      [this](const Slice& key, const std::pair<std::string, std::string>& r) {
+        return comparator_->Compare(key, r.first) < 0;
+      });
+  if (it == hot_ranges_.begin()) {
+    return false;
+  }
+  --it;
+  return comparator_->Compare(user_key, it->second) <= 0;
+}
+
+PartitionerResult SstPartitionerLoadAware::ShouldPartition(
+    const PartitionerRequest& request) {
+  if (hot_ranges_.empty() ||
+      comparator_->Compare(*request.prev_user_key,
+                           *request.current_user_key) == 0) {
+    return kNotRequired;
+  }
+  const bool hot = IsHot(*request.current_user_key);
+  if (hot != IsHot(*request.prev_user_key)) {
+    return kRequired;
+  }
+  return hot && request.current_output_file_size >= hot_file_size_
+             ? kRequired
+             : kNotRequired;
+}
+
+bool SstPartitionerLoadAware::CanDoTrivialMove(
+    const Slice& /* smallest_user_key */, const Slice& /* largest_user_key */) {
+  return true;
+}
+
+SstPartitionerLoadAwareFactory::SstPartitionerLoadAwareFactory(
+    const SstPartitionerLoadAwareOptions& options)
+    : options_(options) {
+  RegisterOptions(&options_, &sst_load_aware_type_info);
+}
+
+std::unique_ptr<SstPartitioner>
+SstPartitionerLoadAwareFactory::CreatePartitioner(
+    const SstPartitioner::Context& context) const {
+  return std::unique_ptr<SstPartitioner>(
+      new SstPartitionerLoadAware(options_, context));
+}
+
+std::shared_ptr<SstPartitionerFactory> NewSstPartitionerLoadAwareFactory(
+    const SstPartitionerLoadAwareOptions& options) {
+  return std::make_shared<SstPartitionerLoadAwareFactory>(options);
+}
+
 namespace {
 static int RegisterSstPartitionerFactories(ObjectLibrary& library,
                                            const std::string& /*arg*/) {
@@ -68,7 +197,16 @@ static int RegisterSstPartitionerFactories(ObjectLibrary& library,
         guard->reset(new SstPartitionerFixedPrefixFactory(0));
         return guard->get();
       });
-  return 1;
+  library.AddFactory<SstPartitionerFactory>(
+      SstPartitionerLoadAwareFactory::kClassName(),
+      [](const std::string& /*uri*/,
+         std::unique_ptr<SstPartitionerFactory>* guard,
+         std::string* /* errmsg */) {
+        guard->reset(new SstPartitionerLoadAwareFactory());
+        return guard->get();
+      });
+  size_t num_types;
+  return static_cast<int>(library.GetFactoryCount(&num_types));
 }
 }  // namespace
 
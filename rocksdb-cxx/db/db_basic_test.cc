@@ -2613,6 +2613,96 @@ TEST_P(DBMultiGetAsyncIOTest, GetFromL1AndL2WithRangeDelInL1) {
 }
 #endif  // ROCKSDB_IOURING_PRESENT
 
+TEST_P(DBMultiGetAsyncIOTest, SpeculativeGet) {
+  PrepareDBForTest();
+
+  ReadOptions ro;
+  ro.async_io = true;
+  ro.speculative_get_reads = GetParam();
+  // 0 is in L0, 33 in L1, 56 in L2, and 139 in L2 but covered by a range
+  // delete in L1. All of them overlap with files in more than one level.
+  std::string value;
+  ASSERT_OK(db_->Get(ro, Key(0), &value));
+  ASSERT_EQ(value, "val_l0_" + std::to_string(0));
+  ASSERT_OK(db_->Get(ro, Key(33), &value));
+  ASSERT_EQ(value, "val_l1_" + std::to_string(33));
+  ASSERT_OK(db_->Get(ro, Key(56), &value));
+  ASSERT_EQ(value, "val_l2_" + std::to_string(56));
+  ASSERT_TRUE(db_->Get(ro, Key(139), &value).IsNotFound());
+
+#ifdef ROCKSDB_IOURING_PRESENT
+  if (GetParam()) {
+    ASSERT_GT(statistics()->getTickerCount(GET_SPECULATIVE_FILE_LOOKUPS), 0);
+  } else {
+    ASSERT_EQ(statistics()->getTickerCount(GET_SPECULATIVE_FILE_LOOKUPS), 0);
+  }
+#endif  // ROCKSDB_IOURING_PRESENT
+}
+
+TEST_P(DBMultiGetAsyncIOTest, SpeculativeGetStats) {
+  // The counters of a Get() with a cold block cache, with and without
+  // speculative reads
+  struct GetStats {
+    uint64_t filter_useful;
+    uint64_t filter_positive;
+    uint64_t filter_true_positive;
+    uint64_t data_block_lookups;
+    uint64_t bloom_sst_checks;
+    uint64_t perf_data_block_lookups;
+  };
+  auto get_stats = [&](bool speculative_get_reads) {
+    BlockBasedTableOptions bbto;
+    bbto.filter_policy.reset(NewBloomFilterPolicy(10));
+    bbto.block_cache = NewLRUCache(8 << 20);
+    options_.table_factory.reset(NewBlockBasedTableFactory(bbto));
+    ReopenDB();
+    EXPECT_OK(statistics()->Reset());
+    SetPerfLevel(kEnableCount);
+    get_perf_context()->Reset();
+
+    ReadOptions ro;
+    ro.async_io = true;
+    ro.speculative_get_reads = speculative_get_reads;
+    // 56 is in L2, under files in L0 and L1 whose filters rule it out
+    std::string value;
+    EXPECT_OK(db_->Get(ro, Key(56), &value));
+    EXPECT_EQ(value, "val_l2_" + std::to_string(56));
+
+    GetStats stats;
+    stats.filter_useful = statistics()->getTickerCount(BLOOM_FILTER_USEFUL);
+    stats.filter_positive =
+        statistics()->getTickerCount(BLOOM_FILTER_FULL_POSITIVE);
+    stats.filter_true_positive =
+        statistics()->getTickerCount(BLOOM_FILTER_FULL_TRUE_POSITIVE);
+    stats.data_block_lookups =
+        statistics()->getTickerCount(BLOCK_CACHE_DATA_HIT) +
+        statistics()->getTickerCount(BLOCK_CACHE_DATA_MISS);
+    stats.bloom_sst_checks = get_perf_context()->bloom_sst_hit_count +
+                             get_perf_context()->bloom_sst_miss_count;
+    stats.perf_data_block_lookups = get_perf_context()->block_cache_hit_count +
+                                    get_perf_context()->block_read_count;
+    SetPerfLevel(kDisable);
+    return stats;
+  };
+
+  GetStats expected = get_stats(/*speculative_get_reads=*/false);
+  ASSERT_GT(expected.filter_useful, 0);
+  ASSERT_GT(expected.data_block_lookups, 0);
+  GetStats actual = get_stats(GetParam());
+  // The speculative lookups are only counted in their own tickers
+  ASSERT_EQ(actual.filter_useful, expected.filter_useful);
+  ASSERT_EQ(actual.filter_positive, expected.filter_positive);
+  ASSERT_EQ(actual.filter_true_positive, expected.filter_true_positive);
+  ASSERT_EQ(actual.data_block_lookups, expected.data_block_lookups);
+  ASSERT_EQ(actual.bloom_sst_checks, expected.bloom_sst_checks);
+  ASSERT_EQ(actual.perf_data_block_lookups, expected.perf_data_block_lookups);
+#ifdef ROCKSDB_IOURING_PRESENT
+  if (GetParam()) {
+    ASSERT_GT(statistics()->getTickerCount(GET_SPECULATIVE_FILE_LOOKUPS), 0);
+  }
+#endif  // ROCKSDB_IOURING_PRESENT
+}
+
 TEST_P(DBMultiGetAsyncIOTest, GetNoIOUring) {
   std::vector<std::string> key_strs;
   std::vector<Slice> keys;
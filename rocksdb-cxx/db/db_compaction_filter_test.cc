@@ -1026,6 +1026,93 @@ TEST_F(DBTestCompactionFilter, DropKeyWithSingleDelete) {
   }
 }
 
+TEST_F(DBTestCompactionFilter, FilterBatch) {
+  // Removes the keys divisible by 2 and changes the value of the ones
+  // divisible by 3 in batches, and leaves the ones divisible by 5 to
+  // FilterV3(), which changes their value.
+  class BatchFilter : public CompactionFilter {
+   public:
+    bool SupportsFilterBatch() const override { return true; }
+
+    void FilterBatch(int /*level*/, size_t n, const Slice* keys,
+                     const Slice* existing_values, Decision* decisions,
+                     std::string* new_values) const override {
+      ++num_batches;
+      num_batched_keys += n;
+      for (size_t i = 0; i < n; ++i) {
+        EXPECT_EQ(decisions[i], Decision::kUndetermined);
+        EXPECT_EQ(existing_values[i].ToString(), "v2");
+        int k = std::stoi(keys[i].ToString());
+        if (k % 5 == 0) {
+          continue;
+        }
+        if (k % 2 == 0) {
+          decisions[i] = Decision::kRemove;
+        } else if (k % 3 == 0) {
+          decisions[i] = Decision::kChangeValue;
+          new_values[i] = "batch";
+        } else {
+          decisions[i] = Decision::kKeep;
+        }
+      }
+    }
+
+    Decision FilterV3(int /*level*/, const Slice& key, ValueType value_type,
+                      const Slice* /*existing_value*/,
+                      const WideColumns* /*existing_columns*/,
+                      std::string* new_value,
+                      std::vector<std::pair<std::string, std::string>>*
+                      /*new_columns*/,
+                      std::string* /*skip_until*/) const override {
+      ++num_single_keys;
+      EXPECT_EQ(value_type, ValueType::kValue);
+      EXPECT_EQ(std::stoi(key.ToString()) % 5, 0);
+      *new_value = "single";
+      return Decision::kChangeValue;
+    }
+
+    const char* Name() const override { return "BatchFilter"; }
+
+    mutable int num_batches = 0;
+    mutable size_t num_batched_keys = 0;
+    mutable int num_single_keys = 0;
+  } batch_filter;
+
+  Options options = CurrentOptions();
+  options.compaction_filter = &batch_filter;
+  options.disable_auto_compactions = true;
+  DestroyAndReopen(options);
+
+  const int kNumKeys = 1000;
+  for (const char* value : {"v1", "v2"}) {
+    for (int i = 0; i < kNumKeys; ++i) {
+      char key[100];
+      snprintf(key, sizeof(key), "%010d", i);
+      ASSERT_OK(Put(key, value));
+    }
+    ASSERT_OK(Flush());
+  }
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+
+  // Only the latest version of each key is filtered
+  ASSERT_GT(batch_filter.num_batches, 1);
+  ASSERT_EQ(batch_filter.num_batched_keys, static_cast<size_t>(kNumKeys));
+  ASSERT_EQ(batch_filter.num_single_keys, kNumKeys / 5);
+  for (int i = 0; i < kNumKeys; ++i) {
+    char key[100];
+    snprintf(key, sizeof(key), "%010d", i);
+    if (i % 5 == 0) {
+      ASSERT_EQ(Get(key), "single");
+    } else if (i % 2 == 0) {
+      ASSERT_EQ(Get(key), "NOT_FOUND");
+    } else if (i % 3 == 0) {
+      ASSERT_EQ(Get(key), "batch");
+    } else {
+      ASSERT_EQ(Get(key), "v2");
+    }
+  }
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
@@ -1157,6 +1157,72 @@ TEST_F(DBCompactionTest, CompactionSstPartitionerNonTrivial) {
   ASSERT_EQ("B", Get("bbbb1"));
 }
 
+TEST_F(DBCompactionTest, CompactionSstPartitionerLoadAware) {
+  Options options = CurrentOptions();
+  options.compaction_style = kCompactionStyleLevel;
+  options.disable_auto_compactions = true;
+  SstPartitionerLoadAwareOptions partitioner_options;
+  // Reads are sampled, so any sampled read makes a file hot enough
+  partitioner_options.min_hot_file_reads = 1;
+  options.sst_partitioner_factory =
+      NewSstPartitionerLoadAwareFactory(partitioner_options);
+
+  DestroyAndReopen(options);
+
+  // One file per key range in L1
+  for (const char* prefix : {"a", "b", "c"}) {
+    for (int i = 0; i < 100; i++) {
+      ASSERT_OK(Put(prefix + Key(i), "val"));
+    }
+    ASSERT_OK(Flush());
+    MoveFilesToLevel(1);
+  }
+  ASSERT_EQ("0,3", FilesPerLevel());
+
+  // Only the middle range is read, so that its file is sampled
+  Random rnd(301);
+  for (int i = 0; i < 20000; i++) {
+    ASSERT_EQ("val", Get("b" + Key(rnd.Uniform(100))));
+  }
+
+  // Rewriting L1 into a single file keeps the hot range in its own file
+  CompactRangeOptions cro;
+  cro.bottommost_level_compaction = BottommostLevelCompaction::kForce;
+  ASSERT_OK(db_->CompactRange(cro, nullptr, nullptr));
+  std::vector<LiveFileMetaData> files;
+  dbfull()->GetLiveFilesMetaData(&files);
+  ASSERT_EQ(3, files.size());
+  std::sort(files.begin(), files.end(),
+            [](const LiveFileMetaData& a, const LiveFileMetaData& b) {
+              return a.smallestkey < b.smallestkey;
+            });
+  ASSERT_EQ("a" + Key(99), files[0].largestkey);
+  ASSERT_EQ("b" + Key(0), files[1].smallestkey);
+  ASSERT_EQ("b" + Key(99), files[1].largestkey);
+  ASSERT_EQ("c" + Key(0), files[2].smallestkey);
+
+  // Hot ranges are cut at hot_file_size
+  SstPartitioner::Context context;
+  context.is_full_compaction = false;
+  context.is_manual_compaction = false;
+  context.output_level = 1;
+  context.input_files.push_back({"a", "b", 1000, 0});
+  context.input_files.push_back({"c", "d", 1000, 1000});
+  partitioner_options.hot_file_size = 100;
+  SstPartitionerLoadAware partitioner(partitioner_options, context);
+  ASSERT_EQ(kNotRequired,
+            partitioner.ShouldPartition(PartitionerRequest("a", "b", 500)));
+  ASSERT_EQ(kRequired,
+            partitioner.ShouldPartition(PartitionerRequest("b", "c", 10)));
+  ASSERT_EQ(kNotRequired,
+            partitioner.ShouldPartition(PartitionerRequest("c", "c1", 10)));
+  ASSERT_EQ(kRequired,
+            partitioner.ShouldPartition(PartitionerRequest("c", "c1", 100)));
+  ASSERT_EQ(kRequired,
+            partitioner.ShouldPartition(PartitionerRequest("c1", "e", 10)));
+  ASSERT_TRUE(partitioner.CanDoTrivialMove("a", "e"));
+}
+
 TEST_F(DBCompactionTest, ZeroSeqIdCompaction) {
   Options options = CurrentOptions();
   options.compaction_style = kCompactionStyleLevel;
@@ -280,6 +280,22 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
       PeriodicTaskType::kRecordSeqnoTime,
       [this]() { this->RecordSeqnoToTimeMapping(); });
 
+  if (immutable_db_options_.wal_compression ==
+          rocksdb_rs::compression_type::CompressionType::kZSTD &&
+      immutable_db_options_.wal_compression_max_dict_bytes > 0) {
+    wal_compression_dict_builder_.reset(new WalCompressionDictBuilder(
+        immutable_db_options_.wal_compression_max_dict_bytes));
+  }
+
+  // Writes must invalidate the hot key cache before they become visible,
+  // which unordered_write and the write policies publishing sequence numbers
+  // per batch do not guarantee. Secondary instances change their data
+  // without writes, by catching up with the primary.
+  if (immutable_db_options_.hot_key_cache && !read_only && !seq_per_batch &&
+      !immutable_db_options_.unordered_write) {
+    hot_key_cache_.reset(new HotKeyCache(immutable_db_options_.hot_key_cache));
+  }
+
   versions_.reset(new VersionSet(dbname_, &immutable_db_options_, file_options_,
                                  table_cache_.get(), write_buffer_manager_,
                                  &write_controller_, &block_cache_tracer_,
@@ -511,6 +527,12 @@ void DBImpl::CancelAllBackgroundWork(bool wait) {
     }
   }
 
+  if (immutable_db_options_.compaction_service) {
+    // The compactions running in the service are waited for below
+    immutable_db_options_.compaction_service->CancelAwaitingJobs(
+        db_session_id_);
+  }
+
   InstrumentedMutexLock l(&mutex_);
   if (!shutting_down_.load(std::memory_order_acquire) &&
       has_unpersisted_data_.load(std::memory_order_relaxed) &&
@@ -554,6 +576,12 @@ rocksdb_rs::status::Status DBImpl::MaybeReleaseTimestampedSnapshotsAndCheck() {
 }
 
 rocksdb_rs::status::Status DBImpl::CloseHelper() {
+  // Release the sync writes still waiting, before anything they depend on is
+  // torn down
+  if (wal_sync_thread_) {
+    wal_sync_thread_->Stop();
+  }
+
   // Guarantee that there is no background error recovery in progress before
   // continuing with the shutdown
   mutex_.Lock();
@@ -2123,6 +2151,26 @@ rocksdb_rs::status::Status DBImpl::GetImpl(const ReadOptions& read_options,
   TEST_SYNC_POINT("DBImpl::GetImpl:3");
   TEST_SYNC_POINT("DBImpl::GetImpl:4");
 
+  // The hot key cache holds final values, and is only valid for reads that
+  // see all the writes up to their sequence number, range deletions
+  // included
+  const bool use_hot_key_cache =
+      hot_key_cache_ != nullptr && get_impl_options.get_value &&
+      get_impl_options.value != nullptr &&
+      get_impl_options.callback == nullptr &&
+      get_impl_options.is_blob_index == nullptr &&
+      read_options.read_tier == kReadAllTier &&
+      read_options.timestamp == nullptr &&
+      !read_options.ignore_range_deletions;
+  bool hot_key_cache_hit = false;
+  if (use_hot_key_cache) {
+    hot_key_cache_hit = hot_key_cache_->Lookup(cfd->GetID(), key, snapshot,
+                                               get_impl_options.value);
+    cfd->internal_stats()->RecordHotKeyCacheLookup(hot_key_cache_hit);
+    RecordTick(stats_,
+               hot_key_cache_hit ? HOT_KEY_CACHE_HIT : HOT_KEY_CACHE_MISS);
+  }
+
   // Prepare to store a list of merge operations if merge occurs.
   MergeContext merge_context;
   SequenceNumber max_covering_tombstone_seq = 0;
@@ -2136,10 +2184,10 @@ rocksdb_rs::status::Status DBImpl::GetImpl(const ReadOptions& read_options,
 
   bool skip_memtable = (read_options.read_tier == kPersistedTier &&
                         has_unpersisted_data_.load(std::memory_order_relaxed));
-  bool done = false;
+  bool done = hot_key_cache_hit;
   std::string* timestamp =
       ucmp->timestamp_size() > 0 ? get_impl_options.timestamp : nullptr;
-  if (!skip_memtable) {
+  if (!done && !skip_memtable) {
     // Get value associated with key
     if (get_impl_options.get_value) {
       if (sv->mem->Get(
@@ -2213,6 +2261,13 @@ rocksdb_rs::status::Status DBImpl::GetImpl(const ReadOptions& read_options,
         get_impl_options.get_value);
     RecordTick(stats_, MEMTABLE_MISS);
   }
+  if (use_hot_key_cache && !hot_key_cache_hit && s.ok() &&
+      hot_key_cache_->Insert(cfd->GetID(), key, snapshot,
+                             *get_impl_options.value) ==
+          HotKeyCache::InsertResult::kRejected) {
+    cfd->internal_stats()->RecordHotKeyCacheAdmissionReject();
+    RecordTick(stats_, HOT_KEY_CACHE_ADMISSION_REJECTED);
+  }
 
   {
     PERF_TIMER_GUARD(get_post_process_time);
@@ -4403,6 +4458,10 @@ rocksdb_rs::status::Status DBImpl::DeleteFile(std::string name) {
       InstallSuperVersionAndScheduleWork(cfd,
                                          &job_context.superversion_contexts[0],
                                          *cfd->GetLatestMutableCFOptions());
+      if (hot_key_cache_ != nullptr) {
+        // Deleting files may bring back older values of their keys
+        hot_key_cache_->InvalidateAll(versions_->LastSequence() + 1);
+      }
     }
     FindObsoleteFiles(&job_context, false);
   }  // lock released here
@@ -4493,6 +4552,10 @@ rocksdb_rs::status::Status DBImpl::DeleteFilesInRanges(
       InstallSuperVersionAndScheduleWork(cfd,
                                          &job_context.superversion_contexts[0],
                                          *cfd->GetLatestMutableCFOptions());
+      if (hot_key_cache_ != nullptr) {
+        // Deleting files may bring back older values of their keys
+        hot_key_cache_->InvalidateAll(versions_->LastSequence() + 1);
+      }
     }
     for (auto* deleted_file : deleted_files) {
       deleted_file->being_compacted = false;
@@ -5499,6 +5562,16 @@ rocksdb_rs::status::Status DBImpl::IngestExternalFiles(
         }
       }
     }
+    // Check the files for overlaps with the levels again, without holding
+    // the mutex, if flushes or compactions changed them since Prepare()
+    if (status.ok()) {
+      for (size_t i = 0; i != num_cfs; ++i) {
+        status = ingestion_jobs[i].UpdateLevelOverlaps(&mutex_);
+        if (!status.ok()) {
+          break;
+        }
+      }
+    }
     // Run ingestion jobs.
     if (status.ok()) {
       for (size_t i = 0; i != num_cfs; ++i) {
@@ -5561,6 +5634,13 @@ rocksdb_rs::status::Status DBImpl::IngestExternalFiles(
         versions_->SetLastPublishedSequence(last_seqno + consumed_seqno_count);
         versions_->SetLastSequence(last_seqno + consumed_seqno_count);
       }
+      if (status.ok() && hot_key_cache_ != nullptr) {
+        // The ingested files change values without going through the
+        // memtables. A Get() may still pair the last sequence number with
+        // the old files until the new super version is installed, so the
+        // entries read at it are invalid too.
+        hot_key_cache_->InvalidateAll(versions_->LastSequence() + 1);
+      }
     }
 
     for (auto& job : ingestion_jobs) {
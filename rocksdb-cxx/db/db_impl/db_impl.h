@@ -28,6 +28,7 @@
 #include "db/external_sst_file_ingestion_job.h"
 #include "db/flush_job.h"
 #include "db/flush_scheduler.h"
+#include "db/hot_key_cache.h"
 #include "db/import_column_family_job.h"
 #include "db/internal_stats.h"
 #include "db/log_writer.h"
@@ -44,6 +45,8 @@
 #include "db/trim_history_scheduler.h"
 #include "db/version_edit.h"
 #include "db/wal_manager.h"
+#include "db/wal_compression_dict_builder.h"
+#include "db/wal_sync_thread.h"
 #include "db/write_controller.h"
 #include "db/write_thread.h"
 #include "logging/event_logger.h"
@@ -73,6 +76,7 @@ class ArenaWrappedDBIter;
 class InMemoryStatsHistoryIterator;
 class MemTable;
 class PersistentStatsHistoryIterator;
+class RecoveryInsertThreads;
 class TableCache;
 class TaskLimiterToken;
 class Version;
@@ -861,6 +865,9 @@ class DBImpl : public DB {
 
   const SnapshotList& snapshots() const { return snapshots_; }
 
+  // nullptr unless DBOptions::hot_key_cache is set and usable
+  HotKeyCache* hot_key_cache() const { return hot_key_cache_.get(); }
+
   // load list of snapshots to `snap_vector` that is no newer than `max_seq`
   // in ascending order.
   // `oldest_write_conflict_snapshot` is filled with the oldest snapshot
@@ -1897,6 +1904,41 @@ class DBImpl : public DB {
       const std::vector<uint64_t>& log_numbers, SequenceNumber* next_sequence,
       bool read_only, bool* corrupted_log_found, RecoveryContext* recovery_ctx);
 
+  // Replays the WALs for RecoverLogFiles(), in parallel if `allow_parallel`
+  // and wal_recovery_threads allow it. Sets `replay_serially` and returns a
+  // non-ok status if a parallel replay left writes in the memtables past a
+  // write batch that failed to be inserted; the WALs must then be replayed
+  // again serially, from empty memtables.
+  rocksdb_rs::status::Status RecoverLogFilesImpl(
+      const std::vector<uint64_t>& log_numbers, SequenceNumber* next_sequence,
+      bool read_only, bool* corrupted_log_found, RecoveryContext* recovery_ctx,
+      bool allow_parallel, bool* replay_serially);
+
+  // A write batch replayed by RecoverLogFiles() that could not be inserted
+  // into the memtables.
+  struct RecoveredBatchFailure {
+    // Index of the batch in the replayed round
+    size_t batch_index;
+    // Sequence number following the last one inserted from the batch
+    SequenceNumber next_sequence;
+    rocksdb_rs::status::Status status;
+  };
+
+  // Inserts `batches`, read in order from WAL `wal_number`, into the
+  // memtables with the threads of `insert_threads`. Each thread owns the
+  // column families whose ID modulo the number of threads is its index, so
+  // every memtable still has a single writer and sees its writes in WAL
+  // order. Failures are returned in batch order. With `stop_on_error`, no
+  // thread inserts a batch after the first failing one it knows of, and
+  // `inserted_past_failure` is set if a batch after the first failing one
+  // was inserted before the failure was found, as the memtables then have
+  // writes that recovery must drop.
+  void InsertRecoveredBatchesInParallel(
+      const std::vector<WriteBatch>& batches, uint64_t wal_number,
+      RecoveryInsertThreads* insert_threads, bool stop_on_error,
+      bool* has_valid_writes, std::vector<RecoveredBatchFailure>* failures,
+      bool* inserted_past_failure);
+
   // The following two methods are used to flush a memtable to
   // storage. The first one is used at database RecoveryTime (when the
   // database is opened) and is heavyweight because it holds the mutex
@@ -2711,6 +2753,18 @@ class DBImpl : public DB {
   // It contains the implementations for each periodic task.
   std::map<PeriodicTaskType, const PeriodicTaskFunc> periodic_task_functions_;
 
+  // Syncs the WAL for sync writes when wal_group_commit is set. Created once
+  // the DB is open, and stopped first thing on close.
+  std::unique_ptr<WalSyncThread> wal_sync_thread_;
+
+  // Samples the WAL records and builds the dictionary of the new WALs when
+  // wal_compression_max_dict_bytes is set
+  std::unique_ptr<WalCompressionDictBuilder> wal_compression_dict_builder_;
+
+  // Caches the results of Get() for hot keys when DBOptions::hot_key_cache
+  // is set. Provides its own synchronization.
+  std::unique_ptr<HotKeyCache> hot_key_cache_;
+
   // When set, we use a separate queue for writes that don't write to memtable.
   // In 2PC these are the writes at Prepare phase.
   const bool two_write_queues_;
@@ -6,11 +6,15 @@
 // Copyright (c) 2011 The LevelDB Authors. All rights reserved.
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
+#include <algorithm>
+#include <atomic>
 #include <cinttypes>
+#include <limits>
 
 #include "db/builder.h"
 #include "db/db_impl/db_impl.h"
 #include "db/error_handler.h"
+#include "db/log_prefetcher.h"
 #include "db/periodic_task_scheduler.h"
 #include "env/composite_env_wrapper.h"
 #include "file/filename.h"
@@ -24,6 +28,8 @@
 #include "rocksdb/table.h"
 #include "rocksdb/wal_filter.h"
 #include "test_util/sync_point.h"
+#include "util/defer.h"
+#include "util/mutexlock.h"
 #include "util/rate_limiter_impl.h"
 #include "util/udt_util.h"
 
@@ -214,7 +220,8 @@ DBOptions SanitizeOptions(const std::string& dbname, const DBOptions& src,
     result.wal_compression =
         rocksdb_rs::compression_type::CompressionType::kNoCompression;
     ROCKS_LOG_WARN(result.info_log,
-                   "wal_compression is disabled since only zstd is supported");
+                   "wal_compression is disabled since only zstd and lz4 are "
+                   "supported");
   }
 
   if (!result.paranoid_checks) {
@@ -294,6 +301,23 @@ rocksdb_rs::status::Status DBImpl::ValidateOptions(
         "unordered_write is incompatible with enable_pipelined_write");
   }
 
+  if (db_options.wal_group_commit &&
+      (db_options.enable_pipelined_write || db_options.unordered_write ||
+       db_options.two_write_queues || db_options.manual_wal_flush ||
+       db_options.allow_mmap_writes)) {
+    return rocksdb_rs::status::Status_InvalidArgument(
+        "wal_group_commit is incompatible with enable_pipelined_write, "
+        "unordered_write, two_write_queues, manual_wal_flush and "
+        "allow_mmap_writes");
+  }
+
+  if (db_options.wal_compression_max_dict_bytes >
+      log::kMaxCompressionDictBytes) {
+    return rocksdb_rs::status::Status_InvalidArgument(
+        "wal_compression_max_dict_bytes cannot exceed " +
+        std::to_string(log::kMaxCompressionDictBytes));
+  }
+
   if (db_options.atomic_flush && db_options.enable_pipelined_write) {
     return rocksdb_rs::status::Status_InvalidArgument(
         "atomic_flush is incompatible with enable_pipelined_write");
@@ -1098,10 +1122,243 @@ bool DBImpl::InvokeWalFilterIfNeededOnWalRecord(
   return true;
 }
 
+namespace {
+// With wal_recovery_threads > 1, the number of WAL records read ahead of
+// replay, and the size of the rounds of write batches inserted into the
+// memtables in parallel. Full memtables are only flushed between rounds.
+constexpr size_t kParallelRecoveryPrefetchRecords = 1024;
+constexpr size_t kParallelRecoveryRoundBytes = 16 << 20;
+
+// The column families seen by one thread of parallel WAL recovery: only those
+// owned by the thread.
+class ParallelRecoveryColumnFamilyMemTables : public ColumnFamilyMemTablesImpl {
+ public:
+  ParallelRecoveryColumnFamilyMemTables(ColumnFamilySet* column_family_set,
+                                        uint32_t num_threads,
+                                        uint32_t thread_index)
+      : ColumnFamilyMemTablesImpl(column_family_set),
+        num_threads_(num_threads),
+        thread_index_(thread_index) {}
+
+  bool Seek(uint32_t column_family_id) override {
+    return column_family_id % num_threads_ == thread_index_ &&
+           ColumnFamilyMemTablesImpl::Seek(column_family_id);
+  }
+
+ private:
+  const uint32_t num_threads_;
+  const uint32_t thread_index_;
+};
+}  // namespace
+
+// The threads inserting write batches into the memtables with parallel WAL
+// recovery, kept for the whole replay.
+class RecoveryInsertThreads {
+ public:
+  explicit RecoveryInsertThreads(int num_threads) : cv_(&mu_) {
+    assert(num_threads > 1);
+    threads_.reserve(num_threads - 1);
+    for (int i = 1; i < num_threads; ++i) {
+      threads_.emplace_back(&RecoveryInsertThreads::WorkerLoop, this, i);
+    }
+  }
+
+  ~RecoveryInsertThreads() {
+    {
+      MutexLock l(&mu_);
+      stop_ = true;
+      cv_.SignalAll();
+    }
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  int NumThreads() const { return static_cast<int>(threads_.size()) + 1; }
+
+  // Calls `fn` with the index of every thread, the calling thread having
+  // index 0, and returns once all the calls returned.
+  void Run(const std::function<void(int)>& fn) {
+    {
+      MutexLock l(&mu_);
+      fn_ = &fn;
+      pending_ = threads_.size();
+      ++round_;
+      cv_.SignalAll();
+    }
+    fn(0);
+    MutexLock l(&mu_);
+    while (pending_ > 0) {
+      cv_.Wait();
+    }
+    fn_ = nullptr;
+  }
+
+ private:
+  void WorkerLoop(int thread_index) {
+    uint64_t last_round = 0;
+    MutexLock l(&mu_);
+    while (true) {
+      while (!stop_ && round_ == last_round) {
+        cv_.Wait();
+      }
+      if (stop_) {
+        return;
+      }
+      last_round = round_;
+      const std::function<void(int)>* fn = fn_;
+      mu_.Unlock();
+      (*fn)(thread_index);
+      mu_.Lock();
+      if (--pending_ == 0) {
+        cv_.SignalAll();
+      }
+    }
+  }
+
+  port::Mutex mu_;
+  port::CondVar cv_;
+  std::vector<port::Thread> threads_;
+  // The function of the current round, and the number of threads other
+  // than the calling one still running it
+  const std::function<void(int)>* fn_ = nullptr;
+  size_t pending_ = 0;
+  uint64_t round_ = 0;
+  bool stop_ = false;
+};
+
+void DBImpl::InsertRecoveredBatchesInParallel(
+    const std::vector<WriteBatch>& batches, uint64_t wal_number,
+    RecoveryInsertThreads* insert_threads, bool stop_on_error,
+    bool* has_valid_writes, std::vector<RecoveredBatchFailure>* failures,
+    bool* inserted_past_failure) {
+  const int num_threads = insert_threads->NumThreads();
+  assert(!seq_per_batch_ && batch_per_txn_);
+  std::vector<std::vector<RecoveredBatchFailure>> thread_failures(
+      num_threads);
+  std::unique_ptr<bool[]> thread_has_valid_writes(new bool[num_threads]());
+  // Index of the last batch each thread wrote to its memtables, plus one
+  std::vector<size_t> thread_written_end(num_threads, 0);
+  // With `stop_on_error`, no thread starts a batch after the earliest
+  // failing one found so far.
+  std::atomic<size_t> first_failure{std::numeric_limits<size_t>::max()};
+
+  auto insert = [&](int thread_index) {
+    ParallelRecoveryColumnFamilyMemTables memtables(
+        versions_->GetColumnFamilySet(), static_cast<uint32_t>(num_threads),
+        static_cast<uint32_t>(thread_index));
+    for (size_t i = 0; i < batches.size(); ++i) {
+      if (stop_on_error && i > first_failure.load(std::memory_order_acquire)) {
+        break;
+      }
+      // Column families of other threads are skipped like missing ones, but
+      // still take their sequence numbers.
+      SequenceNumber next_sequence = kMaxSequenceNumber;
+      bool batch_has_valid_writes = false;
+      rocksdb_rs::status::Status s = WriteBatchInternal::InsertInto(
+          &batches[i], &memtables, &flush_scheduler_,
+          &trim_history_scheduler_, true, wal_number, this,
+          false /* concurrent_memtable_writes */, &next_sequence,
+          &batch_has_valid_writes, seq_per_batch_, batch_per_txn_);
+      if (batch_has_valid_writes) {
+        thread_has_valid_writes[thread_index] = true;
+        thread_written_end[thread_index] = i + 1;
+      }
+      std::pair<const WriteBatch*, rocksdb_rs::status::Status*> cb_arg(
+          &batches[i], &s);
+      TEST_SYNC_POINT_CALLBACK(
+          "DBImpl::InsertRecoveredBatchesInParallel:AfterInsert", &cb_arg);
+      MaybeIgnoreError(&s);
+      if (!s.ok()) {
+        thread_failures[thread_index].push_back(
+            RecoveredBatchFailure{i, next_sequence, std::move(s)});
+        if (stop_on_error) {
+          size_t prev = first_failure.load(std::memory_order_relaxed);
+          while (i < prev && !first_failure.compare_exchange_weak(
+                                 prev, i, std::memory_order_release,
+                                 std::memory_order_relaxed)) {
+          }
+          break;
+        }
+        continue;
+      }
+      assert(next_sequence == WriteBatchInternal::Sequence(&batches[i]) +
+                                  WriteBatchInternal::Count(&batches[i]));
+    }
+  };
+
+  insert_threads->Run(insert);
+
+  for (int i = 0; i < num_threads; ++i) {
+    *has_valid_writes = *has_valid_writes || thread_has_valid_writes[i];
+    for (auto& failure : thread_failures[i]) {
+      failures->push_back(std::move(failure));
+    }
+  }
+  // When several threads failed on the same batch, the serial replay would
+  // have stopped at the earliest failing entry.
+  std::sort(failures->begin(), failures->end(),
+            [](const RecoveredBatchFailure& a, const RecoveredBatchFailure& b) {
+              return a.batch_index != b.batch_index
+                         ? a.batch_index < b.batch_index
+                         : a.next_sequence < b.next_sequence;
+            });
+
+  if (stop_on_error && !failures->empty()) {
+    // A thread may have written a later batch before the failure was
+    // found. Memtables cannot be rolled back, and recovering to the failing
+    // batch would leave later writes in them.
+    const size_t failed_index = failures->front().batch_index;
+    for (int i = 0; i < num_threads; ++i) {
+      if (thread_written_end[i] > failed_index + 1) {
+        *inserted_past_failure = true;
+        break;
+      }
+    }
+  }
+}
+
 // REQUIRES: wal_numbers are sorted in ascending order
 rocksdb_rs::status::Status DBImpl::RecoverLogFiles(
     const std::vector<uint64_t>& wal_numbers, SequenceNumber* next_sequence,
     bool read_only, bool* corrupted_wal_found, RecoveryContext* recovery_ctx) {
+  const SequenceNumber initial_next_sequence = *next_sequence;
+  bool replay_serially = false;
+  rocksdb_rs::status::Status s = RecoverLogFilesImpl(
+      wal_numbers, next_sequence, read_only, corrupted_wal_found, recovery_ctx,
+      true /* allow_parallel */, &replay_serially);
+  if (!replay_serially) {
+    return s;
+  }
+  ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                 "Parallel WAL replay inserted write batches past a failing "
+                 "one; replaying the WALs serially");
+  TEST_SYNC_POINT_CALLBACK("DBImpl::RecoverLogFiles:ReplaySerially",
+                           /*arg=*/nullptr);
+  // The version edits of the parallel replay were dropped with it, so the
+  // files it flushed are in no version, and are deleted as obsolete once the
+  // DB is open. The last sequence was only advanced past complete WALs,
+  // which the serial replay inserts the same way.
+  for (auto cfd : *versions_->GetColumnFamilySet()) {
+    cfd->CreateNewMemtable(*cfd->GetLatestMutableCFOptions(),
+                           versions_->LastSequence());
+  }
+  flush_scheduler_.Clear();
+  trim_history_scheduler_.Clear();
+  *next_sequence = initial_next_sequence;
+  if (corrupted_wal_found != nullptr) {
+    *corrupted_wal_found = false;
+  }
+  return RecoverLogFilesImpl(wal_numbers, next_sequence, read_only,
+                             corrupted_wal_found, recovery_ctx,
+                             false /* allow_parallel */, &replay_serially);
+}
+
+// REQUIRES: wal_numbers are sorted in ascending order
+rocksdb_rs::status::Status DBImpl::RecoverLogFilesImpl(
+    const std::vector<uint64_t>& wal_numbers, SequenceNumber* next_sequence,
+    bool read_only, bool* corrupted_wal_found, RecoveryContext* recovery_ctx,
+    bool allow_parallel, bool* replay_serially) {
   struct LogReporter : public log::Reader::Reporter {
     Env* env;
     Logger* info_log;
@@ -1149,6 +1406,21 @@ rocksdb_rs::status::Status DBImpl::RecoverLogFiles(
   bool flushed = false;
   uint64_t corrupted_wal_number = kMaxSequenceNumber;
   uint64_t min_wal_number = MinLogNumberToKeep();
+  // Parallel replay needs the write batches to take consecutive sequence
+  // numbers, and rules out recovered prepared transactions, which span
+  // several batches.
+  const int wal_recovery_threads =
+      !allow_parallel || allow_2pc() || seq_per_batch_ || !batch_per_txn_
+          ? 1
+          : std::max(immutable_db_options_.wal_recovery_threads, 1);
+  // Memtables are partitioned among the insert threads by column family
+  const int wal_insert_threads = static_cast<int>(std::min(
+      static_cast<size_t>(wal_recovery_threads),
+      versions_->GetColumnFamilySet()->NumberOfColumnFamilies()));
+  std::unique_ptr<RecoveryInsertThreads> insert_threads;
+  if (wal_insert_threads > 1) {
+    insert_threads.reset(new RecoveryInsertThreads(wal_insert_threads));
+  }
   if (!allow_2pc()) {
     // In non-2pc mode, we skip WALs that do not back unflushed data.
     min_wal_number =
@@ -1224,8 +1496,24 @@ rocksdb_rs::status::Status DBImpl::RecoverLogFiles(
     // paranoid_checks==false so that corruptions cause entire commits
     // to be skipped instead of propagating bad information (like overly
     // large sequence numbers).
+    // With parallel recovery, the reader runs ahead on a prefetcher thread,
+    // and the prefetcher forwards the corruptions to `reporter`.
+    std::unique_ptr<log::RecordPrefetcher> prefetcher;
+    if (wal_recovery_threads > 1) {
+      prefetcher.reset(
+          new log::RecordPrefetcher(kParallelRecoveryPrefetchRecords));
+    }
     log::Reader reader(immutable_db_options_.info_log, std::move(file_reader),
-                       &reporter, true /*checksum*/, wal_number);
+                       prefetcher ? static_cast<log::Reader::Reporter*>(
+                                        prefetcher.get())
+                                  : &reporter,
+                       true /*checksum*/, wal_number);
+    // The prefetcher must stop reading before the reader goes away
+    Defer stop_prefetcher([&prefetcher]() {
+      if (prefetcher) {
+        prefetcher->Stop();
+      }
+    });
 
     // Determine if we should tolerate incomplete records at the tail end of the
     // Read all the records and add to a memtable
@@ -1235,13 +1523,93 @@ rocksdb_rs::status::Status DBImpl::RecoverLogFiles(
     const UnorderedMap<uint32_t, size_t>& running_ts_sz =
         versions_->GetRunningColumnFamiliesTimestampSize();
 
+    // we can do this because this is called before client has access to the
+    // DB and there is only a single thread operating on DB
+    auto flush_scheduled_memtables = [&]() -> rocksdb_rs::status::Status {
+      ColumnFamilyData* cfd;
+
+      while ((cfd = flush_scheduler_.TakeNextColumnFamily()) != nullptr) {
+        cfd->UnrefAndTryDelete();
+        // If this asserts, it means that InsertInto failed in
+        // filtering updates to already-flushed column families
+        assert(cfd->GetLogNumber() <= wal_number);
+        auto iter = version_edits.find(cfd->GetID());
+        assert(iter != version_edits.end());
+        VersionEdit* edit = &iter->second;
+        rocksdb_rs::status::Status s =
+            WriteLevel0TableForRecovery(job_id, cfd, cfd->mem(), edit);
+        if (!s.ok()) {
+          return s;
+        }
+        flushed = true;
+
+        cfd->CreateNewMemtable(*cfd->GetLatestMutableCFOptions(),
+                               *next_sequence);
+      }
+      return rocksdb_rs::status::Status_OK();
+    };
+
+    // Write batches read with parallel recovery but not yet inserted into
+    // memtables, and the size of their WAL records.
+    std::vector<WriteBatch> pending_batches;
+    std::vector<size_t> pending_record_sizes;
+    size_t pending_bytes = 0;
+    // Inserts the pending batches, then handles failures and full memtables
+    // as the serial replay does after each batch. Returns a non-ok status if
+    // recovery must fail right away.
+    auto insert_pending_batches = [&]() -> rocksdb_rs::status::Status {
+      if (pending_batches.empty()) {
+        return rocksdb_rs::status::Status_OK();
+      }
+      bool has_valid_writes = false;
+      std::vector<RecoveredBatchFailure> failures;
+      bool inserted_past_failure = false;
+      InsertRecoveredBatchesInParallel(
+          pending_batches, wal_number, insert_threads.get(),
+          reporter.status != nullptr /* stop_on_error */, &has_valid_writes,
+          &failures, &inserted_past_failure);
+      if (inserted_past_failure) {
+        *replay_serially = true;
+        return rocksdb_rs::status::Status_Incomplete(
+            "WAL replay failed after later write batches were inserted in "
+            "parallel",
+            *failures.front().status.ToString());
+      }
+      for (size_t i = 0; i < failures.size() && status.ok(); ++i) {
+        if (i > 0 && failures[i].batch_index == failures[i - 1].batch_index) {
+          continue;
+        }
+        // We are treating this as a failure while reading since we read valid
+        // blocks that do not form coherent data
+        reporter.Corruption(pending_record_sizes[failures[i].batch_index],
+                            failures[i].status);
+        if (!status.ok()) {
+          // Replay stops at this batch
+          *next_sequence = failures[i].next_sequence;
+        }
+      }
+      pending_batches.clear();
+      pending_record_sizes.clear();
+      pending_bytes = 0;
+      if (status.ok() && has_valid_writes && !read_only) {
+        return flush_scheduled_memtables();
+      }
+      return rocksdb_rs::status::Status_OK();
+    };
+
     TEST_SYNC_POINT_CALLBACK("DBImpl::RecoverLogFiles:BeforeReadWal",
                              /*arg=*/nullptr);
+    if (prefetcher) {
+      prefetcher->Start(&reader, immutable_db_options_.wal_recovery_mode);
+    }
     uint64_t record_checksum;
     while (!stop_replay_by_wal_filter &&
-           reader.ReadRecord(&record, &scratch,
+           (prefetcher ? prefetcher->ReadRecord(&record, &record_checksum,
+                                                &reporter)
+                       : reader.ReadRecord(
+                             &record, &scratch,
                              immutable_db_options_.wal_recovery_mode,
-                             &record_checksum) &&
+                             &record_checksum)) &&
            status.ok()) {
       if (record.size() < WriteBatchInternal::kHeader) {
         reporter.Corruption(
@@ -1260,7 +1628,8 @@ rocksdb_rs::status::Status DBImpl::RecoverLogFiles(
       }
 
       const UnorderedMap<uint32_t, size_t>& record_ts_sz =
-          reader.GetRecordedTimestampSize();
+          prefetcher ? prefetcher->GetRecordedTimestampSize()
+                     : reader.GetRecordedTimestampSize();
       // TODO(yuzhangyu): update mode to kReconcileInconsistency when user
       // comparator can be changed.
       status = HandleWriteBatchTimestampSizeDifference(
@@ -1305,6 +1674,25 @@ rocksdb_rs::status::Status DBImpl::RecoverLogFiles(
         continue;
       }
 
+      if (insert_threads) {
+        // Inserted with the next round. Every write of the batch takes a
+        // sequence number, including the ones ignored below.
+        *next_sequence = WriteBatchInternal::Sequence(&batch) +
+                         WriteBatchInternal::Count(&batch);
+        pending_bytes += record.size();
+        pending_record_sizes.push_back(record.size());
+        pending_batches.push_back(std::move(batch));
+        if (pending_bytes >= kParallelRecoveryRoundBytes) {
+          rocksdb_rs::status::Status s = insert_pending_batches();
+          if (!s.ok()) {
+            // Reflect errors immediately so that conditions like full
+            // file-systems cause the DB::Open() to fail.
+            return s;
+          }
+        }
+        continue;
+      }
+
       // If column family was not found, it might mean that the WAL write
       // batch references to the column family that was dropped after the
       // insert. We don't want to fail the whole write batch in that case --
@@ -1316,6 +1704,9 @@ rocksdb_rs::status::Status DBImpl::RecoverLogFiles(
           &trim_history_scheduler_, true, wal_number, this,
           false /* concurrent_memtable_writes */, next_sequence,
           &has_valid_writes, seq_per_batch_, batch_per_txn_);
+      std::pair<const WriteBatch*, rocksdb_rs::status::Status*> cb_arg(
+          &batch, &status);
+      TEST_SYNC_POINT_CALLBACK("DBImpl::RecoverLogFiles:AfterInsert", &cb_arg);
       MaybeIgnoreError(&status);
       if (!status.ok()) {
         // We are treating this as a failure while reading since we read valid
@@ -1325,32 +1716,29 @@ rocksdb_rs::status::Status DBImpl::RecoverLogFiles(
       }
 
       if (has_valid_writes && !read_only) {
-        // we can do this because this is called before client has access to the
-        // DB and there is only a single thread operating on DB
-        ColumnFamilyData* cfd;
-
-        while ((cfd = flush_scheduler_.TakeNextColumnFamily()) != nullptr) {
-          cfd->UnrefAndTryDelete();
-          // If this asserts, it means that InsertInto failed in
-          // filtering updates to already-flushed column families
-          assert(cfd->GetLogNumber() <= wal_number);
-          auto iter = version_edits.find(cfd->GetID());
-          assert(iter != version_edits.end());
-          VersionEdit* edit = &iter->second;
-          status = WriteLevel0TableForRecovery(job_id, cfd, cfd->mem(), edit);
-          if (!status.ok()) {
-            // Reflect errors immediately so that conditions like full
-            // file-systems cause the DB::Open() to fail.
-            return status;
-          }
-          flushed = true;
-
-          cfd->CreateNewMemtable(*cfd->GetLatestMutableCFOptions(),
-                                 *next_sequence);
+        status = flush_scheduled_memtables();
+        if (!status.ok()) {
+          // Reflect errors immediately so that conditions like full
+          // file-systems cause the DB::Open() to fail.
+          return status;
         }
       }
     }
 
+    if (!pending_batches.empty()) {
+      // The pending batches precede any read error, which is only reported if
+      // inserting them does not fail first.
+      rocksdb_rs::status::Status read_status = std::move(status);
+      status = rocksdb_rs::status::Status_OK();
+      rocksdb_rs::status::Status s = insert_pending_batches();
+      if (!s.ok()) {
+        return s;
+      }
+      if (status.ok()) {
+        status = std::move(read_status);
+      }
+    }
+
     if (!status.ok()) {
       if (status.IsNotSupported()) {
         // We should not treat NotSupported as corruption. It is rather a clear
@@ -1946,7 +2334,11 @@ rocksdb_rs::io_status::IOStatus DBImpl::CreateWAL(uint64_t log_file_num,
                                immutable_db_options_.recycle_log_file_num > 0,
                                immutable_db_options_.manual_wal_flush,
                                immutable_db_options_.wal_compression);
-    io_s = (*new_log)->AddCompressionTypeRecord();
+    std::string compression_dict;
+    if (wal_compression_dict_builder_) {
+      compression_dict = wal_compression_dict_builder_->GetDictionary();
+    }
+    io_s = (*new_log)->AddCompressionTypeRecord(compression_dict);
   }
   return io_s;
 }
@@ -2282,6 +2674,11 @@ rocksdb_rs::status::Status DBImpl::Open(
   if (s.ok()) {
     s = impl->RegisterRecordSeqnoTimeWorker();
   }
+  if (s.ok() && impl->immutable_db_options_.wal_group_commit) {
+    impl->wal_sync_thread_.reset(new WalSyncThread(
+        [impl]() { return impl->SyncWAL(); },
+        [impl]() { return impl->versions_->LastSequence(); }));
+  }
   if (!s.ok()) {
     for (auto* h : *handles) {
       delete h;
@@ -224,6 +224,21 @@ rocksdb_rs::status::Status DBImpl::WriteImpl(
     return rocksdb_rs::status::Status_InvalidArgument(
         "`WriteOptions::protection_bytes_per_key` must be zero or eight");
   }
+  if (wal_sync_thread_ && write_options.sync && !write_options.disableWAL) {
+    // Append without syncing, then wait for the WAL sync thread to cover
+    // the write. Once the write returns, LastSequence() is at least its
+    // sequence number, and every write up to there is in the WAL.
+    WriteOptions no_sync_options(write_options);
+    no_sync_options.sync = false;
+    rocksdb_rs::status::Status s = WriteImpl(
+        no_sync_options, my_batch, callback, log_used, log_ref,
+        disable_memtable, seq_used, batch_cnt, pre_release_callback,
+        post_memtable_callback);
+    if (!s.ok()) {
+      return s;
+    }
+    return wal_sync_thread_->WaitForSync(versions_->LastSequence());
+  }
   // TODO: this use of operator bool on `tracer_` can avoid unnecessary lock
   // grabs but does not seem thread-safe.
   if (tracer_) {
@@ -1355,6 +1370,9 @@ rocksdb_rs::io_status::IOStatus DBImpl::WriteToWAL(
     return io_s;
   }
   io_s = log_writer->AddRecord(log_entry, rate_limiter_priority);
+  if (wal_compression_dict_builder_) {
+    wal_compression_dict_builder_->AddSample(log_entry);
+  }
 
   if (UNLIKELY(needs_locking)) {
     log_write_mutex_.Unlock();
@@ -12,6 +12,7 @@
 #include "port/stack_trace.h"
 #include "rocksdb/memtablerep.h"
 #include "rocksdb/slice_transform.h"
+#include "table/scoped_arena_iterator.h"
 
 namespace rocksdb {
 
@@ -278,6 +279,249 @@ TEST_F(DBMemTableTest, ConcurrentMergeWrite) {
   delete mem;
 }
 
+// Verify that the hash based memtable reps support concurrent writes, including
+// while hash linked list buckets are converted to skip lists
+TEST_F(DBMemTableTest, ConcurrentHashRepWrite) {
+  const int kNumThreads = 4;
+  const int kNumPrefixes = 8;
+  const int kKeysPerPrefixPerThread = 100;
+  InternalKeyComparator cmp(BytewiseComparator());
+  std::vector<std::shared_ptr<MemTableRepFactory>> factories;
+  factories.emplace_back(NewHashSkipListRepFactory(4 /* bucket_count */));
+  factories.emplace_back(NewHashLinkListRepFactory(
+      4 /* bucket_count */, 0 /* huge_page_tlb_size */,
+      0 /* bucket_entries_logging_threshold */,
+      false /* if_log_bucket_dist_when_flash */,
+      3 /* threshold_use_skiplist */));
+  for (auto& factory : factories) {
+    Options options;
+    options.memtable_factory = factory;
+    options.prefix_extractor.reset(NewFixedPrefixTransform(3));
+    options.allow_concurrent_memtable_write = true;
+    ImmutableOptions ioptions(options);
+    WriteBufferManager wb(options.db_write_buffer_size);
+    MemTable* mem = new MemTable(cmp, ioptions, MutableCFOptions(options), &wb,
+                                 kMaxSequenceNumber, 0 /* column_family_id */);
+
+    auto key_of = [](int prefix, int i) {
+      char buf[16];
+      snprintf(buf, sizeof(buf), "p%d_%05d", prefix, i);
+      return std::string(buf);
+    };
+    std::vector<port::Thread> threads;
+    for (int t = 0; t < kNumThreads; t++) {
+      threads.emplace_back([&, t]() {
+        MemTablePostProcessInfo post_process_info;
+        for (int i = 0; i < kKeysPerPrefixPerThread; i++) {
+          for (int prefix = 0; prefix < kNumPrefixes; prefix++) {
+            int k = i * kNumThreads + t;
+            SequenceNumber seq =
+                prefix * kNumThreads * kKeysPerPrefixPerThread + k + 1;
+            ASSERT_OK(mem->Add(seq, kTypeValue, key_of(prefix, k),
+                               key_of(prefix, k), nullptr /* kv_prot_info */,
+                               true, &post_process_info));
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    ReadOptions roptions;
+    for (int prefix = 0; prefix < kNumPrefixes; prefix++) {
+      for (int k = 0; k < kNumThreads * kKeysPerPrefixPerThread; k++) {
+        rocksdb_rs::status::Status status = rocksdb_rs::status::Status_new();
+        std::string value;
+        MergeContext merge_context;
+        SequenceNumber max_covering_tombstone_seq = 0;
+        LookupKey lkey(key_of(prefix, k), kMaxSequenceNumber);
+        ASSERT_TRUE(mem->Get(lkey, &value, /*columns=*/nullptr,
+                             /*timestamp=*/nullptr, &status, &merge_context,
+                             &max_covering_tombstone_seq, roptions,
+                             false /* immutable_memtable */));
+        ASSERT_OK(status);
+        ASSERT_EQ(key_of(prefix, k), value);
+      }
+    }
+    delete mem;
+  }
+}
+
+TEST_F(DBMemTableTest, ConcurrentBTreeRepWrite) {
+  const int kNumThreads = 4;
+  const int kKeysPerThread = 5000;
+  InternalKeyComparator cmp(BytewiseComparator());
+  Options options;
+  options.memtable_factory = std::make_shared<BTreeRepFactory>();
+  options.allow_concurrent_memtable_write = true;
+  ImmutableOptions ioptions(options);
+  WriteBufferManager wb(options.db_write_buffer_size);
+  MemTable* mem = new MemTable(cmp, ioptions, MutableCFOptions(options), &wb,
+                               kMaxSequenceNumber, 0 /* column_family_id */);
+
+  auto key_of = [](int k) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "key%06d", k);
+    return std::string(buf);
+  };
+  // Scan while the tree grows, so that iterators run into splits
+  std::atomic<bool> writers_done(false);
+  port::Thread reader([&]() {
+    ReadOptions roptions;
+    while (!writers_done.load()) {
+      Arena arena;
+      ScopedArenaIterator iter(mem->NewIterator(roptions, &arena));
+      std::string prev;
+      for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+        std::string key = iter->key().ToString();
+        if (!prev.empty()) {
+          ASSERT_LT(cmp.Compare(prev, key), 0);
+        }
+        prev = std::move(key);
+      }
+    }
+  });
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([&, t]() {
+      MemTablePostProcessInfo post_process_info;
+      for (int i = 0; i < kKeysPerThread; i++) {
+        // Interleave the threads, and insert in an order scattered enough to
+        // split nodes all over the tree
+        int k = ((i * 7919) % kKeysPerThread) * kNumThreads + t;
+        ASSERT_OK(mem->Add(k + 1, kTypeValue, key_of(k), key_of(k),
+                           nullptr /* kv_prot_info */, true,
+                           &post_process_info));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  writers_done.store(true);
+  reader.join();
+
+  const int kNumKeys = kNumThreads * kKeysPerThread;
+  MemTablePostProcessInfo post_process_info;
+  ASSERT_TRUE(mem->Add(1, kTypeValue, key_of(0), key_of(0),
+                       nullptr /* kv_prot_info */, true, &post_process_info)
+                  .IsTryAgain());
+
+  ReadOptions roptions;
+  for (int k = 0; k < kNumKeys; k++) {
+    rocksdb_rs::status::Status status = rocksdb_rs::status::Status_new();
+    std::string value;
+    MergeContext merge_context;
+    SequenceNumber max_covering_tombstone_seq = 0;
+    LookupKey lkey(key_of(k), kMaxSequenceNumber);
+    ASSERT_TRUE(mem->Get(lkey, &value, /*columns=*/nullptr,
+                         /*timestamp=*/nullptr, &status, &merge_context,
+                         &max_covering_tombstone_seq, roptions,
+                         false /* immutable_memtable */));
+    ASSERT_OK(status);
+    ASSERT_EQ(key_of(k), value);
+  }
+
+  Arena arena;
+  ScopedArenaIterator iter(mem->NewIterator(roptions, &arena));
+  int k = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next(), k++) {
+    ASSERT_EQ(key_of(k), ExtractUserKey(iter->key()).ToString());
+  }
+  ASSERT_EQ(kNumKeys, k);
+  for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+    ASSERT_EQ(key_of(--k), ExtractUserKey(iter->key()).ToString());
+  }
+  ASSERT_EQ(0, k);
+
+  InternalKey target(key_of(kNumKeys / 2) + "a", kMaxSequenceNumber,
+                     kValueTypeForSeek);
+  iter->Seek(target.Encode());
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(key_of(kNumKeys / 2 + 1), ExtractUserKey(iter->key()).ToString());
+  iter->SeekForPrev(target.Encode());
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(key_of(kNumKeys / 2), ExtractUserKey(iter->key()).ToString());
+  iter->Prev();
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(key_of(kNumKeys / 2 - 1), ExtractUserKey(iter->key()).ToString());
+  iter.set(nullptr);
+  delete mem;
+}
+
+// Stress the first insertions into hash linked list buckets, where a single
+// entry bucket gets a header, with many threads racing on the same buckets
+TEST_F(DBMemTableTest, ConcurrentHashLinkListFirstInserts) {
+  const int kNumThreads = 16;
+  const int kNumPrefixes = 64;
+  const int kKeysPerPrefixPerThread = 3;
+  const int kNumRounds = 50;
+  InternalKeyComparator cmp(BytewiseComparator());
+  Options options;
+  options.memtable_factory.reset(NewHashLinkListRepFactory(
+      kNumPrefixes /* bucket_count */, 0 /* huge_page_tlb_size */,
+      0 /* bucket_entries_logging_threshold */,
+      false /* if_log_bucket_dist_when_flash */,
+      2 /* threshold_use_skiplist */));
+  options.prefix_extractor.reset(NewFixedPrefixTransform(4));
+  options.allow_concurrent_memtable_write = true;
+  ImmutableOptions ioptions(options);
+  WriteBufferManager wb(options.db_write_buffer_size);
+
+  auto key_of = [](int prefix, int i) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "p%03d_%05d", prefix, i);
+    return std::string(buf);
+  };
+  for (int round = 0; round < kNumRounds; round++) {
+    MemTable* mem = new MemTable(cmp, ioptions, MutableCFOptions(options), &wb,
+                                 kMaxSequenceNumber, 0 /* column_family_id */);
+    std::atomic<int> ready{0};
+    std::vector<port::Thread> threads;
+    for (int t = 0; t < kNumThreads; t++) {
+      threads.emplace_back([&, t]() {
+        // Start together so that the threads race on every bucket
+        ready.fetch_add(1);
+        while (ready.load() < kNumThreads) {
+        }
+        MemTablePostProcessInfo post_process_info;
+        for (int i = 0; i < kKeysPerPrefixPerThread; i++) {
+          for (int prefix = 0; prefix < kNumPrefixes; prefix++) {
+            int k = i * kNumThreads + t;
+            SequenceNumber seq =
+                prefix * kNumThreads * kKeysPerPrefixPerThread + k + 1;
+            ASSERT_OK(mem->Add(seq, kTypeValue, key_of(prefix, k),
+                               key_of(prefix, k), nullptr /* kv_prot_info */,
+                               true, &post_process_info));
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    ReadOptions roptions;
+    for (int prefix = 0; prefix < kNumPrefixes; prefix++) {
+      for (int k = 0; k < kNumThreads * kKeysPerPrefixPerThread; k++) {
+        rocksdb_rs::status::Status status = rocksdb_rs::status::Status_new();
+        std::string value;
+        MergeContext merge_context;
+        SequenceNumber max_covering_tombstone_seq = 0;
+        LookupKey lkey(key_of(prefix, k), kMaxSequenceNumber);
+        ASSERT_TRUE(mem->Get(lkey, &value, /*columns=*/nullptr,
+                             /*timestamp=*/nullptr, &status, &merge_context,
+                             &max_covering_tombstone_seq, roptions,
+                             false /* immutable_memtable */));
+        ASSERT_OK(status);
+        ASSERT_EQ(key_of(prefix, k), value);
+      }
+    }
+    delete mem;
+  }
+}
+
 TEST_F(DBMemTableTest, InsertWithHint) {
   Options options;
   options.allow_concurrent_memtable_write = false;
@@ -72,6 +72,44 @@ TEST_F(DBRangeDelTest, FlushOutputHasOnlyRangeTombstones) {
   } while (ChangeOptions(kRangeDelSkipConfigs));
 }
 
+TEST_F(DBRangeDelTest, MemtableMaxRangeDeletions) {
+  Options options = CurrentOptions();
+  options.memtable_max_range_deletions = 10;
+  DestroyAndReopen(options);
+
+  for (int i = 0; i < 9; ++i) {
+    ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                               Key(i), Key(i + 1)));
+  }
+  // Point writes do not count towards the limit
+  ASSERT_OK(Put(Key(100), "val"));
+  ASSERT_OK(Delete(Key(101)));
+  ASSERT_OK(dbfull()->TEST_WaitForFlushMemTable());
+  ASSERT_EQ(0, NumTableFilesAtLevel(0));
+
+  // The write reaching the limit schedules a flush, which the next write
+  // picks up
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                             Key(9), Key(10)));
+  ASSERT_OK(Put(Key(102), "val"));
+  ASSERT_OK(dbfull()->TEST_WaitForFlushMemTable());
+  ASSERT_EQ(1, NumTableFilesAtLevel(0));
+  ASSERT_EQ("val", Get(Key(100)));
+  ASSERT_EQ("val", Get(Key(102)));
+
+  // Memtables created after disabling the limit are not flushed early
+  ASSERT_OK(dbfull()->SetOptions({{"memtable_max_range_deletions", "0"}}));
+  ASSERT_OK(Flush());
+  ASSERT_EQ(2, NumTableFilesAtLevel(0));
+  for (int i = 0; i < 20; ++i) {
+    ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                               Key(i), Key(i + 1)));
+  }
+  ASSERT_OK(Put(Key(103), "val"));
+  ASSERT_OK(dbfull()->TEST_WaitForFlushMemTable());
+  ASSERT_EQ(2, NumTableFilesAtLevel(0));
+}
+
 TEST_F(DBRangeDelTest, DictionaryCompressionWithOnlyRangeTombstones) {
   Options opts = CurrentOptions();
   opts.compression_opts.max_dict_bytes = 16384;
@@ -7057,6 +7057,121 @@ TEST_F(DBTest, PinnableSliceAndRowCache) {
       1);
 }
 
+TEST_F(DBTest, HotKeyCache) {
+  Options options = CurrentOptions();
+  options.statistics = rocksdb::CreateDBStatistics();
+  options.hot_key_cache = NewLRUCache(1 << 20);
+  DestroyAndReopen(options);
+
+  ASSERT_OK(Put("foo", "v1"));
+  ASSERT_OK(Flush());
+
+  // Admitted on the second miss
+  for (int i = 0; i < HotKeyCache::kAdmitFrequency + 1; ++i) {
+    ASSERT_EQ(Get("foo"), "v1");
+  }
+  ASSERT_EQ(TestGetTickerCount(options, HOT_KEY_CACHE_MISS),
+            HotKeyCache::kAdmitFrequency);
+  ASSERT_EQ(TestGetTickerCount(options, HOT_KEY_CACHE_ADMISSION_REJECTED),
+            HotKeyCache::kAdmitFrequency - 1);
+  ASSERT_EQ(TestGetTickerCount(options, HOT_KEY_CACHE_HIT), 1);
+
+  // Writes invalidate the entry, but not for older snapshots
+  const Snapshot* snapshot = db_->GetSnapshot();
+  ASSERT_OK(Put("foo", "v2"));
+  ASSERT_EQ(Get("foo"), "v2");
+  ASSERT_EQ(Get("foo", snapshot), "v1");
+  ASSERT_EQ(Get("foo"), "v2");
+  ASSERT_EQ(TestGetTickerCount(options, HOT_KEY_CACHE_HIT), 2);
+  db_->ReleaseSnapshot(snapshot);
+
+  ASSERT_OK(Delete("foo"));
+  ASSERT_EQ(Get("foo"), "NOT_FOUND");
+
+  ASSERT_OK(Put("foo", "v3"));
+  ASSERT_EQ(Get("foo"), "v3");
+  ASSERT_EQ(Get("foo"), "v3");
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(), "a",
+                             "z"));
+  ASSERT_EQ(Get("foo"), "NOT_FOUND");
+
+  std::map<std::string, std::string> stats;
+  ASSERT_TRUE(db_->GetMapProperty(DB::Properties::kHotKeyCacheStats, &stats));
+  ASSERT_EQ(stats["hits"],
+            std::to_string(TestGetTickerCount(options, HOT_KEY_CACHE_HIT)));
+  ASSERT_EQ(stats["misses"],
+            std::to_string(TestGetTickerCount(options, HOT_KEY_CACHE_MISS)));
+}
+
+TEST_F(DBTest, HotKeyCacheIgnoreRangeDeletions) {
+  Options options = CurrentOptions();
+  options.statistics = rocksdb::CreateDBStatistics();
+  options.hot_key_cache = NewLRUCache(1 << 20);
+  DestroyAndReopen(options);
+
+  ASSERT_OK(Put("foo", "v1"));
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(), "a",
+                             "z"));
+  ASSERT_OK(Put("bar", "v1"));
+
+  // Reads ignoring range deletions see the deleted value, which must never
+  // be cached for the other reads
+  ReadOptions ro;
+  ro.ignore_range_deletions = true;
+  for (int i = 0; i < HotKeyCache::kAdmitFrequency + 1; ++i) {
+    std::string value;
+    ASSERT_OK(db_->Get(ro, "foo", &value));
+    ASSERT_EQ(value, "v1");
+  }
+  ASSERT_EQ(TestGetTickerCount(options, HOT_KEY_CACHE_MISS), 0);
+  for (int i = 0; i < HotKeyCache::kAdmitFrequency + 1; ++i) {
+    ASSERT_EQ(Get("foo"), "NOT_FOUND");
+  }
+}
+
+TEST_F(DBTest, HotKeyCacheSharedByTwoDBs) {
+  Options options = CurrentOptions();
+  options.hot_key_cache = NewLRUCache(1 << 20);
+  DestroyAndReopen(options);
+  const std::string dbname2 = test::PerThreadDBPath("hot_key_cache_db2");
+  ASSERT_OK(DestroyDB(dbname2, options));
+  DB* db2 = nullptr;
+  ASSERT_OK(DB::Open(options, dbname2, &db2));
+
+  ASSERT_OK(Put("foo", "db1"));
+  ASSERT_OK(db2->Put(WriteOptions(), "foo", "db2"));
+  // Both keys are admitted, in the default column family of each DB
+  for (int i = 0; i < HotKeyCache::kAdmitFrequency + 1; ++i) {
+    ASSERT_EQ(Get("foo"), "db1");
+    std::string value;
+    ASSERT_OK(db2->Get(ReadOptions(), "foo", &value));
+    ASSERT_EQ(value, "db2");
+  }
+
+  ASSERT_OK(db2->Close());
+  delete db2;
+  ASSERT_OK(DestroyDB(dbname2, options));
+}
+
+TEST_F(DBTest, HotKeyCacheAcrossReopen) {
+  Options options = CurrentOptions();
+  options.hot_key_cache = NewLRUCache(1 << 20);
+  DestroyAndReopen(options);
+
+  ASSERT_OK(Put("foo", "v1"));
+  for (int i = 0; i < HotKeyCache::kAdmitFrequency + 1; ++i) {
+    ASSERT_EQ(Get("foo"), "v1");
+  }
+  ASSERT_OK(Put("foo", "v2"));
+
+  // The entry of the closed DB is not visible to the reopened one, which
+  // does not know about the overwrite
+  Reopen(options);
+  for (int i = 0; i < HotKeyCache::kAdmitFrequency + 1; ++i) {
+    ASSERT_EQ(Get("foo"), "v2");
+  }
+}
+
 TEST_F(DBTest, ReusePinnableSlice) {
   Options options = CurrentOptions();
   options.statistics = rocksdb::CreateDBStatistics();
@@ -14,6 +14,7 @@
 #include "port/stack_trace.h"
 #include "rocksdb/file_system.h"
 #include "test_util/sync_point.h"
+#include "util/random.h"
 #include "utilities/fault_injection_env.h"
 #include "utilities/fault_injection_fs.h"
 
@@ -289,6 +290,53 @@ TEST_F(DBWALTest, SyncWALNotWaitWrite) {
   rocksdb::SyncPoint::GetInstance()->DisableProcessing();
 }
 
+TEST_F(DBWALTest, WalGroupCommit) {
+  Options options = CurrentOptions();
+  options.wal_group_commit = true;
+  options.create_if_missing = true;
+  DestroyAndReopen(options);
+
+  constexpr int kNumThreads = 8;
+  std::atomic<int> num_syncs{0};
+  // Hold the first sync until every writer has appended, so that the
+  // remaining writes all share the second one.
+  rocksdb::SyncPoint::GetInstance()->SetCallBack(
+      "WalSyncThread::BackgroundSync:BeforeSync", [&](void* /*arg*/) {
+        if (num_syncs.fetch_add(1) == 0) {
+          while (dbfull()->GetLatestSequenceNumber() < kNumThreads) {
+            env_->SleepForMicroseconds(100);
+          }
+        }
+      });
+  rocksdb::SyncPoint::GetInstance()->EnableProcessing();
+
+  WriteOptions wo;
+  wo.sync = true;
+  std::vector<port::Thread> threads;
+  for (int i = 0; i < kNumThreads; i++) {
+    threads.emplace_back([&, i]() {
+      ASSERT_OK(db_->Put(wo, Key(i), "v" + std::to_string(i)));
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  rocksdb::SyncPoint::GetInstance()->DisableProcessing();
+  rocksdb::SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  ASSERT_GE(num_syncs.load(), 1);
+  ASSERT_LE(num_syncs.load(), 2);
+
+  Reopen(options);
+  for (int i = 0; i < kNumThreads; i++) {
+    ASSERT_EQ("v" + std::to_string(i), Get(Key(i)));
+  }
+
+  // Not compatible with options that change how the WAL is written
+  options.enable_pipelined_write = true;
+  ASSERT_TRUE(TryReopen(options).IsInvalidArgument());
+}
+
 TEST_F(DBWALTest, Recover) {
   do {
     CreateAndReopenWithCF({"pikachu"}, CurrentOptions());
@@ -1287,6 +1335,44 @@ TEST_F(DBWALTest, RecoverWithLargeLog) {
   } while (ChangeWalOptions());
 }
 
+TEST_F(DBWALTest, RecoverInParallel) {
+  Options options = CurrentOptions();
+  options.merge_operator = MergeOperators::CreateStringAppendOperator();
+  CreateAndReopenWithCF({"one", "two", "three", "four"}, options);
+
+  // Each batch writes to several column families, which are recovered by
+  // different threads
+  Random rnd(301);
+  for (int i = 0; i < 2000; ++i) {
+    WriteBatch batch;
+    int cf = i % 5;
+    ASSERT_OK(batch.Put(handles_[cf], Key(i), rnd.RandomString(100)));
+    ASSERT_OK(batch.Merge(handles_[(cf + 1) % 5], Key(i % 10),
+                          std::to_string(i)));
+    if (i >= 5) {
+      ASSERT_OK(batch.Delete(handles_[cf], Key(i - 5)));
+    }
+    ASSERT_OK(db_->Write(WriteOptions(), &batch));
+  }
+  std::vector<std::string> expected;
+  for (int cf = 0; cf < 5; ++cf) {
+    expected.push_back(Contents(cf));
+  }
+  SequenceNumber expected_seq = db_->GetLatestSequenceNumber();
+
+  // Small memtables are flushed in the middle of recovery
+  options.write_buffer_size = 16 << 10;
+  options.arena_block_size = 4 << 10;
+  options.wal_recovery_threads = 3;
+  ReopenWithColumnFamilies({"default", "one", "two", "three", "four"},
+                           options);
+  ASSERT_EQ(expected_seq, db_->GetLatestSequenceNumber());
+  for (int cf = 0; cf < 5; ++cf) {
+    ASSERT_EQ(expected[cf], Contents(cf));
+    ASSERT_GT(NumTableFilesAtLevel(0, cf), 1);
+  }
+}
+
 // In https://reviews.facebook.net/D20661 we change
 // recovery behavior: previously for each log file each column family
 // memtable was flushed, even it was empty. Now it's changed:
@@ -1976,6 +2062,143 @@ TEST_P(DBWALTestWithParams, kPointInTimeRecovery) {
   }
 }
 
+TEST_F(DBWALTest, kPointInTimeRecoveryInParallel) {
+  const int maxkeys =
+      RecoveryTestHelper::kWALFilesCount * RecoveryTestHelper::kKeysPerWALFile;
+  const int wal_file_id = RecoveryTestHelper::kWALFileOffset +
+                          RecoveryTestHelper::kWALFilesCount / 2;
+
+  // Fill data for testing
+  Options options = CurrentOptions();
+  const size_t row_count = RecoveryTestHelper::FillData(this, &options);
+
+  // Corrupt a WAL in the middle
+  RecoveryTestHelper::CorruptWAL(this, options, /*off=*/.33, /*len%=*/.1,
+                                 wal_file_id);
+
+  // Verify
+  options.wal_recovery_mode = WALRecoveryMode::kPointInTimeRecovery;
+  options.wal_recovery_threads = 4;
+  options.create_if_missing = false;
+  ASSERT_OK(TryReopen(options));
+
+  // Only a prefix of the keys is recovered, as with serial replay
+  size_t recovered_row_count = RecoveryTestHelper::GetData(this);
+  ASSERT_LT(recovered_row_count, row_count);
+  bool expect_data = true;
+  for (size_t k = 0; k < maxkeys; ++k) {
+    bool found = Get("key" + std::to_string(k)) != "NOT_FOUND";
+    if (expect_data && !found) {
+      expect_data = false;
+    }
+    ASSERT_EQ(found, expect_data);
+  }
+  const size_t min = RecoveryTestHelper::kKeysPerWALFile *
+                     (wal_file_id - RecoveryTestHelper::kWALFileOffset);
+  const size_t max = RecoveryTestHelper::kKeysPerWALFile *
+                     (wal_file_id - RecoveryTestHelper::kWALFileOffset + 1);
+  ASSERT_GE(recovered_row_count, min);
+  ASSERT_LE(recovered_row_count, max);
+}
+
+TEST_F(DBWALTest, kPointInTimeRecoveryInParallelWithColumnFamilies) {
+  const std::vector<std::string> cfs = {"default", "one", "two", "three",
+                                        "four"};
+  const int kNumBatches = 1000;
+  const int kFailedBatch = 500;
+  SequenceNumber failed_seq = 0;
+  // Every batch writes to all the column families, so all the insert
+  // threads have writes in every batch
+  auto write_batches = [&]() {
+    Options options = CurrentOptions();
+    DestroyAndReopen(options);
+    CreateAndReopenWithCF({"one", "two", "three", "four"}, options);
+    for (int i = 0; i < kNumBatches; ++i) {
+      if (i == kFailedBatch) {
+        failed_seq = db_->GetLatestSequenceNumber() + 1;
+      }
+      WriteBatch batch;
+      for (int cf = 0; cf < 5; ++cf) {
+        ASSERT_OK(batch.Put(handles_[cf], Key(i), "v"));
+      }
+      ASSERT_OK(db_->Write(WriteOptions(), &batch));
+    }
+    Close();
+  };
+  // Recovery stops at the failing batch, as it does serially
+  auto verify_recovered = [&]() {
+    ASSERT_LT(db_->GetLatestSequenceNumber(), failed_seq + 5);
+    for (int cf = 0; cf < 5; ++cf) {
+      for (int i = 0; i < kNumBatches; ++i) {
+        if (i < kFailedBatch) {
+          ASSERT_EQ("v", Get(cf, Key(i)));
+        } else if (i > kFailedBatch) {
+          ASSERT_EQ("NOT_FOUND", Get(cf, Key(i)));
+        }
+      }
+    }
+  };
+  Options options = CurrentOptions();
+  options.wal_recovery_mode = WALRecoveryMode::kPointInTimeRecovery;
+  options.wal_recovery_threads = 4;
+  auto inject_failure = [&](void* arg) {
+    auto* batch_and_status = static_cast<
+        std::pair<const WriteBatch*, rocksdb_rs::status::Status*>*>(arg);
+    if (WriteBatchInternal::Sequence(batch_and_status->first) == failed_seq) {
+      *batch_and_status->second =
+          rocksdb_rs::status::Status_Corruption("injected");
+    }
+  };
+
+  // One thread fails on a batch after another one inserted the next batch.
+  // The memtables are dropped and the WAL replayed again serially.
+  write_batches();
+  const SequenceNumber next_batch_seq = failed_seq + 5;
+  std::atomic<bool> failed{false};
+  std::atomic<bool> next_batch_inserted{false};
+  int num_serial_replays = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::InsertRecoveredBatchesInParallel:AfterInsert", [&](void* arg) {
+        auto* batch_and_status = static_cast<
+            std::pair<const WriteBatch*, rocksdb_rs::status::Status*>*>(arg);
+        SequenceNumber seq =
+            WriteBatchInternal::Sequence(batch_and_status->first);
+        if (seq == next_batch_seq) {
+          next_batch_inserted = true;
+        } else if (seq == failed_seq && !failed.exchange(true)) {
+          while (!next_batch_inserted) {
+            std::this_thread::yield();
+          }
+          *batch_and_status->second =
+              rocksdb_rs::status::Status_Corruption("injected");
+        }
+      });
+  SyncPoint::GetInstance()->SetCallBack("DBImpl::RecoverLogFiles:AfterInsert",
+                                        inject_failure);
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::RecoverLogFiles:ReplaySerially",
+      [&](void* /*arg*/) { num_serial_replays++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+  ASSERT_OK(TryReopenWithColumnFamilies(cfs, options));
+  ASSERT_EQ(num_serial_replays, 1);
+  verify_recovered();
+  SyncPoint::GetInstance()->DisableProcessing();
+  Close();
+
+  // All the threads fail on the same batch: recovery stops there without
+  // replaying serially.
+  write_batches();
+  num_serial_replays = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::InsertRecoveredBatchesInParallel:AfterInsert", inject_failure);
+  SyncPoint::GetInstance()->EnableProcessing();
+  ASSERT_OK(TryReopenWithColumnFamilies(cfs, options));
+  ASSERT_EQ(num_serial_replays, 0);
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  verify_recovered();
+}
+
 // Test scope:
 // - We expect to open the data store under all scenarios
 // - We expect to have recovered records past the corruption zone
@@ -2626,6 +2849,43 @@ TEST_F(DBWALTest, GetCompressedWalsAfterSync) {
   ASSERT_OK(s);
 }
 
+TEST_F(DBWALTest, WalCompressionDictionary) {
+  if (!StreamingCompressionTypeSupported(
+          rocksdb_rs::compression_type::CompressionType::kZSTD)) {
+    ROCKSDB_GTEST_BYPASS("stream compression not present");
+    return;
+  }
+  Options options = CurrentOptions();
+  options.env = env_;
+  options.avoid_flush_during_recovery = true;
+  options.wal_compression =
+      rocksdb_rs::compression_type::CompressionType::kZSTD;
+  options.wal_compression_max_dict_bytes = 64 * 1024;
+  ASSERT_TRUE(TryReopen(options).IsInvalidArgument());
+
+  options.wal_compression_max_dict_bytes = 1024;
+  DestroyAndReopen(options);
+
+  // Enough records for a dictionary to be trained for the next WAL
+  Random rnd(301);
+  std::vector<std::string> values;
+  for (int i = 0; i < 200; ++i) {
+    values.push_back(rnd.RandomString(10) + std::string(1000, 'v'));
+    ASSERT_OK(Put(Key(i), values.back()));
+  }
+  ASSERT_OK(dbfull()->TEST_SwitchWAL());
+  for (int i = 200; i < 400; ++i) {
+    values.push_back(rnd.RandomString(10) + std::string(1000, 'w'));
+    ASSERT_OK(Put(Key(i), values.back()));
+  }
+
+  // Both WALs are recovered, the second one with its dictionary
+  Reopen(options);
+  for (int i = 0; i < 400; ++i) {
+    ASSERT_EQ(values[i], Get(Key(i)));
+  }
+}
+
 TEST_F(DBWALTest, EmptyWalReopenTest) {
   Options options = CurrentOptions();
   options.env = env_;
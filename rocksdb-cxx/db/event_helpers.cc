@@ -135,6 +135,10 @@ void EventHelpers::LogAndNotifyTableFileCreationFinished(
               << table_properties.slow_compression_estimated_data_size
               << "fast_compression_estimated_data_size"
               << table_properties.fast_compression_estimated_data_size
+              << "num_adaptive_fast_data_blocks"
+              << table_properties.num_adaptive_fast_data_blocks
+              << "num_adaptive_uncompressed_data_blocks"
+              << table_properties.num_adaptive_uncompressed_data_blocks
               << "db_id" << table_properties.db_id << "db_session_id"
               << table_properties.db_session_id << "orig_file_number"
               << table_properties.orig_file_number << "seqno_to_time_mapping";
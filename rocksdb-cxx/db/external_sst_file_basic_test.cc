@@ -690,6 +690,88 @@ TEST_F(ExternalSSTFileBasicTest, NoCopy) {
   }
 }
 
+TEST_F(ExternalSSTFileBasicTest, IngestManyFilesInParallel) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  DestroyAndReopen(options);
+
+  // Only the file with keys 50 => 59 overlaps with the DB
+  ASSERT_OK(Put(Key(55), "db_val"));
+  ASSERT_OK(Flush());
+  const SequenceNumber last_seqno = db_->GetLatestSequenceNumber();
+
+  const int kNumFiles = 32;
+  std::vector<std::string> files;
+  SstFileWriter sst_file_writer(EnvOptions(), options);
+  for (int i = 0; i < kNumFiles; i++) {
+    std::string file = sst_files_dir_ + "file" + std::to_string(i) + ".sst";
+    ASSERT_OK(sst_file_writer.Open(file));
+    for (int k = i * 10; k < (i + 1) * 10; k++) {
+      ASSERT_OK(sst_file_writer.Put(Key(k), Key(k) + "_val"));
+    }
+    ASSERT_OK(sst_file_writer.Finish());
+    files.push_back(file);
+  }
+
+  IngestExternalFileOptions ifo;
+  ifo.max_threads = 8;
+  // A missing file fails the ingestion of all the files
+  std::vector<std::string> files_with_missing = files;
+  files_with_missing.push_back(sst_files_dir_ + "missing.sst");
+  ASSERT_NOK(db_->IngestExternalFile(files_with_missing, ifo));
+  ASSERT_EQ(Get(Key(0)), "NOT_FOUND");
+  ASSERT_EQ("1", FilesPerLevel());
+
+  ASSERT_OK(db_->IngestExternalFile(files, ifo));
+  // The overlapping file goes to L0 with a new sequence number, the others to
+  // the bottommost level
+  ASSERT_EQ(db_->GetLatestSequenceNumber(), last_seqno + 1);
+  ASSERT_EQ("2,0,0,0,0,0,31", FilesPerLevel());
+  for (int k = 0; k < kNumFiles * 10; k++) {
+    ASSERT_EQ(Get(Key(k)), Key(k) + "_val");
+  }
+}
+
+TEST_F(ExternalSSTFileBasicTest, IngestAfterFlushChecksOverlapsUnlocked) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  DestroyAndReopen(options);
+
+  // The flush done for the ingestion changes the levels after Prepare()
+  ASSERT_OK(Put(Key(55), "db_val"));
+
+  const int kNumFiles = 8;
+  std::vector<std::string> files;
+  SstFileWriter sst_file_writer(EnvOptions(), options);
+  for (int i = 0; i < kNumFiles; i++) {
+    std::string file = sst_files_dir_ + "file" + std::to_string(i) + ".sst";
+    ASSERT_OK(sst_file_writer.Open(file));
+    for (int k = i * 10; k < (i + 1) * 10; k++) {
+      ASSERT_OK(sst_file_writer.Put(Key(k), Key(k) + "_val"));
+    }
+    ASSERT_OK(sst_file_writer.Finish());
+    files.push_back(file);
+  }
+
+  int num_unlocked_checks = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "ExternalSstFileIngestionJob::UpdateLevelOverlaps:MutexUnlocked",
+      [&](void* /*arg*/) { num_unlocked_checks++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  IngestExternalFileOptions ifo;
+  ASSERT_OK(db_->IngestExternalFile(files, ifo));
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  ASSERT_EQ(num_unlocked_checks, 1);
+  // The file with keys 50 => 59 overlaps with the flushed file in L0
+  ASSERT_EQ("2,0,0,0,0,0,7", FilesPerLevel());
+  for (int k = 0; k < kNumFiles * 10; k++) {
+    ASSERT_EQ(Get(Key(k)), Key(k) + "_val");
+  }
+}
+
 TEST_P(ExternalSSTFileBasicTest, IngestFileWithGlobalSeqnoPickedSeqno) {
   bool write_global_seqno = std::get<0>(GetParam());
   bool verify_checksums_before_ingest = std::get<1>(GetParam());
@@ -6,7 +6,9 @@
 #include "db/external_sst_file_ingestion_job.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cinttypes>
+#include <functional>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -16,6 +18,7 @@
 #include "file/file_util.h"
 #include "file/random_access_file_reader.h"
 #include "logging/logging.h"
+#include "port/port.h"
 #include "table/merging_iterator.h"
 #include "table/scoped_arena_iterator.h"
 #include "table/sst_file_writer_collectors.h"
@@ -26,6 +29,56 @@
 
 namespace rocksdb {
 
+namespace {
+
+// Calls `func` for the indexes 0 to n - 1 on up to `max_threads` threads,
+// including the calling one, and returns the first non-OK status by index.
+// As with a loop stopping at the first error, the indexes after a failed one
+// may be skipped.
+rocksdb_rs::status::Status ForEachFileInParallel(
+    size_t n, int max_threads,
+    const std::function<rocksdb_rs::status::Status(size_t)>& func) {
+  std::vector<rocksdb_rs::status::Status> statuses;
+  for (size_t i = 0; i < n; i++) {
+    statuses.emplace_back(rocksdb_rs::status::Status_OK());
+  }
+  std::atomic<size_t> next_idx(0);
+  std::atomic<bool> failed(false);
+  std::function<void()> process_func([&]() {
+    while (!failed.load(std::memory_order_relaxed)) {
+      size_t idx = next_idx.fetch_add(1);
+      if (idx >= n) {
+        break;
+      }
+      statuses[idx] = func(idx);
+      if (!statuses[idx].ok()) {
+        failed.store(true, std::memory_order_relaxed);
+      }
+    }
+  });
+
+  std::vector<port::Thread> threads;
+  const size_t num_threads =
+      std::min(n, static_cast<size_t>(std::max(max_threads, 1)));
+  for (size_t i = 1; i < num_threads; i++) {
+    threads.emplace_back(process_func);
+  }
+  process_func();
+  for (auto& t : threads) {
+    t.join();
+  }
+  rocksdb_rs::status::Status ret = rocksdb_rs::status::Status_new();
+  for (const auto& s : statuses) {
+    if (!s.ok()) {
+      ret.copy_from(s);
+      break;
+    }
+  }
+  return ret;
+}
+
+}  // namespace
+
 rocksdb_rs::status::Status ExternalSstFileIngestionJob::Prepare(
     const std::vector<std::string>& external_files_paths,
     const std::vector<std::string>& files_checksums,
@@ -35,34 +88,40 @@ rocksdb_rs::status::Status ExternalSstFileIngestionJob::Prepare(
   rocksdb_rs::status::Status status = rocksdb_rs::status::Status_new();
 
   // Read the information of files we are ingesting
-  for (const std::string& file_path : external_files_paths) {
-    IngestedFileInfo file_to_ingest;
-    status =
-        GetIngestedFileInfo(file_path, next_file_number++, &file_to_ingest, sv);
-    if (!status.ok()) {
-      return status;
-    }
-
-    if (file_to_ingest.cf_id !=
-            TablePropertiesCollectorFactory::Context::kUnknownColumnFamily &&
-        file_to_ingest.cf_id != cfd_->GetID()) {
-      return rocksdb_rs::status::Status_InvalidArgument(
-          "External file column family id don't match");
-    }
+  files_to_ingest_.resize(external_files_paths.size());
+  status = ForEachFileInParallel(
+      files_to_ingest_.size(), ingestion_options_.max_threads,
+      [&](size_t i) -> rocksdb_rs::status::Status {
+        IngestedFileInfo& file_to_ingest = files_to_ingest_[i];
+        rocksdb_rs::status::Status s =
+            GetIngestedFileInfo(external_files_paths[i], next_file_number + i,
+                                &file_to_ingest, sv);
+        if (!s.ok()) {
+          return s;
+        }
 
-    if (file_to_ingest.num_entries == 0 &&
-        file_to_ingest.num_range_deletions == 0) {
-      return rocksdb_rs::status::Status_InvalidArgument(
-          "File contain no entries");
-    }
+        if (file_to_ingest.cf_id != TablePropertiesCollectorFactory::Context::
+                                        kUnknownColumnFamily &&
+            file_to_ingest.cf_id != cfd_->GetID()) {
+          return rocksdb_rs::status::Status_InvalidArgument(
+              "External file column family id don't match");
+        }
 
-    if (!file_to_ingest.smallest_internal_key.Valid() ||
-        !file_to_ingest.largest_internal_key.Valid()) {
-      return rocksdb_rs::status::Status_Corruption(
-          "Generated table have corrupted keys");
-    }
+        if (file_to_ingest.num_entries == 0 &&
+            file_to_ingest.num_range_deletions == 0) {
+          return rocksdb_rs::status::Status_InvalidArgument(
+              "File contain no entries");
+        }
 
-    files_to_ingest_.emplace_back(std::move(file_to_ingest));
+        if (!file_to_ingest.smallest_internal_key.Valid() ||
+            !file_to_ingest.largest_internal_key.Valid()) {
+          return rocksdb_rs::status::Status_Corruption(
+              "Generated table have corrupted keys");
+        }
+        return rocksdb_rs::status::Status_OK();
+      });
+  if (!status.ok()) {
+    return status;
   }
 
   const Comparator* ucmp = cfd_->internal_comparator().user_comparator();
@@ -104,76 +163,91 @@ rocksdb_rs::status::Status ExternalSstFileIngestionJob::Prepare(
   }
 
   // Copy/Move external files into DB
-  std::unordered_set<size_t> ingestion_path_ids;
-  for (IngestedFileInfo& f : files_to_ingest_) {
-    f.copy_file = false;
-    const std::string path_outside_db = f.external_file_path;
-    const std::string path_inside_db =
-        static_cast<std::string>(rocksdb_rs::filename::TableFileName(
-            cfd_->ioptions()->cf_paths, f.fd.GetNumber(), f.fd.GetPathId()));
-    if (ingestion_options_.move_files) {
-      status =
-          fs_->LinkFile(path_outside_db, path_inside_db, IOOptions(), nullptr)
-              .status();
-      if (status.ok()) {
-        // It is unsafe to assume application had sync the file and file
-        // directory before ingest the file. For integrity of RocksDB we need
-        // to sync the file.
-        std::unique_ptr<FSWritableFile> file_to_sync;
-        rocksdb_rs::status::Status s =
-            fs_->ReopenWritableFile(path_inside_db, env_options_, &file_to_sync,
-                                    nullptr)
-                .status();
-        TEST_SYNC_POINT_CALLBACK("ExternalSstFileIngestionJob::Prepare:Reopen",
-                                 &s);
-        // Some file systems (especially remote/distributed) don't support
-        // reopening a file for writing and don't require reopening and
-        // syncing the file. Ignore the NotSupported error in that case.
-        if (!s.IsNotSupported()) {
-          status.copy_from(s);
-          if (status.ok()) {
-            TEST_SYNC_POINT(
-                "ExternalSstFileIngestionJob::BeforeSyncIngestedFile");
-            status = SyncIngestedFile(file_to_sync.get());
-            TEST_SYNC_POINT(
-                "ExternalSstFileIngestionJob::AfterSyncIngestedFile");
-            if (!status.ok()) {
-              ROCKS_LOG_WARN(
-                  db_options_.info_log, "Failed to sync ingested file %s: %s",
-                  path_inside_db.c_str(), status.ToString()->c_str());
+  status = ForEachFileInParallel(
+      num_files, ingestion_options_.max_threads,
+      [&](size_t i) -> rocksdb_rs::status::Status {
+        IngestedFileInfo& f = files_to_ingest_[i];
+        rocksdb_rs::status::Status file_status =
+            rocksdb_rs::status::Status_new();
+        f.copy_file = false;
+        const std::string path_outside_db = f.external_file_path;
+        const std::string path_inside_db =
+            static_cast<std::string>(rocksdb_rs::filename::TableFileName(
+                cfd_->ioptions()->cf_paths, f.fd.GetNumber(),
+                f.fd.GetPathId()));
+        if (ingestion_options_.move_files) {
+          file_status = fs_->LinkFile(path_outside_db, path_inside_db,
+                                      IOOptions(), nullptr)
+                            .status();
+          if (file_status.ok()) {
+            // It is unsafe to assume application had sync the file and file
+            // directory before ingest the file. For integrity of RocksDB we
+            // need to sync the file.
+            std::unique_ptr<FSWritableFile> file_to_sync;
+            rocksdb_rs::status::Status s =
+                fs_->ReopenWritableFile(path_inside_db, env_options_,
+                                        &file_to_sync, nullptr)
+                    .status();
+            TEST_SYNC_POINT_CALLBACK(
+                "ExternalSstFileIngestionJob::Prepare:Reopen", &s);
+            // Some file systems (especially remote/distributed) don't support
+            // reopening a file for writing and don't require reopening and
+            // syncing the file. Ignore the NotSupported error in that case.
+            if (!s.IsNotSupported()) {
+              file_status.copy_from(s);
+              if (file_status.ok()) {
+                TEST_SYNC_POINT(
+                    "ExternalSstFileIngestionJob::BeforeSyncIngestedFile");
+                file_status = SyncIngestedFile(file_to_sync.get());
+                TEST_SYNC_POINT(
+                    "ExternalSstFileIngestionJob::AfterSyncIngestedFile");
+                if (!file_status.ok()) {
+                  ROCKS_LOG_WARN(db_options_.info_log,
+                                 "Failed to sync ingested file %s: %s",
+                                 path_inside_db.c_str(),
+                                 file_status.ToString()->c_str());
+                }
+              }
             }
+          } else if (file_status.IsNotSupported() &&
+                     ingestion_options_.failed_move_fall_back_to_copy) {
+            // Original file is on a different FS, use copy instead of hard
+            // linking.
+            f.copy_file = true;
+            ROCKS_LOG_INFO(db_options_.info_log,
+                           "Triy to link file %s but it's not supported : %s",
+                           path_outside_db.c_str(),
+                           file_status.ToString()->c_str());
           }
+        } else {
+          f.copy_file = true;
         }
-      } else if (status.IsNotSupported() &&
-                 ingestion_options_.failed_move_fall_back_to_copy) {
-        // Original file is on a different FS, use copy instead of hard linking.
-        f.copy_file = true;
-        ROCKS_LOG_INFO(db_options_.info_log,
-                       "Triy to link file %s but it's not supported : %s",
-                       path_outside_db.c_str(), status.ToString()->c_str());
-      }
-    } else {
-      f.copy_file = true;
-    }
 
-    if (f.copy_file) {
-      TEST_SYNC_POINT_CALLBACK("ExternalSstFileIngestionJob::Prepare:CopyFile",
-                               nullptr);
-      // CopyFile also sync the new file.
-      status =
-          CopyFile(fs_.get(), path_outside_db, path_inside_db, 0,
-                   db_options_.use_fsync, io_tracer_, Temperature::kUnknown)
-              .status();
-    }
-    TEST_SYNC_POINT("ExternalSstFileIngestionJob::Prepare:FileAdded");
-    if (!status.ok()) {
-      break;
+        if (f.copy_file) {
+          TEST_SYNC_POINT_CALLBACK(
+              "ExternalSstFileIngestionJob::Prepare:CopyFile", nullptr);
+          // CopyFile also sync the new file.
+          file_status = CopyFile(fs_.get(), path_outside_db, path_inside_db, 0,
+                                 db_options_.use_fsync, io_tracer_,
+                                 Temperature::kUnknown)
+                            .status();
+        }
+        TEST_SYNC_POINT("ExternalSstFileIngestionJob::Prepare:FileAdded");
+        if (!file_status.ok()) {
+          return file_status;
+        }
+        f.internal_file_path = path_inside_db;
+        // Initialize the checksum information of ingested files.
+        f.file_checksum = kUnknownFileChecksum;
+        f.file_checksum_func_name = kUnknownFileChecksumFuncName;
+        return file_status;
+      });
+
+  std::unordered_set<size_t> ingestion_path_ids;
+  for (const IngestedFileInfo& f : files_to_ingest_) {
+    if (!f.internal_file_path.empty()) {
+      ingestion_path_ids.insert(f.fd.GetPathId());
     }
-    f.internal_file_path = path_inside_db;
-    // Initialize the checksum information of ingested files.
-    f.file_checksum = kUnknownFileChecksum;
-    f.file_checksum_func_name = kUnknownFileChecksumFuncName;
-    ingestion_path_ids.insert(f.fd.GetPathId());
   }
 
   TEST_SYNC_POINT("ExternalSstFileIngestionJob::BeforeSyncDir");
@@ -218,41 +292,40 @@ rocksdb_rs::status::Status ExternalSstFileIngestionJob::Prepare(
     std::unique_ptr<FileChecksumGenerator> file_checksum_gen =
         db_options_.file_checksum_gen_factory->CreateFileChecksumGenerator(
             gen_context);
-    std::vector<std::string> generated_checksums;
-    std::vector<std::string> generated_checksum_func_names;
+    std::vector<std::string> generated_checksums(num_files);
+    std::vector<std::string> generated_checksum_func_names(num_files);
     // Step 1: generate the checksum for ingested sst file.
     if (need_generate_file_checksum_) {
-      for (size_t i = 0; i < files_to_ingest_.size(); i++) {
-        std::string generated_checksum;
-        std::string generated_checksum_func_name;
-        std::string requested_checksum_func_name;
-        // TODO: rate limit file reads for checksum calculation during file
-        // ingestion.
-        rocksdb_rs::io_status::IOStatus io_s = GenerateOneFileChecksum(
-            fs_.get(), files_to_ingest_[i].internal_file_path,
-            db_options_.file_checksum_gen_factory.get(),
-            requested_checksum_func_name, &generated_checksum,
-            &generated_checksum_func_name,
-            ingestion_options_.verify_checksums_readahead_size,
-            db_options_.allow_mmap_reads, io_tracer_,
-            db_options_.rate_limiter.get(),
-            Env::IO_TOTAL /* rate_limiter_priority */);
-        if (!io_s.ok()) {
-          status = io_s.status();
-          ROCKS_LOG_WARN(db_options_.info_log,
-                         "Sst file checksum generation of file: %s failed: %s",
-                         files_to_ingest_[i].internal_file_path.c_str(),
-                         status.ToString()->c_str());
-          break;
-        }
-        if (ingestion_options_.write_global_seqno == false) {
-          files_to_ingest_[i].file_checksum = generated_checksum;
-          files_to_ingest_[i].file_checksum_func_name =
-              generated_checksum_func_name;
-        }
-        generated_checksums.push_back(generated_checksum);
-        generated_checksum_func_names.push_back(generated_checksum_func_name);
-      }
+      status = ForEachFileInParallel(
+          num_files, ingestion_options_.max_threads,
+          [&](size_t i) -> rocksdb_rs::status::Status {
+            std::string requested_checksum_func_name;
+            // TODO: rate limit file reads for checksum calculation during file
+            // ingestion.
+            rocksdb_rs::io_status::IOStatus io_s = GenerateOneFileChecksum(
+                fs_.get(), files_to_ingest_[i].internal_file_path,
+                db_options_.file_checksum_gen_factory.get(),
+                requested_checksum_func_name, &generated_checksums[i],
+                &generated_checksum_func_names[i],
+                ingestion_options_.verify_checksums_readahead_size,
+                db_options_.allow_mmap_reads, io_tracer_,
+                db_options_.rate_limiter.get(),
+                Env::IO_TOTAL /* rate_limiter_priority */);
+            if (!io_s.ok()) {
+              ROCKS_LOG_WARN(
+                  db_options_.info_log,
+                  "Sst file checksum generation of file: %s failed: %s",
+                  files_to_ingest_[i].internal_file_path.c_str(),
+                  io_s.ToString()->c_str());
+              return io_s.status();
+            }
+            if (ingestion_options_.write_global_seqno == false) {
+              files_to_ingest_[i].file_checksum = generated_checksums[i];
+              files_to_ingest_[i].file_checksum_func_name =
+                  generated_checksum_func_names[i];
+            }
+            return rocksdb_rs::status::Status_OK();
+          });
     }
 
     // Step 2: based on the verify_file_checksum and ingested checksum
@@ -325,6 +398,12 @@ rocksdb_rs::status::Status ExternalSstFileIngestionJob::Prepare(
     }
   }
 
+  // Check the files for overlaps with the levels while we do not hold the
+  // mutex. Run() reuses the results, unless the version changed by then.
+  if (status.ok() && !ingestion_options_.ingest_behind) {
+    status = ComputeLevelOverlaps(sv->current);
+  }
+
   // TODO: The following is duplicated with Cleanup().
   if (!status.ok()) {
     IOOptions io_opts;
@@ -384,6 +463,35 @@ rocksdb_rs::status::Status ExternalSstFileIngestionJob::NeedsFlush(
   return status;
 }
 
+rocksdb_rs::status::Status ExternalSstFileIngestionJob::UpdateLevelOverlaps(
+    InstrumentedMutex* db_mutex) {
+  db_mutex->AssertHeld();
+  if (ingestion_options_.ingest_behind) {
+    return rocksdb_rs::status::Status_OK();
+  }
+  // Flushes and compactions may still install versions while the mutex is
+  // released
+  constexpr int kMaxAttempts = 3;
+  for (int attempt = 0; attempt < kMaxAttempts; ++attempt) {
+    Version* version = cfd_->GetSuperVersion()->current;
+    if (level_overlaps_computed_ &&
+        level_overlaps_version_number_ == version->GetVersionNumber()) {
+      break;
+    }
+    version->Ref();
+    db_mutex->Unlock();
+    TEST_SYNC_POINT(
+        "ExternalSstFileIngestionJob::UpdateLevelOverlaps:MutexUnlocked");
+    rocksdb_rs::status::Status status = ComputeLevelOverlaps(version);
+    db_mutex->Lock();
+    version->Unref();
+    if (!status.ok()) {
+      return status;
+    }
+  }
+  return rocksdb_rs::status::Status_OK();
+}
+
 // REQUIRES: we have become the only writer by entering both write_thread_ and
 // nonmem_write_thread_
 rocksdb_rs::status::Status ExternalSstFileIngestionJob::Run() {
@@ -416,6 +524,19 @@ rocksdb_rs::status::Status ExternalSstFileIngestionJob::Run() {
   edit_.SetColumnFamily(cfd_->GetID());
   // The levels that the files will be ingested into
 
+  if (!ingestion_options_.ingest_behind &&
+      (!level_overlaps_computed_ ||
+       level_overlaps_version_number_ !=
+           super_version->current->GetVersionNumber())) {
+    // The version kept changing during UpdateLevelOverlaps(), so this reads
+    // the levels while holding the mutex
+    status = ComputeLevelOverlaps(super_version->current);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  std::vector<SequenceNumber> assigned_seqnos;
   for (IngestedFileInfo& f : files_to_ingest_) {
     SequenceNumber assigned_seqno = 0;
     if (ingestion_options_.ingest_behind) {
@@ -451,7 +572,6 @@ rocksdb_rs::status::Status ExternalSstFileIngestionJob::Run() {
                         largest_parsed.type);
     }
 
-    status = AssignGlobalSeqnoForIngestedFile(&f, assigned_seqno);
     TEST_SYNC_POINT_CALLBACK("ExternalSstFileIngestionJob::Run",
                              &assigned_seqno);
     if (assigned_seqno > last_seqno) {
@@ -459,15 +579,26 @@ rocksdb_rs::status::Status ExternalSstFileIngestionJob::Run() {
       last_seqno = assigned_seqno;
       ++consumed_seqno_count_;
     }
-    if (!status.ok()) {
-      return status;
-    }
+    assigned_seqnos.push_back(assigned_seqno);
+  }
 
-    status = GenerateChecksumForIngestedFile(&f).status();
-    if (!status.ok()) {
-      return status;
-    }
+  // Writing the global sequence numbers and generating the checksums reads
+  // and writes the files, so they are processed in parallel.
+  status = ForEachFileInParallel(
+      files_to_ingest_.size(), ingestion_options_.max_threads,
+      [&](size_t i) -> rocksdb_rs::status::Status {
+        rocksdb_rs::status::Status s = AssignGlobalSeqnoForIngestedFile(
+            &files_to_ingest_[i], assigned_seqnos[i]);
+        if (!s.ok()) {
+          return s;
+        }
+        return GenerateChecksumForIngestedFile(&files_to_ingest_[i]).status();
+      });
+  if (!status.ok()) {
+    return status;
+  }
 
+  for (IngestedFileInfo& f : files_to_ingest_) {
     // We use the import time as the ancester time. This is the time the data
     // is written to the database.
     int64_t temp_current_time = 0;
@@ -876,6 +1007,45 @@ rocksdb_rs::status::Status ExternalSstFileIngestionJob::GetIngestedFileInfo(
   return status;
 }
 
+rocksdb_rs::status::Status ExternalSstFileIngestionJob::ComputeLevelOverlaps(
+    Version* version) {
+  VersionStorageInfo* vstorage = version->storage_info();
+  const int num_levels = cfd_->NumberLevels();
+  rocksdb_rs::status::Status status = ForEachFileInParallel(
+      files_to_ingest_.size(), ingestion_options_.max_threads,
+      [&](size_t i) -> rocksdb_rs::status::Status {
+        IngestedFileInfo& f = files_to_ingest_[i];
+        f.overlap_with_level.assign(num_levels, false);
+        // TODO: plumb Env::IOActivity
+        ReadOptions ro;
+        ro.total_order_seek = true;
+        for (int lvl = 0; lvl < num_levels; lvl++) {
+          if ((lvl > 0 && lvl < vstorage->base_level()) ||
+              vstorage->NumLevelFiles(lvl) == 0) {
+            continue;
+          }
+          bool overlap_with_level = false;
+          rocksdb_rs::status::Status s = version->OverlapWithLevelIterator(
+              ro, env_options_, f.smallest_internal_key.user_key(),
+              f.largest_internal_key.user_key(), lvl, &overlap_with_level);
+          if (!s.ok()) {
+            return s;
+          }
+          if (overlap_with_level) {
+            // The levels below are never checked
+            f.overlap_with_level[lvl] = true;
+            break;
+          }
+        }
+        return rocksdb_rs::status::Status_OK();
+      });
+  if (status.ok()) {
+    level_overlaps_computed_ = true;
+    level_overlaps_version_number_ = version->GetVersionNumber();
+  }
+  return status;
+}
+
 rocksdb_rs::status::Status
 ExternalSstFileIngestionJob::AssignLevelAndSeqnoForIngestedFile(
     SuperVersion* sv, bool force_global_seqno, CompactionStyle compaction_style,
@@ -898,12 +1068,12 @@ ExternalSstFileIngestionJob::AssignLevelAndSeqnoForIngestedFile(
   }
 
   bool overlap_with_db = false;
-  Arena arena;
-  // TODO: plumb Env::IOActivity
-  ReadOptions ro;
-  ro.total_order_seek = true;
   int target_level = 0;
   auto* vstorage = cfd_->current()->storage_info();
+  assert(level_overlaps_computed_ &&
+         level_overlaps_version_number_ == sv->current->GetVersionNumber());
+  assert(file_to_ingest->overlap_with_level.size() ==
+         static_cast<size_t>(cfd_->NumberLevels()));
 
   for (int lvl = 0; lvl < cfd_->NumberLevels(); lvl++) {
     if (lvl > 0 && lvl < vstorage->base_level()) {
@@ -919,15 +1089,7 @@ ExternalSstFileIngestionJob::AssignLevelAndSeqnoForIngestedFile(
       overlap_with_db = true;
       break;
     } else if (vstorage->NumLevelFiles(lvl) > 0) {
-      bool overlap_with_level = false;
-      status = sv->current->OverlapWithLevelIterator(
-          ro, env_options_, file_to_ingest->smallest_internal_key.user_key(),
-          file_to_ingest->largest_internal_key.user_key(), lvl,
-          &overlap_with_level);
-      if (!status.ok()) {
-        return status;
-      }
-      if (overlap_with_level) {
+      if (file_to_ingest->overlap_with_level[lvl]) {
         // We must use L0 or any level higher than `lvl` to be able to overwrite
         // the keys that we overlap with in this level, We also need to assign
         // this file a seqno to overwrite the existing keys in level `lvl`
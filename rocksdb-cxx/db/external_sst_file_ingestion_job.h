@@ -73,6 +73,9 @@ struct IngestedFileInfo {
   Temperature file_temperature = Temperature::kUnknown;
   // Unique id of the file to be ingested
   rocksdb_rs::unique_id::UniqueId64x2 unique_id{};
+  // Whether the file overlaps with the keys of each level, in the version
+  // the level overlaps of the job were computed against
+  std::vector<bool> overlap_with_level;
 };
 
 class ExternalSstFileIngestionJob {
@@ -132,6 +135,13 @@ class ExternalSstFileIngestionJob {
   rocksdb_rs::status::Status NeedsFlush(bool* flush_needed,
                                         SuperVersion* super_version);
 
+  // Compute the level overlaps of the files again if the version changed
+  // since Prepare(), releasing `db_mutex` while doing so. Retries a few times
+  // if the version changes again in the meantime, after which Run() computes
+  // them while holding the mutex.
+  // REQUIRES: Mutex held, and we are the only writer
+  rocksdb_rs::status::Status UpdateLevelOverlaps(InstrumentedMutex* db_mutex);
+
   // Will execute the ingestion job and prepare edit() to be applied.
   // REQUIRES: Mutex held
   rocksdb_rs::status::Status Run();
@@ -168,9 +178,15 @@ class ExternalSstFileIngestionJob {
       const std::string& external_file, uint64_t new_file_number,
       IngestedFileInfo* file_to_ingest, SuperVersion* sv);
 
+  // Compute `overlap_with_level` of all the files against `version`, which
+  // reads the overlapping blocks of the levels. Files are processed in
+  // parallel.
+  rocksdb_rs::status::Status ComputeLevelOverlaps(Version* version);
+
   // Assign `file_to_ingest` the appropriate sequence number and the lowest
   // possible level that it can be ingested to according to compaction_style.
-  // REQUIRES: Mutex held
+  // REQUIRES: Mutex held, level overlaps computed against the current version
+  // of `sv`
   rocksdb_rs::status::Status AssignLevelAndSeqnoForIngestedFile(
       SuperVersion* sv, bool force_global_seqno,
       CompactionStyle compaction_style, SequenceNumber last_seqno,
@@ -219,6 +235,12 @@ class ExternalSstFileIngestionJob {
   VersionEdit edit_;
   uint64_t job_start_time_;
   int consumed_seqno_count_;
+  // Whether the level overlaps of the files were computed, and the number of
+  // the version they were computed against. Prepare() and
+  // UpdateLevelOverlaps() compute them without holding the mutex, and Run()
+  // only computes them again if the version changed in between.
+  bool level_overlaps_computed_{false};
+  uint64_t level_overlaps_version_number_{0};
   // Set in ExternalSstFileIngestionJob::Prepare(), if true all files are
   // ingested in L0
   bool files_overlap_{false};
@@ -98,13 +98,18 @@ void FileIndexer::UpdateIndex(Arena* arena, const size_t num_levels,
     const int32_t upper_size = static_cast<int32_t>(upper_files.size());
     const auto& lower_files = files[level + 1];
     level_rb_[level] = static_cast<int32_t>(upper_files.size()) - 1;
+    IndexLevel& index_level = next_level_index_[level];
+    if (index_level.storage != nullptr) {
+      // Shared by ShareLevelIndex()
+      assert(index_level.num_index == upper_files.size());
+      continue;
+    }
     if (upper_size == 0) {
       continue;
     }
-    IndexLevel& index_level = next_level_index_[level];
     index_level.num_index = upper_size;
-    mem = arena->AllocateAligned(upper_size * sizeof(IndexUnit));
-    index_level.index_units = new (mem) IndexUnit[upper_size];
+    index_level.storage = std::make_shared<std::vector<IndexUnit>>(upper_size);
+    index_level.index_units = index_level.storage->data();
 
     CalculateLB(
         upper_files, lower_files, &index_level,
@@ -136,10 +141,33 @@ void FileIndexer::UpdateIndex(Arena* arena, const size_t num_levels,
         [](IndexUnit* index, int32_t f_idx) { index->largest_rb = f_idx; });
   }
 
+  // There is no index for the last level, even one shared from a version
+  // with more levels
+  next_level_index_[num_levels_ - 1] = IndexLevel();
   level_rb_[num_levels_ - 1] =
       static_cast<int32_t>(files[num_levels_ - 1].size()) - 1;
 }
 
+void FileIndexer::ShareLevelIndex(const FileIndexer& base, size_t level) {
+  assert(level_rb_ == nullptr);
+  if (level >= base.next_level_index_.size() ||
+      base.next_level_index_[level].storage == nullptr) {
+    return;
+  }
+  if (next_level_index_.size() <= level) {
+    next_level_index_.resize(level + 1);
+  }
+  next_level_index_[level] = base.next_level_index_[level];
+}
+
+size_t FileIndexer::ApproximateMemoryUsage() const {
+  size_t usage = num_levels_ * sizeof(int32_t);
+  for (const auto& index_level : next_level_index_) {
+    usage += sizeof(IndexLevel) + index_level.num_index * sizeof(IndexUnit);
+  }
+  return usage;
+}
+
 void FileIndexer::CalculateLB(
     const std::vector<FileMetaData*>& upper_files,
     const std::vector<FileMetaData*>& lower_files, IndexLevel* index_level,
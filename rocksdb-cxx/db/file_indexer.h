@@ -11,6 +11,7 @@
 #include <cstdint>
 #include <functional>
 #include <limits>
+#include <memory>
 #include <vector>
 
 #include "memory/arena.h"
@@ -59,6 +60,15 @@ class FileIndexer {
   void UpdateIndex(Arena* arena, const size_t num_levels,
                    std::vector<FileMetaData*>* const files);
 
+  // Makes the next UpdateIndex() reuse the index `base` has for `level`
+  // rather than computing it again. Only valid when both `level` and the
+  // level below it hold the same files as in `base`.
+  void ShareLevelIndex(const FileIndexer& base, size_t level);
+
+  // Approximate number of bytes used by the index, including the parts
+  // shared with other indexers
+  size_t ApproximateMemoryUsage() const;
+
   enum { kLevelMaxIndex = std::numeric_limits<int32_t>::max() };
 
  private:
@@ -113,10 +123,13 @@ class FileIndexer {
     int32_t largest_rb;
   };
 
-  // Data structure to store IndexUnits in a whole level
+  // Data structure to store IndexUnits in a whole level. The units are
+  // immutable once computed, and shared by the indexers of the versions the
+  // level and the one below it are unchanged in.
   struct IndexLevel {
     size_t num_index;
     IndexUnit* index_units;
+    std::shared_ptr<std::vector<IndexUnit>> storage;
 
     IndexLevel() : num_index(0), index_units(nullptr) {}
   };
@@ -343,6 +343,56 @@ TEST_F(FileIndexerTest, mixed) {
   ClearFiles();
 }
 
+// Case 5: index shared with the indexer of a previous version
+TEST_F(FileIndexerTest, shared_level_index) {
+  Arena base_arena;
+  FileIndexer base(&ucmp);
+  // level 1
+  AddFile(1, 100, 200);
+  AddFile(1, 250, 400);
+  AddFile(1, 450, 500);
+  // level 2
+  AddFile(2, 100, 150);
+  AddFile(2, 200, 250);
+  AddFile(2, 251, 300);
+  AddFile(2, 500, 600);
+  // level 3
+  AddFile(3, 0, 50);
+  AddFile(3, 100, 200);
+  base.UpdateIndex(&base_arena, kNumLevels, files);
+
+  // Only level 3 changes, so the index of level 1 can be shared but not the
+  // one of level 2
+  AddFile(3, 201, 250);
+  Arena arena;
+  indexer = new FileIndexer(&ucmp);
+  indexer->ShareLevelIndex(base, 1);
+  indexer->UpdateIndex(&arena, kNumLevels, files);
+
+  Arena expected_arena;
+  FileIndexer expected(&ucmp);
+  expected.UpdateIndex(&expected_arena, kNumLevels, files);
+
+  const std::vector<std::pair<int, int>> cmps = {
+      {-1, -1}, {0, -1}, {1, -1}, {1, 0}, {1, 1}};
+  for (uint32_t level = 1; level < kNumLevels - 1; ++level) {
+    ASSERT_EQ(expected.LevelIndexSize(level), indexer->LevelIndexSize(level));
+    for (uint32_t f = 0; f < files[level].size(); ++f) {
+      for (const auto& cmp : cmps) {
+        int32_t expected_left = 100;
+        int32_t expected_right = 100;
+        expected.GetNextLevelIndex(level, f, cmp.first, cmp.second,
+                                   &expected_left, &expected_right);
+        GetNextLevelIndex(level, f, cmp.first, cmp.second, &left, &right);
+        ASSERT_EQ(expected_left, left);
+        ASSERT_EQ(expected_right, right);
+      }
+    }
+  }
+  delete indexer;
+  ClearFiles();
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
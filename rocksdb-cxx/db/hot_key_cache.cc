@@ -0,0 +1,173 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/hot_key_cache.h"
+
+#include <algorithm>
+
+#include "cache/typed_cache.h"
+#include "util/coding.h"
+#include "util/hash.h"
+
+namespace rocksdb {
+
+namespace {
+
+using HotKeyCacheInterface =
+    BasicTypedCacheInterface<std::string,
+                             rocksdb_rs::cache::CacheEntryRole::kMisc>;
+
+// Entries are the fixed64 sequence number of the read, followed by the value
+constexpr size_t kEntryHeaderSize = 8;
+
+constexpr size_t kNumStripes = size_t{1} << 14;
+
+// The sketch has about one counter per entry the cache can hold
+constexpr size_t kEstimatedEntrySize = 256;
+constexpr size_t kMinSketchCounters = size_t{1} << 12;
+constexpr size_t kMaxSketchCounters = size_t{1} << 24;
+constexpr int kSketchDepth = 4;
+constexpr uint8_t kMaxCount = 15;
+// As in TinyLFU, the counters are halved after this many increments per
+// counter, so that the sketch follows changes of the working set
+constexpr uint64_t kSampleSizePerCounter = 10;
+
+}  // namespace
+
+HotKeyCache::HotKeyCache(std::shared_ptr<Cache> cache)
+    : cache_(std::move(cache)),
+      write_seqs_(new std::atomic<SequenceNumber>[kNumStripes]) {
+  // If the same cache is shared by multiple instances, we need to
+  // disambiguate its entries.
+  PutVarint64(&cache_id_, cache_->NewId());
+  for (size_t i = 0; i < kNumStripes; ++i) {
+    write_seqs_[i].store(0, std::memory_order_relaxed);
+  }
+  size_t num_counters = kMinSketchCounters;
+  const size_t wanted = cache_->GetCapacity() / kEstimatedEntrySize;
+  while (num_counters < wanted && num_counters < kMaxSketchCounters) {
+    num_counters <<= 1;
+  }
+  sketch_.reset(new std::atomic<uint8_t>[num_counters]);
+  for (size_t i = 0; i < num_counters; ++i) {
+    sketch_[i].store(0, std::memory_order_relaxed);
+  }
+  sketch_mask_ = num_counters - 1;
+  sketch_sample_size_ = kSampleSizePerCounter * num_counters;
+}
+
+void HotKeyCache::AppendCacheKey(uint32_t cf_id, const Slice& user_key,
+                                 std::string* key) const {
+  key->append(cache_id_);
+  PutVarint32(key, cf_id);
+  key->append(user_key.data(), user_key.size());
+}
+
+std::atomic<SequenceNumber>& HotKeyCache::StripeOf(uint64_t hash) const {
+  return write_seqs_[hash & (kNumStripes - 1)];
+}
+
+bool HotKeyCache::IsValid(uint64_t hash, SequenceNumber read_seq) const {
+  return read_seq >= StripeOf(hash).load(std::memory_order_acquire) &&
+         read_seq >= invalidate_all_seq_.load(std::memory_order_acquire);
+}
+
+uint8_t HotKeyCache::IncrementFrequency(uint64_t hash) {
+  // Double hashing for the counters of each row
+  const uint64_t step = (hash >> 32) | 1;
+  uint8_t frequency = kMaxCount;
+  for (int i = 0; i < kSketchDepth; ++i) {
+    std::atomic<uint8_t>& counter = sketch_[(hash + i * step) & sketch_mask_];
+    uint8_t count = counter.load(std::memory_order_relaxed);
+    if (count < kMaxCount) {
+      // Racing increments may go a little over kMaxCount, which is harmless
+      count = counter.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+    frequency = std::min(frequency, count);
+  }
+  if (sketch_increments_.fetch_add(1, std::memory_order_relaxed) + 1 ==
+      sketch_sample_size_) {
+    for (size_t i = 0; i <= sketch_mask_; ++i) {
+      sketch_[i].store(sketch_[i].load(std::memory_order_relaxed) / 2,
+                       std::memory_order_relaxed);
+    }
+    sketch_increments_.store(0, std::memory_order_relaxed);
+  }
+  return frequency;
+}
+
+bool HotKeyCache::Lookup(uint32_t cf_id, const Slice& user_key,
+                         SequenceNumber read_seq, PinnableSlice* value) {
+  std::string key;
+  AppendCacheKey(cf_id, user_key, &key);
+  HotKeyCacheInterface cache{cache_.get()};
+  auto handle = cache.Lookup(key);
+  if (handle == nullptr) {
+    return false;
+  }
+  const std::string& entry = *cache.Value(handle);
+  assert(entry.size() >= kEntryHeaderSize);
+  const SequenceNumber entry_seq =
+      rocksdb_rs::coding_lean::DecodeFixed64(entry.data());
+  // An entry read after `read_seq` may have a value too recent for it
+  if (entry_seq > read_seq || !IsValid(GetSliceHash64(key), entry_seq)) {
+    cache.Release(handle);
+    return false;
+  }
+  Cleanable value_pinner;
+  cache.RegisterReleaseAsCleanup(handle, value_pinner);
+  value->Reset();
+  value->PinSlice(Slice(entry.data() + kEntryHeaderSize,
+                        entry.size() - kEntryHeaderSize),
+                  &value_pinner);
+  return true;
+}
+
+HotKeyCache::InsertResult HotKeyCache::Insert(uint32_t cf_id,
+                                              const Slice& user_key,
+                                              SequenceNumber read_seq,
+                                              const Slice& value) {
+  std::string key;
+  AppendCacheKey(cf_id, user_key, &key);
+  const uint64_t hash = GetSliceHash64(key);
+  if (IncrementFrequency(hash) < kAdmitFrequency) {
+    return InsertResult::kRejected;
+  }
+  // A write racing with this insertion is caught by Lookup()
+  if (!IsValid(hash, read_seq)) {
+    return InsertResult::kStale;
+  }
+  auto entry = new std::string();
+  entry->resize(kEntryHeaderSize);
+  rocksdb_rs::coding_lean::EncodeFixed64(&(*entry)[0], read_seq);
+  entry->append(value.data(), value.size());
+  size_t charge = key.size() + entry->capacity() + sizeof(std::string);
+  HotKeyCacheInterface cache{cache_.get()};
+  // If the cache is full, it's OK to continue.
+  cache.Insert(key, entry, charge);
+  return InsertResult::kInserted;
+}
+
+void HotKeyCache::InvalidateKey(uint32_t cf_id, const Slice& user_key,
+                                SequenceNumber seq) {
+  std::string key;
+  AppendCacheKey(cf_id, user_key, &key);
+  std::atomic<SequenceNumber>& stripe = StripeOf(GetSliceHash64(key));
+  SequenceNumber prev = stripe.load(std::memory_order_relaxed);
+  while (prev < seq && !stripe.compare_exchange_weak(
+                           prev, seq, std::memory_order_release,
+                           std::memory_order_relaxed)) {
+  }
+}
+
+void HotKeyCache::InvalidateAll(SequenceNumber seq) {
+  SequenceNumber prev = invalidate_all_seq_.load(std::memory_order_relaxed);
+  while (prev < seq && !invalidate_all_seq_.compare_exchange_weak(
+                           prev, seq, std::memory_order_release,
+                           std::memory_order_relaxed)) {
+  }
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,104 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "db/dbformat.h"
+#include "rocksdb/cache.h"
+#include "rocksdb/slice.h"
+
+namespace rocksdb {
+
+// HotKeyCache caches the results of Get() for frequently read keys, across
+// all the column families of a DB, so that a Get() hitting it looks up
+// neither the memtables nor the SST files. This differs from the row cache,
+// which caches the entries of a key in each SST file separately, and admits
+// every lookup.
+//
+// An entry records the sequence number of the read that produced it, and is
+// valid for reads at that sequence number or later, until the key is
+// written. Writes do not look entries up: each one raises the last write
+// sequence number of the stripe its key hashes to, before it is inserted
+// into the memtable, and this invalidates the entries of all the keys of
+// the stripe read before the write. Changes that do not go through the
+// memtables, such as ingested files, invalidate all the entries instead.
+//
+// Admission is controlled by a TinyLFU frequency sketch, a count-min sketch
+// of the recent misses of each key, periodically halved. A key is only
+// admitted once it missed kAdmitFrequency times within the recent window,
+// so that keys read once, e.g. by scan-like point reads, do not evict the
+// hot ones.
+//
+// Thread-safe.
+class HotKeyCache {
+ public:
+  enum class InsertResult {
+    kInserted,
+    // Not frequent enough yet
+    kRejected,
+    // Written since the read, so the value may not be the latest
+    kStale,
+  };
+
+  explicit HotKeyCache(std::shared_ptr<Cache> cache);
+
+  // No copying allowed
+  HotKeyCache(const HotKeyCache&) = delete;
+  HotKeyCache& operator=(const HotKeyCache&) = delete;
+
+  // If the cache has the value of `user_key` in column family `cf_id` as of
+  // sequence number `read_seq`, pins it in *value and returns true.
+  bool Lookup(uint32_t cf_id, const Slice& user_key, SequenceNumber read_seq,
+              PinnableSlice* value);
+
+  // Offers `value`, read for `user_key` in column family `cf_id` as of
+  // sequence number `read_seq`, after a Lookup() missed.
+  InsertResult Insert(uint32_t cf_id, const Slice& user_key,
+                      SequenceNumber read_seq, const Slice& value);
+
+  // Invalidates the entry of `user_key` in column family `cf_id`, if read
+  // before `seq`. Must be called before a write at `seq` becomes visible.
+  void InvalidateKey(uint32_t cf_id, const Slice& user_key,
+                     SequenceNumber seq);
+
+  // Invalidates all the entries read before `seq`
+  void InvalidateAll(SequenceNumber seq);
+
+  Cache* GetCache() const { return cache_.get(); }
+
+  // Number of misses of a key within the recent window for it to be admitted
+  static constexpr uint8_t kAdmitFrequency = 2;
+
+ private:
+  void AppendCacheKey(uint32_t cf_id, const Slice& user_key,
+                      std::string* key) const;
+  std::atomic<SequenceNumber>& StripeOf(uint64_t hash) const;
+  bool IsValid(uint64_t hash, SequenceNumber read_seq) const;
+  // Records a miss of the key with hash `hash` in the sketch, and returns
+  // the estimated number of its misses in the recent window.
+  uint8_t IncrementFrequency(uint64_t hash);
+
+  std::shared_ptr<Cache> cache_;
+  // Prefix of the keys of this instance, as the cache may be shared by
+  // several DBs, or outlive a DB that is reopened
+  std::string cache_id_;
+  // Sequence number of the last write of each stripe of keys
+  std::unique_ptr<std::atomic<SequenceNumber>[]> write_seqs_;
+  // Entries read before this are invalid
+  std::atomic<SequenceNumber> invalidate_all_seq_{0};
+  // Counters saturating at 15, kSketchDepth of them per key
+  std::unique_ptr<std::atomic<uint8_t>[]> sketch_;
+  size_t sketch_mask_;
+  // Number of increments after which the counters are halved
+  uint64_t sketch_sample_size_;
+  std::atomic<uint64_t> sketch_increments_{0};
+};
+
+}  // namespace rocksdb
@@ -254,6 +254,7 @@ static const std::string levelstats = "levelstats";
 static const std::string block_cache_entry_stats = "block-cache-entry-stats";
 static const std::string fast_block_cache_entry_stats =
     "fast-block-cache-entry-stats";
+static const std::string hot_key_cache_stats = "hot-key-cache-stats";
 static const std::string num_immutable_mem_table = "num-immutable-mem-table";
 static const std::string num_immutable_mem_table_flushed =
     "num-immutable-mem-table-flushed";
@@ -275,6 +276,8 @@ static const std::string num_deletes_imm_mem_tables =
 static const std::string estimate_num_keys = "estimate-num-keys";
 static const std::string estimate_table_readers_mem =
     "estimate-table-readers-mem";
+static const std::string estimate_version_metadata_mem =
+    "estimate-version-metadata-mem";
 static const std::string is_file_deletions_enabled =
     "is-file-deletions-enabled";
 static const std::string num_snapshots = "num-snapshots";
@@ -340,6 +343,8 @@ const std::string DB::Properties::kBlockCacheEntryStats =
     rocksdb_prefix + block_cache_entry_stats;
 const std::string DB::Properties::kFastBlockCacheEntryStats =
     rocksdb_prefix + fast_block_cache_entry_stats;
+const std::string DB::Properties::kHotKeyCacheStats =
+    rocksdb_prefix + hot_key_cache_stats;
 const std::string DB::Properties::kNumImmutableMemTable =
     rocksdb_prefix + num_immutable_mem_table;
 const std::string DB::Properties::kNumImmutableMemTableFlushed =
@@ -372,6 +377,8 @@ const std::string DB::Properties::kEstimateNumKeys =
     rocksdb_prefix + estimate_num_keys;
 const std::string DB::Properties::kEstimateTableReadersMem =
     rocksdb_prefix + estimate_table_readers_mem;
+const std::string DB::Properties::kEstimateVersionMetadataMem =
+    rocksdb_prefix + estimate_version_metadata_mem;
 const std::string DB::Properties::kIsFileDeletionsEnabled =
     rocksdb_prefix + is_file_deletions_enabled;
 const std::string DB::Properties::kNumSnapshots =
@@ -478,6 +485,9 @@ const UnorderedMap<std::string, DBPropertyInfo>
         {DB::Properties::kFastBlockCacheEntryStats,
          {true, &InternalStats::HandleFastBlockCacheEntryStats, nullptr,
           &InternalStats::HandleFastBlockCacheEntryStatsMap, nullptr}},
+        {DB::Properties::kHotKeyCacheStats,
+         {false, &InternalStats::HandleHotKeyCacheStats, nullptr,
+          &InternalStats::HandleHotKeyCacheStatsMap, nullptr}},
         {DB::Properties::kSSTables,
          {false, &InternalStats::HandleSsTables, nullptr, nullptr, nullptr}},
         {DB::Properties::kAggregatedTableProperties,
@@ -529,6 +539,9 @@ const UnorderedMap<std::string, DBPropertyInfo>
         {DB::Properties::kEstimateTableReadersMem,
          {true, nullptr, &InternalStats::HandleEstimateTableReadersMem, nullptr,
           nullptr}},
+        {DB::Properties::kEstimateVersionMetadataMem,
+         {true, nullptr, &InternalStats::HandleEstimateVersionMetadataMem,
+          nullptr, nullptr}},
         {DB::Properties::kIsFileDeletionsEnabled,
          {false, nullptr, &InternalStats::HandleIsFileDeletionsEnabled, nullptr,
           nullptr}},
@@ -828,6 +841,40 @@ bool InternalStats::HandleFastBlockCacheEntryStatsMap(
   return HandleBlockCacheEntryStatsMapInternal(values, true /* fast */);
 }
 
+bool InternalStats::HandleHotKeyCacheStats(std::string* value,
+                                           Slice /*suffix*/) {
+  std::map<std::string, std::string> values;
+  if (!HandleHotKeyCacheStatsMap(&values, Slice())) {
+    return false;
+  }
+  std::ostringstream str;
+  str << "Hot key cache hits: " << values["hits"]
+      << " misses: " << values["misses"]
+      << " hit rate: " << values["hit-rate"]
+      << " admission rejects: " << values["admission-rejects"] << "\n";
+  *value = str.str();
+  return true;
+}
+
+bool InternalStats::HandleHotKeyCacheStatsMap(
+    std::map<std::string, std::string>* values, Slice /*suffix*/) {
+  if (cfd_ == nullptr || !cfd_->ioptions()->hot_key_cache) {
+    return false;
+  }
+  uint64_t hits = hot_key_cache_hits_.load(std::memory_order_relaxed);
+  uint64_t misses = hot_key_cache_misses_.load(std::memory_order_relaxed);
+  uint64_t lookups = hits + misses;
+  char hit_rate[16];
+  snprintf(hit_rate, sizeof(hit_rate), "%.4f",
+           lookups == 0 ? 0.0 : static_cast<double>(hits) / lookups);
+  (*values)["hits"] = std::to_string(hits);
+  (*values)["misses"] = std::to_string(misses);
+  (*values)["hit-rate"] = hit_rate;
+  (*values)["admission-rejects"] = std::to_string(
+      hot_key_cache_admission_rejects_.load(std::memory_order_relaxed));
+  return true;
+}
+
 bool InternalStats::HandleLiveSstFilesSizeAtTemperature(std::string* value,
                                                         Slice suffix) {
   uint64_t temperature;
@@ -1438,6 +1485,15 @@ bool InternalStats::HandleEstimateTableReadersMem(uint64_t* value,
   return true;
 }
 
+bool InternalStats::HandleEstimateVersionMetadataMem(uint64_t* value,
+                                                     DBImpl* /*db*/,
+                                                     Version* version) {
+  *value = (version == nullptr)
+               ? 0
+               : version->storage_info()->EstimateMetadataMemoryUsage();
+  return true;
+}
+
 bool InternalStats::HandleEstimateLiveDataSize(uint64_t* value, DBImpl* /*db*/,
                                                Version* version) {
   const auto* vstorage = version->storage_info();
@@ -565,6 +565,16 @@ class InternalStats {
     return db_stats_[type].load(std::memory_order_relaxed);
   }
 
+  // Called by Get() without holding the DB mutex
+  void RecordHotKeyCacheLookup(bool hit) {
+    (hit ? hot_key_cache_hits_ : hot_key_cache_misses_)
+        .fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void RecordHotKeyCacheAdmissionReject() {
+    hot_key_cache_admission_rejects_.fetch_add(1, std::memory_order_relaxed);
+  }
+
   HistogramImpl* GetFileReadHist(int level) {
     return &file_read_latency_[level];
   }
@@ -647,6 +657,10 @@ class InternalStats {
   // Per-ColumnFamily stats
   uint64_t cf_stats_value_[INTERNAL_CF_STATS_ENUM_MAX];
   uint64_t cf_stats_count_[INTERNAL_CF_STATS_ENUM_MAX];
+  // Per-ColumnFamily DBOptions::hot_key_cache stats
+  std::atomic<uint64_t> hot_key_cache_hits_{0};
+  std::atomic<uint64_t> hot_key_cache_misses_{0};
+  std::atomic<uint64_t> hot_key_cache_admission_rejects_{0};
   // Initialize/reference the collector in constructor so that we don't need
   // additional synchronization in InternalStats, relying on synchronization
   // in CacheEntryStatsCollector::GetStats. This collector is pinned in cache
@@ -825,6 +839,8 @@ class InternalStats {
                                             Version* version);
   bool HandleEstimateTableReadersMem(uint64_t* value, DBImpl* db,
                                      Version* version);
+  bool HandleEstimateVersionMetadataMem(uint64_t* value, DBImpl* db,
+                                        Version* version);
   bool HandleEstimateLiveDataSize(uint64_t* value, DBImpl* db,
                                   Version* version);
   bool HandleMinLogNumberToKeep(uint64_t* value, DBImpl* db, Version* version);
@@ -846,6 +862,9 @@ class InternalStats {
   bool HandleBlockCacheEntryStatsMap(std::map<std::string, std::string>* values,
                                      Slice suffix);
   bool HandleFastBlockCacheEntryStats(std::string* value, Slice suffix);
+  bool HandleHotKeyCacheStats(std::string* value, Slice suffix);
+  bool HandleHotKeyCacheStatsMap(std::map<std::string, std::string>* values,
+                                 Slice suffix);
   bool HandleFastBlockCacheEntryStatsMap(
       std::map<std::string, std::string>* values, Slice suffix);
   bool HandleLiveSstFilesSizeAtTemperature(std::string* value, Slice suffix);
@@ -37,11 +37,18 @@ enum RecordType {
   // User-defined timestamp sizes
   kUserDefinedTimestampSizeType = 10,
   kRecyclableUserDefinedTimestampSizeType = 11,
+
+  // Compression dictionary, right after the compression type
+  kSetCompressionDictionary = 12,
 };
-constexpr int kMaxRecordType = kRecyclableUserDefinedTimestampSizeType;
+constexpr int kMaxRecordType = kSetCompressionDictionary;
 
 constexpr unsigned int kBlockSize = 32768;
 
+// Largest compression dictionary, so that it fits in the first block along
+// with the compression type record
+constexpr size_t kMaxCompressionDictBytes = 16 * 1024;
+
 // Header is checksum (4 bytes), length (2 bytes), type (1 byte)
 constexpr int kHeaderSize = 4 + 2 + 1;
 
@@ -0,0 +1,210 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "db/db_test_util.h"
+#include "port/stack_trace.h"
+#include "rocksdb/sst_file_writer.h"
+#include "rocksdb/table.h"
+#include "util/random.h"
+#include "utilities/merge_operators.h"
+
+namespace rocksdb {
+
+// Param: whether the tables are read with mmap
+class LogHashTableDBTest : public DBTestBase,
+                           public testing::WithParamInterface<bool> {
+ public:
+  LogHashTableDBTest()
+      : DBTestBase("log_hash_table_db_test", /*env_do_fsync=*/false) {}
+
+  Options LogHashOptions() {
+    Options options = CurrentOptions();
+    LogHashTableOptions table_options;
+    // Several restart points even in small tables
+    table_options.restart_interval = 4;
+    options.table_factory.reset(NewLogHashTableFactory(table_options));
+    options.allow_mmap_reads = GetParam();
+    options.merge_operator = MergeOperators::CreateStringAppendOperator();
+    return options;
+  }
+};
+
+TEST_P(LogHashTableDBTest, Flush) {
+  Options options = LogHashOptions();
+  DestroyAndReopen(options);
+
+  ASSERT_OK(Put("key1", "v1"));
+  ASSERT_OK(Put("key2", "v2"));
+  ASSERT_OK(Put("key3", "v3"));
+  ASSERT_OK(Delete("key2"));
+  ASSERT_OK(Flush());
+
+  TablePropertiesCollection ptc;
+  ASSERT_OK(db_->GetPropertiesOfAllTables(&ptc));
+  ASSERT_EQ(1U, ptc.size());
+  ASSERT_EQ(3U, ptc.begin()->second->num_entries);
+  ASSERT_EQ(1U, ptc.begin()->second->num_deletions);
+
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_EQ("v1", Get("key1"));
+    ASSERT_EQ("NOT_FOUND", Get("key2"));
+    ASSERT_EQ("v3", Get("key3"));
+    ASSERT_EQ("NOT_FOUND", Get("key0"));
+    ASSERT_EQ("NOT_FOUND", Get("key4"));
+    // Read the table again from the file
+    Reopen(options);
+  }
+}
+
+TEST_P(LogHashTableDBTest, SnapshotsAndMerges) {
+  Options options = LogHashOptions();
+  DestroyAndReopen(options);
+
+  ASSERT_OK(Put("a", "v1"));
+  const Snapshot* snapshot = db_->GetSnapshot();
+  ASSERT_OK(Put("a", "v2"));
+  ASSERT_OK(Merge("a", "x"));
+  ASSERT_OK(Merge("b", "y"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(Merge("b", "z"));
+  ASSERT_OK(Flush());
+
+  // The versions of "a" newer than the snapshot are skipped
+  ASSERT_EQ("v1", Get("a", snapshot));
+  ASSERT_EQ("v2,x", Get("a"));
+  // The merge operands of "b" are in two tables
+  ASSERT_EQ("NOT_FOUND", Get("b", snapshot));
+  ASSERT_EQ("y,z", Get("b"));
+
+  db_->ReleaseSnapshot(snapshot);
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ("v2,x", Get("a"));
+  ASSERT_EQ("y,z", Get("b"));
+}
+
+TEST_P(LogHashTableDBTest, CompactionIntoMultipleFiles) {
+  Options options = LogHashOptions();
+  options.target_file_size_base = 32 << 10;
+  DestroyAndReopen(options);
+
+  Random rnd(301);
+  std::map<std::string, std::string> values;
+  for (int round = 0; round < 3; ++round) {
+    for (int i = 0; i < 1000; ++i) {
+      std::string value = rnd.RandomString(100);
+      ASSERT_OK(Put(Key(i), value));
+      values[Key(i)] = value;
+    }
+    ASSERT_OK(Flush());
+  }
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(0, NumTableFilesAtLevel(0));
+  std::vector<LiveFileMetaData> files;
+  db_->GetLiveFilesMetaData(&files);
+  ASSERT_GT(files.size(), 1U);
+
+  for (const auto& kv : values) {
+    ASSERT_EQ(kv.second, Get(kv.first));
+  }
+  ASSERT_EQ("NOT_FOUND", Get(Key(1000)));
+}
+
+TEST_P(LogHashTableDBTest, Iterator) {
+  Options options = LogHashOptions();
+  DestroyAndReopen(options);
+
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_OK(Put(Key(2 * i), "v" + std::to_string(2 * i)));
+  }
+  ASSERT_OK(Flush());
+
+  std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+  int count = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    ASSERT_EQ(Key(2 * count), iter->key().ToString());
+    ASSERT_EQ("v" + std::to_string(2 * count), iter->value().ToString());
+    ++count;
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(100, count);
+
+  for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+    --count;
+    ASSERT_EQ(Key(2 * count), iter->key().ToString());
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(0, count);
+
+  iter->Seek(Key(51));
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(Key(52), iter->key().ToString());
+  iter->Prev();
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(Key(50), iter->key().ToString());
+
+  iter->SeekForPrev(Key(51));
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(Key(50), iter->key().ToString());
+
+  iter->Seek(Key(199));
+  ASSERT_FALSE(iter->Valid());
+  ASSERT_OK(iter->status());
+}
+
+TEST_P(LogHashTableDBTest, DeleteRange) {
+  Options options = LogHashOptions();
+  DestroyAndReopen(options);
+
+  ASSERT_OK(Put("a", "v1"));
+  ASSERT_OK(Put("b", "v2"));
+  ASSERT_OK(Put("c", "v3"));
+  // Range tombstones cannot be stored in the table
+  ASSERT_TRUE(
+      db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(), "a", "c")
+          .IsNotSupported());
+  ASSERT_OK(Flush());
+  Reopen(options);
+  ASSERT_EQ("v1", Get("a"));
+  ASSERT_EQ("v2", Get("b"));
+  ASSERT_EQ("v3", Get("c"));
+
+  // A file with a range tombstone is never finished
+  SstFileWriter writer(EnvOptions(), options);
+  const std::string file = dbname_ + "/range_del.sst";
+  ASSERT_OK(writer.Open(file));
+  ASSERT_OK(writer.Put("a", "v1"));
+  ASSERT_OK(writer.DeleteRange("b", "c"));
+  ASSERT_OK(writer.Put("c", "v3"));
+  ASSERT_TRUE(writer.Finish().IsNotSupported());
+}
+
+TEST_P(LogHashTableDBTest, InvalidOptions) {
+  Options options = LogHashOptions();
+  LogHashTableOptions table_options;
+  table_options.hash_table_ratio = 0;
+  options.table_factory.reset(NewLogHashTableFactory(table_options));
+  ASSERT_TRUE(TryReopen(options).IsInvalidArgument());
+
+  table_options.hash_table_ratio = 1;
+  table_options.restart_interval = 0;
+  options.table_factory.reset(NewLogHashTableFactory(table_options));
+  ASSERT_TRUE(TryReopen(options).IsInvalidArgument());
+}
+
+INSTANTIATE_TEST_CASE_P(LogHashTableDBTest, LogHashTableDBTest,
+                        ::testing::Bool());
+
+}  // namespace rocksdb
+
+int main(int argc, char** argv) {
+  rocksdb::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,112 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/log_prefetcher.h"
+
+#include <cassert>
+
+namespace rocksdb {
+namespace log {
+
+RecordPrefetcher::RecordPrefetcher(size_t max_queued_records)
+    : queue_(max_queued_records) {}
+
+RecordPrefetcher::~RecordPrefetcher() { Stop(); }
+
+void RecordPrefetcher::Start(Reader* reader,
+                             WALRecoveryMode wal_recovery_mode) {
+  assert(!thread_.joinable());
+  thread_ = port::Thread(
+      [this, reader, wal_recovery_mode]() {
+        ReadAhead(reader, wal_recovery_mode);
+      });
+}
+
+void RecordPrefetcher::ReadAhead(Reader* reader,
+                                 WALRecoveryMode wal_recovery_mode) {
+  Slice record;
+  std::string scratch;
+  uint64_t record_checksum;
+  size_t num_recorded_ts_sz = 0;
+  while (reader->ReadRecord(&record, &scratch, wal_recovery_mode,
+                            &record_checksum)) {
+    Item item;
+    item.record.assign(record.data(), record.size());
+    item.record_checksum = record_checksum;
+    // The recorded timestamp sizes only ever grow, so the size is enough to
+    // tell whether a copy has to be handed over.
+    const UnorderedMap<uint32_t, size_t>& recorded_ts_sz =
+        reader->GetRecordedTimestampSize();
+    if (recorded_ts_sz.size() != num_recorded_ts_sz) {
+      num_recorded_ts_sz = recorded_ts_sz.size();
+      item.recorded_ts_sz =
+          std::make_shared<const UnorderedMap<uint32_t, size_t>>(
+              recorded_ts_sz);
+    }
+    if (!queue_.push(std::move(item))) {
+      // Stopped
+      return;
+    }
+  }
+  Item end_of_log;
+  end_of_log.type = Item::kEndOfLog;
+  queue_.push(std::move(end_of_log));
+}
+
+void RecordPrefetcher::Corruption(size_t bytes,
+                                  const rocksdb_rs::status::Status& status) {
+  Item item;
+  item.type = Item::kCorruption;
+  item.corrupted_bytes = bytes;
+  item.status.copy_from(status);
+  // Dropped if already stopped
+  queue_.push(std::move(item));
+}
+
+bool RecordPrefetcher::ReadRecord(Slice* record, uint64_t* record_checksum,
+                                  Reader::Reporter* reporter) {
+  while (!end_of_log_ && queue_.pop(current_)) {
+    if (current_.type == Item::kCorruption) {
+      if (reporter != nullptr) {
+        reporter->Corruption(current_.corrupted_bytes, current_.status);
+      }
+      continue;
+    }
+    if (current_.type == Item::kEndOfLog) {
+      end_of_log_ = true;
+      break;
+    }
+    if (current_.recorded_ts_sz != nullptr) {
+      recorded_ts_sz_ = current_.recorded_ts_sz;
+    }
+    *record = current_.record;
+    if (record_checksum != nullptr) {
+      *record_checksum = current_.record_checksum;
+    }
+    return true;
+  }
+  return false;
+}
+
+const UnorderedMap<uint32_t, size_t>&
+RecordPrefetcher::GetRecordedTimestampSize() const {
+  static const UnorderedMap<uint32_t, size_t> kEmpty;
+  return recorded_ts_sz_ != nullptr ? *recorded_ts_sz_ : kEmpty;
+}
+
+void RecordPrefetcher::Stop() {
+  if (!stopped_) {
+    stopped_ = true;
+    // Unblocks the background thread if the queue is full
+    queue_.finish();
+  }
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+}  // namespace log
+}  // namespace rocksdb
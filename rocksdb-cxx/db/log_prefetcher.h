@@ -0,0 +1,90 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "db/log_reader.h"
+#include "port/port.h"
+#include "rocksdb-rs/src/status.rs.h"
+#include "rocksdb/options.h"
+#include "rocksdb/slice.h"
+#include "util/hash_containers.h"
+#include "util/work_queue.h"
+
+namespace rocksdb {
+namespace log {
+
+/**
+ * RecordPrefetcher drives a Reader on a background thread, so that reading
+ * and checksumming the next records of a WAL overlaps with the replay of the
+ * current one. Records, and the corruptions detected while reading them, are
+ * handed over in log order through a bounded queue.
+ *
+ * The prefetcher is the Reporter of the Reader it drives. Corruptions are
+ * forwarded to the Reporter passed to ReadRecord(), on the calling thread, in
+ * the same order relative to the records as a Reader would report them.
+ */
+class RecordPrefetcher : public Reader::Reporter {
+ public:
+  // At most `max_queued_records` records are read ahead.
+  explicit RecordPrefetcher(size_t max_queued_records);
+
+  ~RecordPrefetcher() override;
+
+  // No copying allowed
+  RecordPrefetcher(const RecordPrefetcher&) = delete;
+  void operator=(const RecordPrefetcher&) = delete;
+
+  // Starts reading records from "*reader", which must have been created with
+  // this object as its reporter, and must remain live until Stop().
+  void Start(Reader* reader, WALRecoveryMode wal_recovery_mode);
+
+  // Same contract as Reader::ReadRecord(), except that corruptions are
+  // reported to "*reporter". The contents filled in *record remain valid
+  // until the next call to ReadRecord() or Stop().
+  bool ReadRecord(Slice* record, uint64_t* record_checksum,
+                  Reader::Reporter* reporter);
+
+  // Return the recorded user-defined timestamp sizes as of the last record
+  // returned by ReadRecord().
+  const UnorderedMap<uint32_t, size_t>& GetRecordedTimestampSize() const;
+
+  // Stops reading ahead and waits for the background thread to exit. Records
+  // not yet returned by ReadRecord() are dropped. Safe to call repeatedly.
+  void Stop();
+
+  // Called by the Reader on the background thread.
+  void Corruption(size_t bytes,
+                  const rocksdb_rs::status::Status& status) override;
+
+ private:
+  struct Item {
+    enum Type { kRecord, kCorruption, kEndOfLog };
+    Type type = kRecord;
+    std::string record;
+    uint64_t record_checksum = 0;
+    // Only set when the recorded timestamp sizes changed with this record
+    std::shared_ptr<const UnorderedMap<uint32_t, size_t>> recorded_ts_sz;
+    size_t corrupted_bytes = 0;
+    rocksdb_rs::status::Status status = rocksdb_rs::status::Status_new();
+  };
+
+  void ReadAhead(Reader* reader, WALRecoveryMode wal_recovery_mode);
+
+  WorkQueue<Item> queue_;
+  port::Thread thread_;
+  // The last item returned by ReadRecord()
+  Item current_;
+  bool end_of_log_ = false;
+  bool stopped_ = false;
+  std::shared_ptr<const UnorderedMap<uint32_t, size_t>> recorded_ts_sz_;
+};
+
+}  // namespace log
+}  // namespace rocksdb
@@ -188,6 +188,13 @@ bool Reader::ReadRecord(Slice* record, std::string* scratch,
         }
         break;
       }
+      case kSetCompressionDictionary: {
+        prospective_record_offset = physical_record_offset;
+        scratch->clear();
+        last_record_offset_ = prospective_record_offset;
+        InitCompressionDictionary(fragment);
+        break;
+      }
       case kUserDefinedTimestampSizeType:
       case kRecyclableUserDefinedTimestampSizeType: {
         if (in_fragmented_record && !scratch->empty()) {
@@ -537,6 +544,7 @@ unsigned int Reader::ReadPhysicalRecord(Slice* result, size_t* drop_size,
     buffer_.remove_prefix(header_size + length);
 
     if (!uncompress_ || type == kSetCompressionType ||
+        type == kSetCompressionDictionary ||
         type == kUserDefinedTimestampSizeType ||
         type == kRecyclableUserDefinedTimestampSizeType) {
       *result = Slice(header + header_size, length);
@@ -605,6 +613,18 @@ void Reader::InitCompression(const CompressionTypeRecord& compression_record) {
   assert(uncompressed_buffer_);
 }
 
+void Reader::InitCompressionDictionary(const Slice& compression_dict) {
+  if (!compression_type_record_read_ || first_record_read_) {
+    ReportCorruption(compression_dict.size(),
+                     "SetCompressionDictionary not right after "
+                     "SetCompressionType");
+  } else if (uncompress_ == nullptr ||
+             !uncompress_->SetDictionary(compression_dict)) {
+    ReportCorruption(compression_dict.size(),
+                     "could not load SetCompressionDictionary record");
+  }
+}
+
 rocksdb_rs::status::Status Reader::UpdateRecordedTimestampSize(
     const std::vector<std::pair<uint32_t, size_t>>& cf_to_ts_sz) {
   for (const auto& [cf, ts_sz] : cf_to_ts_sz) {
@@ -718,6 +738,15 @@ bool FragmentBufferedReader::ReadRecord(Slice* record, std::string* scratch,
         break;
       }
 
+      case kSetCompressionDictionary: {
+        fragments_.clear();
+        prospective_record_offset = physical_record_offset;
+        last_record_offset_ = prospective_record_offset;
+        in_fragmented_record_ = false;
+        InitCompressionDictionary(fragment);
+        break;
+      }
+
       case kUserDefinedTimestampSizeType:
       case kRecyclableUserDefinedTimestampSizeType: {
         if (in_fragmented_record_ && !scratch->empty()) {
@@ -914,6 +943,7 @@ bool FragmentBufferedReader::TryReadFragment(
   buffer_.remove_prefix(header_size + length);
 
   if (!uncompress_ || type == kSetCompressionType ||
+      type == kSetCompressionDictionary ||
       type == kUserDefinedTimestampSizeType ||
       type == kRecyclableUserDefinedTimestampSizeType) {
     *fragment = Slice(header + header_size, length);
@@ -206,6 +206,9 @@ class Reader {
 
   void InitCompression(const CompressionTypeRecord& compression_record);
 
+  // Loads the dictionary the records following it were compressed with
+  void InitCompressionDictionary(const Slice& compression_dict);
+
   rocksdb_rs::status::Status UpdateRecordedTimestampSize(
       const std::vector<std::pair<uint32_t, size_t>>& cf_to_ts_sz);
 };
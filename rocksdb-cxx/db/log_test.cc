@@ -1043,6 +1043,30 @@ TEST_P(CompressionLogTest, ReadWrite) {
   ASSERT_EQ("EOF", Read());  // Make sure reads at eof work
 }
 
+TEST_P(CompressionLogTest, ReadWriteWithDictionary) {
+  rocksdb_rs::compression_type::CompressionType compression_type =
+      std::get<2>(GetParam());
+  if (!StreamingCompressionTypeSupported(compression_type)) {
+    ROCKSDB_GTEST_SKIP("Test requires support for compression type");
+    return;
+  }
+  // A raw content dictionary. Compression types without dictionary support
+  // ignore it.
+  std::string dict;
+  for (int i = 0; i < 100; i++) {
+    dict += "dictionary" + std::to_string(i);
+  }
+  ASSERT_OK(writer_->AddCompressionTypeRecord(dict).status());
+  Write("dictionary42");
+  Write("");
+  Write(BigString("dictionary", 3 * kBlockSize));
+  ASSERT_EQ("dictionary42", Read());
+  ASSERT_EQ("", Read());
+  ASSERT_EQ(BigString("dictionary", 3 * kBlockSize), Read());
+  ASSERT_EQ("EOF", Read());
+  ASSERT_EQ(0U, DroppedBytes());
+}
+
 TEST_P(CompressionLogTest, ReadWriteWithTimestampSize) {
   rocksdb_rs::compression_type::CompressionType compression_type =
       std::get<2>(GetParam());
@@ -1153,7 +1177,8 @@ INSTANTIATE_TEST_CASE_P(
         ::testing::Values(0, 1), ::testing::Bool(),
         ::testing::Values(
             rocksdb_rs::compression_type::CompressionType::kNoCompression,
-            rocksdb_rs::compression_type::CompressionType::kZSTD)));
+            rocksdb_rs::compression_type::CompressionType::kZSTD,
+            rocksdb_rs::compression_type::CompressionType::kLZ4Compression)));
 
 class StreamingCompressionTest
     : public ::testing::TestWithParam<
@@ -1224,7 +1249,8 @@ INSTANTIATE_TEST_CASE_P(
     ::testing::Combine(
         ::testing::Values(10, 100, 1000, kBlockSize, kBlockSize * 2),
         ::testing::Values(
-            rocksdb_rs::compression_type::CompressionType::kZSTD)));
+            rocksdb_rs::compression_type::CompressionType::kZSTD,
+            rocksdb_rs::compression_type::CompressionType::kLZ4Compression)));
 
 }  // namespace log
 }  // namespace rocksdb
@@ -161,7 +161,8 @@ rocksdb_rs::io_status::IOStatus Writer::AddRecord(
   return s;
 }
 
-rocksdb_rs::io_status::IOStatus Writer::AddCompressionTypeRecord() {
+rocksdb_rs::io_status::IOStatus Writer::AddCompressionTypeRecord(
+    const Slice& compression_dict) {
   // Should be the first record
   assert(block_offset_ == 0);
 
@@ -192,6 +193,15 @@ rocksdb_rs::io_status::IOStatus Writer::AddCompressionTypeRecord() {
     compressed_buffer_ =
         std::unique_ptr<char[]>(new char[max_output_buffer_len]);
     assert(compressed_buffer_);
+    if (s.ok() && !compression_dict.empty() &&
+        compress_->SetDictionary(compression_dict)) {
+      assert(compression_dict.size() <= kMaxCompressionDictBytes);
+      s = EmitPhysicalRecord(kSetCompressionDictionary,
+                             compression_dict.data(), compression_dict.size());
+      if (s.ok() && !manual_flush_) {
+        s = dest_->Flush();
+      }
+    }
   } else {
     // Disable compression if the record could not be added.
     compression_type_ =
@@ -244,7 +254,7 @@ rocksdb_rs::io_status::IOStatus Writer::EmitPhysicalRecord(
 
   uint32_t crc = type_crc_[t];
   if (t < kRecyclableFullType || t == kSetCompressionType ||
-      t == kUserDefinedTimestampSizeType) {
+      t == kUserDefinedTimestampSizeType || t == kSetCompressionDictionary) {
     // Legacy record format
     assert(block_offset_ + kHeaderSize + n <= kBlockSize);
     header_size = kHeaderSize;
@@ -89,7 +89,12 @@ class Writer {
   rocksdb_rs::io_status::IOStatus AddRecord(
       const Slice& slice,
       Env::IOPriority rate_limiter_priority = Env::IO_TOTAL);
-  rocksdb_rs::io_status::IOStatus AddCompressionTypeRecord();
+  // Adds the record of the compression type, which must be the first record,
+  // followed by a record of `compression_dict` if it is not empty and the
+  // compression type supports dictionaries. The following records are then
+  // compressed with that dictionary.
+  rocksdb_rs::io_status::IOStatus AddCompressionTypeRecord(
+      const Slice& compression_dict = Slice());
 
   // If there are column families in `cf_to_ts_sz` not included in
   // `recorded_cf_to_ts_sz_` and its user-defined timestamp size is non-zero,
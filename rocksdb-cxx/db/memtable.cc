@@ -66,7 +66,8 @@ ImmutableMemTableOptions::ImmutableMemTableOptions(
       info_log(ioptions.logger),
       allow_data_in_errors(ioptions.allow_data_in_errors),
       protection_bytes_per_key(
-          mutable_cf_options.memtable_protection_bytes_per_key) {}
+          mutable_cf_options.memtable_protection_bytes_per_key),
+      max_range_deletions(mutable_cf_options.memtable_max_range_deletions) {}
 
 MemTable::MemTable(const InternalKeyComparator& cmp,
                    const ImmutableOptions& ioptions,
@@ -95,6 +96,7 @@ MemTable::MemTable(const InternalKeyComparator& cmp,
       data_size_(0),
       num_entries_(0),
       num_deletes_(0),
+      num_range_deletes_(0),
       write_buffer_size_(mutable_cf_options.write_buffer_size),
       flush_in_progress_(false),
       flush_completed_(false),
@@ -170,6 +172,14 @@ size_t MemTable::ApproximateMemoryUsage() {
 }
 
 bool MemTable::ShouldFlushNow() {
+  // Reads fragment all range tombstones of the mutable memtable whenever one
+  // is added, so keep their number bounded if asked to.
+  if (moptions_.max_range_deletions > 0 &&
+      num_range_deletes_.load(std::memory_order_relaxed) >=
+          moptions_.max_range_deletions) {
+    return true;
+  }
+
   size_t write_buffer_size = write_buffer_size_.load(std::memory_order_relaxed);
   // In a lot of times, we cannot allocate arena blocks that exactly matches the
   // buffer size. Thus we have to decide if we should over-allocate or
@@ -764,6 +774,10 @@ rocksdb_rs::status::Status MemTable::Add(
         type == kTypeDeletionWithTimestamp) {
       num_deletes_.store(num_deletes_.load(std::memory_order_relaxed) + 1,
                          std::memory_order_relaxed);
+    } else if (type == kTypeRangeDeletion) {
+      num_range_deletes_.store(
+          num_range_deletes_.load(std::memory_order_relaxed) + 1,
+          std::memory_order_relaxed);
     }
 
     if (bloom_filter_ && prefix_extractor_ &&
@@ -800,6 +814,8 @@ rocksdb_rs::status::Status MemTable::Add(
     post_process_info->data_size += encoded_len;
     if (type == kTypeDeletion) {
       post_process_info->num_deletes++;
+    } else if (type == kTypeRangeDeletion) {
+      post_process_info->num_range_deletes++;
     }
 
     if (bloom_filter_ && prefix_extractor_ &&
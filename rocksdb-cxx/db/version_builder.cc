@@ -1164,8 +1164,16 @@ class VersionBuilder::Rep {
   void SaveSSTFilesTo(VersionStorageInfo* vstorage, int level, Cmp cmp) const {
     // Merge the set of added files with the set of pre-existing files.
     // Drop any deleted files.  Store the result in *vstorage.
-    const auto& base_files = base_vstorage_->LevelFiles(level);
     const auto& unordered_added_files = levels_[level].added_files;
+    if (level > 0 && unordered_added_files.empty() &&
+        levels_[level].deleted_files.empty()) {
+      // Unchanged level. L0 is excluded since its files can be sorted
+      // differently than in the base version.
+      vstorage->ShareLevelFrom(level, *base_vstorage_);
+      return;
+    }
+
+    const auto& base_files = base_vstorage_->LevelFiles(level);
     vstorage->Reserve(level, base_files.size() + unordered_added_files.size());
 
     // Sort added files for the level.
@@ -215,6 +215,60 @@ TEST_F(VersionBuilderTest, ApplyAndSaveTo) {
   UnrefFilesInVersion(&new_vstorage);
 }
 
+TEST_F(VersionBuilderTest, SaveToSharesUnchangedLevels) {
+  Add(1, 66U, "150", "200", 100U);
+  Add(1, 88U, "201", "300", 100U);
+
+  Add(2, 6U, "150", "179", 100U);
+  Add(2, 7U, "180", "220", 100U);
+
+  Add(3, 26U, "150", "170", 100U);
+  Add(3, 27U, "171", "179", 100U);
+
+  UpdateVersionStorageInfo();
+
+  VersionEdit version_edit;
+  version_edit.AddFile(
+      3, 666, 0, 100U, GetInternalKey("301"), GetInternalKey("350"), 200, 200,
+      false, Temperature::kUnknown, kInvalidBlobFileNumber,
+      kUnknownOldestAncesterTime, kUnknownFileCreationTime, kUnknownEpochNumber,
+      kUnknownFileChecksum, kUnknownFileChecksumFuncName,
+      rocksdb_rs::unique_id::UniqueId64x2_null(), 0, 0,
+      /* user_defined_timestamps_persisted */ true);
+
+  EnvOptions env_options;
+  constexpr TableCache* table_cache = nullptr;
+  constexpr VersionSet* version_set = nullptr;
+
+  VersionBuilder version_builder(env_options, &ioptions_, table_cache,
+                                 &vstorage_, version_set);
+
+  VersionStorageInfo new_vstorage(&icmp_, ucmp_, options_.num_levels,
+                                  kCompactionStyleLevel, nullptr, false);
+  ASSERT_OK(version_builder.Apply(&version_edit));
+  ASSERT_OK(version_builder.SaveTo(&new_vstorage));
+
+  UpdateVersionStorageInfo(&new_vstorage);
+
+  for (int level = 1; level <= 2; ++level) {
+    ASSERT_EQ(vstorage_.LevelFiles(level), new_vstorage.LevelFiles(level));
+    for (auto* f : new_vstorage.LevelFiles(level)) {
+      ASSERT_EQ(2, f->refs);
+    }
+    // The brief is not copied again
+    ASSERT_EQ(vstorage_.LevelFilesBrief(level).files,
+              new_vstorage.LevelFilesBrief(level).files);
+  }
+  ASSERT_EQ(3U, new_vstorage.LevelFiles(3).size());
+  ASSERT_EQ(3U, new_vstorage.LevelFilesBrief(3).num_files);
+  ASSERT_NE(vstorage_.LevelFilesBrief(3).files,
+            new_vstorage.LevelFilesBrief(3).files);
+  ASSERT_EQ(300U, new_vstorage.NumLevelBytes(3));
+  ASSERT_GT(new_vstorage.EstimateMetadataMemoryUsage(), 0U);
+
+  UnrefFilesInVersion(&new_vstorage);
+}
+
 TEST_F(VersionBuilderTest, ApplyAndSaveToDynamic) {
   ioptions_.level_compaction_dynamic_level_bytes = true;
 
@@ -52,6 +52,7 @@
 #include "file/writable_file_writer.h"
 #include "logging/logging.h"
 #include "monitoring/file_read_sample.h"
+#include "monitoring/iostats_context_imp.h"
 #include "monitoring/perf_context_imp.h"
 #include "monitoring/persistent_stats_history.h"
 #include "options/options_helper.h"
@@ -979,7 +980,10 @@ class LevelIterator final : public InternalIterator {
     }
   }
 
-  ~LevelIterator() override { delete file_iter_.Set(nullptr); }
+  ~LevelIterator() override {
+    ClearPrefetchedFile();
+    delete file_iter_.Set(nullptr);
+  }
 
   // Seek to the first file with a key >= target.
   // If range_tombstone_iter_ is not nullptr, then we pretend that file
@@ -1065,6 +1069,11 @@ class LevelIterator final : public InternalIterator {
   void SkipEmptyFileBackward();
   void SetFileIterator(InternalIterator* iter);
   void InitFileIterator(size_t new_file_index);
+  // With async_io, compaction opens the file after the current one ahead of
+  // time and submits the read of its first data block, so that moving to it
+  // does not stall on I/O.
+  void PrefetchNextFile();
+  void ClearPrefetchedFile();
 
   const Slice& file_smallest_key(size_t file_index) {
     assert(file_index < flevel_->num_files);
@@ -1095,7 +1104,14 @@ class LevelIterator final : public InternalIterator {
   // into the new file. Old range tombstone iterator is cleared.
   InternalIterator* NewFileIterator() {
     assert(file_index_ < flevel_->num_files);
-    auto file_meta = flevel_->files[file_index_];
+    CheckMayBeOutOfLowerBound();
+    ClearRangeTombstoneIter();
+    return NewFileIteratorAt(file_index_, range_tombstone_iter_);
+  }
+
+  InternalIterator* NewFileIteratorAt(
+      size_t file_index, TruncatedRangeDelIterator** range_tombstone_iter) {
+    auto file_meta = flevel_->files[file_index];
     if (should_sample_) {
       sample_file_read_inc(file_meta.file_metadata);
     }
@@ -1103,11 +1119,9 @@ class LevelIterator final : public InternalIterator {
     const InternalKey* smallest_compaction_key = nullptr;
     const InternalKey* largest_compaction_key = nullptr;
     if (compaction_boundaries_ != nullptr) {
-      smallest_compaction_key = (*compaction_boundaries_)[file_index_].smallest;
-      largest_compaction_key = (*compaction_boundaries_)[file_index_].largest;
+      smallest_compaction_key = (*compaction_boundaries_)[file_index].smallest;
+      largest_compaction_key = (*compaction_boundaries_)[file_index].largest;
     }
-    CheckMayBeOutOfLowerBound();
-    ClearRangeTombstoneIter();
     return table_cache_->NewIterator(
         read_options_, file_options_, icomparator_, *file_meta.file_metadata,
         range_del_agg_, prefix_extractor_,
@@ -1115,7 +1129,7 @@ class LevelIterator final : public InternalIterator {
         /*arena=*/nullptr, skip_filters_, level_,
         /*max_file_size_for_l0_meta_pin=*/0, smallest_compaction_key,
         largest_compaction_key, allow_unprepared_value_,
-        block_protection_bytes_per_key_, range_tombstone_iter_);
+        block_protection_bytes_per_key_, range_tombstone_iter);
   }
 
   // Check if current file being fully within iterate_lower_bound.
@@ -1194,6 +1208,13 @@ class LevelIterator final : public InternalIterator {
   // and the next file has a different prefix. SkipEmptyFileForward()
   // will not move to next file when this flag is set.
   bool prefix_exhausted_ = false;
+
+  // Iterator into the file at prefetched_file_index_, opened by
+  // PrefetchNextFile(), along with its range tombstones if
+  // range_tombstone_iter_ is set.
+  InternalIterator* prefetched_file_iter_ = nullptr;
+  TruncatedRangeDelIterator* prefetched_range_tombstone_iter_ = nullptr;
+  size_t prefetched_file_index_ = 0;
 };
 
 void LevelIterator::TrySetDeleteRangeSentinel(const Slice& boundary_key) {
@@ -1346,6 +1367,7 @@ void LevelIterator::SeekToFirst() {
       // we could have an empty file with only range tombstones.
       TrySetDeleteRangeSentinel(file_largest_key(file_index_));
     }
+    PrefetchNextFile();
   }
   SkipEmptyFileForward();
   CheckMayBeOutOfLowerBound();
@@ -1459,6 +1481,7 @@ bool LevelIterator::SkipEmptyFileForward() {
         }
         TrySetDeleteRangeSentinel(file_largest_key(file_index_));
       }
+      PrefetchNextFile();
     }
   }
   return seen_empty_file;
@@ -1514,6 +1537,12 @@ void LevelIterator::SetFileIterator(InternalIterator* iter) {
 }
 
 void LevelIterator::InitFileIterator(size_t new_file_index) {
+  // Keep the prefetched file if we are moving to it or to the file before it
+  if (prefetched_file_iter_ != nullptr &&
+      prefetched_file_index_ != new_file_index &&
+      prefetched_file_index_ != new_file_index + 1) {
+    ClearPrefetchedFile();
+  }
   if (new_file_index >= flevel_->num_files) {
     file_index_ = new_file_index;
     SetFileIterator(nullptr);
@@ -1528,6 +1557,18 @@ void LevelIterator::InitFileIterator(size_t new_file_index) {
         new_file_index == file_index_) {
       // file_iter_ is already constructed with this iterator, so
       // no need to change anything
+    } else if (prefetched_file_iter_ != nullptr &&
+               new_file_index == prefetched_file_index_) {
+      file_index_ = new_file_index;
+      CheckMayBeOutOfLowerBound();
+      ClearRangeTombstoneIter();
+      if (range_tombstone_iter_) {
+        *range_tombstone_iter_ = prefetched_range_tombstone_iter_;
+        prefetched_range_tombstone_iter_ = nullptr;
+      }
+      InternalIterator* iter = prefetched_file_iter_;
+      prefetched_file_iter_ = nullptr;
+      SetFileIterator(iter);
     } else {
       file_index_ = new_file_index;
       InternalIterator* iter = NewFileIterator();
@@ -1535,6 +1576,34 @@ void LevelIterator::InitFileIterator(size_t new_file_index) {
     }
   }
 }
+
+void LevelIterator::PrefetchNextFile() {
+  if (caller_ != TableReaderCaller::kCompaction || !read_options_.async_io ||
+      prefetched_file_iter_ != nullptr) {
+    return;
+  }
+  size_t next_file_index = file_index_ + 1;
+  if (next_file_index >= flevel_->num_files ||
+      KeyReachedUpperBound(file_smallest_key(next_file_index))) {
+    return;
+  }
+  TEST_SYNC_POINT("LevelIterator::PrefetchNextFile");
+  prefetched_file_index_ = next_file_index;
+  prefetched_file_iter_ = NewFileIteratorAt(
+      next_file_index,
+      range_tombstone_iter_ ? &prefetched_range_tombstone_iter_ : nullptr);
+  // With async_io, seeking a block based table only submits the read of the
+  // data block and returns. The SeekToFirst() done when moving to this file
+  // completes the seek.
+  prefetched_file_iter_->Seek(file_smallest_key(next_file_index));
+}
+
+void LevelIterator::ClearPrefetchedFile() {
+  delete prefetched_file_iter_;
+  prefetched_file_iter_ = nullptr;
+  delete prefetched_range_tombstone_iter_;
+  prefetched_range_tombstone_iter_ = nullptr;
+}
 }  // anonymous namespace
 
 rocksdb_rs::status::Status Version::GetTableProperties(
@@ -2385,6 +2454,14 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
     pinned_iters_mgr->StartPinning();
   }
 
+#if USE_COROUTINES
+  if (read_options.async_io && read_options.speculative_get_reads &&
+      read_options.fill_cache && using_coroutines() && use_async_io_ &&
+      *max_covering_tombstone_seq == 0 && !cfd_->ioptions()->row_cache) {
+    SpeculativeGetReads(read_options, k, callback, &blob_fetcher);
+  }
+#endif  // USE_COROUTINES
+
   FilePicker fp(user_key, ikey, &storage_info_.level_files_brief_,
                 storage_info_.num_non_empty_levels_,
                 &storage_info_.file_indexer_, user_comparator(),
@@ -3043,6 +3120,114 @@ rocksdb_rs::status::Status Version::MultiGetAsync(
 
   return s;
 }
+
+void Version::SpeculativeGetReads(const ReadOptions& read_options,
+                                  const LookupKey& k, ReadCallback* callback,
+                                  BlobFetcher* blob_fetcher) {
+  struct Candidate {
+    FdWithKeyRange* file;
+    int level;
+    bool skip_filters;
+  };
+  autovector<Candidate, 8> candidates;
+  FilePicker fp(k.user_key(), k.internal_key(),
+                &storage_info_.level_files_brief_,
+                storage_info_.num_non_empty_levels_,
+                &storage_info_.file_indexer_, user_comparator(),
+                internal_comparator());
+  for (FdWithKeyRange* f = fp.GetNextFile();
+       f != nullptr && candidates.size() < MultiGetContext::MAX_BATCH_SIZE;
+       f = fp.GetNextFile()) {
+    int level = static_cast<int>(fp.GetHitFileLevel());
+    candidates.push_back(
+        {f, level, IsFilterSkipped(level, fp.IsHitFileLastInLevel())});
+  }
+  if (candidates.size() < 2) {
+    // Nothing to overlap
+    return;
+  }
+
+  // One key context per file, all for the same key, so that the lookups do
+  // not share any state
+  const size_t num_files = candidates.size();
+  const Slice user_key = StripTimestampFromUserKey(
+      k.user_key(),
+      read_options.timestamp == nullptr ? 0 : read_options.timestamp->size());
+  std::vector<PinnableSlice> values(num_files);
+  std::vector<rocksdb_rs::status::Status> statuses;
+  autovector<KeyContext, MultiGetContext::MAX_BATCH_SIZE> key_contexts;
+  autovector<KeyContext*, MultiGetContext::MAX_BATCH_SIZE> sorted_keys;
+  statuses.reserve(num_files);
+  for (size_t i = 0; i < num_files; ++i) {
+    statuses.push_back(rocksdb_rs::status::Status_OK());
+    key_contexts.emplace_back(nullptr, user_key, &values[i], nullptr, nullptr,
+                              &statuses[i]);
+    sorted_keys.push_back(&key_contexts[i]);
+  }
+  // The lookups are repeated by Get(), which counts them, so these have no
+  // statistics, and neither perf nor IO stats context
+  MultiGetContext ctx(&sorted_keys, 0, num_files,
+                      GetInternalKeySeqno(k.internal_key()), read_options,
+                      env_->GetFileSystem().get(), /*stats=*/nullptr);
+  MultiGetRange range = ctx.GetMultiGetRange();
+  autovector<GetContext, 8> get_ctx;
+  for (auto iter = range.begin(); iter != range.end(); ++iter) {
+    get_ctx.emplace_back(
+        user_comparator(), merge_operator_, info_log_, /*statistics=*/nullptr,
+        GetContext::kNotFound, iter->ukey_with_ts, iter->value,
+        iter->columns, iter->timestamp, nullptr, &(iter->merge_context),
+        true, &iter->max_covering_tombstone_seq, clock_, nullptr, nullptr,
+        callback, &iter->is_blob_index, BlockCacheTraceHelper::kReservedGetId,
+        blob_fetcher);
+  }
+  std::vector<folly::coro::Task<void>> tasks;
+  size_t stop_index = num_files;
+  size_t index = 0;
+  for (auto iter = range.begin(); iter != range.end(); ++iter, ++index) {
+    iter->get_context = &get_ctx[index];
+    auto next = iter;
+    ++next;
+    const Candidate& candidate = candidates[index];
+    tasks.emplace_back(SpeculativeGetFromSST(
+        read_options, MultiGetRange(range, iter, next), candidate.file,
+        candidate.level, candidate.skip_filters, index, &stop_index));
+  }
+  const PerfLevel prev_perf_level = GetPerfLevel();
+  SetPerfLevel(PerfLevel::kDisable);
+  IOSTATS_SET_DISABLE(true);
+  folly::coro::blockingWait(folly::coro::collectAllRange(std::move(tasks))
+                                .scheduleOn(&ctx.executor()));
+  IOSTATS_SET_DISABLE(false);
+  SetPerfLevel(prev_perf_level);
+}
+
+folly::coro::Task<void> Version::SpeculativeGetFromSST(
+    const ReadOptions& read_options, MultiGetRange file_range,
+    FdWithKeyRange* f, int hit_file_level, bool skip_filters, size_t index,
+    size_t* stop_index) {
+  // Tasks run one at a time on the executor of the MultiGetContext, so the
+  // stop index needs no synchronization. A lookup already waiting for its
+  // reads cannot be cancelled though.
+  if (*stop_index < index) {
+    RecordTick(db_statistics_, GET_SPECULATIVE_FILE_LOOKUPS_CANCELLED);
+    co_return;
+  }
+  RecordTick(db_statistics_, GET_SPECULATIVE_FILE_LOOKUPS);
+  rocksdb_rs::status::Status s = co_await table_cache_->MultiGetCoroutine(
+      read_options, *internal_comparator(), *f->file_metadata, &file_range,
+      mutable_cf_options_.block_protection_bytes_per_key,
+      mutable_cf_options_.prefix_extractor,
+      cfd_->internal_stats()->GetFileReadHist(hit_file_level), skip_filters,
+      /*skip_range_deletions=*/false, hit_file_level,
+      /*table_handle=*/nullptr);
+  const KeyContext& key = *file_range.begin();
+  GetContext::GetState state = key.get_context->State();
+  if (!s.ok() || !key.s->ok() || key.max_covering_tombstone_seq > 0 ||
+      (state != GetContext::kNotFound && state != GetContext::kMerge)) {
+    // Get() does not look further than this file
+    *stop_index = std::min(*stop_index, index);
+  }
+}
 #endif
 
 bool Version::IsFilterSkipped(int level, bool is_file_last_in_level) {
@@ -3053,11 +3238,52 @@ bool Version::IsFilterSkipped(int level, bool is_file_last_in_level) {
          level == storage_info_.num_non_empty_levels() - 1;
 }
 
+struct VersionStorageInfo::LevelFilesBriefStorage {
+  explicit LevelFilesBriefStorage(const std::vector<FileMetaData*>& files) {
+    // Same layout as DoGenerateLevelFilesBrief(), in a single allocation
+    // of the exact size, as it can outlive the version it is made for
+    size_t num = files.size();
+    size = num * sizeof(FdWithKeyRange);
+    for (const FileMetaData* f : files) {
+      size += f->smallest.size() + f->largest.size();
+    }
+    mem.reset(new char[size]);
+    brief.num_files = num;
+    brief.files = new (mem.get()) FdWithKeyRange[num];
+
+    char* keys = mem.get() + num * sizeof(FdWithKeyRange);
+    for (size_t i = 0; i < num; i++) {
+      Slice smallest_key = files[i]->smallest.Encode();
+      Slice largest_key = files[i]->largest.Encode();
+      memcpy(keys, smallest_key.data(), smallest_key.size());
+      memcpy(keys + smallest_key.size(), largest_key.data(),
+             largest_key.size());
+
+      FdWithKeyRange& f = brief.files[i];
+      f.fd = files[i]->fd;
+      f.file_metadata = files[i];
+      f.smallest_key = Slice(keys, smallest_key.size());
+      f.largest_key = Slice(keys + smallest_key.size(), largest_key.size());
+      keys += smallest_key.size() + largest_key.size();
+    }
+  }
+
+  rocksdb::LevelFilesBrief brief;
+  std::unique_ptr<char[]> mem;
+  size_t size;
+};
+
 void VersionStorageInfo::GenerateLevelFilesBrief() {
   level_files_brief_.resize(num_non_empty_levels_);
+  level_files_brief_storage_.resize(num_non_empty_levels_);
   for (int level = 0; level < num_non_empty_levels_; level++) {
-    DoGenerateLevelFilesBrief(&level_files_brief_[level], files_[level],
-                              &arena_);
+    auto& storage = level_files_brief_storage_[level];
+    bool shared = static_cast<size_t>(level) < shared_levels_.size() &&
+                  shared_levels_[level];
+    if (!shared || storage == nullptr) {
+      storage = std::make_shared<LevelFilesBriefStorage>(files_[level]);
+    }
+    level_files_brief_[level] = storage->brief;
   }
 }
 
@@ -3849,6 +4075,36 @@ void VersionStorageInfo::AddFile(int level, FileMetaData* f) {
   f->refs++;
 }
 
+void VersionStorageInfo::ShareLevelFrom(int level,
+                                        const VersionStorageInfo& base) {
+  assert(level >= 0 && level < num_levels_ && level < base.num_levels_);
+  assert(files_[level].empty());
+
+  files_[level] = base.files_[level];
+  for (auto* f : files_[level]) {
+    f->refs++;
+  }
+
+  if (static_cast<size_t>(level) < base.level_files_brief_storage_.size()) {
+    if (level_files_brief_storage_.size() <= static_cast<size_t>(level)) {
+      level_files_brief_storage_.resize(level + 1);
+    }
+    level_files_brief_storage_[level] =
+        base.level_files_brief_storage_[level];
+  }
+
+  // The index of a level depends on its files and on the files of the level
+  // below it
+  shared_levels_.resize(num_levels_);
+  shared_levels_[level] = true;
+  if (level > 0 && shared_levels_[level - 1]) {
+    file_indexer_.ShareLevelIndex(base.file_indexer_, level - 1);
+  }
+  if (level + 1 < num_levels_ && shared_levels_[level + 1]) {
+    file_indexer_.ShareLevelIndex(base.file_indexer_, level);
+  }
+}
+
 void VersionStorageInfo::AddBlobFile(
     std::shared_ptr<BlobFileMetaData> blob_file_meta) {
   assert(blob_file_meta);
@@ -4797,6 +5053,23 @@ uint64_t VersionStorageInfo::EstimateLiveDataSize() const {
   return size;
 }
 
+uint64_t VersionStorageInfo::EstimateMetadataMemoryUsage() const {
+  uint64_t usage = arena_.MemoryAllocatedBytes() +
+                   file_indexer_.ApproximateMemoryUsage();
+  for (int level = 0; level < num_levels_; level++) {
+    usage += files_[level].capacity() * sizeof(FileMetaData*) +
+             files_by_compaction_pri_[level].capacity() * sizeof(int);
+  }
+  for (const auto& storage : level_files_brief_storage_) {
+    if (storage != nullptr) {
+      usage += sizeof(LevelFilesBriefStorage) + storage->size;
+    }
+  }
+  usage += file_locations_.size() *
+           (sizeof(FileLocations::value_type) + sizeof(void*));
+  return usage;
+}
+
 bool VersionStorageInfo::RangeMightExistAfterSortedRun(
     const Slice& smallest_user_key, const Slice& largest_user_key,
     int last_level, int last_l0_idx) {
@@ -5131,6 +5404,7 @@ rocksdb_rs::status::Status VersionSet::ProcessManifestWrites(
     const ReadOptions& read_options) {
   mu->AssertHeld();
   assert(!writers.empty());
+  StopWatch sw(clock_, db_options_->stats, LOG_AND_APPLY_MICROS);
   ManifestWriter& first_writer = writers.front();
   ManifestWriter* last_writer = &first_writer;
 
@@ -143,6 +143,14 @@ class VersionStorageInfo {
 
   void AddFile(int level, FileMetaData* f);
 
+  // Gives `level` the files it has in `base`, the version this one is built
+  // from. Besides saving the per file work of AddFile(), this lets the level
+  // reuse the brief and file indexer data `base` derived from its files, so
+  // that the cost of preparing the version grows with the levels changed
+  // rather than with the files in the DB.
+  // REQUIRES: no file was added to `level` yet
+  void ShareLevelFrom(int level, const VersionStorageInfo& base);
+
   // Resize/Initialize the space for compact_cursor_
   void ResizeCompactCursors(int level) {
     compact_cursor_.resize(level, InternalKey());
@@ -580,6 +588,11 @@ class VersionStorageInfo {
   // Returns an estimate of the amount of live data in bytes.
   uint64_t EstimateLiveDataSize() const;
 
+  // Returns an estimate of the memory used by the file metadata of this
+  // version, excluding the FileMetaData objects but including the parts
+  // shared with other versions.
+  uint64_t EstimateMetadataMemoryUsage() const;
+
   uint64_t estimated_compaction_needed_bytes() const {
     return estimated_compaction_needed_bytes_;
   }
@@ -631,8 +644,16 @@ class VersionStorageInfo {
 
   // A short brief metadata of files per level
   autovector<rocksdb::LevelFilesBrief> level_files_brief_;
+  // Owns the memory of level_files_brief_, per level. A level shares it with
+  // the versions it is unchanged in.
+  struct LevelFilesBriefStorage;
+  std::vector<std::shared_ptr<const LevelFilesBriefStorage>>
+      level_files_brief_storage_;
+  // Levels given the files of the version this one is built from by
+  // ShareLevelFrom()
+  std::vector<bool> shared_levels_;
   FileIndexer file_indexer_;
-  Arena arena_;  // Used to allocate space for file_levels_
+  Arena arena_;  // Used to allocate space for file_indexer_
 
   CompactionStyle compaction_style_;
 
@@ -1073,6 +1094,23 @@ class Version {
       std::deque<size_t>& to_process, unsigned int& num_tasks_queued,
       std::unordered_map<int, std::tuple<uint64_t, uint64_t, uint64_t>>&
           mget_stats);
+
+  // Looks key `k` up, with async IO and in parallel, in every SST file that
+  // Get() may look it up in, so that the data blocks Get() needs are in the
+  // block cache by the time it gets to them. The results of the lookups are
+  // discarded, and they are not counted in statistics or in the perf and IO
+  // stats contexts, as Get() counts the lookups it repeats.
+  void SpeculativeGetReads(const ReadOptions& read_options,
+                           const LookupKey& k, ReadCallback* callback,
+                           BlobFetcher* blob_fetcher);
+
+  // One of the lookups of SpeculativeGetReads(), in the file at position
+  // `index` in Get() order. Skipped if a file before it, at position
+  // *stop_index, is known to end the Get().
+  folly::coro::Task<void> SpeculativeGetFromSST(
+      const ReadOptions& read_options, MultiGetRange file_range,
+      FdWithKeyRange* f, int hit_file_level, bool skip_filters, size_t index,
+      size_t* stop_index);
 #endif
 
   ColumnFamilyData* cfd_;  // ColumnFamilyData to which this Version belongs
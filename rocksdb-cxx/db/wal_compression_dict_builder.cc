@@ -0,0 +1,65 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/wal_compression_dict_builder.h"
+
+#include <algorithm>
+
+#include "util/compression.h"
+#include "util/mutexlock.h"
+
+namespace rocksdb {
+
+namespace {
+// ZSTD recommends about 100 times as many sample bytes as dictionary bytes
+constexpr size_t kSampleBytesPerDictByte = 100;
+}  // namespace
+
+WalCompressionDictBuilder::WalCompressionDictBuilder(size_t max_dict_bytes)
+    : max_dict_bytes_(max_dict_bytes),
+      max_sample_bytes_(max_dict_bytes * kSampleBytesPerDictByte),
+      samples_full_(false) {}
+
+void WalCompressionDictBuilder::AddSample(const Slice& record) {
+  if (samples_full_.load(std::memory_order_relaxed) || record.empty()) {
+    return;
+  }
+  MutexLock l(&mu_);
+  if (samples_.size() >= max_sample_bytes_) {
+    return;
+  }
+  // A large record would crowd out the others
+  size_t len = std::min(
+      {record.size(), max_dict_bytes_, max_sample_bytes_ - samples_.size()});
+  samples_.append(record.data(), len);
+  sample_lens_.push_back(len);
+  if (samples_.size() >= max_sample_bytes_) {
+    samples_full_.store(true, std::memory_order_relaxed);
+  }
+}
+
+std::string WalCompressionDictBuilder::GetDictionary() {
+  MutexLock l(&mu_);
+  if (!samples_full_.load(std::memory_order_relaxed)) {
+    return dict_;
+  }
+  std::string dict;
+  if (ZSTD_TrainDictionarySupported()) {
+    dict = ZSTD_TrainDictionary(samples_, sample_lens_, max_dict_bytes_);
+  }
+  if (dict.empty()) {
+    // Not trainable, so use the most recent samples as a raw content
+    // dictionary, which ZSTD accepts as well
+    dict = samples_.substr(samples_.size() - max_dict_bytes_);
+  }
+  dict_ = std::move(dict);
+  samples_.clear();
+  sample_lens_.clear();
+  samples_full_.store(false, std::memory_order_relaxed);
+  return dict_;
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,51 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/slice.h"
+
+namespace rocksdb {
+
+// WalCompressionDictBuilder builds the ZSTD dictionary of the WALs of a DB
+// opened with DBOptions::wal_compression_max_dict_bytes. It keeps the records
+// written to the WALs as samples, and trains a new dictionary from them each
+// time it has gathered enough, for the WALs created afterwards.
+class WalCompressionDictBuilder {
+ public:
+  explicit WalCompressionDictBuilder(size_t max_dict_bytes);
+
+  // No copying allowed
+  WalCompressionDictBuilder(const WalCompressionDictBuilder&) = delete;
+  void operator=(const WalCompressionDictBuilder&) = delete;
+
+  // Keeps a prefix of `record` as a sample, unless enough samples are kept
+  // already. Thread-safe, and cheap once enough samples are kept.
+  void AddSample(const Slice& record);
+
+  // Returns the dictionary for a new WAL: a dictionary trained from the
+  // samples if enough were kept, which are then discarded, and the dictionary
+  // returned last time otherwise. Returns an empty string until enough
+  // samples are kept once.
+  std::string GetDictionary();
+
+ private:
+  const size_t max_dict_bytes_;
+  const size_t max_sample_bytes_;
+  std::atomic<bool> samples_full_;
+
+  port::Mutex mu_;
+  std::string samples_;
+  std::vector<size_t> sample_lens_;
+  std::string dict_;
+};
+
+}  // namespace rocksdb
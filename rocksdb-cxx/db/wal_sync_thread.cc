@@ -0,0 +1,87 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/wal_sync_thread.h"
+
+#include <algorithm>
+
+#include "test_util/sync_point.h"
+#include "util/mutexlock.h"
+
+namespace rocksdb {
+
+WalSyncThread::WalSyncThread(
+    std::function<rocksdb_rs::status::Status()> sync_wal,
+    std::function<SequenceNumber()> last_sequence)
+    : sync_wal_(std::move(sync_wal)),
+      last_sequence_(std::move(last_sequence)),
+      cv_(&mu_) {
+  thread_ = port::Thread([this]() { BackgroundSync(); });
+}
+
+WalSyncThread::~WalSyncThread() { Stop(); }
+
+rocksdb_rs::status::Status WalSyncThread::WaitForSync(SequenceNumber seq) {
+  MutexLock l(&mu_);
+  while (true) {
+    if (synced_seq_ >= seq) {
+      return rocksdb_rs::status::Status_OK();
+    }
+    if (failed_seq_ >= seq) {
+      return failed_status_.Clone();
+    }
+    if (requested_seq_ < seq) {
+      if (stopped_) {
+        // The background thread only serves the requests made before Stop()
+        return rocksdb_rs::status::Status_ShutdownInProgress();
+      }
+      requested_seq_ = seq;
+      cv_.SignalAll();
+    }
+    cv_.Wait();
+  }
+}
+
+void WalSyncThread::BackgroundSync() {
+  MutexLock l(&mu_);
+  while (true) {
+    while (!stopped_ &&
+           requested_seq_ <= std::max(synced_seq_, failed_seq_)) {
+      cv_.Wait();
+    }
+    if (requested_seq_ <= std::max(synced_seq_, failed_seq_)) {
+      // Stopped with nothing pending
+      break;
+    }
+    mu_.Unlock();
+    // Every write up to `target` is appended to the WAL, so the sync below
+    // covers it, together with whatever is appended while the sync runs.
+    SequenceNumber target = last_sequence_();
+    TEST_SYNC_POINT("WalSyncThread::BackgroundSync:BeforeSync");
+    rocksdb_rs::status::Status s = sync_wal_();
+    mu_.Lock();
+    if (s.ok()) {
+      synced_seq_ = std::max(synced_seq_, target);
+    } else {
+      failed_seq_ = std::max(failed_seq_, target);
+      failed_status_ = std::move(s);
+    }
+    cv_.SignalAll();
+  }
+}
+
+void WalSyncThread::Stop() {
+  {
+    MutexLock l(&mu_);
+    stopped_ = true;
+    cv_.SignalAll();
+  }
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+}  // namespace rocksdb
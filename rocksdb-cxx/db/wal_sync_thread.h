@@ -0,0 +1,66 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <functional>
+
+#include "port/port.h"
+#include "rocksdb-rs/src/status.rs.h"
+#include "rocksdb/types.h"
+
+namespace rocksdb {
+
+/**
+ * WalSyncThread owns the WAL syncs of a DB opened with
+ * DBOptions::wal_group_commit. Writers append their batches to the WAL
+ * without syncing it and then wait here until a sync covering their sequence
+ * number completes. A single background thread performs the syncs, so all the
+ * writers that arrive while one sync is in progress share the next one,
+ * across as many write groups as were appended in the meantime.
+ */
+class WalSyncThread {
+ public:
+  // `sync_wal` syncs every WAL appended so far. `last_sequence` returns the
+  // last sequence number whose write has been appended to the WAL.
+  WalSyncThread(std::function<rocksdb_rs::status::Status()> sync_wal,
+                std::function<SequenceNumber()> last_sequence);
+
+  ~WalSyncThread();
+
+  // No copying allowed
+  WalSyncThread(const WalSyncThread&) = delete;
+  void operator=(const WalSyncThread&) = delete;
+
+  // Blocks until the writes up to `seq`, which must already be appended to
+  // the WAL, are synced. Returns the status of the sync that covered them, or
+  // ShutdownInProgress if the thread was stopped first.
+  rocksdb_rs::status::Status WaitForSync(SequenceNumber seq);
+
+  // Completes the pending syncs, then waits for the background thread to
+  // exit. Safe to call repeatedly.
+  void Stop();
+
+ private:
+  void BackgroundSync();
+
+  const std::function<rocksdb_rs::status::Status()> sync_wal_;
+  const std::function<SequenceNumber()> last_sequence_;
+
+  port::Mutex mu_;
+  port::CondVar cv_;
+  // Highest sequence number requested by a waiter
+  SequenceNumber requested_seq_ = 0;
+  // Highest sequence number covered by a successful sync
+  SequenceNumber synced_seq_ = 0;
+  // Highest sequence number covered by a failed sync, and its status
+  SequenceNumber failed_seq_ = 0;
+  rocksdb_rs::status::Status failed_status_ = rocksdb_rs::status::Status_new();
+  bool stopped_ = false;
+  port::Thread thread_;
+};
+
+}  // namespace rocksdb
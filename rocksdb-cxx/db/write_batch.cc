@@ -1821,6 +1821,8 @@ class MemTableInserter : public WriteBatch::Handler {
   // log number that all Memtables inserted into should reference
   uint64_t log_number_ref_;
   DBImpl* db_;
+  // Invalidated before each write is inserted, if the DB has one
+  HotKeyCache* const hot_key_cache_;
   const bool concurrent_memtable_writes_;
   bool post_info_created_;
   const WriteBatch::ProtectionInfo* prot_info_;
@@ -1935,6 +1937,7 @@ class MemTableInserter : public WriteBatch::Handler {
         recovering_log_number_(recovering_log_number),
         log_number_ref_(0),
         db_(static_cast_with_check<DBImpl>(db)),
+        hot_key_cache_(db_ != nullptr ? db_->hot_key_cache() : nullptr),
         concurrent_memtable_writes_(concurrent_memtable_writes),
         post_info_created_(false),
         prot_info_(prot_info),
@@ -1994,6 +1997,13 @@ class MemTableInserter : public WriteBatch::Handler {
     }
   }
 
+  // Must be called before the write of `key` at sequence_ is inserted
+  void InvalidateHotKey(uint32_t column_family_id, const Slice& key) {
+    if (hot_key_cache_ != nullptr) {
+      hot_key_cache_->InvalidateKey(column_family_id, key, sequence_);
+    }
+  }
+
   void set_log_number_ref(uint64_t log) { log_number_ref_ = log; }
   void set_prot_info(const WriteBatch::ProtectionInfo* prot_info) {
     prot_info_ = prot_info;
@@ -2082,6 +2092,7 @@ class MemTableInserter : public WriteBatch::Handler {
       return ret_status;
     }
     assert(ret_status.ok());
+    InvalidateHotKey(column_family_id, key);
 
     MemTable* mem = cf_mems_->GetMemTable();
     auto* moptions = mem->GetImmutableMemTableOptions();
@@ -2252,9 +2263,16 @@ class MemTableInserter : public WriteBatch::Handler {
   }
 
   rocksdb_rs::status::Status DeleteImpl(
-      uint32_t /*column_family_id*/, const Slice& key, const Slice& value,
+      uint32_t column_family_id, const Slice& key, const Slice& value,
       ValueType delete_type, const ProtectionInfoKVOS64* kv_prot_info) {
     rocksdb_rs::status::Status ret_status = rocksdb_rs::status::Status_new();
+    if (delete_type == kTypeRangeDeletion) {
+      if (hot_key_cache_ != nullptr) {
+        hot_key_cache_->InvalidateAll(sequence_);
+      }
+    } else {
+      InvalidateHotKey(column_family_id, key);
+    }
     MemTable* mem = cf_mems_->GetMemTable();
     ret_status =
         mem->Add(sequence_, delete_type, key, value, kv_prot_info,
@@ -2517,6 +2535,7 @@ class MemTableInserter : public WriteBatch::Handler {
       return ret_status;
     }
     assert(ret_status.ok());
+    InvalidateHotKey(column_family_id, key);
 
     MemTable* mem = cf_mems_->GetMemTable();
     auto* moptions = mem->GetImmutableMemTableOptions();
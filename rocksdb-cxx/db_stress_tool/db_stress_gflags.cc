@@ -897,6 +897,9 @@ DEFINE_bool(avoid_flush_during_recovery,
             rocksdb::Options().avoid_flush_during_recovery,
             "Avoid flush during recovery");
 
+DEFINE_int32(wal_recovery_threads, rocksdb::Options().wal_recovery_threads,
+             "Number of threads replaying WALs into memtables on DB open");
+
 DEFINE_uint64(max_write_batch_group_size_bytes,
               rocksdb::Options().max_write_batch_group_size_bytes,
               "Max write batch group size");
@@ -967,6 +970,11 @@ DEFINE_uint32(
     "specified number of bytes per key. Currently the supported "
     "nonzero values are 1, 2, 4 and 8.");
 
+DEFINE_uint32(memtable_max_range_deletions,
+              rocksdb::Options().memtable_max_range_deletions,
+              "If nonzero, a memtable is flushed once it holds this many "
+              "range deletions.");
+
 DEFINE_uint32(block_protection_bytes_per_key, 0,
               "If nonzero, enables integrity protection in blocks at the "
               "specified number of bytes per key. Currently the supported "
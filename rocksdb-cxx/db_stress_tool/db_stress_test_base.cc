@@ -130,10 +130,14 @@ std::shared_ptr<Cache> StressTest::NewCache(size_t capacity,
   if (FLAGS_cache_type == "clock_cache") {
     fprintf(stderr, "Old clock cache implementation has been removed.\n");
     exit(1);
-  } else if (FLAGS_cache_type == "hyper_clock_cache") {
-    HyperClockCacheOptions opts(static_cast<size_t>(capacity),
-                                FLAGS_block_size /*estimated_entry_charge*/,
-                                num_shard_bits);
+  } else if (FLAGS_cache_type == "hyper_clock_cache" ||
+             FLAGS_cache_type == "auto_hyper_clock_cache") {
+    HyperClockCacheOptions opts(
+        static_cast<size_t>(capacity),
+        FLAGS_cache_type == "auto_hyper_clock_cache"
+            ? 0  // table size determined online
+            : FLAGS_block_size /*estimated_entry_charge*/,
+        num_shard_bits);
     opts.secondary_cache = std::move(secondary_cache);
     return opts.MakeSharedCache();
   } else if (FLAGS_cache_type == "lru_cache") {
@@ -3196,6 +3200,7 @@ void InitializeOptionsFromFlags(
   options.avoid_unnecessary_blocking_io = FLAGS_avoid_unnecessary_blocking_io;
   options.write_dbid_to_manifest = FLAGS_write_dbid_to_manifest;
   options.avoid_flush_during_recovery = FLAGS_avoid_flush_during_recovery;
+  options.wal_recovery_threads = FLAGS_wal_recovery_threads;
   options.max_write_batch_group_size_bytes =
       FLAGS_max_write_batch_group_size_bytes;
   options.level_compaction_dynamic_level_bytes =
@@ -3205,6 +3210,7 @@ void InitializeOptionsFromFlags(
       FLAGS_verify_sst_unique_id_in_manifest;
   options.memtable_protection_bytes_per_key =
       FLAGS_memtable_protection_bytes_per_key;
+  options.memtable_max_range_deletions = FLAGS_memtable_max_range_deletions;
   options.block_protection_bytes_per_key = FLAGS_block_protection_bytes_per_key;
 
   // Integrated BlobDB
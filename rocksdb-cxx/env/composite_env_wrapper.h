@@ -376,6 +376,11 @@ class CompositeEnvWrapper : public CompositeEnv {
     return target_.env->LowerThreadPoolCPUPriority(pool, pri);
   }
 
+  rocksdb_rs::status::Status SetThreadPoolWorkStealing(
+      Priority pool, bool enabled) override {
+    return target_.env->SetThreadPoolWorkStealing(pool, enabled);
+  }
+
   rocksdb_rs::status::Status GetThreadList(
       std::vector<ThreadStatus>* thread_list) override {
     return target_.env->GetThreadList(thread_list);
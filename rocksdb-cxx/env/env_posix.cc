@@ -402,6 +402,13 @@ class PosixEnv : public CompositeEnv {
     return rocksdb_rs::status::Status_OK();
   }
 
+  rocksdb_rs::status::Status SetThreadPoolWorkStealing(Priority pool,
+                                                       bool enabled) override {
+    assert(pool >= Priority::BOTTOM && pool <= Priority::HIGH);
+    thread_pools_[pool].SetWorkStealing(enabled);
+    return rocksdb_rs::status::Status_OK();
+  }
+
  private:
   friend Env* Env::Default();
   // Constructs the default Env, a singleton
@@ -436,6 +436,86 @@ TEST_P(EnvPosixTestWithParam, UnSchedule) {
   WaitThreadPoolsEmpty();
 }
 
+TEST_P(EnvPosixTestWithParam, WorkStealing) {
+  constexpr int kNumThreads = 4;
+  env_->SetBackgroundThreads(kNumThreads, Env::LOW);
+  rocksdb_rs::status::Status s =
+      env_->SetThreadPoolWorkStealing(Env::LOW, true);
+  if (s.IsNotSupported()) {
+    ROCKSDB_GTEST_BYPASS("Work stealing is not supported");
+    return;
+  }
+  ASSERT_OK(s);
+
+  // Block every thread, so that the tasks scheduled next stay queued
+  std::vector<test::SleepingBackgroundTask> sleeping_tasks(kNumThreads);
+  for (auto& sleeping_task : sleeping_tasks) {
+    env_->Schedule(&test::SleepingBackgroundTask::DoSleepTask, &sleeping_task,
+                   Env::Priority::LOW);
+  }
+  for (auto& sleeping_task : sleeping_tasks) {
+    sleeping_task.WaitUntilSleeping();
+  }
+
+  struct CB {
+    static void Run(void* v) {
+      reinterpret_cast<std::atomic<int>*>(v)->fetch_add(1);
+    }
+  };
+  std::atomic<int> unscheduled(0);
+  std::atomic<int> run(0);
+  // The tasks are spread over the queues of the threads, and UnSchedule()
+  // finds them in all of them
+  for (int i = 0; i < 3 * kNumThreads; ++i) {
+    env_->Schedule(&CB::Run, &unscheduled, Env::Priority::LOW, &unscheduled);
+  }
+  ASSERT_EQ(static_cast<unsigned int>(3 * kNumThreads),
+            env_->GetThreadPoolQueueLen(Env::LOW));
+  ASSERT_EQ(3 * kNumThreads, env_->UnSchedule(&unscheduled, Env::LOW));
+  ASSERT_EQ(0U, env_->GetThreadPoolQueueLen(Env::LOW));
+
+  // Tasks scheduled from outside the pool, and from the pool threads
+  constexpr int kNumChildren = 10;
+  struct Parent {
+    Env* env;
+    std::atomic<int>* run;
+    static void Run(void* v) {
+      Parent* parent = reinterpret_cast<Parent*>(v);
+      for (int i = 0; i < kNumChildren; ++i) {
+        parent->env->Schedule(&CB::Run, parent->run, Env::Priority::LOW);
+      }
+      parent->run->fetch_add(1);
+    }
+  };
+  constexpr int kNumParents = 100;
+  Parent parent{env_, &run};
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < 2; ++t) {
+    threads.emplace_back([&]() {
+      for (int i = 0; i < kNumParents / 2; ++i) {
+        env_->Schedule(&Parent::Run, &parent, Env::Priority::LOW);
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  for (auto& sleeping_task : sleeping_tasks) {
+    sleeping_task.WakeUp();
+  }
+  for (auto& sleeping_task : sleeping_tasks) {
+    sleeping_task.WaitUntilDone();
+  }
+  while (run.load() < kNumParents * (kNumChildren + 1)) {
+    Env::Default()->SleepForMicroseconds(kDelayMicros);
+  }
+  ASSERT_EQ(kNumParents * (kNumChildren + 1), run.load());
+  ASSERT_EQ(0, unscheduled.load());
+
+  ASSERT_OK(env_->SetThreadPoolWorkStealing(Env::LOW, false));
+  WaitThreadPoolsEmpty();
+}
+
 // This tests assumes that the last scheduled
 // task will run last. In fact, in the allotted
 // sleeping time nothing may actually run or they may
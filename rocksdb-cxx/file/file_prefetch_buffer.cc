@@ -318,6 +318,7 @@ void FilePrefetchBuffer::PollAndUpdateBuffersIfNeeded(uint64_t offset) {
       std::vector<void*> handles;
       handles.emplace_back(bufs_[curr_].io_handle_);
       StopWatch sw(clock_, stats_, POLL_WAIT_MICROS);
+      IOSTATS_TIMER_GUARD(async_read_wait_nanos);
       fs_->Poll(handles, 1);
     }
 
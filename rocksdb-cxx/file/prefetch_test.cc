@@ -2423,6 +2423,93 @@ TEST_P(PrefetchTest, SeekParallelizationTestWithPosix) {
   Close();
 }
 
+// This test verifies that compaction reads its inputs asynchronously with
+// compaction_async_io and PosixFileSystem.
+TEST_P(PrefetchTest, CompactionAsyncIOWithPosixFS) {
+  if (mem_env_ || encrypted_env_) {
+    ROCKSDB_GTEST_SKIP("Test requires non-mem or non-encrypted environment");
+    return;
+  }
+
+  const int kNumKeys = 1000;
+  std::shared_ptr<MockFS> fs = std::make_shared<MockFS>(
+      FileSystem::Default(), /*support_prefetch=*/false);
+  std::unique_ptr<Env> env(new CompositeEnvWrapper(env_, fs));
+
+  bool use_direct_io = std::get<0>(GetParam());
+  Options options;
+  SetGenericOptions(env.get(), use_direct_io, options);
+  options.statistics = CreateDBStatistics();
+  options.compaction_async_io = true;
+  // Several files per level
+  options.target_file_size_base = 256 * 1024;
+  if (std::get<1>(GetParam())) {
+    options.compaction_readahead_size = 16 * 1024;
+  }
+  BlockBasedTableOptions table_options;
+  SetBlockBasedTableOptions(table_options);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  rocksdb_rs::status::Status s = TryReopen(options);
+  if (use_direct_io && (s.IsNotSupported() || s.IsInvalidArgument())) {
+    // If direct IO is not supported, skip the test
+    return;
+  } else {
+    ASSERT_OK(s);
+  }
+
+  // Write two generations of the keys, so that compacting L1 into L2 is not
+  // a trivial move and goes through the level iterators.
+  Random rnd(309);
+  std::vector<std::string> values(5 * kNumKeys);
+  for (int level = 2; level >= 1; level--) {
+    for (int j = 0; j < 5; j++) {
+      WriteBatch batch;
+      for (int i = j * kNumKeys; i < (j + 1) * kNumKeys; i++) {
+        values[i] = rnd.RandomString(1000);
+        ASSERT_OK(batch.Put(BuildKey(i), values[i]));
+      }
+      ASSERT_OK(db_->Write(WriteOptions(), &batch));
+      ASSERT_OK(Flush());
+    }
+    MoveFilesToLevel(level);
+  }
+
+  int next_file_prefetch_count = 0;
+  bool read_async_called = false;
+  SyncPoint::GetInstance()->SetCallBack(
+      "LevelIterator::PrefetchNextFile",
+      [&](void*) { next_file_prefetch_count++; });
+  SyncPoint::GetInstance()->SetCallBack(
+      "UpdateResults::io_uring_result",
+      [&](void* /*arg*/) { read_async_called = true; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  ASSERT_OK(options.statistics->Reset());
+  CompactRangeOptions cro;
+  cro.bottommost_level_compaction = BottommostLevelCompaction::kForce;
+  ASSERT_OK(db_->CompactRange(cro, nullptr, nullptr));
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  for (int i = 0; i < 5 * kNumKeys; i++) {
+    ASSERT_EQ(values[i], Get(BuildKey(i)));
+  }
+
+  HistogramData async_read_bytes;
+  options.statistics->histogramData(ASYNC_READ_BYTES, &async_read_bytes);
+  if (read_async_called) {
+    ASSERT_GT(next_file_prefetch_count, 0);
+    ASSERT_GT(async_read_bytes.count, 0);
+  } else {
+    // Not all platforms support iouring. In that case, ReadAsync in posix
+    // won't submit async requests.
+    ASSERT_EQ(async_read_bytes.count, 0);
+  }
+  Close();
+}
+
 #ifdef GFLAGS
 // This test verifies io_tracing with PosixFileSystem during prefetching.
 TEST_P(PrefetchTest, TraceReadAsyncWithCallbackWrapper) {
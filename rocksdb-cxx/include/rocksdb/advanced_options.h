@@ -181,6 +181,32 @@ struct CompressionOptions {
   // compressed by less than 12.5% (minimum ratio of 1.143:1).
   int max_compressed_bytes_per_kb = 1024 * 7 / 8;
 
+  // EXPERIMENTAL
+  // When nonzero, the compression type of data blocks is chosen adaptively
+  // while building a BlockBasedTable file, in ranges of this many consecutive
+  // data blocks. The first block of each range is compressed with both the
+  // configured compression type and LZ4 (when supported), and the range uses
+  // whichever pays off according to `adaptive_min_savings_per_kb`, or no
+  // compression when neither achieves `max_compressed_bytes_per_kb`. Setting
+  // it to a large value effectively makes a single choice per file.
+  //
+  // This is meant for data mixing compressible and incompressible parts, so
+  // that compaction does not spend CPU compressing the incompressible ones.
+  // The choices are recorded in the table properties (see
+  // `TableProperties::num_adaptive_fast_data_blocks`) and the bytes left
+  // uncompressed in the BYTES_COMPRESSION_SKIPPED_BY_SAMPLING ticker.
+  //
+  // Not supported with parallel compression (`parallel_threads > 1`), in
+  // which case it is ignored.
+  //
+  // Default: 0 (disabled)
+  uint32_t adaptive_sample_window = 0;
+
+  // With `adaptive_sample_window`, the minimum bytes per 1KB of input that
+  // the configured compression type must save over LZ4 to be chosen, i.e. the
+  // compression ratio worth spending its extra CPU on.
+  int adaptive_min_savings_per_kb = 64;
+
   // A convenience function for setting max_compressed_bytes_per_kb based on a
   // minimum acceptable compression ratio (uncompressed size over compressed
   // size).
@@ -1094,6 +1120,15 @@ struct AdvancedColumnFamilyOptions {
   // Dynamically changeable through the SetOptions() API
   PrepopulateBlobCache prepopulate_blob_cache = PrepopulateBlobCache::kDisable;
 
+  // When MultiGet reads several blobs from the same blob file, blobs at most
+  // this many bytes apart in the file are fetched with a single read, trading
+  // the bytes in between for fewer I/Os. PerfContext::blob_read_byte and
+  // blob_read_useful_byte report the bytes read and the bytes of the blob
+  // records actually used.
+  //
+  // Default: 0 (disabled)
+  uint64_t blob_multiget_coalesce_gap = 0;
+
   // Enable memtable per key-value checksum protection.
   //
   // Each entry in memtable will be suffixed by a per key-value checksum.
@@ -1109,6 +1144,16 @@ struct AdvancedColumnFamilyOptions {
   // Supported values: 0, 1, 2, 4, 8.
   uint32_t memtable_protection_bytes_per_key = 0;
 
+  // Maximum number of range deletions (DeleteRange()) in a memtable. Once a
+  // memtable holds this many range tombstones it is marked for flush, which
+  // bounds the work reads on that memtable spend on fragmenting them.
+  // A change only applies to memtables created after it.
+  //
+  // Default: 0 (no limit)
+  //
+  // Dynamically changeable through SetOptions() API
+  uint32_t memtable_max_range_deletions = 0;
+
   // UNDER CONSTRUCTION -- DO NOT USE
   // When the user-defined timestamp feature is enabled, this flag controls
   // whether the user-defined timestamps will be persisted.
@@ -257,6 +257,26 @@ struct CompressedSecondaryCacheOptions : LRUCacheOptions {
   CacheEntryRoleSet do_not_compress_roles = {
       rocksdb_rs::cache::CacheEntryRole::kFilterBlock};
 
+  // If non-empty, the compressed blocks are stored in a file of `capacity`
+  // bytes at this path, mapped into memory, rather than on the heap. Blocks
+  // are overwritten oldest first once the file is full. A cache created with
+  // the same path and options later, e.g. by the same service after a
+  // restart, re-attaches to the blocks left in the file, so a restart does
+  // not lose the cache contents. The file is best placed on tmpfs or a local
+  // disk. It is locked while a cache uses it, so a second cache on the same
+  // file, e.g. in a process started before the previous one exited, keeps its
+  // blocks on the heap.
+  //
+  // Cache keys embed the unique id of the file they are from, derived from
+  // the DB session that wrote it, so re-attached blocks are only ever found
+  // by the DB files they belong to. Blocks erased from the cache can
+  // reappear after a re-attach, which is harmless for that same reason.
+  //
+  // The capacity cannot be changed and enable_custom_split_merge is ignored.
+  // If the file cannot be mapped, the blocks are kept on the heap. Not
+  // supported on Windows, where the blocks are always kept on the heap.
+  std::string persistent_file_path;
+
   CompressedSecondaryCacheOptions() {}
   CompressedSecondaryCacheOptions(
       size_t _capacity, int _num_shard_bits, bool _strict_capacity_limit,
@@ -325,7 +345,8 @@ inline std::shared_ptr<SecondaryCache> NewCompressedSecondaryCache(
 // compatible with HyperClockCache.
 // * Requires an extra tuning parameter: see estimated_entry_charge below.
 // Similarly, substantially changing the capacity with SetCapacity could
-// harm efficiency.
+// harm efficiency. (EXPERIMENTAL: estimated_entry_charge = 0 instead uses a
+// table that grows as needed.)
 // * Cache priorities are less aggressively enforced, which could cause
 // cache dilution from long range scans (unless they use fill_cache=false).
 // * Can be worse for small caches, because if almost all of a cache shard is
@@ -364,8 +385,23 @@ struct HyperClockCacheOptions : public ShardedCacheOptions {
   // GetOccupancyCount(). However, when the average value size might vary
   // (e.g. balance between metadata and data blocks in cache), it is better
   // to estimate toward the lower side than the higher side.
+  //
+  // EXPERIMENTAL: If 0, the cache instead uses a hash table that starts small
+  // and grows online (lock-free, without blocking Lookups) as needed to fit
+  // the entries within the cache capacity, so no estimate is needed. This
+  // costs some extra CPU on Lookup misses relative to a well-estimated fixed
+  // table. See min_avg_entry_charge.
   size_t estimated_entry_charge;
 
+  // Only used when estimated_entry_charge == 0 (growable table). The table
+  // is allowed to grow to hold capacity / min_avg_entry_charge entries (at
+  // the designed load factor), which determines how much address space (not
+  // resident memory) is reserved up front for the table. If the average
+  // entry charge is smaller than this, the table stops growing and the cache
+  // is limited by occupancy rather than capacity, as with an
+  // estimated_entry_charge that is too high.
+  size_t min_avg_entry_charge = 450;
+
   HyperClockCacheOptions(
       size_t _capacity, size_t _estimated_entry_charge,
       int _num_shard_bits = -1, bool _strict_capacity_limit = false,
@@ -288,6 +288,34 @@ class CompactionFilter : public Customizable {
                     skip_until);
   }
 
+  // Returns true if the compaction should hand plain values to FilterBatch()
+  // before falling back to FilterV3(). See FilterBatch() below.
+  virtual bool SupportsFilterBatch() const { return false; }
+
+  // Batched API for plain values (ValueType::kValue), which amortizes the
+  // per-key overhead of FilterV3(), e.g. the virtual call, or looking up the
+  // current time for TTL checks. To feed it, the compaction reads its input
+  // ahead of the key it is processing. Only called if SupportsFilterBatch()
+  // returns true.
+  //
+  // `keys[i]` and `existing_values[i]` are the key and the value of the i-th
+  // of the `n` key-values, in the order of the compaction. The filter can set
+  // `decisions[i]`, initially kUndetermined, to kKeep, kRemove, kPurge, or
+  // kChangeValue with the updated value in `new_values[i]`. The key-values
+  // left kUndetermined, or given any other decision, are passed to FilterV3()
+  // one at a time as usual, which allows filtering only the common cases in
+  // batches.
+  //
+  // A batch may contain key-values the compaction ends up not filtering, e.g.
+  // ones skipped because of an earlier kRemoveAndSkipUntil decision: their
+  // decisions are ignored. Filters relying on being called exactly once per
+  // key-value should not support batching.
+  virtual void FilterBatch(int /* level */, size_t /* n */,
+                           const Slice* /* keys */,
+                           const Slice* /* existing_values */,
+                           Decision* /* decisions */,
+                           std::string* /* new_values */) const {}
+
   // Internal (BlobDB) use only. Do not override in application code.
   virtual BlobDecision PrepareBlobOutput(const Slice& /* key */,
                                          const Slice& /* existing_value */,
@@ -89,6 +89,13 @@ struct CompactionJobStats {
   // Time spent on preparing file write (fallocate, etc)
   uint64_t file_prepare_write_nanos;
 
+  // Time spent on reading input files synchronously.
+  uint64_t file_read_nanos;
+
+  // Time spent on waiting for asynchronous reads of input files to complete.
+  // Only non-zero with DBOptions::compaction_async_io.
+  uint64_t file_read_async_wait_nanos;
+
   // 0-terminated strings storing the first 8 bytes of the smallest and
   // largest key in the output.
   static const size_t kMaxPrefixLength = 8;
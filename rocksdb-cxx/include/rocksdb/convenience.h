@@ -228,6 +228,8 @@ struct ConfigOptions {
 //     [Example]:
 //     * {"memtable", "vector:1024"} is equivalent to setting memtable
 //       to VectorRepFactory(1024).
+//   - BTreeRepFactory:
+//     Pass "btree" to config memtable to use BTreeRepFactory.
 //
 //  * compression_opts:
 //    Use "compression_opts" to config compression_opts.  The value format
@@ -1023,6 +1023,12 @@ class DB {
     //      stale values more frequently to reduce overhead and latency.
     static const std::string kFastBlockCacheEntryStats;
 
+    //  "rocksdb.hot-key-cache-stats" - returns a string or map with the hits,
+    //      misses, hit rate and admission rejects of the column family in
+    //      DBOptions::hot_key_cache. Map keys are "hits", "misses",
+    //      "hit-rate" and "admission-rejects".
+    static const std::string kHotKeyCacheStats;
+
     //  "rocksdb.num-immutable-mem-table" - returns number of immutable
     //      memtables that have not yet been flushed.
     static const std::string kNumImmutableMemTable;
@@ -1088,6 +1094,11 @@ class DB {
     //      filter and index blocks).
     static const std::string kEstimateTableReadersMem;
 
+    //  "rocksdb.estimate-version-metadata-mem" - returns estimated memory used
+    //      for the per level file lists and search indexes of the current
+    //      version, including the parts shared with older versions.
+    static const std::string kEstimateVersionMetadataMem;
+
     //  "rocksdb.is-file-deletions-enabled" - returns 0 if deletion of obsolete
     //      files is enabled; otherwise, returns a non-zero number.
     //  This name may be misleading because true(non-zero) means disable,
@@ -1273,6 +1284,7 @@ class DB {
   //  "rocksdb.num-deletes-imm-mem-tables"
   //  "rocksdb.estimate-num-keys"
   //  "rocksdb.estimate-table-readers-mem"
+  //  "rocksdb.estimate-version-metadata-mem"
   //  "rocksdb.is-file-deletions-enabled"
   //  "rocksdb.num-snapshots"
   //  "rocksdb.oldest-snapshot-time"
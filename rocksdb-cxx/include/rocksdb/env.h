@@ -600,6 +600,17 @@ class Env : public Customizable {
   // Lower CPU priority for threads from the specified pool.
   virtual void LowerThreadPoolCPUPriority(Priority /*pool*/ = LOW) {}
 
+  // Let the threads of the specified pool schedule their jobs by work
+  // stealing rather than from a single FIFO queue. This lowers the cost of
+  // scheduling many short jobs from many threads, at the price of jobs no
+  // longer starting in the order they were scheduled. Jobs already scheduled
+  // are not affected.
+  virtual rocksdb_rs::status::Status SetThreadPoolWorkStealing(
+      Priority /*pool*/, bool /*enabled*/) {
+    return rocksdb_rs::status::Status_NotSupported(
+        "Env::SetThreadPoolWorkStealing() not supported");
+  }
+
   // Converts seconds-since-Jan-01-1970 to a printable string
   virtual std::string TimeToString(uint64_t time) = 0;
 
@@ -1690,6 +1701,11 @@ class EnvWrapper : public Env {
     return target_.env->LowerThreadPoolCPUPriority(pool, pri);
   }
 
+  rocksdb_rs::status::Status SetThreadPoolWorkStealing(
+      Priority pool, bool enabled) override {
+    return target_.env->SetThreadPoolWorkStealing(pool, enabled);
+  }
+
   std::string TimeToString(uint64_t time) override {
     return target_.env->TimeToString(time);
   }
@@ -446,6 +446,12 @@ class CompactionService : public Customizable {
     return CompactionServiceJobStatus::kUseLocal;
   }
 
+  // Called when a DB using the service, of session ID `db_session_id`, shuts
+  // down, before it waits for its compactions. The service should make the
+  // WaitForCompleteV2() calls for the jobs of that DB return soon, and start
+  // no more jobs for it.
+  virtual void CancelAwaitingJobs(const std::string& /*db_session_id*/) {}
+
   ~CompactionService() override = default;
 };
 
@@ -933,6 +939,18 @@ struct DBOptions {
   // Dynamically changeable through SetDBOptions() API.
   size_t compaction_readahead_size = 0;
 
+  // If true, and the FileSystem supports FSSupportedOps::kAsyncIO, compaction
+  // reads its input files through FSRandomAccessFile::ReadAsync(). The
+  // readahead of each input file is double buffered so that the next chunk
+  // is read while the current one is processed, and before compaction
+  // reaches the end of an input file of a non-zero level, the next file of
+  // that level is opened and the read of its first data block is submitted.
+  // Time spent waiting for those reads is reported in
+  // CompactionJobStats::file_read_async_wait_nanos.
+  //
+  // Default: false
+  bool compaction_async_io = false;
+
   // This is a maximum buffer size that is used by WinMmapReadableFile in
   // unbuffered disk I/O mode. We need to maintain an aligned buffer for
   // reads. We allow the buffer to grow until the specified value and then
@@ -1090,6 +1108,23 @@ struct DBOptions {
   // Default: false
   bool unordered_write = false;
 
+  // If true, writes with WriteOptions::sync do not sync the WAL themselves.
+  // The leader of a write group appends the group to the WAL as usual, and a
+  // dedicated thread then syncs the WAL once for all the writes appended
+  // since its previous sync, possibly from several write groups. Each sync
+  // write returns after the sync covering it completes, so the durability of
+  // acknowledged writes is unchanged, but under concurrency many fewer syncs
+  // are issued.
+  //
+  // Like unordered_write, this relaxes a guarantee for throughput: a sync
+  // write may become visible to readers before its WAL sync completes, so a
+  // reader can observe a write that is lost if the machine crashes before
+  // the sync. Not compatible with enable_pipelined_write, unordered_write,
+  // two_write_queues, manual_wal_flush or allow_mmap_writes.
+  //
+  // Default: false
+  bool wal_group_commit = false;
+
   // If true, allow multi-writers to update mem tables in parallel.
   // Only some memtable_factory-s support concurrent writes; currently it
   // is implemented only for SkipListFactory.  Concurrent memtable writes
@@ -1156,6 +1191,23 @@ struct DBOptions {
   // Default: kPointInTimeRecovery
   WALRecoveryMode wal_recovery_mode = WALRecoveryMode::kPointInTimeRecovery;
 
+  // Number of threads used to replay WALs into memtables during DB::Open.
+  // With a value greater than 1, a background thread reads and checksums
+  // WAL records ahead of replay, and the decoded write batches are inserted
+  // by this many threads, each owning a disjoint set of column families.
+  // This mostly helps to recover large WALs spread across many column
+  // families. WAL corruption is handled as with serial replay, as dictated
+  // by wal_recovery_mode. If a write batch fails to be inserted after a
+  // later one was already inserted by another thread, the memtables are
+  // dropped and the WALs replayed again serially, so that recovery still
+  // stops at the point of failure.
+  //
+  // Ignored (replay is serial) with allow_2pc, and with the WritePrepared or
+  // WriteUnprepared transaction write policies.
+  //
+  // Default: 1
+  int wal_recovery_threads = 1;
+
   // if set to false then recovery will fail when a prepared
   // transaction is encountered in the WAL
   bool allow_2pc = false;
@@ -1164,6 +1216,26 @@ struct DBOptions {
   // Default: nullptr (disabled)
   std::shared_ptr<RowCache> row_cache = nullptr;
 
+  // A cache for the results of Get() on frequently read keys, shared by all
+  // the column families of the DB. A Get() hitting it looks up neither the
+  // memtables nor the SST files. Keys are only admitted after being read a
+  // few times recently, as estimated by a TinyLFU frequency sketch, so that
+  // keys read once do not evict hot ones. Entries are invalidated by writes
+  // to their keys, before the writes become visible, and by changes that do
+  // not go through the memtables, such as file ingestion.
+  //
+  // Only serves Get() at read_tier kReadAllTier, without user-defined
+  // timestamps. Ignored with unordered_write, with the WritePrepared and
+  // WriteUnprepared transaction write policies, and in read-only and
+  // secondary instances. Values that a compaction filter removes or changes
+  // may still be returned until their keys are written again.
+  //
+  // See the "rocksdb.hot-key-cache-stats" property for per column family
+  // statistics.
+  //
+  // Default: nullptr (disabled)
+  std::shared_ptr<RowCache> hot_key_cache = nullptr;
+
   // A filter object supplied to be invoked while processing write-ahead-logs
   // (WALs) during recovery. The filter provides a way to inspect log
   // records, ignoring a particular record or skipping replay.
@@ -1229,11 +1301,22 @@ struct DBOptions {
 
   // This feature is WORK IN PROGRESS
   // If enabled WAL records will be compressed before they are written.
-  // Only zstd is supported. Compressed WAL records will be read in supported
+  // Only zstd and lz4 are supported. lz4 costs less CPU and latency per write,
+  // zstd compresses better. Compressed WAL records will be read in supported
   // versions regardless of the wal_compression settings.
   rocksdb_rs::compression_type::CompressionType wal_compression =
       rocksdb_rs::compression_type::CompressionType::kNoCompression;
 
+  // If non-zero and wal_compression is zstd, every new WAL starts with a
+  // dictionary of at most this many bytes, trained from records of the
+  // previous WALs, and its records are compressed with it. This improves the
+  // compression of small records, at the cost of training a dictionary when
+  // switching to a new WAL once enough records were sampled (100 times the
+  // dictionary size). Cannot exceed 16KB.
+  //
+  // WALs with a dictionary cannot be read by versions without this option.
+  uint32_t wal_compression_max_dict_bytes = 0;
+
   // If true, RocksDB supports flushing multiple column families and committing
   // their results atomically to MANIFEST. Note that it is not
   // necessary to set atomic_flush to true if WAL is always enabled since WAL
@@ -1559,6 +1642,22 @@ struct ReadOptions {
   // comes at the expense of slightly higher CPU overhead.
   bool optimize_multiget_for_io = true;
 
+  // Experimental
+  //
+  // If async_io is set, then this flag makes Get() look the key up in all
+  // the SST files that may hold it in parallel, reading the data blocks of
+  // the files whose filters do not rule the key out, before resolving the
+  // key level by level as usual. This trades extra reads, of files in
+  // levels the lookup would not have reached, for Get() latency when the
+  // key is deep in the LSM tree and the blocks are not cached. The lookups
+  // in later levels are dropped, if not started yet, once an earlier level
+  // is known to end the Get(). The extra lookups are only counted in the
+  // GET_SPECULATIVE_FILE_LOOKUPS* tickers, not in the filter, block cache or
+  // perf context counters of the Get(). Has no effect unless fill_cache is
+  // set, the column family has no row cache, and RocksDB is built with
+  // coroutines.
+  bool speculative_get_reads = false;
+
   // *** END options relevant to point lookups (as well as scans) ***
   // *** BEGIN options only relevant to iterators or scans ***
 
@@ -1972,6 +2071,16 @@ struct IngestExternalFileOptions {
   // ingestion. However, if no checksum information is provided with the
   // ingested files, DB will generate the checksum and store in the Manifest.
   bool verify_file_checksum = true;
+  // Maximum number of threads, including the calling one, used to process the
+  // files of an ingestion in parallel: reading their properties and verifying
+  // their checksums, copying or linking them into the DB, and checking them
+  // for overlaps with the levels of the DB. This work is done without holding
+  // the DB mutex, except for the overlap checks when flushes or compactions
+  // keep changing the levels while the ingestion waits for the mutex: after
+  // a few attempts, the overlaps are checked again while holding it, which
+  // reads blocks of the levels. Setting it to 1 processes the files one by
+  // one.
+  int max_threads = 16;
   // Set to TRUE if user wants file to be ingested to the bottommost level. An
   // error of Status_TryAgain() will be returned if a file cannot fit in the
   // bottommost level when calling
@@ -2081,6 +2190,48 @@ struct OpenAndCompactOptions {
   std::atomic<bool>* canceled = nullptr;
 };
 
+struct LocalCompactionServiceOptions {
+  // The command line of the worker processes: the executable, looked up in
+  // PATH if it has no slash, followed by its arguments. The executable must
+  // call RunLocalCompactionServiceWorker(), and nothing else may use its
+  // standard input and output.
+  std::vector<std::string> worker_command;
+
+  // If not 0, a worker still running this many milliseconds after it was
+  // spawned is killed, and its job fails.
+  uint64_t worker_timeout_ms = 0;
+
+  // The Env of the DBs using the service, whose FileSystem is used to remove
+  // the outputs of the jobs.
+  Env* env = Env::Default();
+};
+
+// Returns a CompactionService running each compaction job in a new local
+// process, spawned from `options.worker_command`, which opens the DB as a
+// secondary and runs the job with DB::OpenAndCompact(). The workers share no
+// memory with the DB, so their CPU and memory usage can be isolated and
+// limited, e.g. with cgroups. There are as many workers at a time as there
+// are running compactions. If a worker cannot be spawned, the job runs in
+// the DB process instead.
+//
+// The job is sent to the worker over its standard input, and the result is
+// read from its standard output, both connected to a unix socket. The
+// outputs of a job are written to a subdirectory of the DB directory, which
+// the service removes after the DB moved them out. The workers of a DB are
+// killed when it shuts down.
+//
+// Not supported on Windows, where it returns nullptr.
+std::shared_ptr<CompactionService> NewLocalCompactionService(
+    const LocalCompactionServiceOptions& options);
+
+// The main function of a worker of the CompactionService returned by
+// NewLocalCompactionService(): reads a job from the standard input, runs it
+// with DB::OpenAndCompact(), passing it `override_options`, and writes the
+// result to the standard output. Returns the exit code of the worker, 0 if
+// the job succeeded.
+int RunLocalCompactionServiceWorker(
+    const CompactionServiceOptionsOverride& override_options);
+
 struct LiveFilesStorageInfoOptions {
   // Whether to populate FileStorageInfo::file_checksum* or leave blank
   bool include_checksum_info = false;
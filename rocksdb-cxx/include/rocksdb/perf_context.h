@@ -104,6 +104,8 @@ struct PerfContextBase {
   uint64_t blob_cache_hit_count;  // total number of blob cache hits
   uint64_t blob_read_count;       // total number of blob reads (with IO)
   uint64_t blob_read_byte;        // total number of bytes from blob reads
+  // total number of bytes of the blob records used out of blob_read_byte
+  uint64_t blob_read_useful_byte;
   uint64_t blob_read_time;        // total nanos spent on blob reads
   uint64_t blob_checksum_time;    // total nanos spent on blob checksum
   uint64_t blob_decompress_time;  // total nanos spent on blob decompression
@@ -8,12 +8,15 @@
 
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "rocksdb/customizable.h"
 #include "rocksdb/slice.h"
 
 namespace rocksdb {
 
+class Comparator;
 class Slice;
 
 enum PartitionerResult : char {
@@ -61,6 +64,17 @@ class SstPartitioner {
   virtual bool CanDoTrivialMove(const Slice& smallest_user_key,
                                 const Slice& largest_user_key) = 0;
 
+  // An input file of a compaction run
+  struct InputFile {
+    Slice smallest_user_key;
+    Slice largest_user_key;
+    uint64_t file_size;
+    // Estimated number of times the file was read by lookups and iterators
+    // since it was created, from the reads sampled on it, as in
+    // SstFileMetaData::num_reads_sampled
+    uint64_t num_reads_sampled;
+  };
+
   // Context information of a compaction run
   struct Context {
     // Does this compaction run include all data files
@@ -74,6 +88,11 @@ class SstPartitioner {
     Slice smallest_user_key;
     // Largest key for compaction
     Slice largest_user_key;
+    // User comparator of the column family, or nullptr for the bytewise
+    // comparator
+    const Comparator* comparator = nullptr;
+    // Input files of the compaction, of all the input levels
+    std::vector<InputFile> input_files;
   };
 };
 
@@ -138,4 +157,77 @@ class SstPartitionerFixedPrefixFactory : public SstPartitionerFactory {
 extern std::shared_ptr<SstPartitionerFactory>
 NewSstPartitionerFixedPrefixFactory(size_t prefix_len);
 
+struct SstPartitionerLoadAwareOptions {
+  static const char* kName() { return "SstPartitionerLoadAwareOptions"; }
+
+  // Output files are cut at this size in the hot key ranges. Output files of
+  // the cold key ranges are cut by the compaction, at the target file size of
+  // the output level.
+  uint64_t hot_file_size = 8 << 20;
+  // An input file is hot when it has at least this many times the average
+  // number of reads per byte of all the input files of the compaction.
+  double hot_read_density_ratio = 2.0;
+  // An input file with fewer reads is never hot, so that a few reads of a
+  // mostly cold compaction do not make a key range hot.
+  uint64_t min_hot_file_reads = 16 << 10;
+};
+
+/*
+ * Load aware partitioner. It splits the output SST files of a compaction
+ * according to how often the key ranges of the input files are read: the hot
+ * key ranges become small files, and the cold ones large files, with a file
+ * boundary wherever a hot range starts or ends. A later compaction of a hot
+ * range then rewrites fewer cold keys along with it. The reads of the files
+ * are sampled by lookups and iterators, see SstFileMetaData::num_reads_sampled.
+ */
+class SstPartitionerLoadAware : public SstPartitioner {
+ public:
+  SstPartitionerLoadAware(const SstPartitionerLoadAwareOptions& options,
+                          const SstPartitioner::Context& context);
+
+  ~SstPartitionerLoadAware() override {}
+
+  const char* Name() const override { return "SstPartitionerLoadAware"; }
+
+  PartitionerResult ShouldPartition(const PartitionerRequest& request) override;
+
+  // Always allowed, as a trivial move rewrites nothing
+  bool CanDoTrivialMove(const Slice& smallest_user_key,
+                        const Slice& largest_user_key) override;
+
+ private:
+  bool IsHot(const Slice& user_key) const;
+
+  const uint64_t hot_file_size_;
+  const Comparator* comparator_;
+  // Disjoint key ranges of the hot input files, by smallest key
+  std::vector<std::pair<std::string, std::string>> hot_ranges_;
+};
+
+/*
+ * Factory for load aware partitioner.
+ */
+class SstPartitionerLoadAwareFactory : public SstPartitionerFactory {
+ public:
+  explicit SstPartitionerLoadAwareFactory(
+      const SstPartitionerLoadAwareOptions& options =
+          SstPartitionerLoadAwareOptions());
+
+  ~SstPartitionerLoadAwareFactory() override {}
+
+  static const char* kClassName() { return "SstPartitionerLoadAwareFactory"; }
+  const char* Name() const override { return kClassName(); }
+
+  std::unique_ptr<SstPartitioner> CreatePartitioner(
+      const SstPartitioner::Context& context) const override;
+
+ private:
+  SstPartitionerLoadAwareOptions options_;
+};
+
+extern std::shared_ptr<SstPartitionerFactory>
+NewSstPartitionerLoadAwareFactory(
+    const SstPartitionerLoadAwareOptions& options =
+        SstPartitionerLoadAwareOptions());
+
 }  // namespace rocksdb
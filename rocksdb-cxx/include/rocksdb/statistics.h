@@ -511,6 +511,24 @@ enum Tickers : uint32_t {
   // compressed SST blocks from storage.
   BYTES_DECOMPRESSED_TO,
 
+  // Number of uncompressed bytes for SST data blocks that are stored
+  // uncompressed because the sampling of
+  // CompressionOptions::adaptive_sample_window found compression not
+  // worthwhile. These bytes are also counted in BYTES_COMPRESSION_BYPASSED.
+  BYTES_COMPRESSION_SKIPPED_BY_SAMPLING,
+
+  // Number of SST files a Get() with ReadOptions::speculative_get_reads
+  // looked up ahead of time, and number of such lookups dropped because a
+  // file in an earlier level already ended the Get()
+  GET_SPECULATIVE_FILE_LOOKUPS,
+  GET_SPECULATIVE_FILE_LOOKUPS_CANCELLED,
+
+  // DBOptions::hot_key_cache lookups, and keys it did not admit after a miss
+  // because they were not read frequently enough
+  HOT_KEY_CACHE_HIT,
+  HOT_KEY_CACHE_MISS,
+  HOT_KEY_CACHE_ADMISSION_REJECTED,
+
   TICKER_ENUM_MAX
 };
 
@@ -633,6 +651,11 @@ enum Histograms : uint32_t {
   // system's prefetch) from the end of SST table during block based table open
   TABLE_OPEN_PREFETCH_TAIL_READ_BYTES,
 
+  // Time spent applying a batch of version edits in LogAndApply(), from
+  // building the new versions to installing them, including the MANIFEST
+  // write.
+  LOG_AND_APPLY_MICROS,
+
   HISTOGRAM_ENUM_MAX
 };
 
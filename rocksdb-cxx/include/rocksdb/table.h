@@ -230,6 +230,20 @@ struct BlockBasedTableOptions {
     // Makes the index significantly bigger (2x or more), especially when keys
     // are long.
     kBinarySearchWithFirstKey = 0x03,
+
+    // Like kBinarySearch, but the index also comes with a small piecewise
+    // linear model of its keys, fitted when the file is written, that predicts
+    // where a key is in the index. Seeks then only binary search the few index
+    // entries around the predicted position, and fall back to searching the
+    // rest of the index when the prediction is off.
+    // Works best when the first 8 bytes of the keys are roughly uniformly
+    // distributed, e.g. with fixed-width big-endian integer keys. The model is
+    // only built with BytewiseComparator and without user-defined timestamps,
+    // and is omitted when it would not be smaller than the index; the index is
+    // then searched like kBinarySearch.
+    // Files written with this index type cannot be read by RocksDB versions
+    // that do not support it.
+    kInterpolationSearch = 0x04,
   };
 
   IndexType index_type = kBinarySearch;
@@ -513,6 +527,13 @@ struct BlockBasedTableOptions {
   // 5 -- Can be read by RocksDB's versions since 6.6.0. Full and partitioned
   // filters use a generally faster and more accurate Bloom filter
   // implementation, with a different schema.
+  // 1000 -- Specific to this fork, which can only read such files. With the
+  // default BytewiseComparator and no user-defined timestamps, data blocks up
+  // to 64KiB also store a fixed-width prefix of each restart key, so Seek()
+  // within a block does fewer key comparisons.
+  // Versions 6 to 999 are left to upstream RocksDB, whose format_version 6
+  // and later use different formats. This fork rejects them, both as an
+  // option and when reading a file.
   uint32_t format_version = 5;
 
   // Store index blocks on disk in compressed format. Changing this option to
@@ -827,6 +848,32 @@ struct CuckooTableOptions {
 extern TableFactory* NewCuckooTableFactory(
     const CuckooTableOptions& table_options = CuckooTableOptions());
 
+// -- Log Hash Table
+// A table format for column families only read by point lookups. The entries
+// are appended in key order to a log region, and an open addressing hash
+// table maps every user key to the range of the log holding its versions.
+// The hash table is kept in memory (or mmapped), so that a Get() costs at most
+// one read of the file, and none with allow_mmap_reads.
+//
+// Unlike CuckooTable, keys and values may have any size, and snapshots and
+// merge operands are supported, so it can be the output of flushes and of
+// compactions. Iterators work but only scan the log, without any index block
+// or filter. Range deletions, user-defined timestamps and comparators under
+// which distinct byte strings compare equal are not supported.
+struct LogHashTableOptions {
+  static const char* kName() { return "LogHashTableOptions"; };
+
+  // Determines the utilization of the hash table, in (0, 1]. Smaller values
+  // result in larger hash tables with shorter probe sequences.
+  double hash_table_ratio = 0.75;
+  // Number of entries between the restart points of the log, which Seek()
+  // binary searches before scanning the log.
+  uint32_t restart_interval = 16;
+};
+
+extern TableFactory* NewLogHashTableFactory(
+    const LogHashTableOptions& table_options = LogHashTableOptions());
+
 class RandomAccessFileReader;
 
 // A base class for table factories.
@@ -838,6 +885,7 @@ class TableFactory : public Customizable {
   static const char* kBlockBasedTableName() { return "BlockBasedTable"; };
   static const char* kPlainTableName() { return "PlainTable"; }
   static const char* kCuckooTableName() { return "CuckooTable"; };
+  static const char* kLogHashTableName() { return "LogHashTable"; };
 
   // Creates and configures a new TableFactory from the input options and id.
   static rocksdb_rs::status::Status CreateFromString(
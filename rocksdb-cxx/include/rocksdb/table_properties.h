@@ -69,6 +69,8 @@ struct TablePropertiesNames {
   static const std::string kFileCreationTime;
   static const std::string kSlowCompressionEstimatedDataSize;
   static const std::string kFastCompressionEstimatedDataSize;
+  static const std::string kNumAdaptiveFastDataBlocks;
+  static const std::string kNumAdaptiveUncompressedDataBlocks;
   static const std::string kSequenceNumberTimeMapping;
   static const std::string kTailStartOffset;
   static const std::string kUserDefinedTimestampsPersisted;
@@ -239,6 +241,12 @@ struct TableProperties {
   // compression algorithm (see `ColumnFamilyOptions::sample_for_compression`).
   // 0 means unknown.
   uint64_t fast_compression_estimated_data_size = 0;
+  // Number of data blocks compressed with LZ4 instead of the configured
+  // compression type because of `CompressionOptions::adaptive_sample_window`.
+  uint64_t num_adaptive_fast_data_blocks = 0;
+  // Number of data blocks left uncompressed because of
+  // `CompressionOptions::adaptive_sample_window`.
+  uint64_t num_adaptive_uncompressed_data_blocks = 0;
   // Offset of the value of the property "external sst file global seqno" in the
   // file if the property exists.
   // 0 means not exists.
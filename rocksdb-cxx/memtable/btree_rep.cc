@@ -0,0 +1,596 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+// A B+-tree memtable rep synchronized with optimistic lock coupling.
+//
+// Every node carries a version word. Writers lock the nodes they modify by
+// setting the low bit of the version, and bump the version when they unlock.
+// Readers never write to shared memory: they remember the version of a node,
+// read it, and then check that the version did not change, retrying from the
+// root otherwise. Inserts use the same optimistic descent and lock only the
+// leaf they insert into, plus the parent when the node on the way splits.
+// Full nodes are split on the way down, so that a parent always has room for
+// the separator of a splitting child.
+//
+// Nodes are allocated from the memtable's allocator and never freed or
+// merged: entries only move to the right, into the new sibling of a
+// splitting node. Child i of an inner node holds the entries in
+// (keys[i - 1], keys[i]]; every separator is an entry of the tree.
+//
+// Iterators copy the leaf they are positioned in, so that Next() within a
+// leaf is a plain array walk. They move on to the next leaf through its
+// sibling link, and to the previous one with a new descent from the root.
+#include <atomic>
+#include <cstring>
+
+#include "db/memtable.h"
+#include "memory/arena.h"
+#include "port/port.h"
+#include "rocksdb/memtablerep.h"
+#include "util/random.h"
+
+namespace rocksdb {
+namespace {
+
+// Leaves and inner nodes span 4 and 8 cache lines of 64 bytes
+constexpr size_t kLeafCapacity = 29;
+constexpr size_t kInnerCapacity = 30;
+
+class OptLock {
+ public:
+  // Returns false if a writer holds the lock
+  bool ReadLock(uint64_t* version) const {
+    *version = version_.load(std::memory_order_acquire);
+    return (*version & 1) == 0;
+  }
+
+  // Returns true if the node did not change since ReadLock() returned
+  // `version`
+  bool Validate(uint64_t version) const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return version_.load(std::memory_order_relaxed) == version;
+  }
+
+  // Locks the node for writing, unless it changed since ReadLock() returned
+  // `version`
+  bool Upgrade(uint64_t version) {
+    if (!version_.compare_exchange_strong(version, version + 1,
+                                          std::memory_order_acquire)) {
+      return false;
+    }
+    // Readers which see any of the writes below also see the lock
+    std::atomic_thread_fence(std::memory_order_release);
+    return true;
+  }
+
+  void WriteUnlock() { version_.fetch_add(1, std::memory_order_release); }
+
+ private:
+  std::atomic<uint64_t> version_{0};
+};
+
+struct Node {
+  OptLock lock;
+  std::atomic<uint16_t> count{0};
+  bool leaf = false;
+};
+
+struct Leaf : public Node {
+  std::atomic<Leaf*> next{nullptr};
+  std::atomic<const char*> keys[kLeafCapacity];
+};
+
+struct Inner : public Node {
+  std::atomic<const char*> keys[kInnerCapacity];
+  std::atomic<Node*> children[kInnerCapacity + 1];
+};
+
+// A copy of a leaf, taken while nobody was writing to it
+struct LeafSnapshot {
+  const char* keys[kLeafCapacity];
+  size_t count = 0;
+  Leaf* next = nullptr;
+};
+
+class BTreeRep : public MemTableRep {
+ public:
+  BTreeRep(const MemTableRep::KeyComparator& compare, Allocator* allocator)
+      : MemTableRep(allocator), cmp_(compare), root_(NewNode<Leaf>()) {
+    root_.load(std::memory_order_relaxed)->leaf = true;
+  }
+
+  void Insert(KeyHandle handle) override { InsertKey(handle); }
+
+  bool InsertKey(KeyHandle handle) override {
+    const char* key = static_cast<char*>(handle);
+    InsertResult result;
+    while ((result = TryInsert(key)) == kRetry) {
+      port::AsmVolatilePause();
+    }
+    return result == kInserted;
+  }
+
+  // Hints are ignored: a descent touches few enough nodes
+  bool InsertKeyWithHint(KeyHandle handle, void** /*hint*/) override {
+    return InsertKey(handle);
+  }
+
+  void InsertConcurrently(KeyHandle handle) override { InsertKey(handle); }
+
+  bool InsertKeyConcurrently(KeyHandle handle) override {
+    return InsertKey(handle);
+  }
+
+  bool InsertKeyWithHintConcurrently(KeyHandle handle,
+                                     void** /*hint*/) override {
+    return InsertKey(handle);
+  }
+
+  // Returns true iff an entry that compares equal to key is in the tree.
+  bool Contains(const char* key) const override {
+    Iterator iter(this);
+    iter.Seek(Slice(), key);
+    return iter.Valid() && cmp_(iter.key(), key) == 0;
+  }
+
+  size_t ApproximateMemoryUsage() override {
+    // All memory is allocated through allocator; nothing to report here
+    return 0;
+  }
+
+  void Get(const LookupKey& k, void* callback_args,
+           bool (*callback_func)(void* arg, const char* entry)) override {
+    Iterator iter(this);
+    Slice dummy_slice;
+    for (iter.Seek(dummy_slice, k.memtable_key().data());
+         iter.Valid() && callback_func(callback_args, iter.key());
+         iter.Next()) {
+    }
+  }
+
+  void UniqueRandomSample(const uint64_t num_entries,
+                          const uint64_t target_sample_size,
+                          std::unordered_set<const char*>* entries) override {
+    entries->clear();
+    assert(num_entries > 0);
+    // The tree has no cheap random seek, so the sample is drawn in one pass,
+    // keeping each entry with probability (samples left) / (entries left).
+    Random* rnd = Random::GetTLSInstance();
+    Iterator iter(this);
+    uint64_t counter = 0, num_samples_left = target_sample_size;
+    for (iter.SeekToFirst(); iter.Valid() && num_samples_left > 0 &&
+                             counter < num_entries;
+         iter.Next(), counter++) {
+      if (rnd->Next() % (num_entries - counter) < num_samples_left) {
+        entries->insert(iter.key());
+        num_samples_left--;
+      }
+    }
+  }
+
+  ~BTreeRep() override {}
+
+  class Iterator : public MemTableRep::Iterator {
+   public:
+    explicit Iterator(const BTreeRep* rep) : rep_(rep) {}
+
+    ~Iterator() override {}
+
+    bool Valid() const override { return pos_ < leaf_.count; }
+
+    const char* key() const override {
+      assert(Valid());
+      return leaf_.keys[pos_];
+    }
+
+    void Next() override {
+      assert(Valid());
+      if (++pos_ < leaf_.count) {
+        return;
+      }
+      // Entries may have moved to a new sibling since the copy was taken,
+      // hence the ones already visited are skipped
+      SeekInNextLeaves(leaf_.keys[pos_ - 1], false /* inclusive */);
+    }
+
+    void Prev() override {
+      assert(Valid());
+      if (pos_ > 0) {
+        --pos_;
+        return;
+      }
+      SeekLast(leaf_.keys[0], false /* inclusive */);
+    }
+
+    // Advance to the first entry with a key >= target
+    void Seek(const Slice& user_key, const char* memtable_key) override {
+      const char* target = memtable_key != nullptr
+                               ? memtable_key
+                               : EncodeKey(&tmp_, user_key);
+      while (!rep_->TryFindLeaf(target, false /* rightmost */, &leaf_,
+                                nullptr /* fence */)) {
+        port::AsmVolatilePause();
+      }
+      pos_ = rep_->LowerBound(leaf_, target, true /* inclusive */);
+      if (pos_ == leaf_.count) {
+        SeekInNextLeaves(target, true /* inclusive */);
+      }
+    }
+
+    // Retreat to the last entry with a key <= target
+    void SeekForPrev(const Slice& user_key, const char* memtable_key) override {
+      SeekLast(memtable_key != nullptr ? memtable_key
+                                       : EncodeKey(&tmp_, user_key),
+               true /* inclusive */);
+    }
+
+    // Position at the first entry in the tree.
+    // Final state of iterator is Valid() iff the tree is not empty.
+    void SeekToFirst() override {
+      while (!rep_->TryFindLeaf(nullptr, false /* rightmost */, &leaf_,
+                                nullptr /* fence */)) {
+        port::AsmVolatilePause();
+      }
+      pos_ = 0;
+    }
+
+    // Position at the last entry in the tree.
+    // Final state of iterator is Valid() iff the tree is not empty.
+    void SeekToLast() override {
+      while (!rep_->TryFindLeaf(nullptr, true /* rightmost */, &leaf_,
+                                nullptr /* fence */)) {
+        port::AsmVolatilePause();
+      }
+      pos_ = leaf_.count > 0 ? leaf_.count - 1 : 0;
+    }
+
+   private:
+    // Positions at the first entry after `target`, or at `target` itself if
+    // `inclusive`, looking only at the leaves after the current one
+    void SeekInNextLeaves(const char* target, bool inclusive) {
+      while (leaf_.next != nullptr) {
+        Leaf* next = leaf_.next;
+        while (!rep_->TryCopyLeaf(next, &leaf_)) {
+          port::AsmVolatilePause();
+        }
+        pos_ = rep_->LowerBound(leaf_, target, inclusive);
+        if (pos_ < leaf_.count) {
+          return;
+        }
+      }
+      leaf_.count = 0;
+      pos_ = 0;
+    }
+
+    // Positions at the last entry before `target`, or at `target` itself if
+    // `inclusive`
+    void SeekLast(const char* target, bool inclusive) {
+      while (true) {
+        const char* fence = nullptr;
+        if (!rep_->TryFindLeaf(target, false /* rightmost */, &leaf_,
+                               &fence)) {
+          port::AsmVolatilePause();
+          continue;
+        }
+        size_t end = rep_->LowerBound(leaf_, target, !inclusive);
+        if (end > 0) {
+          pos_ = end - 1;
+          return;
+        }
+        if (fence == nullptr) {
+          // Nothing before the leftmost leaf
+          leaf_.count = 0;
+          pos_ = 0;
+          return;
+        }
+        // Every entry of the leaf is after the fence, which is itself an
+        // entry before `target`
+        target = fence;
+        inclusive = true;
+      }
+    }
+
+    const BTreeRep* rep_;
+    LeafSnapshot leaf_;
+    size_t pos_ = 0;
+    std::string tmp_;  // For passing to EncodeKey
+  };
+
+  MemTableRep::Iterator* GetIterator(Arena* arena = nullptr) override {
+    void* mem = arena ? arena->AllocateAligned(sizeof(BTreeRep::Iterator))
+                      : operator new(sizeof(BTreeRep::Iterator));
+    return new (mem) BTreeRep::Iterator(this);
+  }
+
+ private:
+  enum InsertResult { kInserted, kDuplicate, kRetry };
+
+  template <class T>
+  T* NewNode() {
+    // Align nodes to cache lines, so that a leaf spans as few of them as
+    // possible
+    char* mem = allocator_->AllocateAligned(sizeof(T) + CACHE_LINE_SIZE - 1);
+    mem = reinterpret_cast<char*>(
+        (reinterpret_cast<uintptr_t>(mem) + CACHE_LINE_SIZE - 1) &
+        ~static_cast<uintptr_t>(CACHE_LINE_SIZE - 1));
+    memset(mem, 0, sizeof(T));
+    return new (mem) T();
+  }
+
+  // Returns the position of the first key >= `key`, or > `key` if
+  // `inclusive` is false. The keys may be read while a writer modifies the
+  // node, so the result is only meaningful once the version of the node is
+  // validated.
+  template <class Keys>
+  size_t LowerBound(const Keys& keys, size_t count, const char* key,
+                    bool inclusive) const {
+    size_t lo = 0, hi = count;
+    while (lo < hi) {
+      size_t mid = lo + (hi - lo) / 2;
+      const char* k = Load(keys[mid]);
+      if (k == nullptr) {
+        // Slot not written yet; the validation will fail
+        return mid;
+      }
+      int c = cmp_(k, key);
+      if (c < 0 || (c == 0 && !inclusive)) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+
+  size_t LowerBound(const LeafSnapshot& leaf, const char* key,
+                    bool inclusive) const {
+    return LowerBound(leaf.keys, leaf.count, key, inclusive);
+  }
+
+  static const char* Load(const std::atomic<const char*>& key) {
+    return key.load(std::memory_order_acquire);
+  }
+  static const char* Load(const char* key) { return key; }
+
+  bool TryCopyLeaf(Leaf* leaf, LeafSnapshot* snapshot) const {
+    uint64_t version;
+    if (!leaf->lock.ReadLock(&version)) {
+      return false;
+    }
+    return CopyLeaf(leaf, version, snapshot);
+  }
+
+  bool CopyLeaf(Leaf* leaf, uint64_t version, LeafSnapshot* snapshot) const {
+    size_t count = leaf->count.load(std::memory_order_acquire);
+    if (count > kLeafCapacity) {
+      return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      snapshot->keys[i] = leaf->keys[i].load(std::memory_order_acquire);
+      if (snapshot->keys[i] == nullptr) {
+        return false;
+      }
+    }
+    snapshot->count = count;
+    snapshot->next = leaf->next.load(std::memory_order_acquire);
+    if (!leaf->lock.Validate(version)) {
+      snapshot->count = 0;
+      return false;
+    }
+    return true;
+  }
+
+  // Copies the leaf which would hold `key`, or the leftmost or rightmost
+  // leaf if `key` is nullptr. If `fence` is not nullptr, sets it to the
+  // largest separator below the keys of the leaf, or to nullptr if it is the
+  // leftmost leaf. Returns false if a concurrent writer got in the way.
+  bool TryFindLeaf(const char* key, bool rightmost, LeafSnapshot* snapshot,
+                   const char** fence) const {
+    Node* node = root_.load(std::memory_order_acquire);
+    uint64_t version;
+    if (!node->lock.ReadLock(&version) ||
+        node != root_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    while (!node->leaf) {
+      Inner* inner = static_cast<Inner*>(node);
+      size_t count = inner->count.load(std::memory_order_acquire);
+      if (count > kInnerCapacity) {
+        return false;
+      }
+      size_t i;
+      if (key != nullptr) {
+        i = LowerBound(inner->keys, count, key, true /* inclusive */);
+      } else {
+        i = rightmost ? count : 0;
+      }
+      if (fence != nullptr && i > 0) {
+        *fence = inner->keys[i - 1].load(std::memory_order_acquire);
+      }
+      Node* child = inner->children[i].load(std::memory_order_acquire);
+      uint64_t child_version;
+      // The parent is validated after the child is read locked, so that the
+      // child is known not to have split in between
+      if (child == nullptr || !child->lock.ReadLock(&child_version) ||
+          !inner->lock.Validate(version)) {
+        return false;
+      }
+      node = child;
+      version = child_version;
+    }
+    return CopyLeaf(static_cast<Leaf*>(node), version, snapshot);
+  }
+
+  // Locks `node`, and `parent` unless it is the root, for a split. Returns
+  // false if either changed since they were read.
+  bool LockForSplit(Inner* parent, uint64_t parent_version, Node* node,
+                    uint64_t version) {
+    if (parent != nullptr && !parent->lock.Upgrade(parent_version)) {
+      return false;
+    }
+    if (!node->lock.Upgrade(version)) {
+      if (parent != nullptr) {
+        parent->lock.WriteUnlock();
+      }
+      return false;
+    }
+    return true;
+  }
+
+  // Moves the upper half of a locked leaf to a new right sibling, and
+  // returns the separator between them
+  const char* SplitLeaf(Leaf* leaf, Node** right_node) {
+    Leaf* right = NewNode<Leaf>();
+    right->leaf = true;
+    size_t count = leaf->count.load(std::memory_order_relaxed);
+    size_t mid = count / 2;
+    for (size_t i = mid; i < count; ++i) {
+      right->keys[i - mid].store(leaf->keys[i].load(std::memory_order_relaxed),
+                                 std::memory_order_relaxed);
+    }
+    right->count.store(static_cast<uint16_t>(count - mid),
+                       std::memory_order_relaxed);
+    right->next.store(leaf->next.load(std::memory_order_relaxed),
+                      std::memory_order_relaxed);
+    leaf->next.store(right, std::memory_order_release);
+    leaf->count.store(static_cast<uint16_t>(mid), std::memory_order_release);
+    *right_node = right;
+    return leaf->keys[mid - 1].load(std::memory_order_relaxed);
+  }
+
+  // Moves the upper half of a locked inner node to a new right sibling, and
+  // returns the separator between them, which moves up to the parent
+  const char* SplitInner(Inner* inner, Node** right_node) {
+    Inner* right = NewNode<Inner>();
+    size_t count = inner->count.load(std::memory_order_relaxed);
+    size_t mid = count / 2;
+    for (size_t i = mid + 1; i < count; ++i) {
+      right->keys[i - mid - 1].store(
+          inner->keys[i].load(std::memory_order_relaxed),
+          std::memory_order_relaxed);
+    }
+    for (size_t i = mid + 1; i <= count; ++i) {
+      right->children[i - mid - 1].store(
+          inner->children[i].load(std::memory_order_relaxed),
+          std::memory_order_relaxed);
+    }
+    right->count.store(static_cast<uint16_t>(count - mid - 1),
+                       std::memory_order_relaxed);
+    inner->count.store(static_cast<uint16_t>(mid), std::memory_order_release);
+    *right_node = right;
+    return inner->keys[mid].load(std::memory_order_relaxed);
+  }
+
+  // Splits a locked node, and adds the new sibling to `parent`, or to a new
+  // root if `parent` is nullptr
+  void Split(Inner* parent, Node* node) {
+    Node* right;
+    const char* separator =
+        node->leaf ? SplitLeaf(static_cast<Leaf*>(node), &right)
+                   : SplitInner(static_cast<Inner*>(node), &right);
+    if (parent == nullptr) {
+      Inner* root = NewNode<Inner>();
+      root->keys[0].store(separator, std::memory_order_relaxed);
+      root->children[0].store(node, std::memory_order_relaxed);
+      root->children[1].store(right, std::memory_order_relaxed);
+      root->count.store(1, std::memory_order_relaxed);
+      root_.store(root, std::memory_order_release);
+      return;
+    }
+    size_t count = parent->count.load(std::memory_order_relaxed);
+    assert(count < kInnerCapacity);
+    size_t pos =
+        LowerBound(parent->keys, count, separator, true /* inclusive */);
+    for (size_t i = count; i > pos; --i) {
+      parent->keys[i].store(parent->keys[i - 1].load(std::memory_order_relaxed),
+                            std::memory_order_release);
+      parent->children[i + 1].store(
+          parent->children[i].load(std::memory_order_relaxed),
+          std::memory_order_release);
+    }
+    parent->keys[pos].store(separator, std::memory_order_release);
+    parent->children[pos + 1].store(right, std::memory_order_release);
+    parent->count.store(static_cast<uint16_t>(count + 1),
+                        std::memory_order_release);
+  }
+
+  InsertResult TryInsert(const char* key) {
+    Node* node = root_.load(std::memory_order_acquire);
+    uint64_t version;
+    if (!node->lock.ReadLock(&version) ||
+        node != root_.load(std::memory_order_acquire)) {
+      return kRetry;
+    }
+    Inner* parent = nullptr;
+    uint64_t parent_version = 0;
+    while (true) {
+      size_t capacity = node->leaf ? kLeafCapacity : kInnerCapacity;
+      if (node->count.load(std::memory_order_relaxed) >= capacity) {
+        // Split full nodes on the way down, so that the parent always has
+        // room for the separator
+        if (LockForSplit(parent, parent_version, node, version)) {
+          Split(parent, node);
+          node->lock.WriteUnlock();
+          if (parent != nullptr) {
+            parent->lock.WriteUnlock();
+          }
+        }
+        return kRetry;
+      }
+      if (node->leaf) {
+        break;
+      }
+      Inner* inner = static_cast<Inner*>(node);
+      size_t count = inner->count.load(std::memory_order_acquire);
+      Node* child = inner->children[LowerBound(inner->keys, count, key,
+                                               true /* inclusive */)]
+                        .load(std::memory_order_acquire);
+      uint64_t child_version;
+      if (child == nullptr || !child->lock.ReadLock(&child_version) ||
+          !inner->lock.Validate(version)) {
+        return kRetry;
+      }
+      parent = inner;
+      parent_version = version;
+      node = child;
+      version = child_version;
+    }
+
+    // The leaf did not split since it was reached, so it still covers `key`
+    Leaf* leaf = static_cast<Leaf*>(node);
+    if (!leaf->lock.Upgrade(version)) {
+      return kRetry;
+    }
+    size_t count = leaf->count.load(std::memory_order_relaxed);
+    size_t pos = LowerBound(leaf->keys, count, key, true /* inclusive */);
+    if (pos < count &&
+        cmp_(leaf->keys[pos].load(std::memory_order_relaxed), key) == 0) {
+      leaf->lock.WriteUnlock();
+      return kDuplicate;
+    }
+    for (size_t i = count; i > pos; --i) {
+      leaf->keys[i].store(leaf->keys[i - 1].load(std::memory_order_relaxed),
+                          std::memory_order_release);
+    }
+    leaf->keys[pos].store(key, std::memory_order_release);
+    leaf->count.store(static_cast<uint16_t>(count + 1),
+                      std::memory_order_release);
+    leaf->lock.WriteUnlock();
+    return kInserted;
+  }
+
+  const MemTableRep::KeyComparator& cmp_;
+  std::atomic<Node*> root_;
+};
+
+}  // namespace
+
+MemTableRep* BTreeRepFactory::CreateMemTableRep(
+    const MemTableRep::KeyComparator& compare, Allocator* allocator,
+    const SliceTransform* /*transform*/, Logger* /*logger*/) {
+  return new BTreeRep(compare, allocator);
+}
+
+}  // namespace rocksdb
@@ -29,9 +29,13 @@ using Pointer = std::atomic<void*>;
 struct BucketHeader {
   Pointer next;
   std::atomic<uint32_t> num_entries;
+  // Number of entries linked into the list. With InsertConcurrently(),
+  // num_entries is incremented before linking an entry, so this one lags
+  // behind it while insertions are in flight. Unused for skip list buckets.
+  std::atomic<uint32_t> num_linked;
 
   explicit BucketHeader(void* n, uint32_t count)
-      : next(n), num_entries(count) {}
+      : next(n), num_entries(count), num_linked(count) {}
 
   bool IsSkipListBucket() {
     return next.load(std::memory_order_relaxed) == this;
@@ -46,6 +50,8 @@ struct BucketHeader {
     // Only one thread can do write at one time. No need to do atomic
     // incremental. Update it with relaxed load and store.
     num_entries.store(GetNumEntries() + 1, std::memory_order_relaxed);
+    num_linked.store(num_linked.load(std::memory_order_relaxed) + 1,
+                     std::memory_order_relaxed);
   }
 };
 
@@ -79,6 +85,10 @@ struct Node {
 
   void NoBarrier_SetNext(Node* x) { next_.store(x, std::memory_order_relaxed); }
 
+  bool CASNext(Node* expected, Node* x) {
+    return next_.compare_exchange_strong(expected, x);
+  }
+
   // Needed for placement new below which is fine
   Node() {}
 
@@ -152,6 +162,21 @@ struct Node {
 //     to itself, so no matter a reader sees any stale or newer value, it will
 //     be able to correctly distinguish case 3 and 4.
 //
+// InsertConcurrently() makes the same changes with CAS instead of stores:
+// (1) Cases 1->2 and 2->3 install the new bucket pointer with a CAS, and
+//     start over when another insertion changed it first.
+// (2) In case 3, an insertion first reserves its entry by incrementing the
+//     header's count with a CAS, as long as it is below the threshold, then
+//     links its node into the sorted list with a CAS on the next pointer of
+//     its predecessor, and finally increments the header's num_linked.
+// (3) Once the count reaches the threshold, the insertion that moves
+//     num_linked from the threshold to one more converts the bucket to case
+//     4. It can only do so after all reserved entries are linked, and as the
+//     count cannot grow anymore, no entry can be added to the linked list
+//     after it is copied to the skip list. Other insertions wait for the
+//     conversion to complete.
+// (4) Case 4 relies on SkipList::InsertConcurrently().
+//
 // The reason that we use case 2 is we want to make the format to be efficient
 // when the utilization of buckets is relatively low. If we use case 3 for
 // single entry bucket, we will need to waste 12 bytes for every entry,
@@ -169,6 +194,8 @@ class HashLinkListRep : public MemTableRep {
 
   void Insert(KeyHandle handle) override;
 
+  void InsertConcurrently(KeyHandle handle) override;
+
   bool Contains(const char* key) const override;
 
   size_t ApproximateMemoryUsage() override;
@@ -259,6 +286,24 @@ class HashLinkListRep : public MemTableRep {
   Node* FindGreaterOrEqualInBucket(Node* head, const Slice& key) const;
   Node* FindLessOrEqualInBucket(Node* head, const Slice& key) const;
 
+  // Links x into the sorted linked list of `header` with CAS.
+  void LinkListInsertConcurrently(BucketHeader* header, Node* x,
+                                  const Slice& internal_key);
+
+  // Creates a skip list bucket with the entries of the linked list headed by
+  // `first` and x.
+  SkipListBucketHeader* ConvertToSkipListBucket(Node* first,
+                                                uint32_t num_entries, Node* x);
+
+  void LogBucketEntries(size_t hash, uint32_t num_entries, Node* x) const {
+    Info(logger_,
+         "HashLinkedList bucket %" ROCKSDB_PRIszt
+         " has more than %d "
+         "entries. Key to insert: %s",
+         hash, num_entries,
+         GetLengthPrefixedSlice(x->key).ToString(true).c_str());
+  }
+
   class FullListIterator : public MemTableRep::Iterator {
    public:
     explicit FullListIterator(MemtableSkipList* list, Allocator* allocator)
@@ -627,32 +672,16 @@ void HashLinkListRep::Insert(KeyHandle handle) {
   if (bucket_entries_logging_threshold_ > 0 &&
       header->GetNumEntries() ==
           static_cast<uint32_t>(bucket_entries_logging_threshold_)) {
-    Info(logger_,
-         "HashLinkedList bucket %" ROCKSDB_PRIszt
-         " has more than %d "
-         "entries. Key to insert: %s",
-         GetHash(transformed), header->GetNumEntries(),
-         GetLengthPrefixedSlice(x->key).ToString(true).c_str());
+    LogBucketEntries(GetHash(transformed), header->GetNumEntries(), x);
   }
 
   if (header->GetNumEntries() == threshold_use_skiplist_) {
     // Case 3. number of entries reaches the threshold so need to convert to
     // skip list.
-    LinkListIterator bucket_iter(
-        this, reinterpret_cast<Node*>(
-                  first_next_pointer->load(std::memory_order_relaxed)));
-    auto mem = allocator_->AllocateAligned(sizeof(SkipListBucketHeader));
-    SkipListBucketHeader* new_skip_list_header = new (mem)
-        SkipListBucketHeader(compare_, allocator_, header->GetNumEntries() + 1);
-    auto& skip_list = new_skip_list_header->skip_list;
-
-    // Add all current entries to the skip list
-    for (bucket_iter.SeekToHead(); bucket_iter.Valid(); bucket_iter.Next()) {
-      skip_list.Insert(bucket_iter.key());
-    }
-
-    // insert the new entry
-    skip_list.Insert(x->key);
+    SkipListBucketHeader* new_skip_list_header = ConvertToSkipListBucket(
+        reinterpret_cast<Node*>(
+            first_next_pointer->load(std::memory_order_relaxed)),
+        header->GetNumEntries(), x);
     // Set the bucket
     bucket.store(new_skip_list_header, std::memory_order_release);
   } else {
@@ -701,6 +730,159 @@ void HashLinkListRep::Insert(KeyHandle handle) {
   }
 }
 
+void HashLinkListRep::InsertConcurrently(KeyHandle handle) {
+  Node* x = static_cast<Node*>(handle);
+  Slice internal_key = GetLengthPrefixedSlice(x->key);
+  auto transformed = GetPrefix(internal_key);
+  size_t hash = GetHash(transformed);
+  auto& bucket = buckets_[hash];
+  // Kept for the next attempt when failing to install it
+  BucketHeader* new_header = nullptr;
+
+  while (true) {
+    void* first_next_pointer_value = bucket.load(std::memory_order_acquire);
+    Pointer* first_next_pointer =
+        static_cast<Pointer*>(first_next_pointer_value);
+
+    if (first_next_pointer == nullptr) {
+      // Case 1. empty bucket
+      x->NoBarrier_SetNext(nullptr);
+      if (bucket.compare_exchange_strong(first_next_pointer_value, x,
+                                         std::memory_order_release,
+                                         std::memory_order_relaxed)) {
+        return;
+      }
+      continue;
+    }
+
+    // Loaded once: it may change from null between two loads.
+    void* first_next = first_next_pointer->load(std::memory_order_acquire);
+    if (first_next == nullptr) {
+      // Case 2. only one entry in the bucket. Add a header before inserting
+      // the new node, as in Insert().
+      Node* first = reinterpret_cast<Node*>(first_next_pointer);
+      if (new_header == nullptr) {
+        auto* mem = allocator_->AllocateAligned(sizeof(BucketHeader));
+        new_header = new (mem) BucketHeader(first, 1);
+      } else {
+        new_header->next.store(first, std::memory_order_relaxed);
+      }
+      if (bucket.compare_exchange_strong(first_next_pointer_value, new_header,
+                                         std::memory_order_release,
+                                         std::memory_order_relaxed)) {
+        new_header = nullptr;
+      }
+      continue;
+    }
+
+    if (bucket.load(std::memory_order_acquire) != first_next_pointer_value) {
+      // As in GetLinkListFirstNode(), the single entry may have been linked
+      // to another one after the bucket was changed to a counting header, so
+      // it is only a header if it is still in the bucket.
+      continue;
+    }
+
+    BucketHeader* header = reinterpret_cast<BucketHeader*>(first_next_pointer);
+    if (header->IsSkipListBucket()) {
+      // Case 4. Bucket is already a skip list
+      auto* skip_list_bucket_header =
+          reinterpret_cast<SkipListBucketHeader*>(header);
+      skip_list_bucket_header->Counting_header.num_entries.fetch_add(
+          1, std::memory_order_relaxed);
+      skip_list_bucket_header->skip_list.InsertConcurrently(x->key);
+      return;
+    }
+
+    uint32_t num_entries = header->GetNumEntries();
+    if (num_entries < threshold_use_skiplist_) {
+      // Case 5. Reserve the entry, then insert to the sorted linked list
+      if (!header->num_entries.compare_exchange_weak(
+              num_entries, num_entries + 1, std::memory_order_relaxed)) {
+        continue;
+      }
+      if (bucket_entries_logging_threshold_ > 0 &&
+          num_entries ==
+              static_cast<uint32_t>(bucket_entries_logging_threshold_)) {
+        LogBucketEntries(hash, num_entries, x);
+      }
+      LinkListInsertConcurrently(header, x, internal_key);
+      header->num_linked.fetch_add(1, std::memory_order_release);
+      return;
+    }
+
+    // Case 3. number of entries reaches the threshold so need to convert to
+    // skip list. Only one insertion does it, once all the entries reserved
+    // before are linked.
+    uint32_t num_linked = threshold_use_skiplist_;
+    if (header->num_linked.compare_exchange_strong(
+            num_linked, threshold_use_skiplist_ + 1,
+            std::memory_order_acquire, std::memory_order_relaxed)) {
+      SkipListBucketHeader* new_skip_list_header = ConvertToSkipListBucket(
+          reinterpret_cast<Node*>(header->next.load(std::memory_order_acquire)),
+          threshold_use_skiplist_, x);
+      bucket.store(new_skip_list_header, std::memory_order_release);
+      return;
+    }
+    // Wait for the in-flight insertions or the conversion
+    port::AsmVolatilePause();
+  }
+}
+
+void HashLinkListRep::LinkListInsertConcurrently(BucketHeader* header,
+                                                 Node* x,
+                                                 const Slice& internal_key) {
+  // nullptr prev stands for the header
+  Node* prev = nullptr;
+  Node* cur =
+      reinterpret_cast<Node*>(header->next.load(std::memory_order_acquire));
+  assert(cur != nullptr);
+  while (true) {
+    while (KeyIsAfterNode(internal_key, cur)) {
+      prev = cur;
+      cur = cur->Next();
+    }
+
+    // Our data structure does not allow duplicate insertion
+    assert(cur == nullptr || !Equal(x->key, cur->key));
+
+    // NoBarrier_SetNext() suffices since the CAS publishing x is a barrier
+    x->NoBarrier_SetNext(cur);
+    if (prev != nullptr) {
+      if (prev->CASNext(cur, x)) {
+        return;
+      }
+      cur = prev->Next();
+    } else {
+      void* expected = cur;
+      if (header->next.compare_exchange_strong(expected, x)) {
+        return;
+      }
+      cur = static_cast<Node*>(expected);
+    }
+    // Another insertion got in between prev and cur. Nodes are never
+    // removed, so search again from prev.
+  }
+}
+
+SkipListBucketHeader* HashLinkListRep::ConvertToSkipListBucket(
+    Node* first, uint32_t num_entries, Node* x) {
+  LinkListIterator bucket_iter(this, first);
+  auto mem = allocator_->AllocateAligned(sizeof(SkipListBucketHeader));
+  SkipListBucketHeader* new_skip_list_header = new (mem)
+      SkipListBucketHeader(compare_, allocator_, num_entries + 1);
+  auto& skip_list = new_skip_list_header->skip_list;
+
+  // Add all current entries to the skip list. It is not visible to other
+  // threads yet, so Insert() suffices.
+  for (bucket_iter.SeekToHead(); bucket_iter.Valid(); bucket_iter.Next()) {
+    skip_list.Insert(bucket_iter.key());
+  }
+
+  // insert the new entry
+  skip_list.Insert(x->key);
+  return new_skip_list_header;
+}
+
 bool HashLinkListRep::Contains(const char* key) const {
   Slice internal_key = GetLengthPrefixedSlice(key);
 
@@ -901,6 +1083,8 @@ class HashLinkListRepFactory : public MemTableRepFactory {
   virtual const char* Name() const override { return kClassName(); }
   virtual const char* NickName() const override { return kNickName(); }
 
+  bool IsInsertConcurrentlySupported() const override { return true; }
+
  private:
   HashLinkListRepOptions options_;
 };
@@ -28,6 +28,8 @@ class HashSkipListRep : public MemTableRep {
 
   void Insert(KeyHandle handle) override;
 
+  void InsertConcurrently(KeyHandle handle) override;
+
   bool Contains(const char* key) const override;
 
   size_t ApproximateMemoryUsage() override;
@@ -73,8 +75,9 @@ class HashSkipListRep : public MemTableRep {
     return GetBucket(GetHash(slice));
   }
   // Get a bucket from buckets_. If the bucket hasn't been initialized yet,
-  // initialize it before returning.
-  Bucket* GetInitializedBucket(const Slice& transformed);
+  // initialize it before returning. With `concurrent`, the bucket is
+  // installed with a CAS, in case another insertion initializes it too.
+  Bucket* GetInitializedBucket(const Slice& transformed, bool concurrent);
 
   class Iterator : public MemTableRep::Iterator {
    public:
@@ -251,14 +254,23 @@ HashSkipListRep::HashSkipListRep(const MemTableRep::KeyComparator& compare,
 HashSkipListRep::~HashSkipListRep() {}
 
 HashSkipListRep::Bucket* HashSkipListRep::GetInitializedBucket(
-    const Slice& transformed) {
+    const Slice& transformed, bool concurrent) {
   size_t hash = GetHash(transformed);
   auto bucket = GetBucket(hash);
   if (bucket == nullptr) {
     auto addr = allocator_->AllocateAligned(sizeof(Bucket));
-    bucket = new (addr) Bucket(compare_, allocator_, skiplist_height_,
-                               skiplist_branching_factor_);
-    buckets_[hash].store(bucket, std::memory_order_release);
+    auto new_bucket = new (addr) Bucket(compare_, allocator_, skiplist_height_,
+                                        skiplist_branching_factor_);
+    if (!concurrent) {
+      buckets_[hash].store(new_bucket, std::memory_order_release);
+      bucket = new_bucket;
+    } else if (buckets_[hash].compare_exchange_strong(
+                   bucket, new_bucket, std::memory_order_release,
+                   std::memory_order_acquire)) {
+      bucket = new_bucket;
+    }
+    // Otherwise another insertion won the race, and `bucket` is now the
+    // bucket it installed. The memory of ours stays in the allocator.
   }
   return bucket;
 }
@@ -267,10 +279,17 @@ void HashSkipListRep::Insert(KeyHandle handle) {
   auto* key = static_cast<char*>(handle);
   assert(!Contains(key));
   auto transformed = transform_->Transform(UserKey(key));
-  auto bucket = GetInitializedBucket(transformed);
+  auto bucket = GetInitializedBucket(transformed, false /* concurrent */);
   bucket->Insert(key);
 }
 
+void HashSkipListRep::InsertConcurrently(KeyHandle handle) {
+  auto* key = static_cast<char*>(handle);
+  auto transformed = transform_->Transform(UserKey(key));
+  auto bucket = GetInitializedBucket(transformed, true /* concurrent */);
+  bucket->InsertConcurrently(key);
+}
+
 bool HashSkipListRep::Contains(const char* key) const {
   auto transformed = transform_->Transform(UserKey(key));
   auto bucket = GetBucket(transformed);
@@ -371,6 +390,8 @@ class HashSkipListRepFactory : public MemTableRepFactory {
   virtual const char* Name() const override { return kClassName(); }
   virtual const char* NickName() const override { return kNickName(); }
 
+  bool IsInsertConcurrentlySupported() const override { return true; }
+
  private:
   HashSkipListRepOptions options_;
 };
@@ -25,6 +25,7 @@ int main() {
 #include "db/dbformat.h"
 #include "db/memtable.h"
 #include "memory/arena.h"
+#include "memory/concurrent_arena.h"
 #include "port/port.h"
 #include "port/stack_trace.h"
 #include "rocksdb/comparator.h"
@@ -47,8 +48,12 @@ DEFINE_string(benchmarks, "fillrandom",
               "Comma-separated list of benchmarks to run. Options:\n"
               "\tfillrandom             -- write N random values\n"
               "\tfillseq                -- write N values in sequential order\n"
+              "\tfillrandomconcurrent   -- N threads write random values\n"
+              "\t                          concurrently\n"
               "\treadrandom             -- read N values in random order\n"
               "\treadseq                -- scan the DB\n"
+              "\tseekrandom             -- seek to N random keys, reading\n"
+              "\t                          seek_nexts entries after each\n"
               "\treadwrite              -- 1 thread writes while N - 1 threads "
               "do random\n"
               "\t                          reads\n"
@@ -61,6 +66,7 @@ DEFINE_string(memtablerep, "skiplist",
               "  more details. Options:\n"
               "\tskiplist            -- backed by a skiplist\n"
               "\tvector              -- backed by an std::vector\n"
+              "\tbtree               -- backed by a B+-tree\n"
               "\thashskiplist        -- backed by a hash skip list\n"
               "\thashlinklist        -- backed by a hash linked list\n"
               "\tcuckoo              -- backed by a cuckoo hash table");
@@ -99,7 +105,8 @@ DEFINE_int64(write_buffer_size, 256,
 DEFINE_int32(
     num_threads, 1,
     "Number of concurrent threads to run. If the benchmark includes writes,\n"
-    "then at most one thread will be a writer");
+    "then at most one thread will be a writer, except for\n"
+    "fillrandomconcurrent where all of them are writers");
 
 DEFINE_int32(num_operations, 1000000,
              "Number of operations to do for write and random read benchmarks");
@@ -109,6 +116,9 @@ DEFINE_int32(num_scans, 10,
              "sequential read "
              "benchmarks");
 
+DEFINE_int32(seek_nexts, 10,
+             "Number of entries to read after each seek in seekrandom");
+
 DEFINE_int32(item_size, 100, "Number of bytes each item should be");
 
 DEFINE_int32(prefix_length, 8,
@@ -234,7 +244,7 @@ class FillBenchmarkThread : public BenchmarkThread {
       : BenchmarkThread(table, key_gen, bytes_written, bytes_read, sequence,
                         num_ops, read_hits) {}
 
-  void FillOne() {
+  void FillOne(bool concurrently = false) {
     char* buf = nullptr;
     auto internal_key_size = 16;
     auto encoded_len = FLAGS_item_size +
@@ -252,7 +262,11 @@ class FillBenchmarkThread : public BenchmarkThread {
     memcpy(p, bytes.data(), FLAGS_item_size);
     p += FLAGS_item_size;
     assert(p == buf + encoded_len);
-    table_->Insert(handle);
+    if (concurrently) {
+      table_->InsertConcurrently(handle);
+    } else {
+      table_->Insert(handle);
+    }
     *bytes_written_ += encoded_len;
   }
 
@@ -287,6 +301,22 @@ class ConcurrentFillBenchmarkThread : public FillBenchmarkThread {
   std::atomic_int* threads_done_;
 };
 
+class MultiWriterFillBenchmarkThread : public FillBenchmarkThread {
+ public:
+  MultiWriterFillBenchmarkThread(MemTableRep* table, KeyGenerator* key_gen,
+                                 uint64_t* bytes_written, uint64_t* bytes_read,
+                                 uint64_t* sequence, uint64_t num_ops,
+                                 uint64_t* read_hits)
+      : FillBenchmarkThread(table, key_gen, bytes_written, bytes_read, sequence,
+                            num_ops, read_hits) {}
+
+  void operator()() override {
+    for (unsigned int i = 0; i < num_ops_; ++i) {
+      FillOne(true /* concurrently */);
+    }
+  }
+};
+
 class ReadBenchmarkThread : public BenchmarkThread {
  public:
   ReadBenchmarkThread(MemTableRep* table, KeyGenerator* key_gen,
@@ -363,6 +393,38 @@ class SeqReadBenchmarkThread : public BenchmarkThread {
   }
 };
 
+class SeekBenchmarkThread : public BenchmarkThread {
+ public:
+  SeekBenchmarkThread(MemTableRep* table, KeyGenerator* key_gen,
+                      uint64_t* bytes_written, uint64_t* bytes_read,
+                      uint64_t* sequence, uint64_t num_ops, uint64_t* read_hits)
+      : BenchmarkThread(table, key_gen, bytes_written, bytes_read, sequence,
+                        num_ops, read_hits) {}
+
+  void SeekOne(MemTableRep::Iterator* iter) {
+    std::string user_key;
+    rocksdb_rs::coding::PutFixed64(user_key, key_gen_->Next());
+    LookupKey lookup_key(user_key, *sequence_);
+    iter->Seek(lookup_key.internal_key(), lookup_key.memtable_key().data());
+    if (iter->Valid()) {
+      ++*read_hits_;
+    }
+    for (int i = 0; i <= FLAGS_seek_nexts && iter->Valid(); ++i) {
+      // pretend to read the value
+      *bytes_read_ +=
+          rocksdb_rs::coding::VarintLength(16) + 16 + FLAGS_item_size;
+      iter->Next();
+    }
+  }
+
+  void operator()() override {
+    std::unique_ptr<MemTableRep::Iterator> iter(table_->GetIterator());
+    for (unsigned int i = 0; i < num_ops_; ++i) {
+      SeekOne(iter.get());
+    }
+  }
+};
+
 class ConcurrentReadBenchmarkThread : public ReadBenchmarkThread {
  public:
   ConcurrentReadBenchmarkThread(MemTableRep* table, KeyGenerator* key_gen,
@@ -481,6 +543,43 @@ class FillBenchmark : public Benchmark {
   }
 };
 
+class MultiWriterFillBenchmark : public Benchmark {
+ public:
+  explicit MultiWriterFillBenchmark(MemTableRep* table, uint64_t* sequence)
+      : Benchmark(table, nullptr, sequence, FLAGS_num_threads) {
+    num_write_ops_per_thread_ = FLAGS_num_operations / FLAGS_num_threads;
+  }
+
+  void RunThreads(std::vector<port::Thread>* threads, uint64_t* bytes_written,
+                  uint64_t* bytes_read, bool /*write*/,
+                  uint64_t* read_hits) override {
+    // Every writer has its own key generator, counters and range of sequence
+    // numbers, so that the only shared state is the memtable rep itself.
+    std::vector<std::unique_ptr<Random64>> rngs;
+    std::vector<std::unique_ptr<KeyGenerator>> key_gens;
+    std::vector<uint64_t> sequences(FLAGS_num_threads);
+    std::vector<uint64_t> thread_bytes_written(FLAGS_num_threads, 0);
+    for (int i = 0; i < FLAGS_num_threads; ++i) {
+      rngs.emplace_back(new Random64(FLAGS_seed + i));
+      key_gens.emplace_back(new KeyGenerator(
+          rngs.back().get(), WriteMode::RANDOM, FLAGS_num_operations));
+      sequences[i] = *sequence_ + i * num_write_ops_per_thread_;
+    }
+    for (int i = 0; i < FLAGS_num_threads; ++i) {
+      threads->emplace_back(MultiWriterFillBenchmarkThread(
+          table_, key_gens[i].get(), &thread_bytes_written[i], bytes_read,
+          &sequences[i], num_write_ops_per_thread_, read_hits));
+    }
+    for (auto& thread : *threads) {
+      thread.join();
+    }
+    for (auto bytes : thread_bytes_written) {
+      *bytes_written += bytes;
+    }
+    *sequence_ += FLAGS_num_threads * num_write_ops_per_thread_;
+  }
+};
+
 class ReadBenchmark : public Benchmark {
  public:
   explicit ReadBenchmark(MemTableRep* table, KeyGenerator* key_gen,
@@ -527,6 +626,28 @@ class SeqReadBenchmark : public Benchmark {
   }
 };
 
+class SeekBenchmark : public Benchmark {
+ public:
+  explicit SeekBenchmark(MemTableRep* table, KeyGenerator* key_gen,
+                         uint64_t* sequence)
+      : Benchmark(table, key_gen, sequence, FLAGS_num_threads) {
+    num_read_ops_per_thread_ = FLAGS_num_operations / FLAGS_num_threads;
+  }
+
+  void RunThreads(std::vector<port::Thread>* threads, uint64_t* bytes_written,
+                  uint64_t* bytes_read, bool /*write*/,
+                  uint64_t* read_hits) override {
+    for (int i = 0; i < FLAGS_num_threads; ++i) {
+      threads->emplace_back(
+          SeekBenchmarkThread(table_, key_gen_, bytes_written, bytes_read,
+                              sequence_, num_read_ops_per_thread_, read_hits));
+    }
+    for (auto& thread : *threads) {
+      thread.join();
+    }
+  }
+};
+
 template <class ReadThreadType>
 class ReadWriteBenchmark : public Benchmark {
  public:
@@ -587,6 +708,8 @@ int main(int argc, char** argv) {
     factory.reset(new rocksdb::SkipListFactory);
   } else if (FLAGS_memtablerep == "vector") {
     factory.reset(new rocksdb::VectorRepFactory);
+  } else if (FLAGS_memtablerep == "btree") {
+    factory.reset(new rocksdb::BTreeRepFactory);
   } else if (FLAGS_memtablerep == "hashskiplist" ||
              FLAGS_memtablerep == "prefix_hash") {
     factory.reset(rocksdb::NewHashSkipListRepFactory(
@@ -619,11 +742,12 @@ int main(int argc, char** argv) {
       rocksdb::BytewiseComparator());
   rocksdb::MemTable::KeyComparator key_comp(internal_key_comp);
   rocksdb::Arena arena;
+  rocksdb::ConcurrentArena concurrent_arena;
   rocksdb::WriteBufferManager wb(FLAGS_write_buffer_size);
   uint64_t sequence;
-  auto createMemtableRep = [&] {
+  auto createMemtableRep = [&](rocksdb::Allocator* allocator) {
     sequence = 0;
-    return factory->CreateMemTableRep(key_comp, &arena,
+    return factory->CreateMemTableRep(key_comp, allocator,
                                       options.prefix_extractor.get(),
                                       options.info_log.get());
   };
@@ -643,17 +767,27 @@ int main(int argc, char** argv) {
     }
     std::unique_ptr<rocksdb::Benchmark> benchmark;
     if (name == rocksdb::Slice("fillseq")) {
-      memtablerep.reset(createMemtableRep());
+      memtablerep.reset(createMemtableRep(&arena));
       key_gen.reset(new rocksdb::KeyGenerator(
           &rng, rocksdb::WriteMode::SEQUENTIAL, FLAGS_num_operations));
       benchmark.reset(new rocksdb::FillBenchmark(memtablerep.get(),
                                                  key_gen.get(), &sequence));
     } else if (name == rocksdb::Slice("fillrandom")) {
-      memtablerep.reset(createMemtableRep());
+      memtablerep.reset(createMemtableRep(&arena));
       key_gen.reset(new rocksdb::KeyGenerator(
           &rng, rocksdb::WriteMode::UNIQUE_RANDOM, FLAGS_num_operations));
       benchmark.reset(new rocksdb::FillBenchmark(memtablerep.get(),
                                                  key_gen.get(), &sequence));
+    } else if (name == rocksdb::Slice("fillrandomconcurrent")) {
+      if (!factory->IsInsertConcurrentlySupported()) {
+        std::cout << "WARNING: skipping fillrandomconcurrent, "
+                  << factory->Name() << " does not support concurrent inserts"
+                  << std::endl;
+        continue;
+      }
+      memtablerep.reset(createMemtableRep(&concurrent_arena));
+      benchmark.reset(
+          new rocksdb::MultiWriterFillBenchmark(memtablerep.get(), &sequence));
     } else if (name == rocksdb::Slice("readrandom")) {
       key_gen.reset(new rocksdb::KeyGenerator(&rng, rocksdb::WriteMode::RANDOM,
                                               FLAGS_num_operations));
@@ -664,15 +798,20 @@ int main(int argc, char** argv) {
           &rng, rocksdb::WriteMode::SEQUENTIAL, FLAGS_num_operations));
       benchmark.reset(
           new rocksdb::SeqReadBenchmark(memtablerep.get(), &sequence));
+    } else if (name == rocksdb::Slice("seekrandom")) {
+      key_gen.reset(new rocksdb::KeyGenerator(&rng, rocksdb::WriteMode::RANDOM,
+                                              FLAGS_num_operations));
+      benchmark.reset(new rocksdb::SeekBenchmark(memtablerep.get(),
+                                                 key_gen.get(), &sequence));
     } else if (name == rocksdb::Slice("readwrite")) {
-      memtablerep.reset(createMemtableRep());
+      memtablerep.reset(createMemtableRep(&arena));
       key_gen.reset(new rocksdb::KeyGenerator(&rng, rocksdb::WriteMode::RANDOM,
                                               FLAGS_num_operations));
       benchmark.reset(new rocksdb::ReadWriteBenchmark<
                       rocksdb::ConcurrentReadBenchmarkThread>(
           memtablerep.get(), key_gen.get(), &sequence));
     } else if (name == rocksdb::Slice("seqreadwrite")) {
-      memtablerep.reset(createMemtableRep());
+      memtablerep.reset(createMemtableRep(&arena));
       key_gen.reset(new rocksdb::KeyGenerator(&rng, rocksdb::WriteMode::RANDOM,
                                               FLAGS_num_operations));
       benchmark.reset(new rocksdb::ReadWriteBenchmark<
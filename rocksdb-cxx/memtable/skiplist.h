@@ -10,7 +10,9 @@
 // Thread safety
 // -------------
 //
-// Writes require external synchronization, most likely a mutex.
+// Writes require external synchronization, most likely a mutex, except
+// for InsertConcurrently(), which may be called concurrently with other calls
+// to InsertConcurrently().
 // Reads require a guarantee that the SkipList will not be destroyed
 // while the read is in progress.  Apart from that, reads progress
 // without any internal locking or synchronization.
@@ -38,6 +40,7 @@
 
 #include "memory/allocator.h"
 #include "port/port.h"
+#include "util/autovector.h"
 #include "util/random.h"
 
 namespace rocksdb {
@@ -61,6 +64,12 @@ class SkipList {
   // REQUIRES: nothing that compares equal to key is currently in the list.
   void Insert(const Key& key);
 
+  // Like Insert(), but external synchronization is only needed with calls
+  // to Insert(), not with other calls to InsertConcurrently(). Requires an
+  // allocator that is safe for concurrent use, such as ConcurrentArena.
+  // REQUIRES: nothing that compares equal to key is currently in the list.
+  void InsertConcurrently(const Key& key);
+
   // Returns true iff an entry that compares equal to key is in the list.
   bool Contains(const Key& key) const;
 
@@ -135,6 +144,9 @@ class SkipList {
   // insertion, in which case max_height_ and prev_height_ are 1.
   Node** prev_;
   int32_t prev_height_;
+  // Set by InsertConcurrently(), which does not maintain prev_, so that the
+  // next Insert() recomputes it.
+  std::atomic<bool> prev_stale_;
 
   inline int GetMaxHeight() const {
     return max_height_.load(std::memory_order_relaxed);
@@ -197,6 +209,11 @@ struct SkipList<Key, Comparator>::Node {
     next_[n].store(x, std::memory_order_relaxed);
   }
 
+  bool CASNext(int n, Node* expected, Node* x) {
+    assert(n >= 0);
+    return next_[n].compare_exchange_strong(expected, x);
+  }
+
  private:
   // Array of length equal to the node height.  next_[0] is lowest level link.
   std::atomic<Node*> next_[1];
@@ -417,7 +434,8 @@ SkipList<Key, Comparator>::SkipList(const Comparator cmp, Allocator* allocator,
       allocator_(allocator),
       head_(NewNode(0 /* any key will do */, max_height)),
       max_height_(1),
-      prev_height_(1) {
+      prev_height_(1),
+      prev_stale_(false) {
   assert(max_height > 0 && kMaxHeight_ == static_cast<uint32_t>(max_height));
   assert(branching_factor > 0 &&
          kBranching_ == static_cast<uint32_t>(branching_factor));
@@ -436,7 +454,8 @@ SkipList<Key, Comparator>::SkipList(const Comparator cmp, Allocator* allocator,
 template <typename Key, class Comparator>
 void SkipList<Key, Comparator>::Insert(const Key& key) {
   // fast path for sequential insertion
-  if (!KeyIsAfterNode(key, prev_[0]->NoBarrier_Next(0)) &&
+  if (!prev_stale_.load(std::memory_order_relaxed) &&
+      !KeyIsAfterNode(key, prev_[0]->NoBarrier_Next(0)) &&
       (prev_[0] == head_ || KeyIsAfterNode(key, prev_[0]))) {
     assert(prev_[0] != head_ || (prev_height_ == 1 && GetMaxHeight() == 1));
 
@@ -452,6 +471,7 @@ void SkipList<Key, Comparator>::Insert(const Key& key) {
     // optimization for architectures where memory_order_acquire needs
     // a synchronization instruction.  Doesn't matter on x86
     FindLessThan(key, prev_);
+    prev_stale_.store(false, std::memory_order_relaxed);
   }
 
   // Our data structure does not allow duplicate insertion
@@ -485,6 +505,66 @@ void SkipList<Key, Comparator>::Insert(const Key& key) {
   prev_height_ = height;
 }
 
+template <typename Key, class Comparator>
+void SkipList<Key, Comparator>::InsertConcurrently(const Key& key) {
+  if (!prev_stale_.load(std::memory_order_relaxed)) {
+    prev_stale_.store(true, std::memory_order_relaxed);
+  }
+
+  int height = RandomHeight();
+  int max_height = GetMaxHeight();
+  while (height > max_height) {
+    if (max_height_.compare_exchange_weak(max_height, height)) {
+      // successfully updated it
+      max_height = height;
+      break;
+    }
+    // else retry, possibly exiting the loop because somebody else
+    // increased it
+  }
+
+  // Predecessor and successor of key at each level of the new node
+  autovector<Node*, 12> prev;
+  autovector<Node*, 12> next;
+  prev.resize(height);
+  next.resize(height);
+  Node* x = head_;
+  for (int level = max_height - 1; level >= 0; level--) {
+    Node* n = x->Next(level);
+    while (KeyIsAfterNode(key, n)) {
+      x = n;
+      n = x->Next(level);
+    }
+    if (level < height) {
+      prev[level] = x;
+      next[level] = n;
+    }
+  }
+
+  // Our data structure does not allow duplicate insertion
+  assert(next[0] == nullptr || !Equal(key, next[0]->key));
+
+  // Link the node from the bottom up, so that it is in the lower levels
+  // whenever it can be reached from the upper ones. When another insertion
+  // gets in between prev and next at some level, search again from prev,
+  // which is still before key since nodes are never removed.
+  Node* node = NewNode(key, height);
+  for (int level = 0; level < height; level++) {
+    while (true) {
+      node->NoBarrier_SetNext(level, next[level]);
+      if (prev[level]->CASNext(level, next[level], node)) {
+        break;
+      }
+      Node* n = prev[level]->Next(level);
+      while (KeyIsAfterNode(key, n)) {
+        prev[level] = n;
+        n = n->Next(level);
+      }
+      next[level] = n;
+    }
+  }
+}
+
 template <typename Key, class Comparator>
 bool SkipList<Key, Comparator>::Contains(const Key& key) const {
   Node* x = FindGreaterOrEqual(key);
@@ -12,6 +12,7 @@
 #include <set>
 
 #include "memory/arena.h"
+#include "memory/concurrent_arena.h"
 #include "rocksdb/env.h"
 #include "test_util/testharness.h"
 #include "util/hash.h"
@@ -138,6 +139,52 @@ TEST_F(SkipTest, InsertAndLookup) {
   }
 }
 
+TEST_F(SkipTest, InsertConcurrently) {
+  const int kNumThreads = 4;
+  const int kKeysPerThread = 2000;
+  ConcurrentArena arena;
+  TestComparator cmp;
+  SkipList<Key, TestComparator> list(cmp, &arena);
+
+  // Thread t inserts the keys congruent to t modulo kNumThreads, in random
+  // order, so that the threads keep inserting next to each other.
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([&list, t]() {
+      std::vector<Key> keys;
+      for (int i = 0; i < kKeysPerThread; i++) {
+        keys.push_back(static_cast<Key>(i) * kNumThreads + t);
+      }
+      RandomShuffle(keys.begin(), keys.end(), static_cast<uint32_t>(t + 1));
+      for (Key key : keys) {
+        list.InsertConcurrently(key);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  const Key kNumKeys = static_cast<Key>(kNumThreads) * kKeysPerThread;
+  for (Key key = 0; key < kNumKeys; key++) {
+    ASSERT_TRUE(list.Contains(key));
+  }
+  ASSERT_FALSE(list.Contains(kNumKeys));
+
+  // Serial inserts after concurrent ones cannot rely on the cached position
+  // of the previous Insert()
+  list.Insert(kNumKeys + 1);
+  list.Insert(kNumKeys);
+
+  SkipList<Key, TestComparator>::Iterator iter(&list);
+  Key expected = 0;
+  for (iter.SeekToFirst(); iter.Valid(); iter.Next()) {
+    ASSERT_EQ(expected, iter.key());
+    expected++;
+  }
+  ASSERT_EQ(kNumKeys + 2, expected);
+}
+
 // We want to make sure that with a single writer and multiple
 // concurrent readers (with no synchronization other than when a
 // reader's iterator is created), the reader always observes all the
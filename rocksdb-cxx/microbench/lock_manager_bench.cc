@@ -0,0 +1,167 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+// Lock throughput of pessimistic transactions locking key ranges under
+// contention, comparing one range lock per range (range lock manager)
+// against one point lock per key in the range (default point lock manager).
+
+#ifndef OS_WIN
+#include <unistd.h>
+#endif  // ! OS_WIN
+
+#include <cinttypes>
+#include <cstdio>
+
+#include "benchmark/benchmark.h"
+#include "file/filename.h"
+#include "rocksdb/db.h"
+#include "rocksdb/options.h"
+#include "rocksdb/utilities/transaction.h"
+#include "rocksdb/utilities/transaction_db.h"
+#include "util/random.h"
+
+namespace rocksdb {
+
+static std::string LockBenchKey(uint64_t k) {
+  // Fixed width, so that bytewise order matches numeric order
+  char buf[24];
+  snprintf(buf, sizeof(buf), "%016" PRIu64, k);
+  return buf;
+}
+
+static void SetupTxnDB(benchmark::State& state, bool use_range_lock,
+                       std::unique_ptr<TransactionDB>* txn_db,
+                       const std::string& test_name) {
+  Options options;
+  options.create_if_missing = true;
+  TransactionDBOptions txn_db_options;
+  if (use_range_lock) {
+#ifndef OS_WIN
+    txn_db_options.lock_mgr_handle.reset(NewRangeLockManager(nullptr));
+#else
+    state.SkipWithError("Range locking is not supported on this platform");
+    return;
+#endif  // ! OS_WIN
+  }
+
+  auto env = Env::Default();
+  std::string db_path;
+  rocksdb_rs::status::Status s = env->GetTestDirectory(&db_path);
+  if (!s.ok()) {
+    state.SkipWithError(s.ToString().c_str());
+    return;
+  }
+  std::string db_name =
+      db_path + kFilePathSeparator + test_name + std::to_string(getpid());
+  DestroyDB(db_name, options);
+
+  TransactionDB* db_ptr = nullptr;
+  s = TransactionDB::Open(options, txn_db_options, db_name, &db_ptr);
+  if (!s.ok()) {
+    state.SkipWithError(s.ToString().c_str());
+    return;
+  }
+  txn_db->reset(db_ptr);
+}
+
+static void TeardownTxnDB(benchmark::State& state,
+                          std::unique_ptr<TransactionDB>* txn_db) {
+  std::string db_name = (*txn_db)->GetName();
+  rocksdb_rs::status::Status s = (*txn_db)->Close();
+  if (!s.ok()) {
+    state.SkipWithError(s.ToString().c_str());
+  }
+  txn_db->reset();
+  DestroyDB(db_name, Options());
+}
+
+// Each iteration is one transaction locking `keys_per_lock` consecutive keys
+// starting at a random key, then releasing them (rollback). With more
+// threads and a smaller key space, transactions conflict more often.
+static void TxnLockRange(benchmark::State& state) {
+  const bool use_range_lock = state.range(0);
+  const uint64_t keys_per_lock = static_cast<uint64_t>(state.range(1));
+  const uint64_t key_space = static_cast<uint64_t>(state.range(2));
+
+  static std::unique_ptr<TransactionDB> txn_db;
+  if (state.thread_index() == 0) {
+    SetupTxnDB(state, use_range_lock, &txn_db, "TxnLockRange");
+  }
+
+  auto rnd = Random(301 + state.thread_index());
+  WriteOptions write_options;
+  ReadOptions read_options;
+  TransactionOptions txn_options;
+  // Don't wait on conflicts; count them instead
+  txn_options.lock_timeout = 0;
+  uint64_t conflicts = 0;
+  // Transactions that locked all their keys
+  uint64_t locked = 0;
+
+  for (auto _ : state) {
+    uint64_t start = rnd.Uniform(static_cast<int>(key_space - keys_per_lock));
+    // Not reusing the transaction object across iterations, so that none
+    // outlive the DB when thread 0 closes it.
+    std::unique_ptr<Transaction> txn(
+        txn_db->BeginTransaction(write_options, txn_options));
+    ColumnFamilyHandle* cf = txn_db->DefaultColumnFamily();
+    rocksdb_rs::status::Status s = rocksdb_rs::status::Status_OK();
+    if (use_range_lock) {
+      std::string first_key = LockBenchKey(start);
+      std::string last_key = LockBenchKey(start + keys_per_lock - 1);
+      s = txn->GetRangeLock(cf, Endpoint(first_key), Endpoint(last_key));
+    } else {
+      for (uint64_t k = start; s.ok() && k < start + keys_per_lock; ++k) {
+        s = txn->GetForUpdate(read_options, cf, LockBenchKey(k),
+                              static_cast<std::string*>(nullptr));
+      }
+    }
+    if (s.ok()) {
+      ++locked;
+    } else if (s.IsBusy() || s.IsTimedOut()) {
+      ++conflicts;
+    } else {
+      state.SkipWithError(s.ToString().c_str());
+      break;
+    }
+    s = txn->Rollback();
+    if (!s.ok()) {
+      state.SkipWithError(s.ToString().c_str());
+      break;
+    }
+  }
+
+  state.counters["keys_locked_per_sec"] = benchmark::Counter(
+      static_cast<double>(locked * keys_per_lock), benchmark::Counter::kIsRate);
+  if (state.iterations() > 0) {
+    state.counters["conflict_rate"] = benchmark::Counter(
+        static_cast<double>(conflicts) / state.iterations(),
+        benchmark::Counter::kAvgThreads);
+  }
+
+  if (state.thread_index() == 0) {
+    TeardownTxnDB(state, &txn_db);
+  }
+}
+
+static void TxnLockRangeArguments(benchmark::internal::Benchmark* b) {
+  for (bool use_range_lock : {false, true}) {
+    for (int64_t keys_per_lock : {1, 16, 256}) {
+      for (int64_t key_space : {10l << 10, 1l << 20}) {
+        b->Args({use_range_lock, keys_per_lock, key_space});
+      }
+    }
+  }
+  b->ArgNames({"use_range_lock", "keys_per_lock", "key_space"});
+}
+
+BENCHMARK(TxnLockRange)->Threads(1)->Apply(TxnLockRangeArguments);
+BENCHMARK(TxnLockRange)->Threads(8)->Apply(TxnLockRangeArguments);
+BENCHMARK(TxnLockRange)->Threads(32)->Apply(TxnLockRangeArguments);
+
+}  // namespace rocksdb
+
+BENCHMARK_MAIN();
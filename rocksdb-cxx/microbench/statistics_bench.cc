@@ -0,0 +1,77 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+// Measures the cost of recording statistics on the hot path, and of reading
+// all of them at once, as periodic stats scraping does.
+#include "benchmark/benchmark.h"
+#include "monitoring/statistics_impl.h"
+#include "rocksdb/statistics.h"
+
+namespace rocksdb {
+
+static std::shared_ptr<Statistics> GetStatistics() {
+  static std::shared_ptr<Statistics> stats = CreateDBStatistics();
+  return stats;
+}
+
+static void StatisticsRecordTick(benchmark::State& state) {
+  std::shared_ptr<Statistics> stats = GetStatistics();
+  for (auto _ : state) {
+    RecordTick(stats.get(), BLOCK_CACHE_HIT);
+  }
+}
+
+BENCHMARK(StatisticsRecordTick)->Threads(1);
+BENCHMARK(StatisticsRecordTick)->Threads(8);
+BENCHMARK(StatisticsRecordTick)->Threads(32);
+
+static void StatisticsRecordInHistogram(benchmark::State& state) {
+  std::shared_ptr<Statistics> stats = GetStatistics();
+  uint64_t value = 1 + state.thread_index();
+  for (auto _ : state) {
+    RecordInHistogram(stats.get(), DB_GET, value);
+    value = (value * 7) % 100000;
+  }
+}
+
+BENCHMARK(StatisticsRecordInHistogram)->Threads(1);
+BENCHMARK(StatisticsRecordInHistogram)->Threads(8);
+BENCHMARK(StatisticsRecordInHistogram)->Threads(32);
+
+static void StatisticsGetTickerMap(benchmark::State& state) {
+  std::shared_ptr<Statistics> stats = GetStatistics();
+  std::map<std::string, uint64_t> ticker_map;
+  for (auto _ : state) {
+    stats->getTickerMap(&ticker_map);
+    benchmark::DoNotOptimize(ticker_map);
+  }
+}
+
+BENCHMARK(StatisticsGetTickerMap);
+
+static void StatisticsHistogramData(benchmark::State& state) {
+  std::shared_ptr<Statistics> stats = GetStatistics();
+  HistogramData data;
+  for (auto _ : state) {
+    stats->histogramData(DB_GET, &data);
+    benchmark::DoNotOptimize(data);
+  }
+}
+
+BENCHMARK(StatisticsHistogramData);
+
+static void StatisticsToString(benchmark::State& state) {
+  std::shared_ptr<Statistics> stats = GetStatistics();
+  for (auto _ : state) {
+    std::string str = stats->ToString();
+    benchmark::DoNotOptimize(str);
+  }
+}
+
+BENCHMARK(StatisticsToString);
+
+}  // namespace rocksdb
+
+BENCHMARK_MAIN();
@@ -0,0 +1,83 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+// Measures the latency of scheduling empty jobs on a thread pool at high job
+// rates, from the submission of a job to the start of its execution, with
+// and without work stealing.
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "monitoring/histogram.h"
+#include "port/port.h"
+#include "rocksdb/system_clock.h"
+#include "util/threadpool_imp.h"
+
+namespace rocksdb {
+
+static void ThreadPoolSchedule(benchmark::State& state) {
+  bool work_stealing = state.range(0);
+  int num_threads = static_cast<int>(state.range(1));
+  int num_submitters = static_cast<int>(state.range(2));
+  const int kJobsPerSubmitter = 10000;
+  const int total_jobs = num_submitters * kJobsPerSubmitter;
+
+  ThreadPoolImpl pool;
+  pool.SetBackgroundThreads(num_threads);
+  pool.SetWorkStealing(work_stealing);
+  SystemClock* clock = SystemClock::Default().get();
+  HistogramImpl latency;
+  std::atomic<int> done(0);
+
+  for (auto _ : state) {
+    done.store(0);
+    std::vector<port::Thread> submitters;
+    for (int s = 0; s < num_submitters; ++s) {
+      submitters.emplace_back([&]() {
+        for (int i = 0; i < kJobsPerSubmitter; ++i) {
+          uint64_t start = clock->NowNanos();
+          pool.SubmitJob([&, start]() {
+            latency.Add(clock->NowNanos() - start);
+            done.fetch_add(1, std::memory_order_release);
+          });
+        }
+      });
+    }
+    for (auto& t : submitters) {
+      t.join();
+    }
+    while (done.load(std::memory_order_acquire) < total_jobs) {
+      std::this_thread::yield();
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * total_jobs);
+  HistogramData latency_data;
+  latency.Data(&latency_data);
+  state.counters["latency_mean_ns"] = latency_data.average;
+  state.counters["latency_p50_ns"] = latency_data.median;
+  state.counters["latency_p99_ns"] = latency_data.percentile99;
+  pool.JoinAllThreads();
+}
+
+static void ThreadPoolScheduleArguments(benchmark::internal::Benchmark* b) {
+  for (int work_stealing : {0, 1}) {
+    for (int num_threads : {4, 16}) {
+      for (int num_submitters : {1, 8}) {
+        b->Args({work_stealing, num_threads, num_submitters});
+      }
+    }
+  }
+  b->ArgNames({"work_stealing", "num_threads", "num_submitters"});
+}
+
+BENCHMARK(ThreadPoolSchedule)
+    ->Apply(ThreadPoolScheduleArguments)
+    ->UseRealTime();
+
+}  // namespace rocksdb
+
+BENCHMARK_MAIN();
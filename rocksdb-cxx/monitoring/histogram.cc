@@ -125,6 +125,25 @@ void HistogramStat::Merge(const HistogramStat& other) {
   }
 }
 
+void HistogramStat::MergeUnshared(const HistogramStat& other) {
+  uint64_t other_min = other.min();
+  if (other_min < min()) {
+    min_.store(other_min, std::memory_order_relaxed);
+  }
+  uint64_t other_max = other.max();
+  if (other_max > max()) {
+    max_.store(other_max, std::memory_order_relaxed);
+  }
+  num_.store(num() + other.num(), std::memory_order_relaxed);
+  sum_.store(sum() + other.sum(), std::memory_order_relaxed);
+  sum_squares_.store(sum_squares() + other.sum_squares(),
+                     std::memory_order_relaxed);
+  for (unsigned int b = 0; b < num_buckets_; b++) {
+    buckets_[b].store(bucket_at(b) + other.bucket_at(b),
+                      std::memory_order_relaxed);
+  }
+}
+
 double HistogramStat::Median() const { return Percentile(50.0); }
 
 double HistogramStat::Percentile(double p) const {
@@ -54,6 +54,9 @@ struct HistogramStat {
   bool Empty() const;
   void Add(uint64_t value);
   void Merge(const HistogramStat& other);
+  // Same as Merge(), for a histogram that no other thread updates, such as
+  // one that aggregates others. Avoids atomic read-modify-write operations.
+  void MergeUnshared(const HistogramStat& other);
 
   inline uint64_t min() const { return min_.load(std::memory_order_relaxed); }
   inline uint64_t max() const { return max_.load(std::memory_order_relaxed); }
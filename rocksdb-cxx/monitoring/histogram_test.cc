@@ -118,6 +118,34 @@ TEST_F(HistogramTest, MergeHistogram) {
   MergeHistogram(histogramWindowing, otherWindowing);
 }
 
+TEST_F(HistogramTest, MergeUnshared) {
+  HistogramStat merged;
+  HistogramStat first;
+  HistogramStat second;
+  for (uint64_t i = 1; i <= 100; i++) {
+    first.Add(i);
+  }
+  for (uint64_t i = 101; i <= 250; i++) {
+    second.Add(i);
+  }
+  merged.MergeUnshared(first);
+  merged.MergeUnshared(second);
+
+  HistogramImpl expected;
+  PopulateHistogram(expected, 1, 250);
+  HistogramData expected_data;
+  expected.Data(&expected_data);
+  HistogramData data;
+  merged.Data(&data);
+  ASSERT_EQ(merged.min(), 1);
+  ASSERT_EQ(merged.max(), 250);
+  ASSERT_EQ(data.count, expected_data.count);
+  ASSERT_EQ(data.sum, expected_data.sum);
+  ASSERT_EQ(data.median, expected_data.median);
+  ASSERT_EQ(data.percentile99, expected_data.percentile99);
+  ASSERT_EQ(data.standard_deviation, expected_data.standard_deviation);
+}
+
 TEST_F(HistogramTest, EmptyHistogram) {
   HistogramImpl histogram;
   EmptyHistogram(histogram);
@@ -75,6 +75,7 @@ struct PerfContextByLevelInt {
   defCmd(blob_cache_hit_count)                     \
   defCmd(blob_read_count)                          \
   defCmd(blob_read_byte)                           \
+  defCmd(blob_read_useful_byte)                    \
   defCmd(blob_read_time)                           \
   defCmd(blob_checksum_time)                       \
   defCmd(blob_decompress_time)                     \
@@ -257,6 +257,15 @@ const std::vector<std::pair<Tickers, std::string>> TickersNameMap = {
      "rocksdb.number.block_compression_rejected"},
     {BYTES_DECOMPRESSED_FROM, "rocksdb.bytes.decompressed.from"},
     {BYTES_DECOMPRESSED_TO, "rocksdb.bytes.decompressed.to"},
+    {BYTES_COMPRESSION_SKIPPED_BY_SAMPLING,
+     "rocksdb.bytes.compression.skipped.by.sampling"},
+    {GET_SPECULATIVE_FILE_LOOKUPS, "rocksdb.get.speculative.file.lookups"},
+    {GET_SPECULATIVE_FILE_LOOKUPS_CANCELLED,
+     "rocksdb.get.speculative.file.lookups.cancelled"},
+    {HOT_KEY_CACHE_HIT, "rocksdb.hot.key.cache.hit"},
+    {HOT_KEY_CACHE_MISS, "rocksdb.hot.key.cache.miss"},
+    {HOT_KEY_CACHE_ADMISSION_REJECTED,
+     "rocksdb.hot.key.cache.admission.rejected"},
 };
 
 const std::vector<std::pair<Histograms, std::string>> HistogramsNameMap = {
@@ -318,6 +327,7 @@ const std::vector<std::pair<Histograms, std::string>> HistogramsNameMap = {
     {ASYNC_PREFETCH_ABORT_MICROS, "rocksdb.async.prefetch.abort.micros"},
     {TABLE_OPEN_PREFETCH_TAIL_READ_BYTES,
      "rocksdb.table.open.prefetch.tail.read.bytes"},
+    {LOG_AND_APPLY_MICROS, "rocksdb.log.and.apply.micros"},
 };
 
 std::shared_ptr<Statistics> CreateDBStatistics() {
@@ -384,26 +394,39 @@ uint64_t StatisticsImpl::getTickerCountLocked(uint32_t tickerType) const {
   return res;
 }
 
+void StatisticsImpl::getAllTickerCountsLocked(uint64_t* counts) const {
+  std::fill(counts, counts + TICKER_ENUM_MAX, 0);
+  for (size_t core_idx = 0; core_idx < per_core_stats_.Size(); ++core_idx) {
+    const StatisticsData* core_stats = per_core_stats_.AccessAtCore(core_idx);
+    for (uint32_t t = 0; t < TICKER_ENUM_MAX; ++t) {
+      counts[t] += core_stats->tickers_[t].load(std::memory_order_relaxed);
+    }
+  }
+}
+
 void StatisticsImpl::histogramData(uint32_t histogramType,
                                    HistogramData* const data) const {
   MutexLock lock(&aggregate_lock_);
-  getHistogramImplLocked(histogramType)->Data(data);
+  HistogramStat stat;
+  getHistogramStatLocked(histogramType, &stat);
+  stat.Data(data);
 }
 
-std::unique_ptr<HistogramImpl> StatisticsImpl::getHistogramImplLocked(
-    uint32_t histogramType) const {
+void StatisticsImpl::getHistogramStatLocked(uint32_t histogramType,
+                                            HistogramStat* res) const {
   assert(histogramType < HISTOGRAM_ENUM_MAX);
-  std::unique_ptr<HistogramImpl> res_hist(new HistogramImpl());
+  assert(res->Empty());
   for (size_t core_idx = 0; core_idx < per_core_stats_.Size(); ++core_idx) {
-    res_hist->Merge(
+    res->MergeUnshared(
         per_core_stats_.AccessAtCore(core_idx)->histograms_[histogramType]);
   }
-  return res_hist;
 }
 
 std::string StatisticsImpl::getHistogramString(uint32_t histogramType) const {
   MutexLock lock(&aggregate_lock_);
-  return getHistogramImplLocked(histogramType)->ToString();
+  HistogramStat stat;
+  getHistogramStatLocked(histogramType, &stat);
+  return stat.ToString();
 }
 
 void StatisticsImpl::setTickerCount(uint32_t tickerType, uint64_t count) {
@@ -494,18 +517,22 @@ std::string StatisticsImpl::ToString() const {
   MutexLock lock(&aggregate_lock_);
   std::string res;
   res.reserve(20000);
+  std::vector<uint64_t> ticker_counts(TICKER_ENUM_MAX);
+  getAllTickerCountsLocked(ticker_counts.data());
   for (const auto& t : TickersNameMap) {
     assert(t.first < TICKER_ENUM_MAX);
     char buffer[kTmpStrBufferSize];
     snprintf(buffer, kTmpStrBufferSize, "%s COUNT : %" PRIu64 "\n",
-             t.second.c_str(), getTickerCountLocked(t.first));
+             t.second.c_str(), ticker_counts[t.first]);
     res.append(buffer);
   }
   for (const auto& h : HistogramsNameMap) {
     assert(h.first < HISTOGRAM_ENUM_MAX);
     char buffer[kTmpStrBufferSize];
     HistogramData hData;
-    getHistogramImplLocked(h.first)->Data(&hData);
+    HistogramStat stat;
+    getHistogramStatLocked(h.first, &stat);
+    stat.Data(&hData);
     // don't handle failures - buffer should always be big enough and arguments
     // should be provided correctly
     int ret =
@@ -529,10 +556,14 @@ bool StatisticsImpl::getTickerMap(
   assert(stats_map);
   if (!stats_map) return false;
   stats_map->clear();
-  MutexLock lock(&aggregate_lock_);
+  std::vector<uint64_t> ticker_counts(TICKER_ENUM_MAX);
+  {
+    MutexLock lock(&aggregate_lock_);
+    getAllTickerCountsLocked(ticker_counts.data());
+  }
   for (const auto& t : TickersNameMap) {
     assert(t.first < TICKER_ENUM_MAX);
-    (*stats_map)[t.second.c_str()] = getTickerCountLocked(t.first);
+    (*stats_map)[t.second.c_str()] = ticker_counts[t.first];
   }
   return true;
 }
@@ -158,6 +158,16 @@ static std::unordered_map<std::string, OptionTypeInfo>
           rocksdb_rs::utilities::options_type::OptionType::kInt,
           rocksdb_rs::utilities::options_type::OptionVerificationType::kNormal,
           rocksdb_rs::utilities::options_type::OptionTypeFlags::kMutable}},
+        {"adaptive_sample_window",
+         {offsetof(struct CompressionOptions, adaptive_sample_window),
+          rocksdb_rs::utilities::options_type::OptionType::kUInt32T,
+          rocksdb_rs::utilities::options_type::OptionVerificationType::kNormal,
+          rocksdb_rs::utilities::options_type::OptionTypeFlags::kMutable}},
+        {"adaptive_min_savings_per_kb",
+         {offsetof(struct CompressionOptions, adaptive_min_savings_per_kb),
+          rocksdb_rs::utilities::options_type::OptionType::kInt,
+          rocksdb_rs::utilities::options_type::OptionVerificationType::kNormal,
+          rocksdb_rs::utilities::options_type::OptionTypeFlags::kMutable}},
         {"max_dict_bytes",
          {offsetof(struct CompressionOptions, max_dict_bytes),
           rocksdb_rs::utilities::options_type::OptionType::kInt,
@@ -623,6 +633,11 @@ static std::unordered_map<std::string, OptionTypeInfo>
           rocksdb_rs::utilities::options_type::OptionType::kUInt32T,
           rocksdb_rs::utilities::options_type::OptionVerificationType::kNormal,
           rocksdb_rs::utilities::options_type::OptionTypeFlags::kMutable}},
+        {"memtable_max_range_deletions",
+         {offsetof(struct MutableCFOptions, memtable_max_range_deletions),
+          rocksdb_rs::utilities::options_type::OptionType::kUInt32T,
+          rocksdb_rs::utilities::options_type::OptionVerificationType::kNormal,
+          rocksdb_rs::utilities::options_type::OptionTypeFlags::kMutable}},
         {"block_protection_bytes_per_key",
          {offsetof(struct MutableCFOptions, block_protection_bytes_per_key),
           rocksdb_rs::utilities::options_type::OptionType::kUInt8T,
@@ -987,6 +1002,11 @@ static std::unordered_map<std::string, OptionTypeInfo>
             auto* cache = static_cast<std::shared_ptr<Cache>*>(addr);
             return Cache::CreateFromString(opts, value, cache);
           }}},
+        {"blob_multiget_coalesce_gap",
+         {offsetof(struct ImmutableCFOptions, blob_multiget_coalesce_gap),
+          rocksdb_rs::utilities::options_type::OptionType::kUInt64T,
+          rocksdb_rs::utilities::options_type::OptionVerificationType::kNormal,
+          rocksdb_rs::utilities::options_type::OptionTypeFlags::kNone}},
         {"persist_user_defined_timestamps",
          {offsetof(struct ImmutableCFOptions, persist_user_defined_timestamps),
           rocksdb_rs::utilities::options_type::OptionType::kBoolean,
@@ -1137,6 +1157,7 @@ ImmutableCFOptions::ImmutableCFOptions(const ColumnFamilyOptions& cf_options)
       compaction_thread_limiter(cf_options.compaction_thread_limiter),
       sst_partitioner_factory(cf_options.sst_partitioner_factory),
       blob_cache(cf_options.blob_cache),
+      blob_multiget_coalesce_gap(cf_options.blob_multiget_coalesce_gap),
       persist_user_defined_timestamps(
           cf_options.persist_user_defined_timestamps) {}
 
@@ -1240,6 +1261,8 @@ void MutableCFOptions::Dump(Logger* log) const {
   ROCKS_LOG_INFO(log,
                  "                 inplace_update_num_locks: %" ROCKSDB_PRIszt,
                  inplace_update_num_locks);
+  ROCKS_LOG_INFO(log, "             memtable_max_range_deletions: %" PRIu32,
+                 memtable_max_range_deletions);
   ROCKS_LOG_INFO(log, "                         prefix_extractor: %s",
                  prefix_extractor == nullptr
                      ? "nullptr"
@@ -87,6 +87,8 @@ struct ImmutableCFOptions {
 
   std::shared_ptr<Cache> blob_cache;
 
+  uint64_t blob_multiget_coalesce_gap;
+
   bool persist_user_defined_timestamps;
 };
 
@@ -172,6 +174,7 @@ struct MutableCFOptions {
                                    : options.last_level_temperature),
         memtable_protection_bytes_per_key(
             options.memtable_protection_bytes_per_key),
+        memtable_max_range_deletions(options.memtable_max_range_deletions),
         block_protection_bytes_per_key(options.block_protection_bytes_per_key),
         sample_for_compression(
             options.sample_for_compression),  // TODO: is 0 fine here?
@@ -228,6 +231,7 @@ struct MutableCFOptions {
                                    kDisableCompressionOption),
         last_level_temperature(Temperature::kUnknown),
         memtable_protection_bytes_per_key(0),
+        memtable_max_range_deletions(0),
         block_protection_bytes_per_key(0),
         sample_for_compression(0) {}
 
@@ -319,6 +323,7 @@ struct MutableCFOptions {
   CompressionOptions bottommost_compression_opts;
   Temperature last_level_temperature;
   uint32_t memtable_protection_bytes_per_key;
+  uint32_t memtable_max_range_deletions;
   uint8_t block_protection_bytes_per_key;
 
   uint64_t sample_for_compression;
@@ -110,6 +110,8 @@ AdvancedColumnFamilyOptions::AdvancedColumnFamilyOptions(const Options& options)
       blob_file_starting_level(options.blob_file_starting_level),
       blob_cache(options.blob_cache),
       prepopulate_blob_cache(options.prepopulate_blob_cache),
+      blob_multiget_coalesce_gap(options.blob_multiget_coalesce_gap),
+      memtable_max_range_deletions(options.memtable_max_range_deletions),
       persist_user_defined_timestamps(options.persist_user_defined_timestamps) {
   assert(memtable_factory.get() != nullptr);
   if (max_bytes_for_level_multiplier_additional.size() <
@@ -261,6 +263,13 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
                    "        Options.compression_opts.max_dict_buffer_bytes: "
                    "%" PRIu64,
                    compression_opts.max_dict_buffer_bytes);
+  ROCKS_LOG_HEADER(log,
+                   "        Options.compression_opts.adaptive_sample_window: "
+                   "%" PRIu32,
+                   compression_opts.adaptive_sample_window);
+  ROCKS_LOG_HEADER(
+      log, "   Options.compression_opts.adaptive_min_savings_per_kb: %d",
+      compression_opts.adaptive_min_savings_per_kb);
   ROCKS_LOG_HEADER(log, "     Options.level0_file_num_compaction_trigger: %d",
                    level0_file_num_compaction_trigger);
   ROCKS_LOG_HEADER(log, "         Options.level0_slowdown_writes_trigger: %d",
@@ -437,8 +446,13 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
                          ? "flush only"
                          : "disabled");
   }
+  ROCKS_LOG_HEADER(log,
+                   "             Options.blob_multiget_coalesce_gap: %" PRIu64,
+                   blob_multiget_coalesce_gap);
   ROCKS_LOG_HEADER(log, "Options.experimental_mempurge_threshold: %f",
                    experimental_mempurge_threshold);
+  ROCKS_LOG_HEADER(log, "Options.memtable_max_range_deletions: %" PRIu32,
+                   memtable_max_range_deletions);
 }  // ColumnFamilyOptions::Dump
 
 void Options::Dump(Logger* log) const {
@@ -1251,6 +1251,11 @@ TEST_F(OptionsTest, GetMemTableRepFactoryFromString) {
   ASSERT_NOK(GetMemTableRepFactoryFromString("vector:1024:invalid_opt",
                                              &new_mem_factory));
 
+  ASSERT_OK(GetMemTableRepFactoryFromString("btree", &new_mem_factory));
+  ASSERT_STREQ(new_mem_factory->Name(), "BTreeRepFactory");
+  ASSERT_NOK(GetMemTableRepFactoryFromString("btree:invalid_opt",
+                                             &new_mem_factory));
+
   ASSERT_NOK(GetMemTableRepFactoryFromString("cuckoo", &new_mem_factory));
   // CuckooHash memtable is already removed.
   ASSERT_NOK(GetMemTableRepFactoryFromString("cuckoo:1024", &new_mem_factory));
@@ -1339,6 +1344,11 @@ TEST_F(OptionsTest, MemTableRepFactoryCreateFromString) {
       config_options, "id=vector; count=42", &new_mem_factory));
   ASSERT_NOK(MemTableRepFactory::CreateFromString(
       config_options, "id=vector; invalid=unknown", &new_mem_factory));
+  ASSERT_OK(MemTableRepFactory::CreateFromString(config_options, "btree",
+                                                 &new_mem_factory));
+  ASSERT_STREQ(new_mem_factory->Name(), "BTreeRepFactory");
+  ASSERT_TRUE(new_mem_factory->IsInstanceOf("btree"));
+  ASSERT_TRUE(new_mem_factory->IsInstanceOf("BTreeRepFactory"));
   ASSERT_NOK(MemTableRepFactory::CreateFromString(config_options, "cuckoo",
                                                   &new_mem_factory));
   // CuckooHash memtable is already removed.
@@ -5,6 +5,12 @@
 
 #include "port/mmap.h"
 
+#ifndef OS_WIN
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif  // !OS_WIN
+
 #include <cassert>
 #include <cstdio>
 #include <cstring>
@@ -31,6 +37,10 @@ MemMapping::~MemMapping() {
       // TODO: handle error?
     }
   }
+  if (fd_ >= 0) {
+    // Also releases the lock
+    close(fd_);
+  }
 #endif  // OS_WIN
 }
 
@@ -95,4 +105,36 @@ MemMapping MemMapping::AllocateLazyZeroed(size_t length) {
   return AllocateAnonymous(length, /*huge*/ false);
 }
 
+MemMapping MemMapping::MapSharedFile(const std::string& fname,
+                                     size_t length) {
+  MemMapping mm;
+  assert(mm.addr_ == nullptr);
+  if (length == 0) {
+    return mm;
+  }
+#ifdef OS_WIN
+  // Not supported
+  (void)fname;
+#else   // OS_WIN -> !OS_WIN
+  int fd = open(fname.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    return mm;
+  }
+  // Locked before resizing, which would break the mapping of another holder
+  if (flock(fd, LOCK_EX | LOCK_NB) == 0 &&
+      ftruncate(fd, static_cast<off_t>(length)) == 0) {
+    void* addr =
+        mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr != MAP_FAILED) {
+      mm.addr_ = addr;
+      mm.length_ = length;
+      mm.fd_ = fd;
+      return mm;
+    }
+  }
+  close(fd);
+#endif  // OS_WIN
+  return mm;
+}
+
 }  // namespace rocksdb
@@ -14,6 +14,7 @@
 #endif  // OS_WIN
 
 #include <cstdint>
+#include <string>
 
 namespace rocksdb {
 
@@ -37,6 +38,15 @@ class MemMapping {
   // back the full mapping.
   static MemMapping AllocateLazyZeroed(size_t length);
 
+  // Map the first `length` bytes of file `fname`, creating the file or
+  // resizing it to `length` as needed. Writes to the memory are shared with
+  // every other mapping of the file and reach the file itself. The file is
+  // locked with flock(LOCK_EX) for as long as it is mapped, so mapping a file
+  // already mapped this way, by this process or another one, fails. On
+  // failure Get() returns nullptr. Not supported on Windows, where it always
+  // fails.
+  static MemMapping MapSharedFile(const std::string& fname, size_t length);
+
   // No copies
   MemMapping(const MemMapping&) = delete;
   MemMapping& operator=(const MemMapping&) = delete;
@@ -60,6 +70,9 @@ class MemMapping {
 
 #ifdef OS_WIN
   HANDLE page_file_handle_ = NULL;
+#else   // OS_WIN -> !OS_WIN
+  // The locked file of MapSharedFile()
+  int fd_ = -1;
 #endif  // OS_WIN
 
   static MemMapping AllocateAnonymous(size_t length, bool huge);
@@ -22,6 +22,7 @@
 #include "rocksdb/comparator.h"
 #include "table/block_based/block_prefix_index.h"
 #include "table/block_based/data_block_footer.h"
+#include "table/block_based/data_block_key_prefix.h"
 #include "table/format.h"
 #include "util/coding.h"
 
@@ -302,7 +303,9 @@ void DataBlockIter::SeekImpl(const Slice& target) {
   }
   uint32_t index = 0;
   bool skip_linear_scan = false;
-  bool ok = BinarySeek<DecodeKey>(seek_key, &index, &skip_linear_scan);
+  bool ok = key_prefixes_ != nullptr
+                ? BinarySeekWithKeyPrefixes(seek_key, &index, &skip_linear_scan)
+                : BinarySeek<DecodeKey>(seek_key, &index, &skip_linear_scan);
 
   if (!ok) {
     return;
@@ -310,6 +313,21 @@ void DataBlockIter::SeekImpl(const Slice& target) {
   FindKeyAfterBinarySeek(seek_key, index, skip_linear_scan);
 }
 
+bool DataBlockIter::BinarySeekWithKeyPrefixes(const Slice& target,
+                                              uint32_t* index,
+                                              bool* skip_linear_scan) {
+  // Restart keys with a smaller prefix are smaller than `target` and those
+  // with a larger prefix are larger, so only restart keys sharing the prefix
+  // of `target` need to be compared.
+  uint32_t num_lt = 0, num_le = 0;
+  CountDataBlockKeyPrefixes(key_prefixes_, num_restarts_,
+                            DataBlockKeyPrefix(ExtractUserKey(target)),
+                            &num_lt, &num_le);
+  return BinarySeek<DecodeKey>(target, static_cast<int64_t>(num_lt) - 1,
+                               static_cast<int64_t>(num_le) - 1, index,
+                               skip_linear_scan);
+}
+
 void MetaBlockIter::SeekImpl(const Slice& target) {
   Slice seek_key = target;
   PERF_TIMER_GUARD(block_seek_nanos);
@@ -353,6 +371,10 @@ void MetaBlockIter::SeekImpl(const Slice& target) {
 bool DataBlockIter::SeekForGetImpl(const Slice& target) {
   Slice target_user_key = ExtractUserKey(target);
   uint32_t map_offset = restarts_ + num_restarts_ * sizeof(uint32_t);
+  if (key_prefixes_ != nullptr) {
+    // The hash index follows the key prefix array
+    map_offset += num_restarts_ * sizeof(uint64_t);
+  }
   uint8_t entry =
       data_block_hash_index_->Lookup(data_, map_offset, target_user_key);
 
@@ -455,6 +477,37 @@ bool DataBlockIter::SeekForGetImpl(const Slice& target) {
   return true;
 }
 
+template <typename DecodeKeyFunc>
+bool IndexBlockIter::InterpolationSeek(const Slice& target,
+                                       const Slice& seek_key, uint32_t* index,
+                                       bool* skip_linear_scan) {
+  assert(interpolation_index_ != nullptr);
+  if (restarts_ == 0) {
+    // Same as BinarySeek() for index blocks without keys
+    return false;
+  }
+  int64_t left = -1;
+  int64_t right = -1;
+  interpolation_index_->Predict(ExtractUserKey(target), num_restarts_, &left,
+                                &right);
+  if (left >= 0 && CompareBlockKey(static_cast<uint32_t>(left), seek_key) > 0) {
+    // Overestimated, the result is before the predicted range
+    right = left - 1;
+    left = -1;
+  } else if (right + 1 < num_restarts_ &&
+             CompareBlockKey(static_cast<uint32_t>(right + 1), seek_key) <=
+                 0) {
+    // Underestimated, the result is after the predicted range
+    left = right + 1;
+    right = num_restarts_ - 1;
+  }
+  if (!status_.ok()) {
+    return false;
+  }
+  return BinarySeek<DecodeKeyFunc>(seek_key, left, right, index,
+                                   skip_linear_scan);
+}
+
 void IndexBlockIter::SeekImpl(const Slice& target) {
 #ifndef NDEBUG
   if (TEST_Corrupt_Callback("IndexBlockIter::SeekImpl")) return;
@@ -485,6 +538,12 @@ void IndexBlockIter::SeekImpl(const Slice& target) {
     // restart interval must be one when hash search is enabled so the binary
     // search simply lands at the right place.
     skip_linear_scan = true;
+  } else if (interpolation_index_) {
+    ok = value_delta_encoded_
+             ? InterpolationSeek<DecodeKeyV4>(target, seek_key, &index,
+                                              &skip_linear_scan)
+             : InterpolationSeek<DecodeKey>(target, seek_key, &index,
+                                            &skip_linear_scan);
   } else if (value_delta_encoded_) {
     ok = BinarySeek<DecodeKeyV4>(seek_key, &index, &skip_linear_scan);
   } else {
@@ -505,7 +564,9 @@ void DataBlockIter::SeekForPrevImpl(const Slice& target) {
   }
   uint32_t index = 0;
   bool skip_linear_scan = false;
-  bool ok = BinarySeek<DecodeKey>(seek_key, &index, &skip_linear_scan);
+  bool ok = key_prefixes_ != nullptr
+                ? BinarySeekWithKeyPrefixes(seek_key, &index, &skip_linear_scan)
+                : BinarySeek<DecodeKey>(seek_key, &index, &skip_linear_scan);
 
   if (!ok) {
     return;
@@ -814,7 +875,8 @@ void BlockIter<TValue>::FindKeyAfterBinarySeek(const Slice& target,
 // compared again later.
 template <class TValue>
 template <typename DecodeKeyFunc>
-bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t* index,
+bool BlockIter<TValue>::BinarySeek(const Slice& target, int64_t left,
+                                   int64_t right, uint32_t* index,
                                    bool* skip_linear_scan) {
   if (restarts_ == 0) {
     // SST files dedicated to range tombstones are written with index blocks
@@ -833,7 +895,7 @@ bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t* index,
   //   keys.
   // - Any restart keys after index `right` are strictly greater than the target
   //   key.
-  int64_t left = -1, right = num_restarts_ - 1;
+  assert(left >= -1 && left <= right && right < num_restarts_);
   while (left != right) {
     // The `mid` is computed by rounding up so it lands in (`left`, `right`].
     int64_t mid = left + (right - left + 1) / 2;
@@ -1038,6 +1100,20 @@ BlockBasedTableOptions::DataBlockIndexType Block::IndexType() const {
   return index_type;
 }
 
+bool Block::HasKeyPrefixes() const {
+  assert(size_ >= 2 * sizeof(uint32_t));
+  if (size_ > kMaxBlockSizeSupportedByHashIndex) {
+    // The check is for the same reason as that in NumRestarts()
+    return false;
+  }
+  uint32_t block_footer =
+      rocksdb_rs::coding_lean::DecodeFixed32(data_ + size_ - sizeof(uint32_t));
+  bool has_key_prefixes = false;
+  UnPackIndexTypeAndNumRestarts(block_footer, nullptr /* index_type */,
+                                nullptr /* num_restarts */, &has_key_prefixes);
+  return has_key_prefixes;
+}
+
 Block::~Block() {
   // This sync point can be re-enabled if RocksDB can control the
   // initialization order of any/all static options created by the user.
@@ -1051,7 +1127,8 @@ Block::Block(BlockContents&& contents, size_t read_amp_bytes_per_bit,
       data_(contents_.data.data()),
       size_(contents_.data.size()),
       restart_offset_(0),
-      num_restarts_(0) {
+      num_restarts_(0),
+      key_prefix_offset_(0) {
   TEST_SYNC_POINT("Block::Block:0");
   if (size_ < sizeof(uint32_t)) {
     size_ = 0;  // Error marker
@@ -1093,6 +1170,19 @@ Block::Block(BlockContents&& contents, size_t read_amp_bytes_per_bit,
       default:
         size_ = 0;  // Error marker
     }
+    if (size_ != 0 && HasKeyPrefixes()) {
+      // The key prefix array sits between the restart array and the hash
+      // index or footer, so the restart array starts that much earlier.
+      size_t key_prefix_bytes = num_restarts_ * sizeof(uint64_t);
+      if (restart_offset_ < key_prefix_bytes) {
+        size_ = 0;
+      } else {
+        restart_offset_ -= static_cast<uint32_t>(key_prefix_bytes);
+        key_prefix_offset_ =
+            restart_offset_ +
+            static_cast<uint32_t>(num_restarts_ * sizeof(uint32_t));
+      }
+    }
   }
   if (read_amp_bytes_per_bit != 0 && statistics && size_ != 0) {
     read_amp_bitmap_.reset(new BlockReadAmpBitmap(
@@ -1269,6 +1359,7 @@ DataBlockIter* Block::NewDataIterator(const Comparator* raw_ucmp,
         read_amp_bitmap_.get(), block_contents_pinned,
         user_defined_timestamps_persisted,
         data_block_hash_index_.Valid() ? &data_block_hash_index_ : nullptr,
+        key_prefix_offset_ != 0 ? data_ + key_prefix_offset_ : nullptr,
         protection_bytes_per_key_, kv_checksum_, block_restart_interval_);
     if (read_amp_bitmap_) {
       if (read_amp_bitmap_->GetStatistics() != stats) {
@@ -1286,7 +1377,8 @@ IndexBlockIter* Block::NewIndexIterator(
     IndexBlockIter* iter, Statistics* /*stats*/, bool total_order_seek,
     bool have_first_key, bool key_includes_seq, bool value_is_full,
     bool block_contents_pinned, bool user_defined_timestamps_persisted,
-    BlockPrefixIndex* prefix_index) {
+    BlockPrefixIndex* prefix_index,
+    const BlockInterpolationIndex* interpolation_index) {
   IndexBlockIter* ret_iter;
   if (iter != nullptr) {
     ret_iter = iter;
@@ -1309,7 +1401,8 @@ IndexBlockIter* Block::NewIndexIterator(
         raw_ucmp, data_, restart_offset_, num_restarts_, global_seqno,
         prefix_index_ptr, have_first_key, key_includes_seq, value_is_full,
         block_contents_pinned, user_defined_timestamps_persisted,
-        protection_bytes_per_key_, kv_checksum_, block_restart_interval_);
+        protection_bytes_per_key_, kv_checksum_, block_restart_interval_,
+        interpolation_index);
   }
 
   return ret_iter;
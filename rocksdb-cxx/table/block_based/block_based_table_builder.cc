@@ -319,6 +319,16 @@ struct BlockBasedTableBuilder::Rep {
   std::vector<std::unique_ptr<UncompressionContext>> verify_ctxs;
   std::unique_ptr<UncompressionDict> verify_dict;
 
+  // State of CompressionOptions::adaptive_sample_window. The compression type
+  // of the current range of data blocks, and how many blocks are left in it.
+  const bool use_adaptive_compression;
+  rocksdb_rs::compression_type::CompressionType adaptive_compression_type;
+  uint32_t adaptive_blocks_left = 0;
+  // For compressing with LZ4 when it is not the configured compression type.
+  // Default options, since the configured ones are meant for the latter.
+  CompressionOptions adaptive_fast_opts;
+  std::unique_ptr<CompressionContext> adaptive_fast_ctx;
+
   size_t data_begin_offset = 0;
 
   TableProperties props;
@@ -459,7 +469,12 @@ struct BlockBasedTableBuilder::Rep {
                        ? BlockBasedTableOptions::kDataBlockBinarySearch
                        : table_options.data_block_index_type,
                    table_options.data_block_hash_table_util_ratio, ts_sz,
-                   persist_user_defined_timestamps),
+                   persist_user_defined_timestamps, false /* is_user_key */,
+                   table_options.format_version >=
+                           kRestartKeyPrefixFormatVersion &&
+                       tbo.internal_comparator.user_comparator() ==
+                           BytewiseComparator() &&
+                       ts_sz == 0 /* use_key_prefixes */),
         range_del_block(
             1 /* block_restart_interval */, true /* use_delta_encoding */,
             false /* use_value_delta_encoding */,
@@ -479,6 +494,12 @@ struct BlockBasedTableBuilder::Rep {
         compression_ctxs(tbo.compression_opts.parallel_threads),
         verify_ctxs(tbo.compression_opts.parallel_threads),
         verify_dict(),
+        use_adaptive_compression(
+            tbo.compression_opts.adaptive_sample_window > 0 &&
+            tbo.compression_opts.parallel_threads <= 1 &&
+            compression_type !=
+                rocksdb_rs::compression_type::CompressionType::kNoCompression),
+        adaptive_compression_type(compression_type),
         state((tbo.compression_opts.max_dict_bytes > 0) ? State::kBuffered
                                                         : State::kUnbuffered),
         use_delta_encoding_for_index_values(table_opt.format_version >= 4 &&
@@ -534,6 +555,12 @@ struct BlockBasedTableBuilder::Rep {
     for (uint32_t i = 0; i < compression_opts.parallel_threads; i++) {
       compression_ctxs[i].reset(new CompressionContext(compression_type));
     }
+    if (use_adaptive_compression && LZ4_Supported() &&
+        compression_type !=
+            rocksdb_rs::compression_type::CompressionType::kLZ4Compression) {
+      adaptive_fast_ctx.reset(new CompressionContext(
+          rocksdb_rs::compression_type::CompressionType::kLZ4Compression));
+    }
     if (table_options.index_type ==
         BlockBasedTableOptions::kTwoLevelIndexSearch) {
       p_index_builder_ = PartitionedIndexBuilder::CreateIndexBuilder(
@@ -1196,9 +1223,40 @@ void BlockBasedTableBuilder::CompressAndVerifyBlock(
       compression_dict = r->compression_dict.get();
     }
     assert(compression_dict != nullptr);
-    CompressionInfo compression_info(r->compression_opts, compression_ctx,
-                                     *compression_dict, r->compression_type,
-                                     r->sample_for_compression);
+
+    rocksdb_rs::compression_type::CompressionType compression_type =
+        r->compression_type;
+    if (is_data_block && r->use_adaptive_compression) {
+      assert(!r->IsParallelCompressionEnabled());
+      if (r->adaptive_blocks_left == 0) {
+        r->adaptive_compression_type = SampleAdaptiveCompressionType(
+            uncompressed_block_data,
+            CompressionInfo(r->compression_opts, compression_ctx,
+                            *compression_dict, r->compression_type,
+                            r->sample_for_compression));
+        r->adaptive_blocks_left = r->compression_opts.adaptive_sample_window;
+      }
+      --r->adaptive_blocks_left;
+      compression_type = r->adaptive_compression_type;
+      if (compression_type ==
+          rocksdb_rs::compression_type::CompressionType::kNoCompression) {
+        ++r->props.num_adaptive_uncompressed_data_blocks;
+        RecordTick(r->ioptions.stats, BYTES_COMPRESSION_SKIPPED_BY_SAMPLING,
+                   uncompressed_block_data.size());
+      } else if (compression_type != r->compression_type) {
+        ++r->props.num_adaptive_fast_data_blocks;
+      }
+    }
+    // Blocks compressed with a type chosen over the configured one do not use
+    // the dictionary, which is only meant for the latter.
+    const bool use_fast_compression = compression_type != r->compression_type &&
+                                      r->adaptive_fast_ctx != nullptr;
+    CompressionInfo compression_info(
+        use_fast_compression ? r->adaptive_fast_opts : r->compression_opts,
+        use_fast_compression ? *r->adaptive_fast_ctx : compression_ctx,
+        use_fast_compression ? CompressionDict::GetEmptyDict()
+                             : *compression_dict,
+        compression_type, r->sample_for_compression);
 
     std::string sampled_output_fast;
     std::string sampled_output_slow;
@@ -1230,15 +1288,15 @@ void BlockBasedTableBuilder::CompressAndVerifyBlock(
         r->table_options.verify_compression) {
       // Retrieve the uncompressed contents into a new buffer
       const UncompressionDict* verify_dict;
-      if (!is_data_block || r->verify_dict == nullptr) {
+      if (!is_data_block || r->verify_dict == nullptr ||
+          *type != r->compression_type) {
         verify_dict = &UncompressionDict::GetEmptyDict();
       } else {
         verify_dict = r->verify_dict.get();
       }
       assert(verify_dict != nullptr);
       BlockContents contents;
-      UncompressionInfo uncompression_info(*verify_ctx, *verify_dict,
-                                           r->compression_type);
+      UncompressionInfo uncompression_info(*verify_ctx, *verify_dict, *type);
       rocksdb_rs::status::Status uncompress_status = UncompressBlockData(
           uncompression_info, block_contents->data(), block_contents->size(),
           &contents, r->table_options.format_version, r->ioptions);
@@ -1299,6 +1357,63 @@ void BlockBasedTableBuilder::CompressAndVerifyBlock(
   }
 }
 
+rocksdb_rs::compression_type::CompressionType
+BlockBasedTableBuilder::SampleAdaptiveCompressionType(
+    const Slice& uncompressed_block_data, const CompressionInfo& info) {
+  Rep* r = rep_;
+  const uint32_t compress_format_version =
+      GetCompressFormatForVersion(r->table_options.format_version);
+  const int max_compressed_bytes_per_kb =
+      r->compression_opts.max_compressed_bytes_per_kb;
+  if (max_compressed_bytes_per_kb <= 0) {
+    return rocksdb_rs::compression_type::CompressionType::kNoCompression;
+  }
+
+  // A candidate is only considered when its output would be kept by
+  // CompressBlock()
+  std::string output;
+  const bool slow_ok =
+      CompressData(uncompressed_block_data, info, compress_format_version,
+                   &output) &&
+      GoodCompressionRatio(output.size(), uncompressed_block_data.size(),
+                           max_compressed_bytes_per_kb);
+  const size_t slow_size = output.size();
+
+  bool fast_ok = false;
+  size_t fast_size = 0;
+  if (r->adaptive_fast_ctx != nullptr) {
+    output.clear();
+    CompressionInfo fast_info(
+        r->adaptive_fast_opts, *r->adaptive_fast_ctx,
+        CompressionDict::GetEmptyDict(),
+        rocksdb_rs::compression_type::CompressionType::kLZ4Compression,
+        r->sample_for_compression);
+    fast_ok = CompressData(uncompressed_block_data, fast_info,
+                           compress_format_version, &output) &&
+              GoodCompressionRatio(output.size(),
+                                   uncompressed_block_data.size(),
+                                   max_compressed_bytes_per_kb);
+    fast_size = output.size();
+  }
+
+  if (!fast_ok) {
+    return slow_ok
+               ? r->compression_type
+               : rocksdb_rs::compression_type::CompressionType::kNoCompression;
+  }
+  // The configured compression type has to save enough over LZ4 to be worth
+  // its extra CPU
+  const uint64_t min_savings =
+      (static_cast<uint64_t>(
+           std::max(r->compression_opts.adaptive_min_savings_per_kb, 0)) *
+       uncompressed_block_data.size()) >>
+      10;
+  if (slow_ok && slow_size + min_savings <= fast_size) {
+    return r->compression_type;
+  }
+  return rocksdb_rs::compression_type::CompressionType::kLZ4Compression;
+}
+
 void BlockBasedTableBuilder::WriteMaybeCompressedBlock(
     const Slice& block_contents,
     rocksdb_rs::compression_type::CompressionType comp_type,
@@ -191,6 +191,12 @@ class BlockBasedTableBuilder : public TableBuilder {
       rocksdb_rs::compression_type::CompressionType* result_compression_type,
       rocksdb_rs::status::Status* out_status);
 
+  // For CompressionOptions::adaptive_sample_window, compress a data block
+  // with the configured compression type (per `info`) and with LZ4 to choose
+  // the compression type of the range of data blocks it starts.
+  rocksdb_rs::compression_type::CompressionType SampleAdaptiveCompressionType(
+      const Slice& uncompressed_block_data, const CompressionInfo& info);
+
   // Get compressed blocks from BGWorkCompression and write them into SST
   void BGWorkWriteMaybeCompressedBlock();
 
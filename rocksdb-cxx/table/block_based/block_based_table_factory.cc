@@ -179,7 +179,9 @@ static std::unordered_map<std::string, BlockBasedTableOptions::IndexType>
         {"kTwoLevelIndexSearch",
          BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch},
         {"kBinarySearchWithFirstKey",
-         BlockBasedTableOptions::IndexType::kBinarySearchWithFirstKey}};
+         BlockBasedTableOptions::IndexType::kBinarySearchWithFirstKey},
+        {"kInterpolationSearch",
+         BlockBasedTableOptions::IndexType::kInterpolationSearch}};
 
 static std::unordered_map<std::string,
                           BlockBasedTableOptions::DataBlockIndexType>
@@ -651,6 +653,12 @@ rocksdb_rs::status::Status BlockBasedTableFactory::ValidateOptions(
         "Enable pin_l0_filter_and_index_blocks_in_cache, "
         ", but block cache is disabled");
   }
+  if (IsUpstreamOnlyFormatVersion(table_options_.format_version)) {
+    return rocksdb_rs::status::Status_InvalidArgument(
+        "format_version " + std::to_string(table_options_.format_version) +
+        " of upstream RocksDB is not supported. Please check "
+        "include/rocksdb/table.h for more info");
+  }
   if (!IsSupportedFormatVersion(table_options_.format_version)) {
     return rocksdb_rs::status::Status_InvalidArgument(
         "Unsupported BlockBasedTable format_version. Please check "
@@ -1007,6 +1015,7 @@ const std::string BlockBasedTablePropertyNames::kPrefixFiltering =
 const std::string kHashIndexPrefixesBlock = "rocksdb.hashindex.prefixes";
 const std::string kHashIndexPrefixesMetadataBlock =
     "rocksdb.hashindex.metadata";
+const std::string kInterpolationIndexBlock = "rocksdb.interpolation.index";
 const std::string kPropTrue = "1";
 const std::string kPropFalse = "0";
 
@@ -55,6 +55,7 @@
 #include "table/block_based/filter_policy_internal.h"
 #include "table/block_based/full_filter_block.h"
 #include "table/block_based/hash_index_reader.h"
+#include "table/block_based/interpolation_index_reader.h"
 #include "table/block_based/partitioned_filter_block.h"
 #include "table/block_based/partitioned_index_reader.h"
 #include "table/block_fetcher.h"
@@ -1989,17 +1990,23 @@ void BlockBasedTable::FullFilterKeysMayMatch(
   }
   uint64_t before_keys = range->KeysLeft();
   assert(before_keys > 0);  // Caller should ensure
+  // Counted in the statistics of the lookups, which have none when their
+  // counters must not be reported, e.g. for speculative reads
+  GetContext* get_context = range->begin()->get_context;
+  Statistics* const statistics = get_context != nullptr
+                                     ? get_context->statistics()
+                                     : rep_->ioptions.stats;
   if (rep_->whole_key_filtering) {
     filter->KeysMayMatch(range, no_io, lookup_context, read_options);
     uint64_t after_keys = range->KeysLeft();
     if (after_keys) {
-      RecordTick(rep_->ioptions.stats, BLOOM_FILTER_FULL_POSITIVE, after_keys);
+      RecordTick(statistics, BLOOM_FILTER_FULL_POSITIVE, after_keys);
       PERF_COUNTER_BY_LEVEL_ADD(bloom_filter_full_positive, after_keys,
                                 rep_->level);
     }
     uint64_t filtered_keys = before_keys - after_keys;
     if (filtered_keys) {
-      RecordTick(rep_->ioptions.stats, BLOOM_FILTER_USEFUL, filtered_keys);
+      RecordTick(statistics, BLOOM_FILTER_USEFUL, filtered_keys);
       PERF_COUNTER_BY_LEVEL_ADD(bloom_filter_useful, filtered_keys,
                                 rep_->level);
     }
@@ -2008,7 +2015,7 @@ void BlockBasedTable::FullFilterKeysMayMatch(
     // prefix_extractor at all. It should always use table_prefix_extractor.
     filter->PrefixesMayMatch(range, prefix_extractor, false, lookup_context,
                              read_options);
-    RecordTick(rep_->ioptions.stats, BLOOM_FILTER_PREFIX_CHECKED, before_keys);
+    RecordTick(statistics, BLOOM_FILTER_PREFIX_CHECKED, before_keys);
     uint64_t after_keys = range->KeysLeft();
     if (after_keys) {
       // Includes prefix stats
@@ -2017,8 +2024,7 @@ void BlockBasedTable::FullFilterKeysMayMatch(
     }
     uint64_t filtered_keys = before_keys - after_keys;
     if (filtered_keys) {
-      RecordTick(rep_->ioptions.stats, BLOOM_FILTER_PREFIX_USEFUL,
-                 filtered_keys);
+      RecordTick(statistics, BLOOM_FILTER_PREFIX_USEFUL, filtered_keys);
       // Includes prefix stats
       PERF_COUNTER_BY_LEVEL_ADD(bloom_filter_useful, filtered_keys,
                                 rep_->level);
@@ -2580,6 +2586,11 @@ rocksdb_rs::status::Status BlockBasedTable::CreateIndexReader(
                                        index_reader);
       }
     }
+    case BlockBasedTableOptions::kInterpolationSearch: {
+      return InterpolationIndexReader::Create(
+          this, ro, prefetch_buffer, meta_iter, use_cache, prefetch, pin,
+          lookup_context, index_reader);
+    }
     default: {
       std::string error_message =
           "Unrecognized index type: " + std::to_string(rep_->index_type);
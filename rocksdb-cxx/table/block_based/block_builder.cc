@@ -30,6 +30,10 @@
 //     restarts: uint32[num_restarts]
 //     num_restarts: uint32
 // restarts[i] contains the offset within the block of the ith restart point.
+//
+// Data blocks may also have a key prefix array and/or a hash index between
+// the restarts and num_restarts, flagged in the high bits of num_restarts.
+// See data_block_key_prefix.h and data_block_hash_index.h.
 
 #include "table/block_based/block_builder.h"
 
@@ -40,6 +44,7 @@
 #include "db/dbformat.h"
 #include "rocksdb/comparator.h"
 #include "table/block_based/data_block_footer.h"
+#include "table/block_based/data_block_key_prefix.h"
 #include "util/coding.h"
 
 namespace rocksdb {
@@ -49,12 +54,14 @@ BlockBuilder::BlockBuilder(
     bool use_value_delta_encoding,
     BlockBasedTableOptions::DataBlockIndexType index_type,
     double data_block_hash_table_util_ratio, size_t ts_sz,
-    bool persist_user_defined_timestamps, bool is_user_key)
+    bool persist_user_defined_timestamps, bool is_user_key,
+    bool use_key_prefixes)
     : block_restart_interval_(block_restart_interval),
       use_delta_encoding_(use_delta_encoding),
       use_value_delta_encoding_(use_value_delta_encoding),
       strip_ts_sz_(persist_user_defined_timestamps ? 0 : ts_sz),
       is_user_key_(is_user_key),
+      use_key_prefixes_(use_key_prefixes),
       restarts_(1, 0),  // First restart point is at offset 0
       counter_(0),
       finished_(false) {
@@ -69,6 +76,7 @@ BlockBuilder::BlockBuilder(
       assert(0);
   }
   assert(block_restart_interval_ >= 1);
+  assert(!use_key_prefixes_ || (!is_user_key_ && ts_sz == 0));
   estimate_ = sizeof(uint32_t) + sizeof(uint32_t);
 }
 
@@ -76,6 +84,7 @@ void BlockBuilder::Reset() {
   buffer_.clear();
   restarts_.resize(1);  // First restart point is at offset 0
   assert(restarts_[0] == 0);
+  key_prefixes_.clear();
   estimate_ = sizeof(uint32_t) + sizeof(uint32_t);
   counter_ = 0;
   finished_ = false;
@@ -112,6 +121,10 @@ size_t BlockBuilder::EstimateSizeAfterKV(const Slice& key,
   if (counter_ >= block_restart_interval_) {
     estimate += sizeof(uint32_t);  // a new restart entry.
   }
+  if (use_key_prefixes_ &&
+      (counter_ == 0 || counter_ >= block_restart_interval_)) {
+    estimate += sizeof(uint64_t);  // a new key prefix entry.
+  }
 
   estimate += sizeof(int32_t);  // varint for shared prefix length.
   // Note: this is an imprecise estimate as we will have to encoded size, one
@@ -133,6 +146,20 @@ Slice BlockBuilder::Finish() {
   }
 
   uint32_t num_restarts = static_cast<uint32_t>(restarts_.size());
+  bool has_key_prefixes = false;
+  if (!key_prefixes_.empty()) {
+    assert(key_prefixes_.size() == restarts_.size());
+    // The footer flag is not interpreted for larger blocks
+    if (estimate_ <= kMaxBlockSizeSupportedByHashIndex) {
+      for (uint64_t prefix : key_prefixes_) {
+        rocksdb_rs::coding::PutFixed64(buffer_, prefix);
+      }
+      has_key_prefixes = true;
+    } else {
+      estimate_ -= key_prefixes_.size() * sizeof(uint64_t);
+    }
+  }
+
   BlockBasedTableOptions::DataBlockIndexType index_type =
       BlockBasedTableOptions::kDataBlockBinarySearch;
   if (data_block_hash_index_builder_.Valid() &&
@@ -142,7 +169,8 @@ Slice BlockBuilder::Finish() {
   }
 
   // footer is a packed format of data_block_index_type and num_restarts
-  uint32_t block_footer = PackIndexTypeAndNumRestarts(index_type, num_restarts);
+  uint32_t block_footer =
+      PackIndexTypeAndNumRestarts(index_type, num_restarts, has_key_prefixes);
 
   rocksdb_rs::coding::PutFixed32(buffer_, block_footer);
   finished_ = true;
@@ -214,6 +242,10 @@ inline void BlockBuilder::AddWithLastKeyImpl(const Slice& key,
     // See how much sharing to do with previous string
     shared = key_to_persist.difference_offset(last_key_persisted);
   }
+  if (use_key_prefixes_ && counter_ == 0) {
+    key_prefixes_.push_back(DataBlockKeyPrefix(ExtractUserKey(key)));
+    estimate_ += sizeof(uint64_t);
+  }
 
   const size_t non_shared = key_to_persist.size() - shared;
 
@@ -0,0 +1,161 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/block_interpolation_index.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "table/block_based/data_block_key_prefix.h"
+#include "util/coding.h"
+
+namespace rocksdb {
+
+namespace {
+uint64_t EncodeSlope(double slope) {
+  uint64_t bits;
+  static_assert(sizeof(bits) == sizeof(slope), "");
+  memcpy(&bits, &slope, sizeof(bits));
+  return bits;
+}
+
+double DecodeSlope(uint64_t bits) {
+  double slope;
+  memcpy(&slope, &bits, sizeof(slope));
+  return slope;
+}
+}  // namespace
+
+void BlockInterpolationIndex::Build(const std::vector<uint64_t>& points,
+                                    uint32_t max_error, std::string* dst) {
+  // Greedily extends each segment for as long as some line through its first
+  // point predicts every point covered so far within max_error. The slopes of
+  // these lines are kept as the range [slope_lo, slope_hi], which can only
+  // shrink as points are added.
+  std::vector<Segment> segments;
+  double slope_lo = 0;
+  double slope_hi = std::numeric_limits<double>::infinity();
+  auto finish_segment = [&]() {
+    segments.back().slope = std::isinf(slope_hi)
+                                ? slope_lo
+                                : slope_lo + (slope_hi - slope_lo) / 2;
+  };
+
+  for (size_t i = 0; i < points.size(); ++i) {
+    assert(i == 0 || points[i - 1] <= points[i]);
+    if (i + 1 < points.size() && points[i + 1] == points[i]) {
+      // Only the last restart of a run of equal points is modeled
+      continue;
+    }
+    const uint32_t restart = static_cast<uint32_t>(i);
+    if (segments.empty()) {
+      segments.push_back({points[i], restart, 0});
+      continue;
+    }
+    const Segment& segment = segments.back();
+    const double dx = static_cast<double>(points[i] - segment.first_point);
+    const double dy = static_cast<double>(restart - segment.first_restart);
+    const double lo = (dy - max_error) / dx;
+    const double hi = (dy + max_error) / dx;
+    if (lo > slope_hi || hi < slope_lo) {
+      finish_segment();
+      segments.push_back({points[i], restart, 0});
+      slope_lo = 0;
+      slope_hi = std::numeric_limits<double>::infinity();
+    } else {
+      slope_lo = std::max(slope_lo, lo);
+      slope_hi = std::min(slope_hi, hi);
+    }
+  }
+  if (!segments.empty()) {
+    finish_segment();
+  }
+
+  rocksdb_rs::coding::PutFixed32(*dst, max_error);
+  rocksdb_rs::coding::PutFixed32(*dst, static_cast<uint32_t>(segments.size()));
+  for (const Segment& segment : segments) {
+    rocksdb_rs::coding::PutFixed64(*dst, segment.first_point);
+    rocksdb_rs::coding::PutFixed32(*dst, segment.first_restart);
+    rocksdb_rs::coding::PutFixed64(*dst, EncodeSlope(segment.slope));
+  }
+}
+
+rocksdb_rs::status::Status BlockInterpolationIndex::Create(
+    const Slice& contents,
+    std::unique_ptr<BlockInterpolationIndex>* interpolation_index) {
+  if (contents.size() < kHeaderSize) {
+    return rocksdb_rs::status::Status_Corruption(
+        "Corrupted interpolation index block");
+  }
+  const char* p = contents.data();
+  const uint32_t max_error = rocksdb_rs::coding_lean::DecodeFixed32(p);
+  const uint32_t num_segments =
+      rocksdb_rs::coding_lean::DecodeFixed32(p + sizeof(uint32_t));
+  p += kHeaderSize;
+  if (contents.size() - kHeaderSize !=
+      static_cast<uint64_t>(num_segments) * kEncodedSegmentSize) {
+    return rocksdb_rs::status::Status_Corruption(
+        "Corrupted interpolation index block");
+  }
+
+  std::unique_ptr<BlockInterpolationIndex> index(
+      new BlockInterpolationIndex(max_error));
+  index->segments_.reserve(num_segments);
+  for (uint32_t i = 0; i < num_segments; ++i) {
+    Segment segment;
+    segment.first_point = rocksdb_rs::coding_lean::DecodeFixed64(p);
+    p += sizeof(uint64_t);
+    segment.first_restart = rocksdb_rs::coding_lean::DecodeFixed32(p);
+    p += sizeof(uint32_t);
+    segment.slope = DecodeSlope(rocksdb_rs::coding_lean::DecodeFixed64(p));
+    p += sizeof(uint64_t);
+    if (!std::isfinite(segment.slope) || segment.slope < 0 ||
+        (i > 0 &&
+         (segment.first_point <= index->segments_.back().first_point ||
+          segment.first_restart <= index->segments_.back().first_restart))) {
+      return rocksdb_rs::status::Status_Corruption(
+          "Corrupted interpolation index segment");
+    }
+    index->segments_.push_back(segment);
+  }
+  *interpolation_index = std::move(index);
+  return rocksdb_rs::status::Status_OK();
+}
+
+void BlockInterpolationIndex::Predict(const Slice& user_key,
+                                      uint32_t num_restarts, int64_t* left,
+                                      int64_t* right) const {
+  assert(num_restarts > 0);
+  const uint64_t point = DataBlockKeyPrefix(user_key);
+  // The first segment starting after `point`
+  auto next = std::upper_bound(
+      segments_.begin(), segments_.end(), point,
+      [](uint64_t p, const Segment& segment) { return p < segment.first_point; });
+
+  double predicted = -1;
+  if (next != segments_.begin()) {
+    const Segment& segment = *(next - 1);
+    predicted = segment.first_restart +
+                segment.slope * static_cast<double>(point - segment.first_point);
+    if (next != segments_.end()) {
+      // The restart keys of the next segment are all greater than `user_key`
+      predicted =
+          std::min(predicted, static_cast<double>(next->first_restart) - 1);
+    }
+  }
+  predicted = std::min(predicted, static_cast<double>(num_restarts) - 1);
+
+  // One more on each side for the rounding of the prediction
+  const int64_t restart = static_cast<int64_t>(std::floor(predicted));
+  *left = std::max<int64_t>(-1, restart - max_error_ - 1);
+  *right = std::min<int64_t>(num_restarts - 1, restart + max_error_ + 1);
+  assert(*left <= *right);
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,94 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+#pragma once
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb-rs/src/status.rs.h"
+#include "rocksdb/slice.h"
+
+namespace rocksdb {
+
+// A piecewise linear model of the restart keys of an index block, used by
+// BlockBasedTableOptions::kInterpolationSearch to predict where a key lands
+// in the index block.
+//
+// Restart keys are mapped to points with DataBlockKeyPrefix(), i.e. the first
+// 8 bytes of the user key as a big-endian integer, which preserves the order
+// of the bytewise comparator. Each segment covers the points from its first
+// one up to the first point of the next segment, and predicts the restart
+// index of each of these points within +/- max_error. For a run of restart
+// keys mapped to the same point, the last restart index of the run is
+// modeled.
+//
+// The model is only a hint: IndexBlockIter checks the restart keys bounding
+// the predicted range, and falls back to binary searching the rest of the
+// block when the target is outside of it.
+//
+// The model is stored in the "rocksdb.interpolation.index" meta block:
+//
+// +--------------------+-----------------------+
+// | max_error: 4 bytes | num_segments: 4 bytes |
+// +--------------------+-----------------------+----------------+
+// <=segment 1
+// | first point: 8 bytes | first restart: 4 bytes | slope: 8 bytes |
+// +----------------------+------------------------+----------------+
+// |                                                                 |
+// | ....                                                            |
+// |                                                                 |
+// +----------------------+------------------------+----------------+
+// <=segment n
+// | first point: 8 bytes | first restart: 4 bytes | slope: 8 bytes |
+// +----------------------+------------------------+----------------+
+class BlockInterpolationIndex {
+ public:
+  // Fits segments to `points`, the sorted points of the consecutive restart
+  // keys of an index block, such that each restart index is predicted within
+  // `max_error`. Appends the serialized model to *dst.
+  static void Build(const std::vector<uint64_t>& points, uint32_t max_error,
+                    std::string* dst);
+
+  // Create the model by reading from the meta block contents.
+  static rocksdb_rs::status::Status Create(
+      const Slice& contents,
+      std::unique_ptr<BlockInterpolationIndex>* interpolation_index);
+
+  // Sets [*left, *right] to the range of restart indexes that should contain
+  // the last restart key <= `user_key` of an index block with `num_restarts`
+  // restarts, where -1 stands for "before the first restart".
+  void Predict(const Slice& user_key, uint32_t num_restarts, int64_t* left,
+               int64_t* right) const;
+
+  size_t NumSegments() const { return segments_.size(); }
+
+  size_t ApproximateMemoryUsage() const {
+    return sizeof(BlockInterpolationIndex) +
+           segments_.capacity() * sizeof(Segment);
+  }
+
+ private:
+  struct Segment {
+    uint64_t first_point;
+    uint32_t first_restart;
+    double slope;
+  };
+
+  static constexpr size_t kHeaderSize = 2 * sizeof(uint32_t);
+  static constexpr size_t kEncodedSegmentSize =
+      sizeof(uint64_t) + sizeof(uint32_t) + sizeof(uint64_t);
+
+  explicit BlockInterpolationIndex(uint32_t max_error)
+      : max_error_(max_error) {}
+
+  uint32_t max_error_;
+  std::vector<Segment> segments_;
+};
+
+}  // namespace rocksdb
@@ -16,12 +16,15 @@ void BlockPrefetcher::PrefetchIfNeeded(
     const BlockBasedTable::Rep* rep, const BlockHandle& handle,
     const size_t readahead_size, bool is_for_compaction,
     const bool no_sequential_checking,
-    const Env::IOPriority rate_limiter_priority) {
+    const Env::IOPriority rate_limiter_priority, bool async_io) {
   const size_t len = BlockBasedTable::BlockSizeWithTrailer(handle);
   const size_t offset = handle.offset();
 
   if (is_for_compaction) {
-    if (!rep->file->use_direct_io() && compaction_readahead_size_ > 0) {
+    // With async_io, readahead goes through the internal prefetch buffer so
+    // that it can be submitted with ReadAsync.
+    if (!rep->file->use_direct_io() && compaction_readahead_size_ > 0 &&
+        !async_io) {
       // If FS supports prefetching (readahead_limit_ will be non zero in that
       // case) and current block exists in prefetch buffer then return.
       if (offset + len <= readahead_limit_) {
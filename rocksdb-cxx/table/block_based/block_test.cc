@@ -287,6 +287,92 @@ TEST_P(BlockTest, IndexHashWithSharedPrefix) {
                      shouldPersistUDT());
 }
 
+TEST_P(BlockTest, KeyPrefixes) {
+  if (isUDTEnabled()) {
+    ROCKSDB_GTEST_BYPASS("Key prefixes are not used with timestamps");
+    return;
+  }
+  const int kMaxKey = 160;
+  // Keys sharing a primary key also share their first 8 bytes
+  const int kPrefixGroup = 5;
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  GenerateRandomKVs(&keys, &values, 0 /* first key id */, kMaxKey,
+                    2 /* step */, 0 /* padding_size */, kPrefixGroup);
+
+  BlockBuilder builder(4 /* restart interval */, keyUseDeltaEncoding(),
+                       false /* use_value_delta_encoding */,
+                       dataBlockIndexType(),
+                       0.75 /* data_block_hash_table_util_ratio */,
+                       0 /* ts_sz */, true /* persist_udt */,
+                       false /* is_user_key */, true /* use_key_prefixes */);
+  BlockBuilder expected_builder(4 /* restart interval */,
+                                keyUseDeltaEncoding(),
+                                false /* use_value_delta_encoding */,
+                                dataBlockIndexType());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    builder.Add(keys[i], values[i]);
+    expected_builder.Add(keys[i], values[i]);
+  }
+  Block reader(BlockContents(builder.Finish()));
+  Block expected_reader(BlockContents(expected_builder.Finish()));
+  ASSERT_TRUE(reader.HasKeyPrefixes());
+  ASSERT_FALSE(expected_reader.HasKeyPrefixes());
+  ASSERT_EQ(reader.NumRestarts(), expected_reader.NumRestarts());
+  ASSERT_EQ(reader.IndexType(), expected_reader.IndexType());
+  ASSERT_EQ(reader.size(),
+            expected_reader.size() + reader.NumRestarts() * sizeof(uint64_t));
+
+  std::unique_ptr<DataBlockIter> iter(reader.NewDataIterator(
+      BytewiseComparator(), kDisableGlobalSequenceNumber));
+  std::unique_ptr<DataBlockIter> expected_iter(expected_reader.NewDataIterator(
+      BytewiseComparator(), kDisableGlobalSequenceNumber));
+
+  auto check_seek = [&](const std::string &target) {
+    iter->Seek(target);
+    expected_iter->Seek(target);
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(iter->Valid(), expected_iter->Valid());
+    if (iter->Valid()) {
+      ASSERT_EQ(iter->key(), expected_iter->key());
+    }
+
+    iter->SeekForPrev(target);
+    expected_iter->SeekForPrev(target);
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(iter->Valid(), expected_iter->Valid());
+    if (iter->Valid()) {
+      ASSERT_EQ(iter->key(), expected_iter->key());
+    }
+
+    ASSERT_EQ(iter->SeekForGet(target), expected_iter->SeekForGet(target));
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(iter->Valid(), expected_iter->Valid());
+    if (iter->Valid()) {
+      ASSERT_EQ(iter->key(), expected_iter->key());
+    }
+  };
+
+  // Seek to existing keys, keys in between them, and keys before and after
+  // all of them, with both the smallest and largest sequence number.
+  for (int i = -1; i <= kMaxKey; ++i) {
+    for (int j = 0; j <= kPrefixGroup; ++j) {
+      for (SequenceNumber seq : {SequenceNumber{0}, kMaxSequenceNumber}) {
+        char buf[50];
+        snprintf(buf, sizeof(buf), "%6d%4d", i, j);
+        std::string target(buf);
+        AppendInternalKeyFooter(&target, seq, kTypeValue);
+        check_seek(target);
+      }
+    }
+  }
+  for (const char *user_key : {"", "\xff\xff\xff\xff\xff\xff\xff\xff\xff"}) {
+    std::string target(user_key);
+    AppendInternalKeyFooter(&target, 0 /* seqno */, kTypeValue);
+    check_seek(target);
+  }
+}
+
 // Param 0: key use delta encoding
 // Param 1: user-defined timestamp test mode
 // Param 2: data block index type. User-defined timestamp feature is not
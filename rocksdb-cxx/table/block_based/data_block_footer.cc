@@ -18,12 +18,16 @@ const int kDataBlockIndexTypeBitShift = 31;
 // 0x7FFFFFFF
 const uint32_t kMaxNumRestarts = (1u << kDataBlockIndexTypeBitShift) - 1u;
 
-// 0x7FFFFFFF
-const uint32_t kNumRestartsMask = (1u << kDataBlockIndexTypeBitShift) - 1u;
+// Only used for blocks <= kMaxBlockSizeSupportedByHashIndex, which cannot
+// have anywhere near 2^30 restarts.
+const int kDataBlockKeyPrefixBitShift = 30;
+
+// 0x3FFFFFFF
+const uint32_t kNumRestartsMask = (1u << kDataBlockKeyPrefixBitShift) - 1u;
 
 uint32_t PackIndexTypeAndNumRestarts(
     BlockBasedTableOptions::DataBlockIndexType index_type,
-    uint32_t num_restarts) {
+    uint32_t num_restarts, bool has_key_prefixes) {
   if (num_restarts > kMaxNumRestarts) {
     assert(0);  // mute travis "unused" warning
   }
@@ -34,6 +38,10 @@ uint32_t PackIndexTypeAndNumRestarts(
   } else if (index_type != BlockBasedTableOptions::kDataBlockBinarySearch) {
     assert(0);
   }
+  if (has_key_prefixes) {
+    assert(num_restarts <= kNumRestartsMask);
+    block_footer |= 1u << kDataBlockKeyPrefixBitShift;
+  }
 
   return block_footer;
 }
@@ -41,7 +49,7 @@ uint32_t PackIndexTypeAndNumRestarts(
 void UnPackIndexTypeAndNumRestarts(
     uint32_t block_footer,
     BlockBasedTableOptions::DataBlockIndexType* index_type,
-    uint32_t* num_restarts) {
+    uint32_t* num_restarts, bool* has_key_prefixes) {
   if (index_type) {
     if (block_footer & 1u << kDataBlockIndexTypeBitShift) {
       *index_type = BlockBasedTableOptions::kDataBlockBinaryAndHash;
@@ -50,6 +58,11 @@ void UnPackIndexTypeAndNumRestarts(
     }
   }
 
+  if (has_key_prefixes) {
+    *has_key_prefixes =
+        (block_footer & 1u << kDataBlockKeyPrefixBitShift) != 0;
+  }
+
   if (num_restarts) {
     *num_restarts = block_footer & kNumRestartsMask;
     assert(*num_restarts <= kMaxNumRestarts);
@@ -13,13 +13,16 @@
 
 namespace rocksdb {
 
+// `has_key_prefixes` flags a key prefix array after the restart array (see
+// data_block_key_prefix.h). It may only be set for blocks no larger than
+// kMaxBlockSizeSupportedByHashIndex, whose footers are unpacked below.
 uint32_t PackIndexTypeAndNumRestarts(
     BlockBasedTableOptions::DataBlockIndexType index_type,
-    uint32_t num_restarts);
+    uint32_t num_restarts, bool has_key_prefixes = false);
 
 void UnPackIndexTypeAndNumRestarts(
     uint32_t block_footer,
     BlockBasedTableOptions::DataBlockIndexType* index_type,
-    uint32_t* num_restarts);
+    uint32_t* num_restarts, bool* has_key_prefixes = nullptr);
 
 }  // namespace rocksdb
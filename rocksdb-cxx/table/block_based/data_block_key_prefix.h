@@ -0,0 +1,132 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstdint>
+
+#include "rocksdb-rs/src/coding_lean.rs.h"
+#include "rocksdb/slice.h"
+#include "util/math.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#elif defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
+namespace rocksdb {
+// Data blocks written with kRestartKeyPrefixFormatVersion (bytewise
+// comparator, no user-defined timestamps) may store a fixed-width prefix of
+// the user key of every restart point, right after the restart array:
+//
+// DATA_BLOCK: [RI RI RI ... RI RI_IDX KEY_PREFIX_IDX [HASH_IDX] FOOTER]
+//
+// KEY_PREFIX_IDX: [P P P ... P], one uint64_t (fixed64) per restart point.
+//
+// P is the first 8 bytes of the restart user key, zero padded, as a
+// big-endian integer. So for two user keys a <= b (bytewise) we have
+// P(a) <= P(b), and a Seek() can narrow the restart range to binary search
+// by comparing integers before decoding any key or calling the comparator.
+//
+// The presence of KEY_PREFIX_IDX is flagged in bit 30 of the block footer
+// (see data_block_footer.h), which like the hash index flag is only
+// interpreted for blocks <= kMaxBlockSizeSupportedByHashIndex.
+
+// Beyond this many restarts, CountDataBlockKeyPrefixes() binary searches the
+// prefixes instead of scanning them.
+constexpr uint32_t kDataBlockKeyPrefixScanLimit = 64;
+
+inline uint64_t DataBlockKeyPrefix(const Slice& user_key) {
+  uint64_t prefix = 0;
+  for (size_t i = 0; i < sizeof(uint64_t); ++i) {
+    prefix <<= 8;
+    if (i < user_key.size()) {
+      prefix |= static_cast<unsigned char>(user_key[i]);
+    }
+  }
+  return prefix;
+}
+
+inline uint64_t DecodeDataBlockKeyPrefix(const char* prefixes, uint32_t i) {
+  return rocksdb_rs::coding_lean::DecodeFixed64(prefixes +
+                                                i * sizeof(uint64_t));
+}
+
+// Given the `num_prefixes` sorted key prefixes at `prefixes`, sets `*lt` to
+// the number of prefixes < `target` and `*le` to the number of prefixes <=
+// `target`.
+inline void CountDataBlockKeyPrefixes(const char* prefixes,
+                                      uint32_t num_prefixes, uint64_t target,
+                                      uint32_t* lt, uint32_t* le) {
+  if (num_prefixes > kDataBlockKeyPrefixScanLimit) {
+    uint32_t lo = 0, hi = num_prefixes;
+    while (lo < hi) {
+      uint32_t mid = lo + (hi - lo) / 2;
+      if (DecodeDataBlockKeyPrefix(prefixes, mid) < target) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    *lt = lo;
+    hi = num_prefixes;
+    while (lo < hi) {
+      uint32_t mid = lo + (hi - lo) / 2;
+      if (DecodeDataBlockKeyPrefix(prefixes, mid) <= target) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    *le = lo;
+    return;
+  }
+
+  uint32_t num_lt = 0, num_gt = 0;
+  uint32_t i = 0;
+  // The SIMD compares are signed, so flip the sign bit of both sides to
+  // compare as unsigned. Prefixes are stored little-endian, which is the
+  // native order on all targets with these instruction sets.
+#ifdef __AVX2__
+  const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+  const __m256i t = _mm256_xor_si256(
+      _mm256_set1_epi64x(static_cast<int64_t>(target)), sign);
+  for (; i + 4 <= num_prefixes; i += 4) {
+    const __m256i p = _mm256_xor_si256(
+        _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(prefixes + i * sizeof(uint64_t))),
+        sign);
+    num_lt += BitsSetToOne(static_cast<uint32_t>(
+        _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(t, p)))));
+    num_gt += BitsSetToOne(static_cast<uint32_t>(
+        _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(p, t)))));
+  }
+#elif defined(__SSE4_2__)
+  const __m128i sign = _mm_set1_epi64x(INT64_MIN);
+  const __m128i t =
+      _mm_xor_si128(_mm_set1_epi64x(static_cast<int64_t>(target)), sign);
+  for (; i + 2 <= num_prefixes; i += 2) {
+    const __m128i p = _mm_xor_si128(
+        _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(prefixes + i * sizeof(uint64_t))),
+        sign);
+    num_lt += BitsSetToOne(static_cast<uint32_t>(
+        _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(t, p)))));
+    num_gt += BitsSetToOne(static_cast<uint32_t>(
+        _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(p, t)))));
+  }
+#endif
+  for (; i < num_prefixes; ++i) {
+    uint64_t p = DecodeDataBlockKeyPrefix(prefixes, i);
+    num_lt += p < target;
+    num_gt += p > target;
+  }
+  *lt = num_lt;
+  *le = num_prefixes - num_gt;
+}
+
+}  // namespace rocksdb
@@ -536,17 +536,24 @@ class FastLocalBloomBitsReader : public BuiltinFilterBitsReader {
   }
 
   virtual void MayMatch(int num_keys, Slice** keys, bool* may_match) override {
-    std::array<uint32_t, MultiGetContext::MAX_BATCH_SIZE> hashes;
+    std::array<uint64_t, MultiGetContext::MAX_BATCH_SIZE> hashes;
+    for (int i = 0; i < num_keys; ++i) {
+      hashes[i] = GetSliceHash64(*keys[i]);
+    }
+    MayMatchWithHashes(num_keys, keys, hashes.data(), may_match);
+  }
+
+  void MayMatchWithHashes(int num_keys, Slice** /* keys */,
+                          const uint64_t* hashes, bool* may_match) override {
+    // Prefetch all the cache lines before probing any
     std::array<uint32_t, MultiGetContext::MAX_BATCH_SIZE> byte_offsets;
     for (int i = 0; i < num_keys; ++i) {
-      uint64_t h = GetSliceHash64(*keys[i]);
-      FastLocalBloomImpl::PrepareHash(Lower32of64(h), len_bytes_, data_,
-                                      /*out*/ &byte_offsets[i]);
-      hashes[i] = Upper32of64(h);
+      FastLocalBloomImpl::PrepareHash(Lower32of64(hashes[i]), len_bytes_,
+                                      data_, /*out*/ &byte_offsets[i]);
     }
     for (int i = 0; i < num_keys; ++i) {
       may_match[i] = FastLocalBloomImpl::HashMayMatchPrepared(
-          hashes[i], num_probes_, data_ + byte_offsets[i]);
+          Upper32of64(hashes[i]), num_probes_, data_ + byte_offsets[i]);
     }
   }
 
@@ -975,6 +982,15 @@ class Standard128RibbonBitsReader : public BuiltinFilterBitsReader {
   }
 
   virtual void MayMatch(int num_keys, Slice** keys, bool* may_match) override {
+    std::array<uint64_t, MultiGetContext::MAX_BATCH_SIZE> hashes;
+    for (int i = 0; i < num_keys; ++i) {
+      hashes[i] = GetSliceHash64(*keys[i]);
+    }
+    MayMatchWithHashes(num_keys, keys, hashes.data(), may_match);
+  }
+
+  void MayMatchWithHashes(int num_keys, Slice** /* keys */,
+                          const uint64_t* hashes, bool* may_match) override {
     struct SavedData {
       uint64_t seeded_hash;
       uint32_t segment_num;
@@ -984,7 +1000,7 @@ class Standard128RibbonBitsReader : public BuiltinFilterBitsReader {
     std::array<SavedData, MultiGetContext::MAX_BATCH_SIZE> saved;
     for (int i = 0; i < num_keys; ++i) {
       ribbon::InterleavedPrepareQuery(
-          GetSliceHash64(*keys[i]), hasher_, soln_, &saved[i].seeded_hash,
+          hashes[i], hasher_, soln_, &saved[i].seeded_hash,
           &saved[i].segment_num, &saved[i].num_columns, &saved[i].start_bits);
     }
     for (int i = 0; i < num_keys; ++i) {
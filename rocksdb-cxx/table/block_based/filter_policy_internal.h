@@ -96,6 +96,15 @@ class FilterBitsReader {
       may_match[i] = MayMatch(*keys[i]);
     }
   }
+
+  // Same as above, with hashes[i] the GetSliceHash64() of *keys[i]. Filters
+  // built on that hash use it rather than hashing the keys again, so that a
+  // batch of keys is hashed once for all the filters it is checked against.
+  virtual void MayMatchWithHashes(int num_keys, Slice** keys,
+                                  const uint64_t* /* hashes */,
+                                  bool* may_match) {
+    MayMatch(num_keys, keys, may_match);
+  }
 };
 
 // Exposes any extra information needed for testing built-in
@@ -248,19 +248,33 @@ void FullFilterBlockReader::MayMatch(MultiGetRange* range, bool no_io,
   autovector<Slice, MultiGetContext::MAX_BATCH_SIZE> prefixes;
   int num_keys = 0;
   MultiGetRange filter_range(*range, range->begin(), range->end());
-  for (auto iter = filter_range.begin(); iter != filter_range.end(); ++iter) {
-    if (!prefix_extractor) {
+  if (!prefix_extractor) {
+    // Whole keys are hashed the same way for every file, so the hashes are
+    // kept in the key contexts for the next filters of the MultiGet
+    std::array<uint64_t, MultiGetContext::MAX_BATCH_SIZE> hashes;
+    for (auto iter = filter_range.begin(); iter != filter_range.end(); ++iter) {
+      if (!iter->filter_hash_valid) {
+        iter->filter_hash = GetSliceHash64(iter->ukey_without_ts);
+        iter->filter_hash_valid = true;
+      }
+      hashes[num_keys] = iter->filter_hash;
       keys[num_keys++] = &iter->ukey_without_ts;
-    } else if (prefix_extractor->InDomain(iter->ukey_without_ts)) {
-      prefixes.emplace_back(prefix_extractor->Transform(iter->ukey_without_ts));
-      keys[num_keys++] = &prefixes.back();
-    } else {
-      filter_range.SkipKey(iter);
     }
+    filter_bits_reader->MayMatchWithHashes(num_keys, &keys[0], &hashes[0],
+                                           &may_match[0]);
+  } else {
+    for (auto iter = filter_range.begin(); iter != filter_range.end(); ++iter) {
+      if (prefix_extractor->InDomain(iter->ukey_without_ts)) {
+        prefixes.emplace_back(
+            prefix_extractor->Transform(iter->ukey_without_ts));
+        keys[num_keys++] = &prefixes.back();
+      } else {
+        filter_range.SkipKey(iter);
+      }
+    }
+    filter_bits_reader->MayMatch(num_keys, &keys[0], &may_match[0]);
   }
 
-  filter_bits_reader->MayMatch(num_keys, &keys[0], &may_match[0]);
-
   int i = 0;
   for (auto iter = filter_range.begin(); iter != filter_range.end(); ++iter) {
     if (!may_match[i]) {
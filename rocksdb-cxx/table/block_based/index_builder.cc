@@ -18,6 +18,8 @@
 #include "db/dbformat.h"
 #include "rocksdb/comparator.h"
 #include "rocksdb/flush_block_policy.h"
+#include "table/block_based/block_interpolation_index.h"
+#include "table/block_based/data_block_key_prefix.h"
 #include "table/block_based/partitioned_filter_block.h"
 #include "table/format.h"
 
@@ -66,6 +68,13 @@ IndexBuilder* IndexBuilder::CreateIndexBuilder(
           persist_user_defined_timestamps);
       break;
     }
+    case BlockBasedTableOptions::kInterpolationSearch: {
+      result = new InterpolationIndexBuilder(
+          comparator, table_opt.index_block_restart_interval,
+          table_opt.format_version, use_value_delta_encoding,
+          table_opt.index_shortening, ts_sz, persist_user_defined_timestamps);
+      break;
+    }
     default: {
       assert(!"Do not recognize the index type ");
       break;
@@ -108,6 +117,42 @@ void ShortenedIndexBuilder::FindShortInternalKeySuccessor(
   }
 }
 
+// Keeps the range binary searched by InterpolationSeek() to a handful of
+// restart keys.
+static constexpr uint32_t kInterpolationIndexMaxError = 4;
+
+void InterpolationIndexBuilder::AddIndexEntry(
+    std::string* last_key_in_current_block,
+    const Slice* first_key_in_next_block, const BlockHandle& block_handle) {
+  primary_index_builder_.AddIndexEntry(last_key_in_current_block,
+                                       first_key_in_next_block, block_handle);
+  // The primary index builder substitutes the separator for the last key
+  if (build_model_ && num_entries_ % index_block_restart_interval_ == 0) {
+    restart_points_.push_back(
+        DataBlockKeyPrefix(ExtractUserKey(*last_key_in_current_block)));
+  }
+  ++num_entries_;
+}
+
+rocksdb_rs::status::Status InterpolationIndexBuilder::Finish(
+    IndexBlocks* index_blocks, const BlockHandle& last_partition_block_handle) {
+  rocksdb_rs::status::Status s = primary_index_builder_.Finish(
+      index_blocks, last_partition_block_handle);
+  if (!s.ok() || restart_points_.empty()) {
+    return s;
+  }
+  BlockInterpolationIndex::Build(restart_points_, kInterpolationIndexMaxError,
+                                 &model_block_);
+  if (model_block_.size() >= index_blocks->index_block_contents.size()) {
+    // The keys are too irregular for the model to pay off
+    model_block_.clear();
+  } else {
+    index_blocks->meta_blocks.insert(
+        {kInterpolationIndexBlock.c_str(), model_block_});
+  }
+  return s;
+}
+
 PartitionedIndexBuilder* PartitionedIndexBuilder::CreateIndexBuilder(
     const InternalKeyComparator* comparator,
     const bool use_value_delta_encoding,
@@ -13,6 +13,7 @@
 #include <list>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "db/dbformat.h"
 #include "rocksdb/comparator.h"
@@ -404,6 +405,54 @@ class HashIndexBuilder : public IndexBuilder {
   uint64_t current_restart_index_ = 0;
 };
 
+// InterpolationIndexBuilder builds a binary-searchable primary index along
+// with a metablock holding a piecewise linear model of its restart keys (see
+// block_interpolation_index.h), which is fitted in Finish(). The model is
+// only built for the bytewise comparator without user-defined timestamps.
+// Otherwise, or if it would not be smaller than the primary index, the
+// metablock is omitted and the index is read as a plain binary search index.
+class InterpolationIndexBuilder : public IndexBuilder {
+ public:
+  InterpolationIndexBuilder(
+      const InternalKeyComparator* comparator, int index_block_restart_interval,
+      int format_version, bool use_value_delta_encoding,
+      BlockBasedTableOptions::IndexShorteningMode shortening_mode,
+      size_t ts_sz, const bool persist_user_defined_timestamps)
+      : IndexBuilder(comparator, ts_sz, persist_user_defined_timestamps),
+        primary_index_builder_(comparator, index_block_restart_interval,
+                               format_version, use_value_delta_encoding,
+                               shortening_mode, /* include_first_key */ false,
+                               ts_sz, persist_user_defined_timestamps),
+        index_block_restart_interval_(index_block_restart_interval),
+        build_model_(ts_sz == 0 &&
+                     comparator->user_comparator() == BytewiseComparator()) {}
+
+  void AddIndexEntry(std::string* last_key_in_current_block,
+                     const Slice* first_key_in_next_block,
+                     const BlockHandle& block_handle) override;
+
+  rocksdb_rs::status::Status Finish(
+      IndexBlocks* index_blocks,
+      const BlockHandle& last_partition_block_handle) override;
+
+  size_t IndexSize() const override {
+    return primary_index_builder_.IndexSize() + model_block_.size();
+  }
+
+  bool seperator_is_key_plus_seq() override {
+    return primary_index_builder_.seperator_is_key_plus_seq();
+  }
+
+ private:
+  ShortenedIndexBuilder primary_index_builder_;
+  const int index_block_restart_interval_;
+  const bool build_model_;
+  uint64_t num_entries_ = 0;
+  // DataBlockKeyPrefix() of the user key of each restart of the primary index
+  std::vector<uint64_t> restart_points_;
+  std::string model_block_;
+};
+
 /**
  * IndexBuilder for two-level indexing. Internally it creates a new index for
  * each partition and Finish then in order when Finish is called on it
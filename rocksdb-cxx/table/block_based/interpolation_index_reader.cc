@@ -0,0 +1,118 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+#include "table/block_based/interpolation_index_reader.h"
+
+#include "logging/logging.h"
+#include "table/block_fetcher.h"
+#include "table/meta_blocks.h"
+
+namespace rocksdb {
+rocksdb_rs::status::Status InterpolationIndexReader::Create(
+    const BlockBasedTable* table, const ReadOptions& ro,
+    FilePrefetchBuffer* prefetch_buffer, InternalIterator* meta_index_iter,
+    bool use_cache, bool prefetch, bool pin,
+    BlockCacheLookupContext* lookup_context,
+    std::unique_ptr<IndexReader>* index_reader) {
+  assert(table != nullptr);
+  assert(index_reader != nullptr);
+  assert(!pin || prefetch);
+
+  const BlockBasedTable::Rep* rep = table->get_rep();
+  assert(rep != nullptr);
+
+  CachableEntry<Block> index_block;
+  if (prefetch || !use_cache) {
+    const rocksdb_rs::status::Status s =
+        ReadIndexBlock(table, prefetch_buffer, ro, use_cache,
+                       /*get_context=*/nullptr, lookup_context, &index_block);
+    if (!s.ok()) {
+      return s.Clone();
+    }
+
+    if (use_cache && !pin) {
+      index_block.Reset();
+    }
+  }
+
+  // Like for the hash index, the index block is enough to serve lookups, so
+  // a missing or unreadable model only costs the full binary search.
+  index_reader->reset(
+      new InterpolationIndexReader(table, std::move(index_block)));
+
+  BlockHandle model_handle;
+  rocksdb_rs::status::Status s =
+      FindMetaBlock(meta_index_iter, kInterpolationIndexBlock, &model_handle);
+  if (!s.ok()) {
+    // Not written for this file
+    return rocksdb_rs::status::Status_OK();
+  }
+
+  BlockContents model_contents;
+  BlockFetcher model_block_fetcher(
+      rep->file.get(), prefetch_buffer, rep->footer, ro, model_handle,
+      &model_contents, rep->ioptions, true /*decompress*/,
+      true /*maybe_compressed*/, BlockType::kIndex,
+      UncompressionDict::GetEmptyDict(), rep->persistent_cache_options,
+      GetMemoryAllocator(rep->table_options));
+  s = model_block_fetcher.ReadBlockContents().status();
+  if (!s.ok()) {
+    ROCKS_LOG_WARN(rep->ioptions.logger,
+                   "Failed to read interpolation index, falling back to "
+                   "binary search: %s",
+                   s.ToString()->c_str());
+    return rocksdb_rs::status::Status_OK();
+  }
+
+  std::unique_ptr<BlockInterpolationIndex> interpolation_index;
+  s = BlockInterpolationIndex::Create(model_contents.data,
+                                      &interpolation_index);
+  if (!s.ok()) {
+    ROCKS_LOG_WARN(rep->ioptions.logger,
+                   "Failed to parse interpolation index, falling back to "
+                   "binary search: %s",
+                   s.ToString()->c_str());
+    return rocksdb_rs::status::Status_OK();
+  }
+  static_cast<InterpolationIndexReader*>(index_reader->get())
+      ->interpolation_index_ = std::move(interpolation_index);
+
+  return rocksdb_rs::status::Status_OK();
+}
+
+InternalIteratorBase<IndexValue>* InterpolationIndexReader::NewIterator(
+    const ReadOptions& read_options, bool /* disable_prefix_seek */,
+    IndexBlockIter* iter, GetContext* get_context,
+    BlockCacheLookupContext* lookup_context) {
+  const BlockBasedTable::Rep* rep = table()->get_rep();
+  const bool no_io = (read_options.read_tier == kBlockCacheTier);
+  CachableEntry<Block> index_block;
+  const rocksdb_rs::status::Status s = GetOrReadIndexBlock(
+      no_io, get_context, lookup_context, &index_block, read_options);
+  if (!s.ok()) {
+    if (iter != nullptr) {
+      iter->Invalidate(s);
+      return iter;
+    }
+
+    return NewErrorInternalIterator<IndexValue>(s);
+  }
+
+  Statistics* kNullStats = nullptr;
+  // We don't return pinned data from index blocks, so no need
+  // to set `block_contents_pinned`.
+  auto it = index_block.GetValue()->NewIndexIterator(
+      internal_comparator()->user_comparator(),
+      rep->get_global_seqno(BlockType::kIndex), iter, kNullStats, true,
+      index_has_first_key(), index_key_includes_seq(), index_value_is_full(),
+      false /* block_contents_pinned */, user_defined_timestamps_persisted(),
+      /* prefix_index */ nullptr, interpolation_index_.get());
+
+  assert(it != nullptr);
+  index_block.TransferTo(it);
+
+  return it;
+}
+}  // namespace rocksdb
@@ -0,0 +1,49 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+#pragma once
+
+#include "table/block_based/block_interpolation_index.h"
+#include "table/block_based/index_reader_common.h"
+
+namespace rocksdb {
+// Index that uses a piecewise linear model of the index block keys to narrow
+// down the binary search for a given key.
+class InterpolationIndexReader : public BlockBasedTable::IndexReaderCommon {
+ public:
+  static rocksdb_rs::status::Status Create(
+      const BlockBasedTable* table, const ReadOptions& ro,
+      FilePrefetchBuffer* prefetch_buffer, InternalIterator* meta_index_iter,
+      bool use_cache, bool prefetch, bool pin,
+      BlockCacheLookupContext* lookup_context,
+      std::unique_ptr<IndexReader>* index_reader);
+
+  InternalIteratorBase<IndexValue>* NewIterator(
+      const ReadOptions& read_options, bool disable_prefix_seek,
+      IndexBlockIter* iter, GetContext* get_context,
+      BlockCacheLookupContext* lookup_context) override;
+
+  size_t ApproximateMemoryUsage() const override {
+    size_t usage = ApproximateIndexBlockMemoryUsage();
+#ifdef ROCKSDB_MALLOC_USABLE_SIZE
+    usage +=
+        malloc_usable_size(const_cast<InterpolationIndexReader*>(this));
+#else
+    usage += sizeof(*this);
+#endif  // ROCKSDB_MALLOC_USABLE_SIZE
+    if (interpolation_index_) {
+      usage += interpolation_index_->ApproximateMemoryUsage();
+    }
+    return usage;
+  }
+
+ private:
+  InterpolationIndexReader(const BlockBasedTable* t,
+                           CachableEntry<Block>&& index_block)
+      : IndexReaderCommon(t, std::move(index_block)) {}
+
+  std::unique_ptr<BlockInterpolationIndex> interpolation_index_;
+};
+}  // namespace rocksdb
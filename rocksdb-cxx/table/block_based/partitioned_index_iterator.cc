@@ -92,7 +92,7 @@ void PartitionedIndexIterator::InitPartitionedIndexBlock() {
     block_prefetcher_.PrefetchIfNeeded(
         rep, partitioned_index_handle, read_options_.readahead_size,
         is_for_compaction, /*no_sequential_checking=*/false,
-        read_options_.rate_limiter_priority);
+        read_options_.rate_limiter_priority, /*async_io=*/false);
     rocksdb_rs::status::Status s = rocksdb_rs::status::Status_new();
     table_->NewDataBlockIterator<IndexBlockIter>(
         read_options_, partitioned_index_handle, &block_iter_,
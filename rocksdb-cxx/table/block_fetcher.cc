@@ -80,7 +80,7 @@ inline bool BlockFetcher::TryGetFromPrefetchBuffer() {
         file_->PrepareIOOptions(read_options_, opts);
     if (io_s.ok()) {
       bool read_from_prefetch_buffer = false;
-      if (read_options_.async_io && !for_compaction_) {
+      if (read_options_.async_io) {
         read_from_prefetch_buffer = prefetch_buffer_->TryReadFromCacheAsync(
             opts, file_, handle_.offset(), block_size_with_trailer_, &slice_,
             reinterpret_cast<rocksdb_rs::status::Status *>(&io_s),
@@ -368,7 +368,9 @@ rocksdb_rs::io_status::IOStatus BlockFetcher::ReadAsyncBlockContents() {
     return rocksdb_rs::io_status::IOStatus_OK();
   } else if (!TryGetSerializedBlockFromPersistentCache()) {
     assert(prefetch_buffer_ != nullptr);
-    if (!for_compaction_) {
+    // Compaction reads asynchronously only with
+    // DBOptions::compaction_async_io.
+    if (!for_compaction_ || read_options_.async_io) {
       IOOptions opts;
       rocksdb_rs::io_status::IOStatus io_s =
           file_->PrepareIOOptions(read_options_, opts);
@@ -415,7 +417,7 @@ rocksdb_rs::io_status::IOStatus BlockFetcher::ReadAsyncBlockContents() {
       }
     }
     // Fallback to sequential reading of data blocks in case of io_s returns
-    // error or for_compaction_is true.
+    // error or for_compaction_ is true without async_io.
     return ReadBlockContents();
   }
   return io_status_.Clone();
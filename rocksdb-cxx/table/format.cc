@@ -297,6 +297,11 @@ rocksdb_rs::status::Status Footer::DecodeFrom(
   } else {
     const char* part3_ptr = magic_ptr - 4;
     format_version_ = rocksdb_rs::coding_lean::DecodeFixed32(part3_ptr);
+    if (IsUpstreamOnlyFormatVersion(format_version_)) {
+      return rocksdb_rs::status::Status_NotSupported(
+          "format_version " + std::to_string(format_version_) +
+          " of upstream RocksDB is not supported");
+    }
     if (!IsSupportedFormatVersion(format_version_)) {
       return rocksdb_rs::status::Status_Corruption(
           "Corrupt or unsupported format_version: " +
@@ -118,10 +118,26 @@ inline uint32_t GetCompressFormatForVersion(uint32_t format_version) {
   return format_version >= 2 ? 2 : 1;
 }
 
-constexpr uint32_t kLatestFormatVersion = 5;
+// The format versions after this one differ from those of upstream RocksDB,
+// which are not supported.
+constexpr uint32_t kLatestUpstreamCompatibleFormatVersion = 5;
+
+// Data blocks store a prefix of each restart key. Specific to this fork, and
+// far above the format versions upstream RocksDB may reach.
+constexpr uint32_t kRestartKeyPrefixFormatVersion = 1000;
+
+constexpr uint32_t kLatestFormatVersion = kRestartKeyPrefixFormatVersion;
 
 inline bool IsSupportedFormatVersion(uint32_t version) {
-  return version <= kLatestFormatVersion;
+  return version <= kLatestUpstreamCompatibleFormatVersion ||
+         version == kRestartKeyPrefixFormatVersion;
+}
+
+// Whether `version` is likely one of the format versions of upstream RocksDB
+// that this fork does not support.
+inline bool IsUpstreamOnlyFormatVersion(uint32_t version) {
+  return version > kLatestUpstreamCompatibleFormatVersion &&
+         version < kRestartKeyPrefixFormatVersion;
 }
 
 // Footer encapsulates the fixed information stored at the tail end of every
@@ -188,6 +188,8 @@ class GetContext {
 
   uint64_t get_tracing_get_id() const { return tracing_get_id_; }
 
+  Statistics* statistics() const { return statistics_; }
+
   void push_operand(const Slice& value, Cleanable* value_pinner);
 
  private:
@@ -0,0 +1,326 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/log_hash/log_hash_table_builder.h"
+
+#include <assert.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+
+#include "db/dbformat.h"
+#include "file/writable_file_writer.h"
+#include "logging/logging.h"
+#include "table/format.h"
+#include "table/meta_blocks.h"
+#include "util/coding.h"
+#include "util/fastrange.h"
+#include "util/hash.h"
+
+namespace rocksdb {
+
+namespace {
+
+// a utility that helps writing block content to the file
+//   @offset will advance if @block_contents was successfully written.
+//   @block_handle the block handle this particular block.
+rocksdb_rs::io_status::IOStatus WriteBlock(const Slice& block_contents,
+                                           WritableFileWriter* file,
+                                           uint64_t* offset,
+                                           BlockHandle* block_handle) {
+  block_handle->set_offset(*offset);
+  block_handle->set_size(block_contents.size());
+  rocksdb_rs::io_status::IOStatus io_s = file->Append(block_contents);
+
+  if (io_s.ok()) {
+    *offset += block_contents.size();
+  }
+  return io_s;
+}
+
+// Offsets and sizes in the log are stored as fixed32
+const uint64_t kMaxLogSize = std::numeric_limits<uint32_t>::max();
+
+}  // namespace
+
+// kLogHashTableMagicNumber was picked by running
+//    echo rocksdb.table.log_hash | sha1sum
+// and taking the leading 64 bits.
+extern const uint64_t kLogHashTableMagicNumber = 0x59b02564bdce104dull;
+
+const std::string LogHashTableBuilder::kIndexBlock = "rocksdb.log_hash.index";
+
+LogHashTableBuilder::LogHashTableBuilder(
+    const ImmutableOptions& ioptions,
+    const IntTblPropCollectorFactories* int_tbl_prop_collector_factories,
+    uint32_t column_family_id, int level_at_creation, WritableFileWriter* file,
+    double hash_table_ratio, uint32_t restart_interval,
+    const std::string& column_family_name, const std::string& db_id,
+    const std::string& db_session_id, uint64_t file_number)
+    : ioptions_(ioptions),
+      file_(file),
+      hash_table_ratio_(hash_table_ratio),
+      restart_interval_(std::max(1U, restart_interval)),
+      status_(rocksdb_rs::status::Status_new()) {
+  assert(hash_table_ratio_ > 0 && hash_table_ratio_ <= 1);
+  // The log is a single big block.
+  properties_.num_data_blocks = 1;
+  properties_.index_size = 0;
+  properties_.filter_size = 0;
+  properties_.column_family_id = column_family_id;
+  properties_.column_family_name = column_family_name;
+  properties_.db_id = db_id;
+  properties_.db_session_id = db_session_id;
+  properties_.db_host_id = ioptions.db_host_id;
+  if (!ReifyDbHostIdProperty(ioptions_.env, &properties_.db_host_id).ok()) {
+    ROCKS_LOG_INFO(ioptions_.logger, "db_host_id property will not be set");
+  }
+  properties_.orig_file_number = file_number;
+
+  assert(int_tbl_prop_collector_factories);
+  for (auto& factory : *int_tbl_prop_collector_factories) {
+    assert(factory);
+
+    table_properties_collectors_.emplace_back(
+        factory->CreateIntTblPropCollector(column_family_id,
+                                           level_at_creation));
+  }
+}
+
+void LogHashTableBuilder::Add(const Slice& key, const Slice& value) {
+  if (!status_.ok()) {
+    // Nothing is written after an error, so that the file is never finished
+    // without some of its entries.
+    return;
+  }
+  ParsedInternalKey ikey;
+  rocksdb_rs::status::Status pik_status =
+      ParseInternalKey(key, &ikey, false /* log_err_key */);
+  if (!pik_status.ok()) {
+    status_ = rocksdb_rs::status::Status_Corruption(
+        "Unable to parse key into internal key. ", pik_status.getState());
+    return;
+  }
+  if (ikey.type == kTypeRangeDeletion) {
+    status_ =
+        rocksdb_rs::status::Status_NotSupported("Range deletion unsupported");
+    return;
+  }
+
+  // Two varint32
+  char header[10];
+  char* header_end = rocksdb_rs::coding::EncodeVarint32(
+      header, static_cast<uint32_t>(key.size()));
+  header_end = rocksdb_rs::coding::EncodeVarint32(
+      header_end, static_cast<uint32_t>(value.size()));
+  const size_t header_size = static_cast<size_t>(header_end - header);
+  const uint64_t record_size = header_size + key.size() + value.size();
+  if (offset_ + record_size > kMaxLogSize) {
+    status_ = rocksdb_rs::status::Status_NotSupported(
+        "File is too large for LogHashTable");
+    return;
+  }
+
+  // The versions of a user key are contiguous, as keys are added in order
+  if (properties_.num_entries == 0 || ikey.user_key != last_user_key_) {
+    if (properties_.num_entries > 0) {
+      FinishKeyRange();
+    }
+    last_user_key_.assign(ikey.user_key.data(), ikey.user_key.size());
+    last_user_key_offset_ = offset_;
+  }
+  if (properties_.num_entries % restart_interval_ == 0) {
+    restarts_.push_back(static_cast<uint32_t>(offset_));
+  }
+
+  io_status_ = file_->Append(Slice(header, header_size));
+  if (io_status_.ok()) {
+    io_status_ = file_->Append(key);
+  }
+  if (io_status_.ok()) {
+    io_status_ = file_->Append(value);
+  }
+  if (!io_status_.ok()) {
+    status_ = io_status_.status();
+    return;
+  }
+  offset_ += record_size;
+
+  properties_.num_entries++;
+  properties_.raw_key_size += key.size();
+  properties_.raw_value_size += value.size();
+  if (ikey.type == kTypeDeletion || ikey.type == kTypeSingleDeletion) {
+    properties_.num_deletions++;
+  } else if (ikey.type == kTypeMerge) {
+    properties_.num_merge_operands++;
+  }
+
+  // notify property collectors
+  NotifyCollectTableCollectorsOnAdd(
+      key, value, offset_, table_properties_collectors_, ioptions_.logger);
+}
+
+void LogHashTableBuilder::FinishKeyRange() {
+  KeyRange range;
+  range.hash = GetSliceHash64(last_user_key_);
+  range.offset = static_cast<uint32_t>(last_user_key_offset_);
+  range.size = static_cast<uint32_t>(offset_ - last_user_key_offset_);
+  key_ranges_.push_back(range);
+}
+
+uint64_t LogHashTableBuilder::NumBuckets() const {
+  // Keep at least one bucket empty, so that probing for a missing key stops
+  uint64_t num_keys = key_ranges_.size();
+  if (!closed_ && properties_.num_entries > 0) {
+    // The last user key is not in key_ranges_ yet
+    ++num_keys;
+  }
+  return std::max(num_keys + 1, static_cast<uint64_t>(
+                                    std::ceil(num_keys / hash_table_ratio_)));
+}
+
+std::string LogHashTableBuilder::BuildIndexBlock() const {
+  const uint64_t num_buckets = NumBuckets();
+  std::string block(
+      static_cast<size_t>(num_buckets * kLogHashTableBucketSize), '\0');
+  for (const KeyRange& range : key_ranges_) {
+    uint64_t bucket_id =
+        rocksdb_rs::util::fastrange::FastRange64(range.hash, num_buckets);
+    char* bucket = &block[static_cast<size_t>(bucket_id *
+                                              kLogHashTableBucketSize)];
+    // Empty buckets have a zero size
+    while (rocksdb_rs::coding_lean::DecodeFixed32(bucket + 8) != 0) {
+      if (++bucket_id == num_buckets) {
+        bucket_id = 0;
+      }
+      bucket = &block[static_cast<size_t>(bucket_id * kLogHashTableBucketSize)];
+    }
+    rocksdb_rs::coding_lean::EncodeFixed32(bucket, Lower32of64(range.hash));
+    rocksdb_rs::coding_lean::EncodeFixed32(bucket + 4, range.offset);
+    rocksdb_rs::coding_lean::EncodeFixed32(bucket + 8, range.size);
+  }
+  for (uint32_t restart : restarts_) {
+    rocksdb_rs::coding::PutFixed32(block, restart);
+  }
+  rocksdb_rs::coding::PutFixed32(block, static_cast<uint32_t>(num_buckets));
+  rocksdb_rs::coding::PutFixed32(block,
+                                 static_cast<uint32_t>(restarts_.size()));
+  return block;
+}
+
+rocksdb_rs::status::Status LogHashTableBuilder::Finish() {
+  assert(!closed_);
+  closed_ = true;
+
+  if (!status_.ok()) {
+    return status_.Clone();
+  }
+  if (properties_.num_entries > 0) {
+    FinishKeyRange();
+  }
+  properties_.data_size = offset_;
+
+  //  Write the following blocks
+  //  1. [meta block: index]
+  //  2. [meta block: properties]
+  //  3. [metaindex block]
+  //  4. [footer]
+
+  MetaIndexBuilder meta_index_builder;
+
+  if (NumBuckets() > std::numeric_limits<uint32_t>::max()) {
+    status_ = rocksdb_rs::status::Status_NotSupported(
+        "Too many keys for LogHashTable");
+    return status_.Clone();
+  }
+  std::string index_block = BuildIndexBlock();
+  properties_.index_size = index_block.size();
+  BlockHandle index_block_handle;
+  io_status_ = WriteBlock(index_block, file_, &offset_, &index_block_handle);
+  if (!io_status_.ok()) {
+    status_ = io_status_.status();
+    return status_.Clone();
+  }
+  meta_index_builder.Add(kIndexBlock, index_block_handle);
+
+  PropertyBlockBuilder property_block_builder;
+  // -- Add basic properties
+  property_block_builder.AddTableProperty(properties_);
+
+  property_block_builder.Add(properties_.user_collected_properties);
+
+  // -- Add user collected properties
+  NotifyCollectTableCollectorsOnFinish(
+      table_properties_collectors_, ioptions_.logger, &property_block_builder);
+
+  // -- Write property block
+  BlockHandle property_block_handle;
+  io_status_ = WriteBlock(property_block_builder.Finish(), file_, &offset_,
+                          &property_block_handle);
+  if (!io_status_.ok()) {
+    status_ = io_status_.status();
+    return status_.Clone();
+  }
+  meta_index_builder.Add(kPropertiesBlockName, property_block_handle);
+
+  // -- write metaindex block
+  BlockHandle metaindex_block_handle;
+  io_status_ = WriteBlock(meta_index_builder.Finish(), file_, &offset_,
+                          &metaindex_block_handle);
+  if (!io_status_.ok()) {
+    status_ = io_status_.status();
+    return status_.Clone();
+  }
+
+  // Write Footer
+  FooterBuilder footer;
+  footer.Build(kLogHashTableMagicNumber, /* format_version */ 1, offset_,
+               kNoChecksum, metaindex_block_handle);
+  io_status_ = file_->Append(footer.GetSlice());
+  if (io_status_.ok()) {
+    offset_ += footer.GetSlice().size();
+  }
+  status_ = io_status_.status();
+  return status_.Clone();
+}
+
+void LogHashTableBuilder::Abandon() {
+  assert(!closed_);
+  closed_ = true;
+}
+
+uint64_t LogHashTableBuilder::NumEntries() const {
+  return properties_.num_entries;
+}
+
+uint64_t LogHashTableBuilder::FileSize() const {
+  if (closed_) {
+    return offset_;
+  }
+  // Account for the index written by Finish(), so that compactions cut their
+  // output files at the target size.
+  return offset_ + NumBuckets() * kLogHashTableBucketSize +
+         restarts_.size() * sizeof(uint32_t);
+}
+
+std::string LogHashTableBuilder::GetFileChecksum() const {
+  if (file_ != nullptr) {
+    return file_->GetFileChecksum();
+  } else {
+    return kUnknownFileChecksum;
+  }
+}
+
+const char* LogHashTableBuilder::GetFileChecksumFuncName() const {
+  if (file_ != nullptr) {
+    return file_->GetFileChecksumFuncName();
+  } else {
+    return kUnknownFileChecksumFuncName;
+  }
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,126 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb-rs/src/status.rs.h"
+#include "rocksdb/table.h"
+#include "rocksdb/table_properties.h"
+#include "table/table_builder.h"
+
+namespace rocksdb {
+
+// Size of a bucket of the hash table: fingerprint, offset and size
+const uint32_t kLogHashTableBucketSize = 12;
+
+class LogHashTableBuilder : public TableBuilder {
+ public:
+  LogHashTableBuilder(
+      const ImmutableOptions& ioptions,
+      const IntTblPropCollectorFactories* int_tbl_prop_collector_factories,
+      uint32_t column_family_id, int level_at_creation,
+      WritableFileWriter* file, double hash_table_ratio,
+      uint32_t restart_interval, const std::string& column_family_name,
+      const std::string& db_id = "", const std::string& db_session_id = "",
+      uint64_t file_number = 0);
+  // No copying allowed
+  LogHashTableBuilder(const LogHashTableBuilder&) = delete;
+  void operator=(const LogHashTableBuilder&) = delete;
+
+  // REQUIRES: Either Finish() or Abandon() has been called.
+  ~LogHashTableBuilder() {}
+
+  // Add key,value to the table being constructed.
+  // REQUIRES: key is after any previously added key according to comparator.
+  // REQUIRES: Finish(), Abandon() have not been called
+  void Add(const Slice& key, const Slice& value) override;
+
+  // Return non-ok iff some error has been detected.
+  rocksdb_rs::status::Status status() const override { return status_.Clone(); }
+
+  // Return non-ok iff some error happens during IO.
+  rocksdb_rs::io_status::IOStatus io_status() const override {
+    return io_status_.Clone();
+  }
+
+  // Finish building the table.  Stops using the file passed to the
+  // constructor after this function returns.
+  // REQUIRES: Finish(), Abandon() have not been called
+  rocksdb_rs::status::Status Finish() override;
+
+  // Indicate that the contents of this builder should be abandoned.  Stops
+  // using the file passed to the constructor after this function returns.
+  // If the caller is not going to call Finish(), it must call Abandon()
+  // before destroying this builder.
+  // REQUIRES: Finish(), Abandon() have not been called
+  void Abandon() override;
+
+  // Number of calls to Add() so far.
+  uint64_t NumEntries() const override;
+
+  // Size of the file generated so far, including the hash table that
+  // Finish() will write.  If invoked after a successful Finish() call,
+  // returns the size of the final generated file.
+  uint64_t FileSize() const override;
+
+  TableProperties GetTableProperties() const override {
+    TableProperties ret = properties_;
+    for (const auto& collector : table_properties_collectors_) {
+      for (const auto& prop : collector->GetReadableProperties()) {
+        ret.readable_properties.insert(prop);
+      }
+      collector->Finish(&ret.user_collected_properties);
+    }
+    return ret;
+  }
+
+  // Get file checksum
+  std::string GetFileChecksum() const override;
+
+  // Get file checksum function name
+  const char* GetFileChecksumFuncName() const override;
+
+  // Name of the meta block holding the hash table and the restart points
+  static const std::string kIndexBlock;
+
+ private:
+  // The versions of a user key in the log
+  struct KeyRange {
+    uint64_t hash;
+    uint32_t offset;
+    uint32_t size;
+  };
+
+  // Appends the range of the current user key to key_ranges_
+  void FinishKeyRange();
+  uint64_t NumBuckets() const;
+  std::string BuildIndexBlock() const;
+
+  const ImmutableOptions& ioptions_;
+  std::vector<std::unique_ptr<IntTblPropCollector>>
+      table_properties_collectors_;
+  WritableFileWriter* file_;
+  const double hash_table_ratio_;
+  const uint32_t restart_interval_;
+  uint64_t offset_ = 0;
+  std::vector<KeyRange> key_ranges_;
+  std::vector<uint32_t> restarts_;
+  // The user key of the last added entry and the start of its versions
+  std::string last_user_key_;
+  uint64_t last_user_key_offset_ = 0;
+  rocksdb_rs::status::Status status_;
+  rocksdb_rs::io_status::IOStatus io_status_ =
+      rocksdb_rs::io_status::IOStatus_new();
+  TableProperties properties_;
+
+  bool closed_ = false;  // Either Finish() or Abandon() has been called.
+};
+
+}  // namespace rocksdb
@@ -0,0 +1,97 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/log_hash/log_hash_table_factory.h"
+
+#include "db/dbformat.h"
+#include "options/configurable_helper.h"
+#include "rocksdb/utilities/options_type.h"
+#include "table/log_hash/log_hash_table_builder.h"
+#include "table/log_hash/log_hash_table_reader.h"
+
+namespace rocksdb {
+
+static std::unordered_map<std::string, OptionTypeInfo>
+    log_hash_table_type_info = {
+        {"hash_table_ratio",
+         {offsetof(struct LogHashTableOptions, hash_table_ratio),
+          rocksdb_rs::utilities::options_type::OptionType::kDouble,
+          rocksdb_rs::utilities::options_type::OptionVerificationType::kNormal,
+          rocksdb_rs::utilities::options_type::OptionTypeFlags::kNone}},
+        {"restart_interval",
+         {offsetof(struct LogHashTableOptions, restart_interval),
+          rocksdb_rs::utilities::options_type::OptionType::kUInt32T,
+          rocksdb_rs::utilities::options_type::OptionVerificationType::kNormal,
+          rocksdb_rs::utilities::options_type::OptionTypeFlags::kNone}},
+};
+
+LogHashTableFactory::LogHashTableFactory(
+    const LogHashTableOptions& table_options)
+    : table_options_(table_options) {
+  RegisterOptions(&table_options_, &log_hash_table_type_info);
+}
+
+rocksdb_rs::status::Status LogHashTableFactory::NewTableReader(
+    const ReadOptions& /*ro*/, const TableReaderOptions& table_reader_options,
+    std::unique_ptr<RandomAccessFileReader>&& file, uint64_t file_size,
+    std::unique_ptr<TableReader>* table,
+    bool /*prefetch_index_and_filter_in_cache*/) const {
+  return LogHashTableReader::Open(
+      table_reader_options.ioptions, table_reader_options.env_options,
+      table_reader_options.internal_comparator, std::move(file), file_size,
+      table);
+}
+
+TableBuilder* LogHashTableFactory::NewTableBuilder(
+    const TableBuilderOptions& table_builder_options,
+    WritableFileWriter* file) const {
+  return new LogHashTableBuilder(
+      table_builder_options.ioptions,
+      table_builder_options.int_tbl_prop_collector_factories,
+      table_builder_options.column_family_id,
+      table_builder_options.level_at_creation, file,
+      table_options_.hash_table_ratio, table_options_.restart_interval,
+      table_builder_options.column_family_name, table_builder_options.db_id,
+      table_builder_options.db_session_id, table_builder_options.cur_file_num);
+}
+
+rocksdb_rs::status::Status LogHashTableFactory::ValidateOptions(
+    const DBOptions& db_opts, const ColumnFamilyOptions& cf_opts) const {
+  if (!(table_options_.hash_table_ratio > 0 &&
+        table_options_.hash_table_ratio <= 1)) {
+    return rocksdb_rs::status::Status_InvalidArgument(
+        "LogHashTable hash_table_ratio should be in (0, 1]");
+  }
+  if (table_options_.restart_interval == 0) {
+    return rocksdb_rs::status::Status_InvalidArgument(
+        "LogHashTable restart_interval should be greater than 0");
+  }
+  if (cf_opts.comparator->timestamp_size() > 0) {
+    return rocksdb_rs::status::Status_NotSupported(
+        "LogHashTable does not support user-defined timestamps");
+  }
+  return TableFactory::ValidateOptions(db_opts, cf_opts);
+}
+
+std::string LogHashTableFactory::GetPrintableOptions() const {
+  std::string ret;
+  ret.reserve(2000);
+  const int kBufferSize = 200;
+  char buffer[kBufferSize];
+
+  snprintf(buffer, kBufferSize, "  hash_table_ratio: %lf\n",
+           table_options_.hash_table_ratio);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  restart_interval: %u\n",
+           table_options_.restart_interval);
+  ret.append(buffer);
+  return ret;
+}
+
+TableFactory* NewLogHashTableFactory(const LogHashTableOptions& table_options) {
+  return new LogHashTableFactory(table_options);
+}
+
+}  // namespace rocksdb
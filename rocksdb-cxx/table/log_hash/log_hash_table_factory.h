@@ -0,0 +1,70 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "rocksdb/options.h"
+#include "rocksdb/table.h"
+
+namespace rocksdb {
+
+// Log Hash Table is designed for column families that are only read by point
+// lookups, e.g. metadata. See LogHashTableOptions for the format.
+//
+// File layout:
+//   [log: record 0 .. record N-1]
+//   [meta block: index]
+//   [meta block: properties]
+//   [metaindex block]
+//   [footer]
+//
+// A record is varint32(internal key size), varint32(value size), internal
+// key, value. Records are in internal key order, so all the versions of a user
+// key are contiguous, newest first.
+//
+// The index block is the hash table, num_buckets fixed size buckets, followed
+// by the restart points of the log, and two fixed32: num_buckets and
+// num_restarts. A bucket is fixed32 fingerprint of the user key, fixed32
+// offset and fixed32 size of the versions of the user key in the log, or all
+// zeros when empty. Collisions are resolved by linear probing.
+class LogHashTableFactory : public TableFactory {
+ public:
+  explicit LogHashTableFactory(
+      const LogHashTableOptions& table_options = LogHashTableOptions());
+  ~LogHashTableFactory() {}
+
+  // Method to allow CheckedCast to work for this class
+  static const char* kClassName() { return kLogHashTableName(); }
+  const char* Name() const override { return kLogHashTableName(); }
+
+  using TableFactory::NewTableReader;
+  rocksdb_rs::status::Status NewTableReader(
+      const ReadOptions& ro, const TableReaderOptions& table_reader_options,
+      std::unique_ptr<RandomAccessFileReader>&& file, uint64_t file_size,
+      std::unique_ptr<TableReader>* table,
+      bool prefetch_index_and_filter_in_cache = true) const override;
+
+  TableBuilder* NewTableBuilder(
+      const TableBuilderOptions& table_builder_options,
+      WritableFileWriter* file) const override;
+
+  rocksdb_rs::status::Status ValidateOptions(
+      const DBOptions& db_opts,
+      const ColumnFamilyOptions& cf_opts) const override;
+
+  std::string GetPrintableOptions() const override;
+
+  // Range tombstones cannot be stored in the log, so DeleteRange() is
+  // rejected by the write path for the column families using this table.
+  bool IsDeleteRangeSupported() const override { return false; }
+
+ private:
+  LogHashTableOptions table_options_;
+};
+
+}  // namespace rocksdb
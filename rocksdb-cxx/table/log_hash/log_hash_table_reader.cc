@@ -0,0 +1,523 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/log_hash/log_hash_table_reader.h"
+
+#include <algorithm>
+#include <string>
+
+#include "memory/arena.h"
+#include "options/cf_options.h"
+#include "table/block_based/block_type.h"
+#include "table/format.h"
+#include "table/get_context.h"
+#include "table/internal_iterator.h"
+#include "table/log_hash/log_hash_table_builder.h"
+#include "table/meta_blocks.h"
+#include "util/coding.h"
+#include "util/fastrange.h"
+#include "util/hash.h"
+
+namespace rocksdb {
+
+extern const uint64_t kLogHashTableMagicNumber;
+
+namespace {
+
+// Two varint32
+const size_t kMaxRecordHeaderSize = 10;
+const size_t kDefaultReadaheadSize = 32 * 1024;
+
+// Decodes the record at `p`. Returns the end of the record, or nullptr if it
+// is corrupted or goes past `limit`.
+const char* DecodeRecord(const char* p, const char* limit, Slice* internal_key,
+                         Slice* value) {
+  uint32_t key_size = 0;
+  uint32_t value_size = 0;
+  p = rocksdb_rs::coding::GetVarint32Ptr(p, limit, &key_size);
+  if (p != nullptr) {
+    p = rocksdb_rs::coding::GetVarint32Ptr(p, limit, &value_size);
+  }
+  if (p == nullptr || key_size < kNumInternalBytes ||
+      static_cast<uint64_t>(limit - p) < uint64_t{key_size} + value_size) {
+    return nullptr;
+  }
+  *internal_key = Slice(p, key_size);
+  *value = Slice(p + key_size, value_size);
+  return p + key_size + value_size;
+}
+
+}  // namespace
+
+LogHashTableReader::LogHashTableReader(
+    const InternalKeyComparator& internal_comparator,
+    std::unique_ptr<RandomAccessFileReader>&& file, bool is_mmap_mode)
+    : internal_comparator_(internal_comparator),
+      file_(std::move(file)),
+      is_mmap_mode_(is_mmap_mode) {}
+
+rocksdb_rs::status::Status LogHashTableReader::Open(
+    const ImmutableOptions& ioptions, const EnvOptions& env_options,
+    const InternalKeyComparator& internal_comparator,
+    std::unique_ptr<RandomAccessFileReader>&& file, uint64_t file_size,
+    std::unique_ptr<TableReader>* table_reader) {
+  std::unique_ptr<TableProperties> props;
+  // TODO: plumb Env::IOActivity
+  const ReadOptions read_options;
+  auto s = ReadTableProperties(file.get(), file_size, kLogHashTableMagicNumber,
+                               ioptions, read_options, &props);
+  if (!s.ok()) {
+    return s;
+  }
+  if (props->data_size > file_size) {
+    return rocksdb_rs::status::Status_Corruption(
+        "LogHashTable log is larger than the file");
+  }
+
+  std::unique_ptr<LogHashTableReader> new_reader(new LogHashTableReader(
+      internal_comparator, std::move(file), env_options.use_mmap_reads));
+  new_reader->data_size_ = props->data_size;
+  if (new_reader->is_mmap_mode_) {
+    // Get mmapped memory.
+    s = new_reader->file_
+            ->Read(IOOptions(), 0, static_cast<size_t>(file_size),
+                   &new_reader->file_data_, nullptr, nullptr,
+                   Env::IO_TOTAL /* rate_limiter_priority */)
+            .status();
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  s = new_reader->ReadIndex(ioptions, file_size);
+  if (!s.ok()) {
+    return s;
+  }
+  new_reader->table_props_ = std::move(props);
+
+  *table_reader = std::move(new_reader);
+  return s;
+}
+
+rocksdb_rs::status::Status LogHashTableReader::ReadIndex(
+    const ImmutableOptions& ioptions, uint64_t file_size) {
+  BlockContents index_block_contents;
+  // TODO: plumb Env::IOActivity
+  const ReadOptions read_options;
+  rocksdb_rs::status::Status s = ReadMetaBlock(
+      file_.get(), nullptr /* prefetch_buffer */, file_size,
+      kLogHashTableMagicNumber, ioptions, read_options,
+      LogHashTableBuilder::kIndexBlock, BlockType::kIndex,
+      &index_block_contents);
+  if (!s.ok()) {
+    return s;
+  }
+  // In non-mmap mode, it holds the allocated memory of the index block, which
+  // needs to be kept alive to keep buckets_ and restarts_ valid.
+  index_block_alloc_ = std::move(index_block_contents.allocation);
+  const Slice index_block = index_block_contents.data;
+  if (index_block.size() < 2 * sizeof(uint32_t)) {
+    return rocksdb_rs::status::Status_Corruption(
+        "LogHashTable index block is too small");
+  }
+  const char* footer =
+      index_block.data() + index_block.size() - 2 * sizeof(uint32_t);
+  num_buckets_ = rocksdb_rs::coding_lean::DecodeFixed32(footer);
+  num_restarts_ = rocksdb_rs::coding_lean::DecodeFixed32(footer + 4);
+  if (num_buckets_ == 0 ||
+      uint64_t{num_buckets_} * kLogHashTableBucketSize +
+              uint64_t{num_restarts_} * sizeof(uint32_t) +
+              2 * sizeof(uint32_t) !=
+          index_block.size()) {
+    return rocksdb_rs::status::Status_Corruption(
+        "Bad LogHashTable index block");
+  }
+  buckets_ = index_block.data();
+  restarts_ = buckets_ + uint64_t{num_buckets_} * kLogHashTableBucketSize;
+  return rocksdb_rs::status::Status_OK();
+}
+
+rocksdb_rs::status::Status LogHashTableReader::ReadLog(uint64_t offset,
+                                                       size_t n,
+                                                       ReadBuffer* buf,
+                                                       Slice* result) const {
+  assert(n > 0 && offset + n <= data_size_);
+  if (is_mmap_mode_) {
+    *result = Slice(file_data_.data() + offset, n);
+    return rocksdb_rs::status::Status_OK();
+  }
+  if (offset >= buf->offset && offset + n <= buf->offset + buf->data.size()) {
+    *result = Slice(buf->data.data() + (offset - buf->offset), n);
+    return rocksdb_rs::status::Status_OK();
+  }
+  const size_t read_size = static_cast<size_t>(std::min<uint64_t>(
+      std::max(n, buf->readahead_size), data_size_ - offset));
+  buf->data.resize(read_size);
+  Slice read;
+  rocksdb_rs::io_status::IOStatus io_s =
+      file_->Read(IOOptions(), offset, read_size, &read, &buf->data[0],
+                  nullptr /* aligned_buf */,
+                  Env::IO_TOTAL /* rate_limiter_priority */);
+  if (!io_s.ok() || read.size() < n) {
+    buf->data.clear();
+    if (!io_s.ok()) {
+      return io_s.status();
+    }
+    return rocksdb_rs::status::Status_Corruption(
+        "Truncated read of LogHashTable log");
+  }
+  if (read.data() != buf->data.data()) {
+    buf->data.assign(read.data(), read.size());
+  } else {
+    buf->data.resize(read.size());
+  }
+  buf->offset = offset;
+  *result = Slice(buf->data.data(), n);
+  return rocksdb_rs::status::Status_OK();
+}
+
+rocksdb_rs::status::Status LogHashTableReader::ReadRecord(
+    uint64_t offset, ReadBuffer* buf, Slice* internal_key, Slice* value,
+    uint64_t* next_offset) const {
+  if (offset >= data_size_) {
+    return rocksdb_rs::status::Status_Corruption(
+        "Bad record offset in LogHashTable");
+  }
+  Slice header;
+  rocksdb_rs::status::Status s =
+      ReadLog(offset,
+              static_cast<size_t>(std::min<uint64_t>(kMaxRecordHeaderSize,
+                                                     data_size_ - offset)),
+              buf, &header);
+  if (!s.ok()) {
+    return s;
+  }
+  uint32_t key_size = 0;
+  uint32_t value_size = 0;
+  const char* limit = header.data() + header.size();
+  const char* p =
+      rocksdb_rs::coding::GetVarint32Ptr(header.data(), limit, &key_size);
+  if (p != nullptr) {
+    p = rocksdb_rs::coding::GetVarint32Ptr(p, limit, &value_size);
+  }
+  if (p == nullptr) {
+    return rocksdb_rs::status::Status_Corruption("Bad record in LogHashTable");
+  }
+  const uint64_t record_size =
+      static_cast<uint64_t>(p - header.data()) + key_size + value_size;
+  if (record_size > data_size_ - offset) {
+    return rocksdb_rs::status::Status_Corruption("Bad record in LogHashTable");
+  }
+  Slice record;
+  s = ReadLog(offset, static_cast<size_t>(record_size), buf, &record);
+  if (!s.ok()) {
+    return s;
+  }
+  if (DecodeRecord(record.data(), record.data() + record.size(), internal_key,
+                   value) == nullptr) {
+    return rocksdb_rs::status::Status_Corruption("Bad record in LogHashTable");
+  }
+  *next_offset = offset + record_size;
+  return rocksdb_rs::status::Status_OK();
+}
+
+uint32_t LogHashTableReader::GetRestart(uint32_t restart_index) const {
+  assert(restart_index < num_restarts_);
+  return rocksdb_rs::coding_lean::DecodeFixed32(
+      restarts_ + uint64_t{restart_index} * sizeof(uint32_t));
+}
+
+rocksdb_rs::status::Status LogHashTableReader::FindRestart(
+    const Slice& target, ReadBuffer* buf, uint32_t* restart_index) const {
+  uint32_t left = 0;
+  uint32_t right = num_restarts_ > 0 ? num_restarts_ - 1 : 0;
+  while (left < right) {
+    const uint32_t mid = left + (right - left + 1) / 2;
+    Slice internal_key;
+    Slice value;
+    uint64_t next_offset = 0;
+    rocksdb_rs::status::Status s =
+        ReadRecord(GetRestart(mid), buf, &internal_key, &value, &next_offset);
+    if (!s.ok()) {
+      return s;
+    }
+    if (internal_comparator_.Compare(internal_key, target) < 0) {
+      left = mid;
+    } else {
+      right = mid - 1;
+    }
+  }
+  *restart_index = left;
+  return rocksdb_rs::status::Status_OK();
+}
+
+rocksdb_rs::status::Status LogHashTableReader::Get(
+    const ReadOptions& /*readOptions*/, const Slice& key,
+    GetContext* get_context, const SliceTransform* /* prefix_extractor */,
+    bool /*skip_filters*/) {
+  const Slice user_key = ExtractUserKey(key);
+  const uint64_t hash = GetSliceHash64(user_key);
+  const uint32_t fingerprint = Lower32of64(hash);
+  uint32_t bucket_id = static_cast<uint32_t>(
+      rocksdb_rs::util::fastrange::FastRange64(hash, num_buckets_));
+  for (uint32_t probes = 0; probes < num_buckets_; ++probes) {
+    const char* bucket =
+        buckets_ + uint64_t{bucket_id} * kLogHashTableBucketSize;
+    const uint32_t size = rocksdb_rs::coding_lean::DecodeFixed32(bucket + 8);
+    if (size == 0) {
+      // Empty bucket, the key is not in the table
+      return rocksdb_rs::status::Status_OK();
+    }
+    if (rocksdb_rs::coding_lean::DecodeFixed32(bucket) == fingerprint) {
+      const uint32_t offset =
+          rocksdb_rs::coding_lean::DecodeFixed32(bucket + 4);
+      if (uint64_t{offset} + size > data_size_) {
+        return rocksdb_rs::status::Status_Corruption(
+            "Bad bucket in LogHashTable");
+      }
+      // All the versions of the user key at once
+      ReadBuffer buf;
+      Slice versions;
+      rocksdb_rs::status::Status s = ReadLog(offset, size, &buf, &versions);
+      if (!s.ok()) {
+        return s;
+      }
+      const char* p = versions.data();
+      const char* limit = p + versions.size();
+      Slice internal_key;
+      Slice value;
+      p = DecodeRecord(p, limit, &internal_key, &value);
+      if (p == nullptr) {
+        return rocksdb_rs::status::Status_Corruption(
+            "Bad record in LogHashTable");
+      }
+      if (ExtractUserKey(internal_key) == user_key) {
+        // Skip the versions newer than the snapshot of the lookup
+        while (internal_comparator_.Compare(internal_key, key) < 0) {
+          if (p == limit) {
+            return rocksdb_rs::status::Status_OK();
+          }
+          p = DecodeRecord(p, limit, &internal_key, &value);
+          if (p == nullptr) {
+            return rocksdb_rs::status::Status_Corruption(
+                "Bad record in LogHashTable");
+          }
+        }
+        while (true) {
+          ParsedInternalKey parsed_key;
+          s = ParseInternalKey(internal_key, &parsed_key,
+                               false /* log_err_key */);
+          if (!s.ok()) {
+            return s;
+          }
+          bool matched = false;
+          if (!get_context->SaveValue(parsed_key, value, &matched) ||
+              p == limit) {
+            return rocksdb_rs::status::Status_OK();
+          }
+          p = DecodeRecord(p, limit, &internal_key, &value);
+          if (p == nullptr) {
+            return rocksdb_rs::status::Status_Corruption(
+                "Bad record in LogHashTable");
+          }
+        }
+      }
+    }
+    if (++bucket_id == num_buckets_) {
+      bucket_id = 0;
+    }
+  }
+  return rocksdb_rs::status::Status_OK();
+}
+
+void LogHashTableReader::Prepare(const Slice& target) {
+  // Prefetch the first bucket of the key.
+  const uint64_t hash = GetSliceHash64(ExtractUserKey(target));
+  PREFETCH(buckets_ +
+               rocksdb_rs::util::fastrange::FastRange64(hash, num_buckets_) *
+                   kLogHashTableBucketSize,
+           0, 3);
+}
+
+uint64_t LogHashTableReader::ApproximateOffsetOf(
+    const ReadOptions& /*read_options*/, const Slice& key,
+    TableReaderCaller /*caller*/) {
+  if (num_restarts_ == 0) {
+    return 0;
+  }
+  ReadBuffer buf;
+  uint32_t restart_index = 0;
+  if (!FindRestart(key, &buf, &restart_index).ok()) {
+    return 0;
+  }
+  return GetRestart(restart_index);
+}
+
+uint64_t LogHashTableReader::ApproximateSize(const ReadOptions& read_options,
+                                             const Slice& start,
+                                             const Slice& end,
+                                             TableReaderCaller caller) {
+  const uint64_t start_offset =
+      ApproximateOffsetOf(read_options, start, caller);
+  const uint64_t end_offset = ApproximateOffsetOf(read_options, end, caller);
+  return end_offset >= start_offset ? end_offset - start_offset : 0;
+}
+
+size_t LogHashTableReader::ApproximateMemoryUsage() const {
+  // Only the index is loaded in memory, and not at all in mmap mode
+  return index_block_alloc_ ? static_cast<size_t>(table_props_->index_size)
+                            : 0;
+}
+
+// Iterator over the log, in key order. It binary searches the restart points
+// of the log to seek, and reads ahead when not in mmap mode.
+class LogHashTableIterator : public InternalIterator {
+ public:
+  LogHashTableIterator(const LogHashTableReader* reader,
+                       size_t readahead_size)
+      : reader_(reader),
+        offset_(reader->data_size_),
+        status_(rocksdb_rs::status::Status_OK()) {
+    buf_.readahead_size = readahead_size;
+  }
+  // No copying allowed
+  LogHashTableIterator(const LogHashTableIterator&) = delete;
+  void operator=(const Iterator&) = delete;
+  ~LogHashTableIterator() override {}
+
+  bool Valid() const override { return offset_ < reader_->data_size_; }
+
+  void SeekToFirst() override { ReadAt(0); }
+
+  void SeekToLast() override {
+    if (reader_->num_restarts_ == 0) {
+      ReadAt(reader_->data_size_);
+      return;
+    }
+    ReadAt(reader_->GetRestart(reader_->num_restarts_ - 1));
+    while (Valid() && next_offset_ < reader_->data_size_) {
+      ReadAt(next_offset_);
+    }
+  }
+
+  void Seek(const Slice& target) override {
+    if (reader_->num_restarts_ == 0) {
+      ReadAt(reader_->data_size_);
+      return;
+    }
+    uint32_t restart_index = 0;
+    status_ = reader_->FindRestart(target, &buf_, &restart_index);
+    if (!status_.ok()) {
+      offset_ = reader_->data_size_;
+      return;
+    }
+    ReadAt(reader_->GetRestart(restart_index));
+    while (Valid() &&
+           reader_->internal_comparator_.Compare(key_, target) < 0) {
+      ReadAt(next_offset_);
+    }
+  }
+
+  void SeekForPrev(const Slice& target) override {
+    Seek(target);
+    if (!Valid() && status_.ok()) {
+      SeekToLast();
+    }
+    while (Valid() &&
+           reader_->internal_comparator_.Compare(key_, target) > 0) {
+      Prev();
+    }
+  }
+
+  void Next() override {
+    assert(Valid());
+    ReadAt(next_offset_);
+  }
+
+  void Prev() override {
+    assert(Valid());
+    const uint64_t target = offset_;
+    // Scan from the last restart point before the current record
+    uint32_t left = 0;
+    uint32_t right = reader_->num_restarts_;
+    while (left < right) {
+      const uint32_t mid = left + (right - left) / 2;
+      if (reader_->GetRestart(mid) < target) {
+        left = mid + 1;
+      } else {
+        right = mid;
+      }
+    }
+    if (left == 0) {
+      offset_ = reader_->data_size_;
+      return;
+    }
+    ReadAt(reader_->GetRestart(left - 1));
+    while (Valid() && next_offset_ < target) {
+      ReadAt(next_offset_);
+    }
+  }
+
+  Slice key() const override {
+    assert(Valid());
+    return key_;
+  }
+
+  Slice value() const override {
+    assert(Valid());
+    return value_;
+  }
+
+  rocksdb_rs::status::Status status() const override {
+    return status_.Clone();
+  }
+
+ private:
+  // Positions the iterator at the record at `offset`, or invalidates it at
+  // the end of the log or on errors.
+  void ReadAt(uint64_t offset) {
+    status_ = rocksdb_rs::status::Status_OK();
+    offset_ = offset;
+    if (offset_ >= reader_->data_size_) {
+      offset_ = reader_->data_size_;
+      return;
+    }
+    status_ = reader_->ReadRecord(offset_, &buf_, &key_, &value_,
+                                  &next_offset_);
+    if (!status_.ok()) {
+      offset_ = reader_->data_size_;
+    }
+  }
+
+  const LogHashTableReader* reader_;
+  LogHashTableReader::ReadBuffer buf_;
+  // Offset of the current record in the log, or the size of the log when
+  // invalid
+  uint64_t offset_;
+  uint64_t next_offset_ = 0;
+  Slice key_;
+  Slice value_;
+  rocksdb_rs::status::Status status_;
+};
+
+InternalIterator* LogHashTableReader::NewIterator(
+    const ReadOptions& /*read_options*/,
+    const SliceTransform* /* prefix_extractor */, Arena* arena,
+    bool /*skip_filters*/, TableReaderCaller caller,
+    size_t compaction_readahead_size, bool /* allow_unprepared_value */) {
+  const size_t readahead_size = (caller == TableReaderCaller::kCompaction &&
+                                 compaction_readahead_size > 0)
+                                    ? compaction_readahead_size
+                                    : kDefaultReadaheadSize;
+  LogHashTableIterator* iter;
+  if (arena == nullptr) {
+    iter = new LogHashTableIterator(this, readahead_size);
+  } else {
+    auto iter_mem = arena->AllocateAligned(sizeof(LogHashTableIterator));
+    iter = new (iter_mem) LogHashTableIterator(this, readahead_size);
+  }
+  return iter;
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,114 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+#include <memory>
+#include <string>
+
+#include "db/dbformat.h"
+#include "file/random_access_file_reader.h"
+#include "memory/memory_allocator_impl.h"
+#include "rocksdb/env.h"
+#include "rocksdb/options.h"
+#include "table/table_reader.h"
+
+namespace rocksdb {
+
+class Arena;
+struct ImmutableOptions;
+
+// Reader of the tables written by LogHashTableBuilder. See
+// LogHashTableFactory for the format.
+class LogHashTableReader : public TableReader {
+ public:
+  static rocksdb_rs::status::Status Open(
+      const ImmutableOptions& ioptions, const EnvOptions& env_options,
+      const InternalKeyComparator& internal_comparator,
+      std::unique_ptr<RandomAccessFileReader>&& file, uint64_t file_size,
+      std::unique_ptr<TableReader>* table_reader);
+
+  ~LogHashTableReader() {}
+
+  std::shared_ptr<const TableProperties> GetTableProperties() const override {
+    return table_props_;
+  }
+
+  // Reads at most the versions of the user key of `key`, with a single read
+  // of the file or none in mmap mode.
+  rocksdb_rs::status::Status Get(const ReadOptions& readOptions,
+                                 const Slice& key, GetContext* get_context,
+                                 const SliceTransform* prefix_extractor,
+                                 bool skip_filters = false) override;
+
+  // Returns a new iterator over table contents
+  InternalIterator* NewIterator(const ReadOptions&,
+                                const SliceTransform* prefix_extractor,
+                                Arena* arena, bool skip_filters,
+                                TableReaderCaller caller,
+                                size_t compaction_readahead_size = 0,
+                                bool allow_unprepared_value = false) override;
+
+  void Prepare(const Slice& target) override;
+
+  uint64_t ApproximateOffsetOf(const ReadOptions& read_options,
+                               const Slice& key,
+                               TableReaderCaller caller) override;
+
+  uint64_t ApproximateSize(const ReadOptions& read_options, const Slice& start,
+                           const Slice& end, TableReaderCaller caller) override;
+
+  void SetupForCompaction() override {}
+
+  // Report an approximation of how much memory has been used.
+  size_t ApproximateMemoryUsage() const override;
+
+ private:
+  friend class LogHashTableIterator;
+
+  // Buffer of the reads of the log, reused for sequential reads when not in
+  // mmap mode
+  struct ReadBuffer {
+    std::string data;
+    uint64_t offset = 0;
+    size_t readahead_size = 0;
+  };
+
+  LogHashTableReader(const InternalKeyComparator& internal_comparator,
+                     std::unique_ptr<RandomAccessFileReader>&& file,
+                     bool is_mmap_mode);
+
+  rocksdb_rs::status::Status ReadIndex(const ImmutableOptions& ioptions,
+                                       uint64_t file_size);
+  // Sets `result` to the `n` bytes of the log at `offset`, which stay valid
+  // until the next read into `buf`.
+  rocksdb_rs::status::Status ReadLog(uint64_t offset, size_t n,
+                                     ReadBuffer* buf, Slice* result) const;
+  // Reads the record of the log at `offset`
+  rocksdb_rs::status::Status ReadRecord(uint64_t offset, ReadBuffer* buf,
+                                        Slice* internal_key, Slice* value,
+                                        uint64_t* next_offset) const;
+  // Returns the index of the last restart point whose key is before `target`,
+  // or 0 when there is none.
+  rocksdb_rs::status::Status FindRestart(const Slice& target, ReadBuffer* buf,
+                                         uint32_t* restart_index) const;
+  uint32_t GetRestart(uint32_t restart_index) const;
+
+  const InternalKeyComparator& internal_comparator_;
+  std::unique_ptr<RandomAccessFileReader> file_;
+  const bool is_mmap_mode_;
+  // The whole file in mmap mode
+  Slice file_data_;
+  // Size of the log, at the start of the file
+  uint64_t data_size_ = 0;
+  // Holds the index block when not in mmap mode
+  CacheAllocationPtr index_block_alloc_;
+  const char* buckets_ = nullptr;
+  uint32_t num_buckets_ = 0;
+  const char* restarts_ = nullptr;
+  uint32_t num_restarts_ = 0;
+  std::shared_ptr<const TableProperties> table_props_;
+};
+
+}  // namespace rocksdb
@@ -115,6 +115,14 @@ void PropertyBlockBuilder::AddTableProperty(const TableProperties& props) {
     Add(TablePropertiesNames::kFastCompressionEstimatedDataSize,
         props.fast_compression_estimated_data_size);
   }
+  if (props.num_adaptive_fast_data_blocks > 0) {
+    Add(TablePropertiesNames::kNumAdaptiveFastDataBlocks,
+        props.num_adaptive_fast_data_blocks);
+  }
+  if (props.num_adaptive_uncompressed_data_blocks > 0) {
+    Add(TablePropertiesNames::kNumAdaptiveUncompressedDataBlocks,
+        props.num_adaptive_uncompressed_data_blocks);
+  }
   Add(TablePropertiesNames::kTailStartOffset, props.tail_start_offset);
   if (props.user_defined_timestamps_persisted == 0) {
     Add(TablePropertiesNames::kUserDefinedTimestampsPersisted,
@@ -314,6 +322,10 @@ rocksdb_rs::status::Status ReadTablePropertiesHelper(
        &new_table_properties->slow_compression_estimated_data_size},
       {TablePropertiesNames::kFastCompressionEstimatedDataSize,
        &new_table_properties->fast_compression_estimated_data_size},
+      {TablePropertiesNames::kNumAdaptiveFastDataBlocks,
+       &new_table_properties->num_adaptive_fast_data_blocks},
+      {TablePropertiesNames::kNumAdaptiveUncompressedDataBlocks,
+       &new_table_properties->num_adaptive_uncompressed_data_blocks},
       {TablePropertiesNames::kTailStartOffset,
        &new_table_properties->tail_start_offset},
       {TablePropertiesNames::kUserDefinedTimestampsPersisted,
@@ -41,6 +41,10 @@ struct KeyContext {
   PinnableWideColumns* columns;
   std::string* timestamp;
   GetContext* get_context;
+  // GetSliceHash64() of ukey_without_ts, computed by the first whole key
+  // filter the key is checked against, and reused by the next ones
+  uint64_t filter_hash;
+  bool filter_hash_valid;
 
   KeyContext(ColumnFamilyHandle* col_family, const Slice& user_key,
              PinnableSlice* val, PinnableWideColumns* cols, std::string* ts,
@@ -56,7 +60,9 @@ struct KeyContext {
         value(val),
         columns(cols),
         timestamp(ts),
-        get_context(nullptr) {}
+        get_context(nullptr),
+        filter_hash(0),
+        filter_hash_valid(false) {}
 };
 
 // The MultiGetContext class is a container for the sorted list of keys that
@@ -69,6 +69,7 @@ extern const uint64_t kBlockBasedTableMagicNumber;
 extern const uint64_t kLegacyBlockBasedTableMagicNumber;
 extern const uint64_t kPlainTableMagicNumber;
 extern const uint64_t kLegacyPlainTableMagicNumber;
+extern const uint64_t kLogHashTableMagicNumber;
 
 const char* testFileName = "test_file_name";
 
@@ -431,6 +432,11 @@ rocksdb_rs::status::Status SstFileDumper::SetTableOptionsByMagicNumber(
     if (!silent_) {
       fprintf(stdout, "Sst file format: plain table\n");
     }
+  } else if (table_magic_number == kLogHashTableMagicNumber) {
+    options_.table_factory.reset(NewLogHashTableFactory());
+    if (!silent_) {
+      fprintf(stdout, "Sst file format: log hash table\n");
+    }
   } else {
     char error_msg_buffer[80];
     snprintf(error_msg_buffer, sizeof(error_msg_buffer) - 1,
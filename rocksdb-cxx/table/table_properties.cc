@@ -150,6 +150,13 @@ std::string TableProperties::ToString(const std::string& prop_delim,
                  slow_compression_estimated_data_size, prop_delim, kv_delim);
   AppendProperty(result, "fast compression estimated data size",
                  fast_compression_estimated_data_size, prop_delim, kv_delim);
+  if (num_adaptive_fast_data_blocks > 0 ||
+      num_adaptive_uncompressed_data_blocks > 0) {
+    AppendProperty(result, "# adaptive fast data blocks",
+                   num_adaptive_fast_data_blocks, prop_delim, kv_delim);
+    AppendProperty(result, "# adaptive uncompressed data blocks",
+                   num_adaptive_uncompressed_data_blocks, prop_delim, kv_delim);
+  }
 
   // DB identity and DB session ID
   AppendProperty(result, "DB identity", db_id, prop_delim, kv_delim);
@@ -196,6 +203,9 @@ void TableProperties::Add(const TableProperties& tp) {
       tp.slow_compression_estimated_data_size;
   fast_compression_estimated_data_size +=
       tp.fast_compression_estimated_data_size;
+  num_adaptive_fast_data_blocks += tp.num_adaptive_fast_data_blocks;
+  num_adaptive_uncompressed_data_blocks +=
+      tp.num_adaptive_uncompressed_data_blocks;
 }
 
 std::map<std::string, uint64_t>
@@ -218,6 +228,9 @@ TableProperties::GetAggregatablePropertiesAsMap() const {
       slow_compression_estimated_data_size;
   rv["fast_compression_estimated_data_size"] =
       fast_compression_estimated_data_size;
+  rv["num_adaptive_fast_data_blocks"] = num_adaptive_fast_data_blocks;
+  rv["num_adaptive_uncompressed_data_blocks"] =
+      num_adaptive_uncompressed_data_blocks;
   return rv;
 }
 
@@ -310,6 +323,10 @@ const std::string TablePropertiesNames::kSlowCompressionEstimatedDataSize =
     "rocksdb.sample_for_compression.slow.data.size";
 const std::string TablePropertiesNames::kFastCompressionEstimatedDataSize =
     "rocksdb.sample_for_compression.fast.data.size";
+const std::string TablePropertiesNames::kNumAdaptiveFastDataBlocks =
+    "rocksdb.adaptive.compression.fast.data.blocks";
+const std::string TablePropertiesNames::kNumAdaptiveUncompressedDataBlocks =
+    "rocksdb.adaptive.compression.uncompressed.data.blocks";
 const std::string TablePropertiesNames::kSequenceNumberTimeMapping =
     "rocksdb.seqno.time.map";
 const std::string TablePropertiesNames::kTailStartOffset =
@@ -11,6 +11,8 @@ int main() {
 }
 #else
 
+#include <cinttypes>
+
 #include "db/db_impl/db_impl.h"
 #include "db/dbformat.h"
 #include "file/random_access_file_reader.h"
@@ -36,18 +38,30 @@ namespace rocksdb {
 
 namespace {
 // Make a key that i determines the first 4 characters and j determines the
-// last 4 characters.
-static std::string MakeKey(int i, int j, bool through_db) {
+// last 4 characters. With integer_keys, the key is instead the 8-byte
+// big-endian encoding of (i << 32 | j).
+static std::string MakeKey(int i, int j, bool through_db,
+                           bool integer_keys) {
   char buf[100];
-  snprintf(buf, sizeof(buf), "%04d__key___%04d", i, j);
+  if (integer_keys) {
+    const uint64_t v =
+        (static_cast<uint64_t>(i) << 32) | static_cast<uint32_t>(j);
+    for (size_t k = 0; k < sizeof(v); ++k) {
+      buf[k] = static_cast<char>(v >> (8 * (sizeof(v) - 1 - k)));
+    }
+  } else {
+    snprintf(buf, sizeof(buf), "%04d__key___%04d", i, j);
+  }
+  const std::string user_key =
+      integer_keys ? std::string(buf, sizeof(uint64_t)) : std::string(buf);
   if (through_db) {
-    return std::string(buf);
+    return user_key;
   }
   // If we directly query table, which operates on internal keys
   // instead of user keys, we need to add 8 bytes of internal
   // information (row type etc) to user key to make an internal
   // key.
-  InternalKey key(std::string(buf), 0, ValueType::kTypeValue);
+  InternalKey key(user_key, 0, ValueType::kTypeValue);
   return key.Encode().ToString();
 }
 
@@ -74,7 +88,8 @@ void TableReaderBenchmark(Options& opts, EnvOptions& env_options,
                           ReadOptions& read_options, int num_keys1,
                           int num_keys2, int num_iter, int /*prefix_len*/,
                           bool if_query_empty_keys, bool for_iterator,
-                          bool through_db, bool measured_by_nanosecond) {
+                          bool through_db, bool measured_by_nanosecond,
+                          bool integer_keys) {
   rocksdb::InternalKeyComparator ikc(opts.comparator);
 
   std::string file_name =
@@ -113,7 +128,7 @@ void TableReaderBenchmark(Options& opts, EnvOptions& env_options,
   // Populate slightly more than 1M keys
   for (int i = 0; i < num_keys1; i++) {
     for (int j = 0; j < num_keys2; j++) {
-      std::string key = MakeKey(i * 2, j, through_db);
+      std::string key = MakeKey(i * 2, j, through_db, integer_keys);
       if (!through_db) {
         tb->Add(key, key);
       } else {
@@ -169,7 +184,7 @@ void TableReaderBenchmark(Options& opts, EnvOptions& env_options,
 
         if (!for_iterator) {
           // Query one existing key;
-          std::string key = MakeKey(r1, r2, through_db);
+          std::string key = MakeKey(r1, r2, through_db, integer_keys);
           uint64_t start_time = Now(clock, measured_by_nanosecond);
           if (!through_db) {
             PinnableSlice value;
@@ -195,8 +210,9 @@ void TableReaderBenchmark(Options& opts, EnvOptions& env_options,
               r2_len = num_keys2 - r2;
             }
           }
-          std::string start_key = MakeKey(r1, r2, through_db);
-          std::string end_key = MakeKey(r1, r2 + r2_len, through_db);
+          std::string start_key = MakeKey(r1, r2, through_db, integer_keys);
+          std::string end_key =
+              MakeKey(r1, r2 + r2_len, through_db, integer_keys);
           uint64_t total_time = 0;
           uint64_t start_time = Now(clock, measured_by_nanosecond);
           Iterator* iter = nullptr;
@@ -217,7 +233,7 @@ void TableReaderBenchmark(Options& opts, EnvOptions& env_options,
             }
             // verify key;
             total_time += Now(clock, measured_by_nanosecond) - start_time;
-            assert(Slice(MakeKey(r1, r2 + count, through_db)) ==
+            assert(Slice(MakeKey(r1, r2 + count, through_db, integer_keys)) ==
                    (through_db ? iter->key() : iiter->key()));
             start_time = Now(clock, measured_by_nanosecond);
             if (++count >= r2_len) {
@@ -253,6 +269,11 @@ void TableReaderBenchmark(Options& opts, EnvOptions& env_options,
       measured_by_nanosecond ? "nanosecond" : "microsecond",
       hist.ToString().c_str());
   if (!through_db) {
+    fprintf(stderr,
+            "Index size: %" PRIu64
+            " bytes, table reader memory: %" ROCKSDB_PRIszt " bytes\n",
+            table_reader->GetTableProperties()->index_size,
+            table_reader->ApproximateMemoryUsage());
     env->DeleteFile(file_name);
   } else {
     delete db;
@@ -275,8 +296,26 @@ DEFINE_bool(through_db, false,
             "against DB. Otherwise, will be directly against a table reader.");
 DEFINE_bool(mmap_read, true, "Whether use mmap read");
 DEFINE_string(table_factory, "block_based",
-              "Table factory to use: `block_based` (default), `plain_table` or "
-              "`cuckoo_hash`.");
+              "Table factory to use: `block_based` (default), `plain_table`, "
+              "`cuckoo_hash` or `log_hash`.");
+DEFINE_int32(format_version,
+             static_cast<int32_t>(
+                 rocksdb::BlockBasedTableOptions().format_version),
+             "BlockBasedTableOptions::format_version for `block_based`. "
+             "Version 1000 adds restart key prefixes to data blocks, which "
+             "help seeks most when keys differ in their first 8 bytes (e.g. "
+             "with a small --num_keys2).");
+DEFINE_int32(block_restart_interval,
+             rocksdb::BlockBasedTableOptions().block_restart_interval,
+             "BlockBasedTableOptions::block_restart_interval for "
+             "`block_based`.");
+DEFINE_int32(index_type,
+             static_cast<int32_t>(rocksdb::BlockBasedTableOptions().index_type),
+             "BlockBasedTableOptions::index_type for `block_based` (see `enum "
+             "IndexType` in table.h). Use 4 (kInterpolationSearch) with "
+             "--integer_keys to compare with the default binary search index.");
+DEFINE_bool(integer_keys, false,
+            "Use 8-byte big-endian integer keys instead of 16-byte strings.");
 DEFINE_string(time_unit, "microsecond",
               "The time unit used for measuring performance. User can specify "
               "`microsecond` (default) or `nanosecond`");
@@ -304,12 +343,16 @@ int main(int argc, char** argv) {
     rocksdb::CuckooTableOptions table_options;
     table_options.hash_table_ratio = 0.75;
     tf.reset(rocksdb::NewCuckooTableFactory(table_options));
+  } else if (FLAGS_table_factory == "log_hash") {
+    options.allow_mmap_reads = FLAGS_mmap_read;
+    env_options.use_mmap_reads = FLAGS_mmap_read;
+    tf.reset(rocksdb::NewLogHashTableFactory());
   } else if (FLAGS_table_factory == "plain_table") {
     options.allow_mmap_reads = FLAGS_mmap_read;
     env_options.use_mmap_reads = FLAGS_mmap_read;
 
     rocksdb::PlainTableOptions plain_table_options;
-    plain_table_options.user_key_len = 16;
+    plain_table_options.user_key_len = FLAGS_integer_keys ? 8 : 16;
     plain_table_options.bloom_bits_per_key = (FLAGS_prefix_len == 16) ? 0 : 8;
     plain_table_options.hash_table_ratio = 0.75;
 
@@ -317,7 +360,13 @@ int main(int argc, char** argv) {
     options.prefix_extractor.reset(
         rocksdb::NewFixedPrefixTransform(FLAGS_prefix_len));
   } else if (FLAGS_table_factory == "block_based") {
-    tf.reset(new rocksdb::BlockBasedTableFactory());
+    rocksdb::BlockBasedTableOptions table_options;
+    table_options.format_version = static_cast<uint32_t>(FLAGS_format_version);
+    table_options.block_restart_interval = FLAGS_block_restart_interval;
+    table_options.index_type =
+        static_cast<rocksdb::BlockBasedTableOptions::IndexType>(
+            FLAGS_index_type);
+    tf.reset(new rocksdb::BlockBasedTableFactory(table_options));
   } else {
     fprintf(stderr, "Invalid table type %s\n", FLAGS_table_factory.c_str());
   }
@@ -330,7 +379,8 @@ int main(int argc, char** argv) {
     rocksdb::TableReaderBenchmark(options, env_options, ro, FLAGS_num_keys1,
                                   FLAGS_num_keys2, FLAGS_iter, FLAGS_prefix_len,
                                   FLAGS_query_empty, FLAGS_iterator,
-                                  FLAGS_through_db, measured_by_nanosecond);
+                                  FLAGS_through_db, measured_by_nanosecond,
+                                  FLAGS_integer_keys);
   } else {
     return 1;
   }
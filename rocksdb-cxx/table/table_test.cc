@@ -55,6 +55,7 @@
 #include "table/block_based/block_based_table_factory.h"
 #include "table/block_based/block_based_table_reader.h"
 #include "table/block_based/block_builder.h"
+#include "table/block_based/block_interpolation_index.h"
 #include "table/block_based/filter_policy_internal.h"
 #include "table/block_based/flush_block_policy_impl.h"
 #include "table/block_fetcher.h"
@@ -2702,6 +2703,108 @@ TEST_P(BlockBasedTableTest, HashIndexTest) {
   IndexTest(table_options);
 }
 
+TEST_P(BlockBasedTableTest, InterpolationIndexTest) {
+  // Fixed-width big-endian integer keys, for which the model fits best
+  auto encode_key = [](uint64_t v) {
+    std::string key(sizeof(v), '\0');
+    for (size_t i = 0; i < sizeof(v); ++i) {
+      key[sizeof(v) - 1 - i] = static_cast<char>(v >> (8 * i));
+    }
+    return key;
+  };
+  auto seek_key = [&](uint64_t v) {
+    return InternalKey(encode_key(v), kMaxSequenceNumber, kValueTypeForSeek)
+        .Encode()
+        .ToString();
+  };
+
+  for (int index_block_restart_interval : {1, 4}) {
+    for (bool uniform : {true, false}) {
+      BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+      table_options.index_type = BlockBasedTableOptions::kInterpolationSearch;
+      table_options.block_size = 1024;
+      table_options.index_block_restart_interval =
+          index_block_restart_interval;
+      Options options;
+      options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+      const ImmutableOptions ioptions(options);
+      const MutableCFOptions moptions(options);
+
+      Random rnd(301);
+      Random64 rnd64(301);
+      std::vector<uint64_t> values;
+      for (uint64_t i = 1; i <= 10000; ++i) {
+        // Evenly spaced, or log-uniform so that the model needs many
+        // segments or is not written at all
+        values.push_back(uniform ? i * 1000
+                                 : rnd64.Next() >> rnd64.Uniform(64));
+      }
+      std::sort(values.begin(), values.end());
+      values.erase(std::unique(values.begin(), values.end()), values.end());
+
+      TableConstructor c(BytewiseComparator());
+      for (uint64_t v : values) {
+        c.Add(InternalKey(encode_key(v), 0, kTypeValue).Encode().ToString(),
+              rnd.RandomString(100));
+      }
+      std::vector<std::string> keys;
+      stl_wrappers::KVMap kvmap;
+      c.Finish(options, ioptions, moptions, table_options,
+               GetPlainInternalComparator(options.comparator), &keys, &kvmap);
+
+      if (uniform) {
+        test::StringSink* sink = c.TEST_GetSink();
+        std::unique_ptr<RandomAccessFileReader> file(new RandomAccessFileReader(
+            std::unique_ptr<FSRandomAccessFile>(new test::StringSource(
+                sink->contents(), 0 /* unique_id */,
+                false /* allow_mmap_reads */)),
+            "test"));
+        BlockContents contents;
+        ASSERT_OK(ReadMetaBlock(file.get(), nullptr /* prefetch_buffer */,
+                                sink->contents().size(),
+                                kBlockBasedTableMagicNumber, ioptions,
+                                ReadOptions(), kInterpolationIndexBlock,
+                                BlockType::kIndex, &contents));
+        std::unique_ptr<BlockInterpolationIndex> model;
+        ASSERT_OK(BlockInterpolationIndex::Create(contents.data, &model));
+        ASSERT_GE(model->NumSegments(), 1U);
+        ASSERT_LT(model->NumSegments(), 10U);
+      }
+
+      auto reader = c.GetTableReader();
+      std::unique_ptr<InternalIterator> iter(reader->NewIterator(
+          ReadOptions(), moptions.prefix_extractor.get(), /*arena=*/nullptr,
+          /*skip_filters=*/false, TableReaderCaller::kUncategorized));
+
+      for (const auto& kv : kvmap) {
+        iter->Seek(kv.first);
+        ASSERT_TRUE(iter->Valid());
+        ASSERT_OK(iter->status());
+        ASSERT_EQ(iter->key(), kv.first);
+        ASSERT_EQ(iter->value(), kv.second);
+      }
+
+      // Keys between, before and after the keys of the table
+      for (int i = 0; i < 10000; ++i) {
+        const uint64_t target = i == 0   ? 0
+                                : i == 1 ? values.back() + 1
+                                         : rnd64.Next() >> rnd64.Uniform(64);
+        iter->Seek(seek_key(target));
+        ASSERT_OK(iter->status());
+        auto expected =
+            std::lower_bound(values.begin(), values.end(), target);
+        if (expected == values.end()) {
+          ASSERT_FALSE(iter->Valid());
+        } else {
+          ASSERT_TRUE(iter->Valid());
+          ASSERT_EQ(ExtractUserKey(iter->key()), encode_key(*expected));
+        }
+      }
+      c.ResetTableReader();
+    }
+  }
+}
+
 TEST_P(BlockBasedTableTest, PartitionIndexTest) {
   const int max_index_keys = 5;
   const int est_max_index_key_value_size = 32;
@@ -4560,7 +4663,10 @@ TEST(TableTest, FooterTests) {
   }
   // block based, various checksums, various versions
   for (auto t : GetSupportedChecksums()) {
-    for (uint32_t fv = 1; IsSupportedFormatVersion(fv); ++fv) {
+    for (uint32_t fv = 1; fv <= kLatestFormatVersion; ++fv) {
+      if (!IsSupportedFormatVersion(fv)) {
+        continue;
+      }
       FooterBuilder footer;
       footer.Build(kBlockBasedTableMagicNumber, fv, footer_offset, t,
                    meta_index, index);
@@ -4578,6 +4684,17 @@ TEST(TableTest, FooterTests) {
       ASSERT_EQ(decoded_footer.GetBlockTrailerSize(), 5U);
     }
   }
+  {
+    // format_version 6 of upstream RocksDB, which puts it at the same place
+    FooterBuilder footer;
+    footer.Build(kBlockBasedTableMagicNumber, /* format_version */ 5,
+                 footer_offset, kCRC32c, meta_index, index);
+    std::string encoded = footer.GetSlice().ToString();
+    rocksdb_rs::coding_lean::EncodeFixed32(&encoded[encoded.size() - 12], 6);
+    Footer decoded_footer;
+    ASSERT_TRUE(decoded_footer.DecodeFrom(encoded, footer_offset)
+                    .IsNotSupported());
+  }
 
   {
     // legacy plain table
@@ -5204,6 +5321,87 @@ TEST_P(BlockBasedTableTest, CompressionRatioThreshold) {
   }
 }
 
+TEST_P(BlockBasedTableTest, AdaptiveCompression) {
+  if (!ZSTD_Supported()) {
+    fprintf(stderr, "ZSTD compression not supported, skip this test\n");
+    return;
+  }
+  Options options;
+  options.compression = rocksdb_rs::compression_type::CompressionType::kZSTD;
+  options.compression_opts.adaptive_sample_window = 4;
+  options.statistics = CreateDBStatistics();
+  BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+  table_options.block_size = 4096;
+  table_options.verify_compression = true;
+  Random rnd(301);
+
+  struct Case {
+    double compressible_to;
+    int adaptive_min_savings_per_kb;
+  };
+  for (const Case& test_case : {Case{1.0, 64}, Case{0.25, 64},
+                                Case{0.25, 1024}}) {
+    SCOPED_TRACE("compressible_to=" +
+                 std::to_string(test_case.compressible_to) +
+                 " adaptive_min_savings_per_kb=" +
+                 std::to_string(test_case.adaptive_min_savings_per_kb));
+    options.compression_opts.adaptive_min_savings_per_kb =
+        test_case.adaptive_min_savings_per_kb;
+    ASSERT_OK(options.statistics->Reset());
+    ImmutableOptions ioptions(options);
+    MutableCFOptions moptions(options);
+
+    TableConstructor c(BytewiseComparator(),
+                       true /* convert_to_internal_key_ */);
+    std::string buf;
+    for (int i = 0; i < 100; ++i) {
+      c.Add(test::RandomKey(&rnd, 16),
+            test::CompressibleString(&rnd, test_case.compressible_to, 1000,
+                                     &buf)
+                .ToString());
+    }
+    std::vector<std::string> keys;
+    stl_wrappers::KVMap kvmap;
+    c.Finish(options, ioptions, moptions, table_options,
+             GetPlainInternalComparator(options.comparator), &keys, &kvmap);
+
+    auto& props = *c.GetTableReader()->GetTableProperties();
+    ASSERT_GT(props.num_data_blocks, 1U);
+    uint64_t skipped_bytes = options.statistics->getTickerCount(
+        BYTES_COMPRESSION_SKIPPED_BY_SAMPLING);
+    if (test_case.compressible_to == 1.0) {
+      // Incompressible data is not worth compressing with either type
+      ASSERT_EQ(props.num_adaptive_uncompressed_data_blocks,
+                props.num_data_blocks);
+      ASSERT_EQ(props.num_adaptive_fast_data_blocks, 0U);
+      ASSERT_GT(skipped_bytes, 100U * 1000U);
+      ASSERT_LE(skipped_bytes, options.statistics->getTickerCount(
+                                   BYTES_COMPRESSION_BYPASSED));
+    } else {
+      ASSERT_EQ(props.num_adaptive_uncompressed_data_blocks, 0U);
+      ASSERT_EQ(skipped_bytes, 0U);
+      if (test_case.adaptive_min_savings_per_kb == 1024 && LZ4_Supported()) {
+        // ZSTD cannot save a whole KB per KB over LZ4
+        ASSERT_EQ(props.num_adaptive_fast_data_blocks, props.num_data_blocks);
+      }
+    }
+
+    // All blocks read back, whatever their compression type
+    std::unique_ptr<InternalIterator> iter(
+        c.NewIterator(moptions.prefix_extractor.get()));
+    auto expected = kvmap.begin();
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++expected) {
+      ASSERT_NE(expected, kvmap.end());
+      ASSERT_EQ(iter->key().ToString(), expected->first);
+      ASSERT_EQ(iter->value().ToString(), expected->second);
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(expected, kvmap.end());
+    iter.reset();
+    c.ResetTableReader();
+  }
+}
+
 TEST_P(BlockBasedTableTest, PropertiesMetaBlockLast) {
   // The properties meta-block should come at the end since we always need to
   // read it when opening a file, unlike index/filter/other meta-blocks, which
@@ -43,12 +43,18 @@ class WithCacheType : public TestCreateContext {
 
   static constexpr auto kLRU = "lru";
   static constexpr auto kHyperClock = "hyper_clock";
+  static constexpr auto kAutoHyperClock = "auto_hyper_clock";
 
   // For options other than capacity
   size_t estimated_value_size_ = 1;
 
   virtual const std::string& Type() = 0;
 
+  // Either HyperClockCache or AutoHyperClockCache
+  bool IsHyperClock() {
+    return Type() == kHyperClock || Type() == kAutoHyperClock;
+  }
+
   std::shared_ptr<Cache> NewCache(
       size_t capacity,
       std::function<void(ShardedCacheOptions&)> modify_opts_fn = {}) {
@@ -70,6 +76,16 @@ class WithCacheType : public TestCreateContext {
       }
       return hc_opts.MakeSharedCache();
     }
+    if (type == kAutoHyperClock) {
+      HyperClockCacheOptions hc_opts{capacity, /*estimated_entry_charge=*/0};
+      // Grows up to the size of the table of kHyperClock
+      hc_opts.min_avg_entry_charge = estimated_value_size_;
+      hc_opts.hash_seed = 0;  // deterministic tests
+      if (modify_opts_fn) {
+        modify_opts_fn(hc_opts);
+      }
+      return hc_opts.MakeSharedCache();
+    }
     assert(false);
     return nullptr;
   }
@@ -112,9 +128,11 @@ class WithCacheTypeParam : public WithCacheType,
 
 constexpr auto kLRU = WithCacheType::kLRU;
 constexpr auto kHyperClock = WithCacheType::kHyperClock;
+constexpr auto kAutoHyperClock = WithCacheType::kAutoHyperClock;
 
 inline auto GetTestingCacheTypes() {
-  return testing::Values(std::string(kLRU), std::string(kHyperClock));
+  return testing::Values(std::string(kLRU), std::string(kHyperClock),
+                         std::string(kAutoHyperClock));
 }
 
 }  // namespace secondary_cache_test_util
@@ -59,6 +59,7 @@
 #include "rocksdb/secondary_cache.h"
 #include "rocksdb/slice.h"
 #include "rocksdb/slice_transform.h"
+#include "rocksdb/sst_file_writer.h"
 #include "rocksdb/stats_history.h"
 #include "rocksdb/table.h"
 #include "rocksdb/utilities/backup_engine.h"
@@ -126,6 +127,8 @@ DEFINE_string(
     "flush,"
     "compact0,"
     "compact1,"
+    "compactionfilter,"
+    "ingest,"
     "waitforcompaction,"
     "multireadrandom,"
     "mixgraph,"
@@ -225,8 +228,15 @@ DEFINE_string(
     "\tcompactall  -- Compact the entire DB\n"
     "\tcompact0  -- compact L0 into L1\n"
     "\tcompact1  -- compact L1 into L2\n"
+    "\tcompactionfilter -- Compact the entire DB through the compaction "
+    "filter, reporting the keys filtered per second; requires "
+    "--use_keep_filter or --expire_style=compaction_filter\n"
+    "\tingest -- Write --num keys to --ingest_num_files external SST "
+    "files per thread, and ingest them into the DB in one call, reporting "
+    "the latency of the ingestion\n"
     "\twaitforcompaction - pause until compaction is (probably) done\n"
     "\tflush - flush the memtable\n"
+    "\trecover - close and reopen the DB, timing the replay of its WALs\n"
     "\tstats       -- Print DB stats\n"
     "\tresetstats  -- Reset DB stats\n"
     "\tlevelstats  -- Print the number of files and bytes per level\n"
@@ -600,6 +610,13 @@ DEFINE_uint32(
     "compress_format_version == 2 -- decompressed size is included"
     " in the block header in varint32 format.");
 
+DEFINE_string(compressed_secondary_cache_persistent_file_path, "",
+              "If non-empty, the CompressedSecondaryCache keeps its blocks "
+              "in a file mapped at this path, e.g. on tmpfs, and reuses the "
+              "blocks left there by a previous run. Compare readrandom with "
+              "and without the file of a previous run to measure the warm "
+              "restart.");
+
 DEFINE_bool(use_tiered_volatile_cache, false,
             "If use_compressed_secondary_cache is true and "
             "use_tiered_volatile_cache is true, then allocate a tiered cache "
@@ -712,6 +729,10 @@ DEFINE_int32(file_opening_threads, rocksdb::Options().max_file_opening_threads,
 
 DEFINE_int32(compaction_readahead_size, 0, "Compaction readahead size");
 
+DEFINE_bool(compaction_async_io, rocksdb::Options().compaction_async_io,
+            "Read compaction inputs with asynchronous IO when the file system "
+            "supports it");
+
 DEFINE_int32(log_readahead_size, 0, "WAL and manifest readahead size");
 
 DEFINE_int32(random_access_max_buffer_size, 1024 * 1024,
@@ -777,6 +798,32 @@ DEFINE_bool(read_cache_direct_read, true,
 
 DEFINE_bool(use_keep_filter, false, "Whether to use a noop compaction filter");
 
+DEFINE_bool(local_compaction_service, false,
+            "Run the compactions in local worker processes spawned from the "
+            "same db_bench command line, see NewLocalCompactionService()");
+
+DEFINE_bool(local_compaction_service_worker, false,
+            "Internal: run a worker of --local_compaction_service");
+// The command line of db_bench, which the workers of
+// --local_compaction_service run with an extra flag
+static std::vector<std::string> command_line;
+
+DEFINE_bool(compaction_filter_batch, false,
+            "Whether the compaction filters of db_bench filter plain values "
+            "in batches, see CompactionFilter::FilterBatch()");
+
+DEFINE_int32(ingest_num_files, 100,
+             "Number of external SST files ingested by each thread of the "
+             "ingest benchmark");
+
+DEFINE_int32(ingest_max_threads,
+             rocksdb::IngestExternalFileOptions().max_threads,
+             "IngestExternalFileOptions::max_threads of the ingest benchmark");
+
+DEFINE_bool(ingest_move_files, false,
+            "Whether the ingest benchmark moves the external SST files into "
+            "the DB instead of copying them");
+
 static bool ValidateCacheNumshardbits(const char* flagname, int32_t value) {
   if (value >= 20) {
     fprintf(stderr, "Invalid value for --%s: %d, must be < 20\n", flagname,
@@ -819,6 +866,11 @@ static enum rocksdb_rs::compression_type::CompressionType
     FLAGS_wal_compression_e =
         rocksdb_rs::compression_type::CompressionType::kNoCompression;
 
+DEFINE_uint32(wal_compression_max_dict_bytes,
+              rocksdb::Options().wal_compression_max_dict_bytes,
+              "Maximum size of the dictionary trained for each WAL when "
+              "--wal_compression=zstd. 0 to disable.");
+
 DEFINE_string(wal_dir, "", "If not empty, use the given dir for WAL");
 
 DEFINE_string(truth_db, "/dev/shm/truth_db/dbbench",
@@ -1072,6 +1124,12 @@ DEFINE_int32(blob_file_starting_level,
              rocksdb::AdvancedColumnFamilyOptions().blob_file_starting_level,
              "[Integrated BlobDB] The starting level for blob files.");
 
+DEFINE_uint64(
+    blob_multiget_coalesce_gap,
+    rocksdb::AdvancedColumnFamilyOptions().blob_multiget_coalesce_gap,
+    "[Integrated BlobDB] Largest gap in bytes between blobs of the same file "
+    "that MultiGet reads with a single request.");
+
 DEFINE_bool(use_blob_cache, false, "[Integrated BlobDB] Enable blob cache.");
 
 DEFINE_bool(
@@ -1161,6 +1219,10 @@ DEFINE_bool(optimize_multiget_for_io, true,
             "When set true, RocksDB does asynchronous reads for SST files in "
             "multiple levels for MultiGet.");
 
+DEFINE_bool(speculative_get_reads, false,
+            "When async_io is set, look a key up in all the SST files that "
+            "may hold it in parallel in Get()");
+
 DEFINE_bool(charge_compression_dictionary_building_buffer, false,
             "Setting for "
             "CacheEntryRoleOptions::charged of "
@@ -1300,6 +1362,18 @@ DEFINE_bool(compression_use_zstd_dict_trainer,
             "If true, use ZSTD_TrainDictionary() to create dictionary, else"
             "use ZSTD_FinalizeDictionary() to create dictionary");
 
+DEFINE_uint32(compression_adaptive_sample_window,
+              rocksdb::CompressionOptions().adaptive_sample_window,
+              "If nonzero, choose between the configured compression type, "
+              "LZ4 and no compression by sampling one in this many data "
+              "blocks.");
+
+DEFINE_int32(compression_adaptive_min_savings_per_kb,
+             rocksdb::CompressionOptions().adaptive_min_savings_per_kb,
+             "Minimum bytes per KB the configured compression type must save "
+             "over LZ4 to be chosen with "
+             "--compression_adaptive_sample_window.");
+
 static bool ValidateTableCacheNumshardbits(const char* flagname,
                                            int32_t value) {
   if (0 >= value || value >= 20) {
@@ -1386,6 +1460,10 @@ DEFINE_bool(
     "Enable the unordered write feature, which provides higher throughput but "
     "relaxes the guarantees around atomic reads and immutable snapshots");
 
+DEFINE_bool(wal_group_commit, rocksdb::Options().wal_group_commit,
+            "Sync the WAL for sync writes from a dedicated thread, sharing "
+            "each sync among all the writes appended since the previous one");
+
 DEFINE_bool(allow_concurrent_memtable_write, true,
             "Allow multi-writers to update mem tables in parallel.");
 
@@ -1619,6 +1697,9 @@ DEFINE_bool(enable_io_prio, false,
             "Lower the background flush/compaction threads' IO priority");
 DEFINE_bool(enable_cpu_prio, false,
             "Lower the background flush/compaction threads' CPU priority");
+DEFINE_bool(thread_pool_work_stealing, false,
+            "Schedule the background jobs of every thread pool by work "
+            "stealing instead of from a single FIFO queue");
 DEFINE_bool(identity_as_first_hash, false,
             "the first hash function of cuckoo table becomes an identity "
             "function. This is only valid when key is 8 bytes");
@@ -1636,6 +1717,8 @@ DEFINE_uint64(stats_history_buffer_size,
 DEFINE_bool(avoid_flush_during_recovery,
             rocksdb::Options().avoid_flush_during_recovery,
             "If true, avoids flushing the recovered WAL data where possible.");
+DEFINE_int32(wal_recovery_threads, rocksdb::Options().wal_recovery_threads,
+             "Number of threads replaying WALs into memtables on DB open.");
 DEFINE_int64(multiread_stride, 0,
              "Stride length for the keys in a MultiGet batch");
 DEFINE_bool(multiread_batched, false, "Use the new MultiGet API");
@@ -1646,14 +1729,29 @@ DEFINE_bool(use_plain_table, false,
             "if use plain table instead of block-based table format");
 DEFINE_bool(use_cuckoo_table, false, "if use cuckoo table format");
 DEFINE_double(cuckoo_hash_ratio, 0.9, "Hash ratio for Cuckoo SST table.");
+DEFINE_bool(use_log_hash_table, false,
+            "if use log hash table format, for point lookup only workloads");
+DEFINE_double(log_hash_table_ratio,
+              rocksdb::LogHashTableOptions().hash_table_ratio,
+              "Hash ratio for Log Hash SST table.");
 DEFINE_bool(use_hash_search, false,
             "if use kHashSearch instead of kBinarySearch. "
             "This is valid if only we use BlockTable");
+DEFINE_bool(use_interpolation_search, false,
+            "if use kInterpolationSearch instead of kBinarySearch. "
+            "This is valid if only we use BlockTable");
 DEFINE_string(merge_operator, "",
               "The merge operator to use with the database."
               "If a new merge operator is specified, be sure to use fresh"
               " database The possible merge operators are defined in"
               " utilities/merge_operators.h");
+
+DEFINE_string(sst_partitioner, "",
+              "The SstPartitionerFactory splitting the compaction outputs, "
+              "e.g. SstPartitionerLoadAwareFactory to keep the key ranges "
+              "read most, as with the skewed reads of mixgraph, in small "
+              "files. Options are passed as in "
+              "\"id=SstPartitionerLoadAwareFactory;hot_file_size=4194304\"");
 DEFINE_int32(skip_list_lookahead, 0,
              "Used with skip_list memtablerep; try linear search first for "
              "this many steps from the previous position");
@@ -1706,6 +1804,11 @@ DEFINE_uint32(
     "This options determines the size of such checksums. "
     "Supported values: 0, 1, 2, 4, 8.");
 
+DEFINE_uint32(memtable_max_range_deletions,
+              rocksdb::Options().memtable_max_range_deletions,
+              "If nonzero, a memtable is flushed once it holds this many "
+              "range deletions.");
+
 DEFINE_uint32(block_protection_bytes_per_key, 0,
               "Enable block per key-value checksum protection. "
               "Supported values: 0, 1, 2, 4, 8.");
@@ -2946,6 +3049,18 @@ class Benchmark {
                 bool* /*value_changed*/) const override {
       return KeyExpired(timestamp_emulator_.get(), key);
     }
+    bool SupportsFilterBatch() const override {
+      return FLAGS_compaction_filter_batch;
+    }
+    void FilterBatch(int /*level*/, size_t n, const Slice* keys,
+                     const Slice* /*existing_values*/, Decision* decisions,
+                     std::string* /*new_values*/) const override {
+      for (size_t i = 0; i < n; ++i) {
+        decisions[i] = KeyExpired(timestamp_emulator_.get(), keys[i])
+                           ? Decision::kRemove
+                           : Decision::kKeep;
+      }
+    }
     const char* Name() const override { return "ExpiredTimeFilter"; }
 
    private:
@@ -2960,6 +3075,16 @@ class Benchmark {
       return false;
     }
 
+    bool SupportsFilterBatch() const override {
+      return FLAGS_compaction_filter_batch;
+    }
+
+    void FilterBatch(int /*level*/, size_t n, const Slice* /*keys*/,
+                     const Slice* /*existing_values*/, Decision* decisions,
+                     std::string* /*new_values*/) const override {
+      std::fill(decisions, decisions + n, Decision::kKeep);
+    }
+
     const char* Name() const override { return "KeepFilter"; }
   };
 
@@ -3007,6 +3132,8 @@ class Benchmark {
           FLAGS_compressed_secondary_cache_compression_type_e;
       secondary_cache_opts.compress_format_version =
           FLAGS_compressed_secondary_cache_compress_format_version;
+      secondary_cache_opts.persistent_file_path =
+          FLAGS_compressed_secondary_cache_persistent_file_path;
       if (FLAGS_use_tiered_volatile_cache) {
         use_tiered_cache = true;
       }
@@ -3014,10 +3141,13 @@ class Benchmark {
     if (FLAGS_cache_type == "clock_cache") {
       fprintf(stderr, "Old clock cache implementation has been removed.\n");
       exit(1);
-    } else if (FLAGS_cache_type == "hyper_clock_cache") {
+    } else if (FLAGS_cache_type == "hyper_clock_cache" ||
+               FLAGS_cache_type == "auto_hyper_clock_cache") {
       HyperClockCacheOptions hcco{
           static_cast<size_t>(capacity),
-          static_cast<size_t>(FLAGS_block_size) /*estimated_entry_charge*/,
+          FLAGS_cache_type == "auto_hyper_clock_cache"
+              ? 0  // table size determined online
+              : static_cast<size_t>(FLAGS_block_size),  // estimated
           FLAGS_cache_numshardbits};
       hcco.hash_seed = GetCacheHashSeed();
       if (use_tiered_cache) {
@@ -3335,6 +3465,7 @@ class Benchmark {
       read_options_.adaptive_readahead = FLAGS_adaptive_readahead;
       read_options_.async_io = FLAGS_async_io;
       read_options_.optimize_multiget_for_io = FLAGS_optimize_multiget_for_io;
+      read_options_.speculative_get_reads = FLAGS_speculative_get_reads;
 
       void (Benchmark::*method)(ThreadState*) = nullptr;
       void (Benchmark::*post_process_method)() = nullptr;
@@ -3532,10 +3663,16 @@ class Benchmark {
         CompactLevel(0);
       } else if (name == "compact1") {
         CompactLevel(1);
+      } else if (name == "compactionfilter") {
+        method = &Benchmark::CompactionFilterThroughput;
+      } else if (name == "ingest") {
+        method = &Benchmark::IngestExternalFiles;
       } else if (name == "waitforcompaction") {
         WaitForCompaction();
       } else if (name == "flush") {
         Flush();
+      } else if (name == "recover") {
+        Recover();
       } else if (name == "crc32c") {
         method = &Benchmark::Crc32c;
       } else if (name == "xxhash") {
@@ -4075,6 +4212,7 @@ class Benchmark {
     options.stats_history_buffer_size =
         static_cast<size_t>(FLAGS_stats_history_buffer_size);
     options.avoid_flush_during_recovery = FLAGS_avoid_flush_during_recovery;
+    options.wal_recovery_threads = FLAGS_wal_recovery_threads;
 
     options.compression_opts.level = FLAGS_compression_level;
     options.compression_opts.max_dict_bytes = FLAGS_compression_max_dict_bytes;
@@ -4086,6 +4224,10 @@ class Benchmark {
         FLAGS_compression_max_dict_buffer_bytes;
     options.compression_opts.use_zstd_dict_trainer =
         FLAGS_compression_use_zstd_dict_trainer;
+    options.compression_opts.adaptive_sample_window =
+        FLAGS_compression_adaptive_sample_window;
+    options.compression_opts.adaptive_min_savings_per_kb =
+        FLAGS_compression_adaptive_min_savings_per_kb;
 
     options.max_open_files = FLAGS_open_files;
     if (FLAGS_cost_write_buffer_to_cache || FLAGS_db_write_buffer_size != 0) {
@@ -4114,6 +4256,8 @@ class Benchmark {
         FLAGS_use_direct_io_for_flush_and_compaction;
     options.manual_wal_flush = FLAGS_manual_wal_flush;
     options.wal_compression = FLAGS_wal_compression_e;
+    options.wal_compression_max_dict_bytes =
+        FLAGS_wal_compression_max_dict_bytes;
     options.ttl = FLAGS_fifo_compaction_ttl;
     options.compaction_options_fifo = CompactionOptionsFIFO(
         FLAGS_fifo_compaction_max_table_files_size_mb * 1024 * 1024,
@@ -4141,6 +4285,7 @@ class Benchmark {
     options.bloom_locality = FLAGS_bloom_locality;
     options.max_file_opening_threads = FLAGS_file_opening_threads;
     options.compaction_readahead_size = FLAGS_compaction_readahead_size;
+    options.compaction_async_io = FLAGS_compaction_async_io;
     options.log_readahead_size = FLAGS_log_readahead_size;
     options.random_access_max_buffer_size = FLAGS_random_access_max_buffer_size;
     options.writable_file_max_buffer_size = FLAGS_writable_file_max_buffer_size;
@@ -4201,6 +4346,16 @@ class Benchmark {
       table_options.identity_as_first_hash = FLAGS_identity_as_first_hash;
       options.table_factory =
           std::shared_ptr<TableFactory>(NewCuckooTableFactory(table_options));
+    } else if (FLAGS_use_log_hash_table) {
+      if (FLAGS_log_hash_table_ratio > 1 || FLAGS_log_hash_table_ratio <= 0) {
+        fprintf(stderr, "Invalid log_hash_table_ratio\n");
+        exit(1);
+      }
+
+      rocksdb::LogHashTableOptions table_options;
+      table_options.hash_table_ratio = FLAGS_log_hash_table_ratio;
+      options.table_factory =
+          std::shared_ptr<TableFactory>(NewLogHashTableFactory(table_options));
     } else {
       BlockBasedTableOptions block_based_options;
       block_based_options.checksum =
@@ -4212,6 +4367,9 @@ class Benchmark {
           exit(1);
         }
         block_based_options.index_type = BlockBasedTableOptions::kHashSearch;
+      } else if (FLAGS_use_interpolation_search) {
+        block_based_options.index_type =
+            BlockBasedTableOptions::kInterpolationSearch;
       } else {
         block_based_options.index_type = BlockBasedTableOptions::kBinarySearch;
       }
@@ -4482,6 +4640,7 @@ class Benchmark {
         FLAGS_enable_write_thread_adaptive_yield;
     options.enable_pipelined_write = FLAGS_enable_pipelined_write;
     options.unordered_write = FLAGS_unordered_write;
+    options.wal_group_commit = FLAGS_wal_group_commit;
     options.write_thread_max_yield_usec = FLAGS_write_thread_max_yield_usec;
     options.write_thread_slow_yield_usec = FLAGS_write_thread_slow_yield_usec;
     options.table_cache_numshardbits = FLAGS_table_cache_numshardbits;
@@ -4514,6 +4673,17 @@ class Benchmark {
     options.max_successive_merges = FLAGS_max_successive_merges;
     options.report_bg_io_stats = FLAGS_report_bg_io_stats;
 
+    if (!FLAGS_sst_partitioner.empty()) {
+      s = SstPartitionerFactory::CreateFromString(
+          config_options, FLAGS_sst_partitioner,
+          &options.sst_partitioner_factory);
+      if (!s.ok()) {
+        fprintf(stderr, "invalid sst partitioner[%s]: %s\n",
+                FLAGS_sst_partitioner.c_str(), s.ToString()->c_str());
+        exit(1);
+      }
+    }
+
     // set universal style compaction configurations, if applicable
     if (FLAGS_universal_size_ratio != 0) {
       options.compaction_options_universal.size_ratio =
@@ -4570,6 +4740,7 @@ class Benchmark {
     options.blob_compaction_readahead_size =
         FLAGS_blob_compaction_readahead_size;
     options.blob_file_starting_level = FLAGS_blob_file_starting_level;
+    options.blob_multiget_coalesce_gap = FLAGS_blob_multiget_coalesce_gap;
 
     if (FLAGS_readonly && FLAGS_transaction_db) {
       fprintf(stderr, "Cannot use readonly flag with transaction_db\n");
@@ -4582,10 +4753,25 @@ class Benchmark {
     }
     options.memtable_protection_bytes_per_key =
         FLAGS_memtable_protection_bytes_per_key;
+    options.memtable_max_range_deletions = FLAGS_memtable_max_range_deletions;
     options.block_protection_bytes_per_key =
         FLAGS_block_protection_bytes_per_key;
   }
 
+  static void InitializeFilterPolicy(BlockBasedTableOptions* table_options) {
+    if (table_options->filter_policy == nullptr) {
+      if (FLAGS_bloom_bits < 0) {
+        table_options->filter_policy = BlockBasedTableOptions().filter_policy;
+      } else if (FLAGS_bloom_bits == 0) {
+        table_options->filter_policy.reset();
+      } else {
+        table_options->filter_policy.reset(
+            FLAGS_use_ribbon_filter ? NewRibbonFilterPolicy(FLAGS_bloom_bits)
+                                    : NewBloomFilterPolicy(FLAGS_bloom_bits));
+      }
+    }
+  }
+
   void InitializeOptionsGeneral(Options* opts) {
     // Be careful about what is set here to avoid accidentally overwriting
     // settings already configured by OPTIONS file. Only configure settings that
@@ -4614,16 +4800,21 @@ class Benchmark {
         // block cache, even with OPTIONS file provided.
         table_options->block_cache = cache_;
       }
-      if (table_options->filter_policy == nullptr) {
-        if (FLAGS_bloom_bits < 0) {
-          table_options->filter_policy = BlockBasedTableOptions().filter_policy;
-        } else if (FLAGS_bloom_bits == 0) {
-          table_options->filter_policy.reset();
-        } else {
-          table_options->filter_policy.reset(
-              FLAGS_use_ribbon_filter ? NewRibbonFilterPolicy(FLAGS_bloom_bits)
-                                      : NewBloomFilterPolicy(FLAGS_bloom_bits));
-        }
+      InitializeFilterPolicy(table_options);
+    }
+
+    if (options.compaction_service == nullptr &&
+        FLAGS_local_compaction_service) {
+      LocalCompactionServiceOptions cs_options;
+      cs_options.worker_command = command_line;
+      cs_options.worker_command.emplace_back(
+          "--local_compaction_service_worker");
+      options.compaction_service = NewLocalCompactionService(cs_options);
+      if (options.compaction_service == nullptr) {
+        fprintf(stderr,
+                "--local_compaction_service is not supported on this "
+                "platform\n");
+        exit(1);
       }
     }
 
@@ -4722,6 +4913,60 @@ class Benchmark {
     InitializeOptionsGeneral(opts);
   }
 
+ public:
+  // Runs a worker of --local_compaction_service, with the options the DB
+  // gets from the same flags
+  int RunCompactionServiceWorker() {
+    Options options;
+#ifndef OS_WIN
+    // The standard output carries the result of the job, so the messages
+    // printed while initializing the options go to the standard error
+    fflush(stdout);
+    const int stdout_fd = dup(STDOUT_FILENO);
+    dup2(STDERR_FILENO, STDOUT_FILENO);
+#endif
+    if (!InitializeOptionsFromFile(&options)) {
+      InitializeOptionsFromFlags(&options);
+    }
+#ifndef OS_WIN
+    fflush(stdout);
+    dup2(stdout_fd, STDOUT_FILENO);
+    close(stdout_fd);
+#endif
+    auto table_options =
+        options.table_factory->GetOptions<BlockBasedTableOptions>();
+    if (table_options != nullptr) {
+      InitializeFilterPolicy(table_options);
+    }
+    std::unique_ptr<CompactionFilter> keep_filter;
+    if (options.compaction_filter == nullptr && FLAGS_use_keep_filter) {
+      keep_filter.reset(new KeepFilter());
+      options.compaction_filter = keep_filter.get();
+    }
+    if (options.file_checksum_gen_factory == nullptr && FLAGS_file_checksum) {
+      options.file_checksum_gen_factory.reset(
+          new FileChecksumGenCrc32cFactory());
+    }
+
+    CompactionServiceOptionsOverride override_options;
+    override_options.env = FLAGS_env;
+    override_options.file_checksum_gen_factory =
+        options.file_checksum_gen_factory;
+    override_options.comparator = options.comparator;
+    override_options.merge_operator = options.merge_operator;
+    override_options.compaction_filter = options.compaction_filter;
+    override_options.compaction_filter_factory =
+        options.compaction_filter_factory;
+    override_options.prefix_extractor = options.prefix_extractor;
+    override_options.table_factory = options.table_factory;
+    override_options.sst_partitioner_factory =
+        options.sst_partitioner_factory;
+    override_options.statistics = dbstats;
+    return RunLocalCompactionServiceWorker(override_options);
+  }
+
+ private:
+
   void OpenDb(Options options, const std::string& db_name,
               DBWithColumnFamilies* db) {
     uint64_t open_start = FLAGS_report_open_timing ? FLAGS_env->NowNanos() : 0;
@@ -8093,6 +8338,109 @@ class Benchmark {
     db->CompactRange(cro, nullptr, nullptr);
   }
 
+  // Compacts the whole DB into the last level, so that each key goes through
+  // the compaction filter, and reports the number of keys per second.
+  void CompactionFilterThroughput(ThreadState* thread) {
+    DB* db = SelectDB(thread);
+    if (db->GetOptions().compaction_filter == nullptr) {
+      fprintf(stderr,
+              "compactionfilter requires --use_keep_filter or "
+              "--expire_style=compaction_filter\n");
+      exit(1);
+    }
+    uint64_t num_keys = 0;
+    if (!db->GetIntProperty(DB::Properties::kEstimateNumKeys, &num_keys)) {
+      fprintf(stderr, "compactionfilter: cannot get the number of keys\n");
+      exit(1);
+    }
+    CompactRangeOptions cro;
+    cro.bottommost_level_compaction = BottommostLevelCompaction::kForce;
+    cro.max_subcompactions = static_cast<uint32_t>(FLAGS_subcompactions);
+    rocksdb_rs::status::Status s = db->CompactRange(cro, nullptr, nullptr);
+    if (!s.ok()) {
+      fprintf(stderr, "compactionfilter: %s\n", s.ToString()->c_str());
+      exit(1);
+    }
+    thread->stats.FinishedOps(nullptr, db, static_cast<int64_t>(num_keys),
+                              OperationType::kOthers);
+    char msg[100];
+    snprintf(msg, sizeof(msg), "(%" PRIu64 " keys%s)", num_keys,
+             FLAGS_compaction_filter_batch ? ", batched" : "");
+    thread->stats.AddMessage(msg);
+  }
+
+  // Writes the keys of the thread to external SST files, and reports the
+  // latency of ingesting them all into the DB in one call.
+  void IngestExternalFiles(ThreadState* thread) {
+    DB* db = SelectDB(thread);
+    if (FLAGS_ingest_num_files <= 0) {
+      fprintf(stderr, "ingest: --ingest_num_files must be positive\n");
+      exit(1);
+    }
+    const std::string dir =
+        FLAGS_db + "/ingest_bench_" + std::to_string(thread->tid);
+    rocksdb_rs::status::Status s = FLAGS_env->CreateDirIfMissing(dir);
+    if (!s.ok()) {
+      fprintf(stderr, "ingest: %s\n", s.ToString()->c_str());
+      exit(1);
+    }
+
+    // Each thread writes its own range of keys, split evenly between the
+    // files
+    const int64_t num_keys = FLAGS_num * FLAGS_threads;
+    const int64_t first_key = FLAGS_num * thread->tid;
+    const int64_t keys_per_file =
+        std::max<int64_t>(1, FLAGS_num / FLAGS_ingest_num_files);
+    RandomGenerator gen;
+    std::unique_ptr<const char[]> key_guard;
+    Slice key = AllocateKey(&key_guard);
+    SstFileWriter sst_file_writer(EnvOptions(), db->GetOptions());
+    std::vector<std::string> files;
+    for (int64_t k = 0; k < FLAGS_num; k += keys_per_file) {
+      std::string file = dir + "/" + std::to_string(files.size()) + ".sst";
+      s = sst_file_writer.Open(file);
+      for (int64_t i = k; s.ok() && i < std::min(k + keys_per_file, FLAGS_num);
+           i++) {
+        GenerateKeyFromInt(first_key + i, num_keys, &key);
+        s = sst_file_writer.Put(key, gen.Generate());
+      }
+      if (s.ok()) {
+        s = sst_file_writer.Finish();
+      }
+      if (!s.ok()) {
+        fprintf(stderr, "ingest: %s\n", s.ToString()->c_str());
+        exit(1);
+      }
+      files.push_back(file);
+    }
+
+    // Only the ingestion is timed
+    thread->stats.Start(thread->tid);
+    IngestExternalFileOptions ifo;
+    ifo.move_files = FLAGS_ingest_move_files;
+    ifo.max_threads = FLAGS_ingest_max_threads;
+    const uint64_t start = FLAGS_env->NowMicros();
+    s = db->IngestExternalFile(files, ifo);
+    const uint64_t micros = FLAGS_env->NowMicros() - start;
+    if (!s.ok()) {
+      fprintf(stderr, "ingest: %s\n", s.ToString()->c_str());
+      exit(1);
+    }
+    thread->stats.FinishedOps(nullptr, db, 1, OperationType::kOthers);
+
+    for (const std::string& file : files) {
+      // Already gone if moved
+      FLAGS_env->DeleteFile(file);
+    }
+    FLAGS_env->DeleteDir(dir);
+
+    char msg[100];
+    snprintf(msg, sizeof(msg),
+             "(%" ROCKSDB_PRIszt " files, %" PRIu64 " keys in %.3f ms)",
+             files.size(), static_cast<uint64_t>(FLAGS_num), micros / 1000.0);
+    thread->stats.AddMessage(msg);
+  }
+
   void CompactAll() {
     CompactRangeOptions cro;
     cro.max_subcompactions = static_cast<uint32_t>(FLAGS_subcompactions);
@@ -8277,6 +8625,32 @@ class Benchmark {
     fprintf(stdout, "flush memtable\n");
   }
 
+  // Closes and reopens the DBs, and reports how long opening them took. Run it
+  // after writes that are still in the WALs (e.g. with a large
+  // --write_buffer_size) to measure WAL recovery, for instance with different
+  // --wal_recovery_threads.
+  void Recover() {
+    uint64_t open_micros = 0;
+    if (db_.db != nullptr) {
+      db_.DeleteDBs();
+      uint64_t start = FLAGS_env->NowMicros();
+      OpenDb(open_options_, FLAGS_db, &db_);
+      open_micros += FLAGS_env->NowMicros() - start;
+    }
+    Options options = open_options_;
+    for (size_t i = 0; i < multi_dbs_.size(); i++) {
+      multi_dbs_[i].DeleteDBs();
+      if (!open_options_.wal_dir.empty()) {
+        options.wal_dir = GetPathForMultiple(open_options_.wal_dir, i);
+      }
+      uint64_t start = FLAGS_env->NowMicros();
+      OpenDb(options, GetPathForMultiple(FLAGS_db, i), &multi_dbs_[i]);
+      open_micros += FLAGS_env->NowMicros() - start;
+    }
+    fprintf(stdout, "%-12s : %11.3f seconds to reopen the DB\n", "recover",
+            open_micros / 1000000.0);
+  }
+
   void ResetStats() {
     if (db_.db != nullptr) {
       db_.db->ResetStats();
@@ -8465,6 +8839,7 @@ int db_bench_tool(int argc, char** argv) {
     SetVersionString(GetRocksVersionAsString(true));
     initialized = true;
   }
+  command_line.assign(argv, argv + argc);
   ParseCommandLineFlags(&argc, &argv, true);
   FLAGS_compaction_style_e = (rocksdb::CompactionStyle)FLAGS_compaction_style;
   if (FLAGS_statistics && !FLAGS_statistics_string.empty()) {
@@ -8590,6 +8965,18 @@ int db_bench_tool(int argc, char** argv) {
                                   rocksdb::Env::Priority::BOTTOM);
   FLAGS_env->SetBackgroundThreads(FLAGS_num_low_pri_threads,
                                   rocksdb::Env::Priority::LOW);
+  if (FLAGS_thread_pool_work_stealing) {
+    for (auto pri : {rocksdb::Env::Priority::BOTTOM, rocksdb::Env::Priority::LOW,
+                     rocksdb::Env::Priority::HIGH}) {
+      rocksdb_rs::status::Status s =
+          FLAGS_env->SetThreadPoolWorkStealing(pri, true);
+      if (!s.ok()) {
+        fprintf(stderr, "Unable to enable thread pool work stealing: %s\n",
+                s.ToString()->c_str());
+        exit(1);
+      }
+    }
+  }
 
   // Choose a location for the test database if none given with --db=<path>
   if (FLAGS_db.empty()) {
@@ -8618,6 +9005,13 @@ int db_bench_tool(int argc, char** argv) {
     exit(1);
   }
 
+  if (FLAGS_local_compaction_service_worker) {
+    // The DB belongs to the process that spawned the worker
+    FLAGS_use_existing_db = true;
+    rocksdb::Benchmark benchmark;
+    return benchmark.RunCompactionServiceWorker();
+  }
+
   rocksdb::Benchmark benchmark;
   benchmark.Run();
 
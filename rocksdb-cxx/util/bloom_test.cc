@@ -150,6 +150,19 @@ class FullBloomTest : public testing::TestWithParam<std::string> {
     return bits_reader_->MayMatch(s);
   }
 
+  // Like Matches() on each key, through the batched interface taking the
+  // hashes of the keys
+  void MatchesWithHashes(int num_keys, Slice** keys, bool* may_match) {
+    if (bits_reader_ == nullptr) {
+      Build();
+    }
+    std::vector<uint64_t> hashes(num_keys);
+    for (int i = 0; i < num_keys; i++) {
+      hashes[i] = GetSliceHash64(*keys[i]);
+    }
+    bits_reader_->MayMatchWithHashes(num_keys, keys, hashes.data(), may_match);
+  }
+
   // Provides a kind of fingerprint on the Bloom filter's
   // behavior, for reasonbly high FP rates.
   uint64_t PackedMatches() {
@@ -288,6 +301,40 @@ TEST_P(FullBloomTest, FullSmall) {
   ASSERT_TRUE(!Matches("foo"));
 }
 
+TEST_P(FullBloomTest, BatchedMatchesWithHashes) {
+  char buffer[sizeof(int)];
+  for (int i = 0; i < 1000; i++) {
+    Add(Key(i, buffer));
+  }
+
+  constexpr int kBatchSize = 32;
+  std::array<std::string, kBatchSize> key_data;
+  std::array<Slice, kBatchSize> keys;
+  std::array<Slice*, kBatchSize> key_ptrs;
+  std::array<bool, kBatchSize> may_match;
+  int fp_count = 0;
+  // Half added keys, half not added
+  for (int start = 0; start < 2000; start += kBatchSize) {
+    for (int j = 0; j < kBatchSize; j++) {
+      key_data[j] = Key(start + j, buffer).ToString();
+      keys[j] = key_data[j];
+      key_ptrs[j] = &keys[j];
+    }
+    MatchesWithHashes(kBatchSize, key_ptrs.data(), may_match.data());
+    for (int j = 0; j < kBatchSize; j++) {
+      ASSERT_EQ(Matches(keys[j]), may_match[j]) << "key " << start + j;
+      if (start + j < 1000) {
+        ASSERT_TRUE(may_match[j]) << "key " << start + j;
+      } else {
+        fp_count += may_match[j];
+      }
+    }
+  }
+  if (FLAGS_bits_per_key == 10) {
+    EXPECT_LE(fp_count, 40);
+  }
+}
+
 TEST_P(FullBloomTest, FullVaryingLengths) {
   char buffer[sizeof(int)];
 
@@ -19,6 +19,13 @@ StreamingCompress* StreamingCompress::Create(
       return new ZSTDStreamingCompress(opts, compress_format_version,
                                        max_output_len);
     }
+    case rocksdb_rs::compression_type::CompressionType::kLZ4Compression: {
+      if (!LZ4_Streaming_Supported()) {
+        return nullptr;
+      }
+      return new LZ4StreamingCompress(opts, compress_format_version,
+                                      max_output_len);
+    }
     default:
       return nullptr;
   }
@@ -35,6 +42,13 @@ StreamingUncompress* StreamingUncompress::Create(
       return new ZSTDStreamingUncompress(compress_format_version,
                                          max_output_len);
     }
+    case rocksdb_rs::compression_type::CompressionType::kLZ4Compression: {
+      if (!LZ4_Streaming_Supported()) {
+        return nullptr;
+      }
+      return new LZ4StreamingUncompress(compress_format_version,
+                                        max_output_len);
+    }
     default:
       return nullptr;
   }
@@ -83,6 +97,17 @@ void ZSTDStreamingCompress::Reset() {
 #endif
 }
 
+bool ZSTDStreamingCompress::SetDictionary(const Slice& dict) {
+#ifdef ZSTD_STREAMING
+  // The dictionary survives the session resets between inputs
+  return !ZSTD_isError(
+      ZSTD_CCtx_loadDictionary(cctx_, dict.data(), dict.size()));
+#else
+  (void)dict;
+  return false;
+#endif
+}
+
 int ZSTDStreamingUncompress::Uncompress(const char* input, size_t input_size,
                                         char* output, size_t* output_pos) {
   assert(output != nullptr && output_pos != nullptr);
@@ -119,4 +144,146 @@ void ZSTDStreamingUncompress::Reset() {
 #endif
 }
 
+bool ZSTDStreamingUncompress::SetDictionary(const Slice& dict) {
+#ifdef ZSTD_STREAMING
+  return !ZSTD_isError(
+      ZSTD_DCtx_loadDictionary(dctx_, dict.data(), dict.size()));
+#else
+  (void)dict;
+  return false;
+#endif
+}
+
+namespace {
+// Largest encoding of the two varint32 sizes heading an LZ4 block
+constexpr size_t kMaxLZ4BlockHeaderSize = 10;
+
+// Parses the block at the start of `input`. Returns false if `input` does not
+// hold all of it yet.
+bool ParseLZ4Block(Slice input, uint32_t* uncompressed_size,
+                   Slice* compressed) {
+  uint32_t compressed_size;
+  if (!GetVarint32(&input, uncompressed_size) ||
+      !GetVarint32(&input, &compressed_size) ||
+      input.size() < compressed_size) {
+    return false;
+  }
+  *compressed = Slice(input.data(), compressed_size);
+  return true;
+}
+}  // namespace
+
+int LZ4StreamingCompress::Compress(const char* input, size_t input_size,
+                                   char* output, size_t* output_pos) {
+  assert(input != nullptr && output != nullptr && output_pos != nullptr);
+  *output_pos = 0;
+  // Don't need to compress an empty input
+  if (input_size == 0) {
+    return 0;
+  }
+#ifdef LZ4_STREAMING
+  if (input_ != input) {
+    // New input
+    input_ = input;
+    input_pos_ = 0;
+  }
+  // Largest block whose compressed form is guaranteed to fit in the output,
+  // from the definition of LZ4_compressBound()
+  assert(max_output_len_ > kMaxLZ4BlockHeaderSize + 16);
+  const size_t max_compressed_size = max_output_len_ - kMaxLZ4BlockHeaderSize;
+  size_t max_block_size = (max_compressed_size - 16) * 255 / 256;
+  while (static_cast<size_t>(LZ4_compressBound(
+             static_cast<int>(max_block_size))) > max_compressed_size) {
+    max_block_size--;
+  }
+  const size_t block_size = std::min(input_size - input_pos_, max_block_size);
+
+  // Compress past the largest header, then move the data next to the actual
+  // header
+  char* compressed = output + kMaxLZ4BlockHeaderSize;
+  int compressed_size = LZ4_compress_fast_extState(
+      stream_, input + input_pos_, compressed, static_cast<int>(block_size),
+      static_cast<int>(max_compressed_size), /*acceleration=*/1);
+  if (compressed_size <= 0) {
+    // Failure
+    Reset();
+    return -1;
+  }
+  char* p = rocksdb_rs::coding::EncodeVarint32(
+      output, static_cast<uint32_t>(block_size));
+  p = rocksdb_rs::coding::EncodeVarint32(
+      p, static_cast<uint32_t>(compressed_size));
+  memmove(p, compressed, static_cast<size_t>(compressed_size));
+  *output_pos =
+      static_cast<size_t>(p - output) + static_cast<size_t>(compressed_size);
+  input_pos_ += block_size;
+  return static_cast<int>(input_size - input_pos_);
+#else
+  (void)input;
+  (void)input_size;
+  (void)output;
+  return -1;
+#endif
+}
+
+void LZ4StreamingCompress::Reset() {
+  input_ = nullptr;
+  input_pos_ = 0;
+}
+
+int LZ4StreamingUncompress::Uncompress(const char* input, size_t input_size,
+                                       char* output, size_t* output_pos) {
+  assert(output != nullptr && output_pos != nullptr);
+  *output_pos = 0;
+  // Don't need to uncompress an empty input
+  if (input_size == 0) {
+    return 0;
+  }
+#ifdef LZ4_STREAMING
+  if (input) {
+    // New input
+    pending_.erase(0, pending_pos_);
+    pending_pos_ = 0;
+    pending_.append(input, input_size);
+  }
+  uint32_t uncompressed_size;
+  Slice compressed;
+  if (!ParseLZ4Block(Slice(pending_.data() + pending_pos_,
+                           pending_.size() - pending_pos_),
+                     &uncompressed_size, &compressed)) {
+    // Wait for the rest of the block
+    return 0;
+  }
+  if (uncompressed_size > max_output_len_) {
+    Reset();
+    return -1;
+  }
+  int ret = LZ4_decompress_safe(compressed.data(), output,
+                                static_cast<int>(compressed.size()),
+                                static_cast<int>(uncompressed_size));
+  if (ret < 0 || static_cast<uint32_t>(ret) != uncompressed_size) {
+    Reset();
+    return -1;
+  }
+  *output_pos = uncompressed_size;
+  pending_pos_ = static_cast<size_t>(compressed.data() + compressed.size() -
+                                     pending_.data());
+  // Only report the input left once it holds a whole block, so that the
+  // caller stops calling until it has more input otherwise
+  Slice rest(pending_.data() + pending_pos_, pending_.size() - pending_pos_);
+  return ParseLZ4Block(rest, &uncompressed_size, &compressed)
+             ? static_cast<int>(rest.size())
+             : 0;
+#else
+  (void)input;
+  (void)output;
+  return -1;
+#endif
+}
+
+void LZ4StreamingUncompress::Reset() {
+  pending_.clear();
+  pending_pos_ = 0;
+}
+
 }  // namespace rocksdb
@@ -44,6 +44,10 @@
 #if defined(LZ4)
 #include <lz4.h>
 #include <lz4hc.h>
+// r129+
+#if LZ4_VERSION_NUMBER >= 10700
+#define LZ4_STREAMING
+#endif  // LZ4_VERSION_NUMBER >= 10700
 #endif
 
 #if defined(ZSTD)
@@ -544,6 +548,14 @@ inline bool ZSTD_Streaming_Supported() {
 #endif
 }
 
+inline bool LZ4_Streaming_Supported() {
+#ifdef LZ4_STREAMING
+  return true;
+#else
+  return false;
+#endif
+}
+
 inline bool StreamingCompressionTypeSupported(
     rocksdb_rs::compression_type::CompressionType compression_type) {
   switch (compression_type) {
@@ -551,6 +563,8 @@ inline bool StreamingCompressionTypeSupported(
       return true;
     case rocksdb_rs::compression_type::CompressionType::kZSTD:
       return ZSTD_Streaming_Supported();
+    case rocksdb_rs::compression_type::CompressionType::kLZ4Compression:
+      return LZ4_Streaming_Supported();
     default:
       return false;
   }
@@ -682,6 +696,15 @@ inline std::string CompressionOptionsToString(
   result.append("use_zstd_dict_trainer=")
       .append(std::to_string(compression_options.use_zstd_dict_trainer))
       .append("; ");
+  if (compression_options.adaptive_sample_window > 0) {
+    result.append("adaptive_sample_window=")
+        .append(std::to_string(compression_options.adaptive_sample_window))
+        .append("; ");
+    result.append("adaptive_min_savings_per_kb=")
+        .append(
+            std::to_string(compression_options.adaptive_min_savings_per_kb))
+        .append("; ");
+  }
   return result;
 }
 
@@ -1716,6 +1739,10 @@ class StreamingCompress {
       const CompressionOptions& opts, uint32_t compress_format_version,
       size_t max_output_len);
   virtual void Reset() = 0;
+  // Makes the following inputs compress with the dictionary `dict`, copied,
+  // which the StreamingUncompress must be given too. Returns false if the
+  // compression type does not support dictionaries.
+  virtual bool SetDictionary(const Slice& /*dict*/) { return false; }
 
  protected:
   const rocksdb_rs::compression_type::CompressionType compression_type_;
@@ -1757,6 +1784,9 @@ class StreamingUncompress {
       rocksdb_rs::compression_type::CompressionType compression_type,
       uint32_t compress_format_version, size_t max_output_len);
   virtual void Reset() = 0;
+  // Sets the dictionary the input was compressed with. Returns false if it
+  // is not a valid dictionary for the compression type.
+  virtual bool SetDictionary(const Slice& /*dict*/) { return false; }
 
  protected:
   rocksdb_rs::compression_type::CompressionType compression_type_;
@@ -1787,6 +1817,7 @@ class ZSTDStreamingCompress final : public StreamingCompress {
   int Compress(const char* input, size_t input_size, char* output,
                size_t* output_pos) override;
   void Reset() override;
+  bool SetDictionary(const Slice& dict) override;
 #ifdef ZSTD_STREAMING
   ZSTD_CCtx* cctx_;
   ZSTD_inBuffer input_buffer_;
@@ -1814,6 +1845,7 @@ class ZSTDStreamingUncompress final : public StreamingUncompress {
   int Uncompress(const char* input, size_t input_size, char* output,
                  size_t* output_size) override;
   void Reset() override;
+  bool SetDictionary(const Slice& dict) override;
 
  private:
 #ifdef ZSTD_STREAMING
@@ -1822,4 +1854,58 @@ class ZSTDStreamingUncompress final : public StreamingUncompress {
 #endif
 };
 
+// Compresses each input as a sequence of independent LZ4 blocks, each small
+// enough for its compressed form to fit in one output buffer, and stored as
+//   varint32 uncompressed size
+//   varint32 compressed size
+//   compressed data
+// LZ4 trades compression ratio for much lower latency than ZSTD.
+class LZ4StreamingCompress final : public StreamingCompress {
+ public:
+  explicit LZ4StreamingCompress(const CompressionOptions& opts,
+                                uint32_t compress_format_version,
+                                size_t max_output_len)
+      : StreamingCompress(
+            rocksdb_rs::compression_type::CompressionType::kLZ4Compression,
+            opts, compress_format_version, max_output_len) {
+#ifdef LZ4_STREAMING
+    stream_ = LZ4_createStream();
+    assert(stream_ != nullptr);
+#endif
+  }
+  ~LZ4StreamingCompress() override {
+#ifdef LZ4_STREAMING
+    LZ4_freeStream(stream_);
+#endif
+  }
+  int Compress(const char* input, size_t input_size, char* output,
+               size_t* output_pos) override;
+  void Reset() override;
+
+ private:
+#ifdef LZ4_STREAMING
+  LZ4_stream_t* stream_;
+#endif
+  const char* input_ = nullptr;
+  size_t input_pos_ = 0;
+};
+
+class LZ4StreamingUncompress final : public StreamingUncompress {
+ public:
+  explicit LZ4StreamingUncompress(uint32_t compress_format_version,
+                                  size_t max_output_len)
+      : StreamingUncompress(
+            rocksdb_rs::compression_type::CompressionType::kLZ4Compression,
+            compress_format_version, max_output_len) {}
+  int Uncompress(const char* input, size_t input_size, char* output,
+                 size_t* output_size) override;
+  void Reset() override;
+
+ private:
+  // Input not uncompressed yet, starting at pending_pos_. A block can span
+  // several inputs.
+  std::string pending_;
+  size_t pending_pos_ = 0;
+};
+
 }  // namespace rocksdb
@@ -240,6 +240,7 @@ enum class TestMode {
   kSingleFilter,
   kBatchPrepared,
   kBatchUnprepared,
+  kBatchPrehashed,
   kFiftyOneFilter,
   kEightyTwentyFilter,
   kRandomFilter,
@@ -247,8 +248,9 @@ enum class TestMode {
 
 static const std::vector<TestMode> allTestModes = {
     TestMode::kSingleFilter,       TestMode::kBatchPrepared,
-    TestMode::kBatchUnprepared,    TestMode::kFiftyOneFilter,
-    TestMode::kEightyTwentyFilter, TestMode::kRandomFilter,
+    TestMode::kBatchUnprepared,    TestMode::kBatchPrehashed,
+    TestMode::kFiftyOneFilter,     TestMode::kEightyTwentyFilter,
+    TestMode::kRandomFilter,
 };
 
 static const std::vector<TestMode> quickTestModes = {
@@ -268,6 +270,8 @@ const char *TestModeToString(TestMode tm) {
       return "Batched, prepared";
     case TestMode::kBatchUnprepared:
       return "Batched, unprepared";
+    case TestMode::kBatchPrehashed:
+      return "Batched, prehashed";
     case TestMode::kFiftyOneFilter:
       return "Skewed 50% in 1%";
     case TestMode::kEightyTwentyFilter:
@@ -648,13 +652,16 @@ double FilterBench::RandomQueryTest(uint32_t inside_threshold, bool dry_run,
   std::unique_ptr<Slice[]> batch_slices;
   std::unique_ptr<Slice *[]> batch_slice_ptrs;
   std::unique_ptr<bool[]> batch_results;
-  if (mode == TestMode::kBatchPrepared || mode == TestMode::kBatchUnprepared) {
+  std::unique_ptr<uint64_t[]> batch_hashes;
+  if (mode == TestMode::kBatchPrepared || mode == TestMode::kBatchUnprepared ||
+      mode == TestMode::kBatchPrehashed) {
     batch_size = static_cast<uint32_t>(kms_.size());
   }
 
   batch_slices.reset(new Slice[batch_size]);
   batch_slice_ptrs.reset(new Slice *[batch_size]);
   batch_results.reset(new bool[batch_size]);
+  batch_hashes.reset(new uint64_t[batch_size]);
   for (uint32_t i = 0; i < batch_size; ++i) {
     batch_results[i] = false;
     batch_slice_ptrs[i] = &batch_slices[i];
@@ -687,16 +694,31 @@ double FilterBench::RandomQueryTest(uint32_t inside_threshold, bool dry_run,
     }
     // TODO: implement batched interface to full block reader
     // TODO: implement batched interface to plain table bloom
-    if (mode == TestMode::kBatchPrepared && !FLAGS_use_full_block_reader &&
-        !FLAGS_use_plain_table_bloom) {
+    if ((mode == TestMode::kBatchPrepared ||
+         mode == TestMode::kBatchPrehashed) &&
+        !FLAGS_use_full_block_reader && !FLAGS_use_plain_table_bloom) {
       for (uint32_t i = 0; i < batch_size; ++i) {
         batch_results[i] = false;
       }
+      if (mode == TestMode::kBatchPrehashed) {
+        // As MultiGet does once for all the filters it checks a batch
+        // against. Part of the dry run too, so never in the net time.
+        for (uint32_t i = 0; i < batch_size; ++i) {
+          batch_hashes[i] = GetSliceHash64(batch_slices[i]);
+          dry_run_hash += static_cast<uint32_t>(batch_hashes[i]);
+        }
+      }
       if (dry_run) {
         for (uint32_t i = 0; i < batch_size; ++i) {
           batch_results[i] = true;
-          dry_run_hash += dry_run_hash_fn(batch_slices[i]);
+          if (mode == TestMode::kBatchPrepared) {
+            dry_run_hash += dry_run_hash_fn(batch_slices[i]);
+          }
         }
+      } else if (mode == TestMode::kBatchPrehashed) {
+        info.reader_->MayMatchWithHashes(batch_size, batch_slice_ptrs.get(),
+                                         batch_hashes.get(),
+                                         batch_results.get());
       } else {
         info.reader_->MayMatch(batch_size, batch_slice_ptrs.get(),
                                batch_results.get());
@@ -820,6 +842,9 @@ int main(int argc, char **argv) {
         << std::endl
         << "  \"Batched, unprepared\" - similar, but using serial calls"
         << "\n     to single query interface." << std::endl
+        << "  \"Batched, prehashed\" - like \"Batched, prepared\", with the"
+        << "\n     keys hashed beforehand as MultiGet does once for all"
+        << "\n     filters. Net time never includes hashing." << std::endl
         << "  \"Random filter\" - a filter is chosen at random as target"
         << "\n     of each query." << std::endl
         << "  \"Skewed X% in Y%\" - like \"Random filter\" except Y% of"
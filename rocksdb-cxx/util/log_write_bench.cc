@@ -11,6 +11,8 @@ int main() {
 }
 #else
 
+#include "db/log_writer.h"
+#include "db/wal_compression_dict_builder.h"
 #include "file/writable_file_writer.h"
 #include "monitoring/histogram.h"
 #include "rocksdb/env.h"
@@ -18,6 +20,7 @@ int main() {
 #include "test_util/testharness.h"
 #include "test_util/testutil.h"
 #include "util/gflags_compat.h"
+#include "util/random.h"
 
 using GFLAGS_NAMESPACE::ParseCommandLineFlags;
 using GFLAGS_NAMESPACE::SetUsageMessage;
@@ -29,9 +32,36 @@ DEFINE_int32(record_size, 249, "Size of each record.");
 DEFINE_int32(record_interval, 10000, "Interval between records (microSec)");
 DEFINE_int32(bytes_per_sync, 0, "bytes_per_sync parameter in EnvOptions");
 DEFINE_bool(enable_sync, false, "sync after each write.");
+DEFINE_string(wal_compression, "none",
+              "Compression of the records: none, lz4 or zstd.");
+DEFINE_uint32(wal_compression_max_dict_bytes, 0,
+              "With --wal_compression=zstd, size of the dictionary trained "
+              "from records before the benchmark. 0 to disable.");
+DEFINE_double(compression_ratio, 0.5,
+              "Fraction of its size each record compresses to.");
 
 namespace rocksdb {
 void RunBenchmark() {
+  rocksdb_rs::compression_type::CompressionType compression_type;
+  if (FLAGS_wal_compression == "none") {
+    compression_type =
+        rocksdb_rs::compression_type::CompressionType::kNoCompression;
+  } else if (FLAGS_wal_compression == "lz4") {
+    compression_type =
+        rocksdb_rs::compression_type::CompressionType::kLZ4Compression;
+  } else if (FLAGS_wal_compression == "zstd") {
+    compression_type = rocksdb_rs::compression_type::CompressionType::kZSTD;
+  } else {
+    fprintf(stderr, "Unknown --wal_compression %s\n",
+            FLAGS_wal_compression.c_str());
+    exit(1);
+  }
+  if (!StreamingCompressionTypeSupported(compression_type)) {
+    fprintf(stderr, "WAL compression %s is not supported\n",
+            FLAGS_wal_compression.c_str());
+    exit(1);
+  }
+
   std::string file_name = test::PerThreadDBPath("log_write_benchmark.log");
   DBOptions options;
   Env* env = Env::Default();
@@ -40,23 +70,45 @@ void RunBenchmark() {
   env_options.bytes_per_sync = FLAGS_bytes_per_sync;
   std::unique_ptr<WritableFile> file;
   env->NewWritableFile(file_name, &file, env_options);
-  std::unique_ptr<WritableFileWriter> writer;
-  writer.reset(new WritableFileWriter(std::move(file), file_name, env_options,
-                                      clock, nullptr /* stats */,
-                                      options.listeners));
+  std::unique_ptr<WritableFileWriter> file_writer;
+  file_writer.reset(new WritableFileWriter(std::move(file), file_name,
+                                           env_options, clock,
+                                           nullptr /* stats */,
+                                           options.listeners));
+  log::Writer writer(std::move(file_writer), /*log_number=*/1,
+                     /*recycle_log_files=*/false, /*manual_flush=*/false,
+                     compression_type);
 
-  std::string record;
-  record.assign(FLAGS_record_size, 'X');
+  // Distinct records, as compressible as requested
+  Random rnd(301);
+  std::vector<std::string> records(1000);
+  for (auto& record : records) {
+    test::CompressibleString(&rnd, FLAGS_compression_ratio, FLAGS_record_size,
+                             &record);
+  }
+
+  std::string compression_dict;
+  if (FLAGS_wal_compression_max_dict_bytes > 0) {
+    WalCompressionDictBuilder dict_builder(
+        FLAGS_wal_compression_max_dict_bytes);
+    for (size_t i = 0; compression_dict.empty(); ++i) {
+      dict_builder.AddSample(records[i % records.size()]);
+      if (i % records.size() == records.size() - 1) {
+        compression_dict = dict_builder.GetDictionary();
+      }
+    }
+  }
+  writer.AddCompressionTypeRecord(compression_dict);
 
   HistogramImpl hist;
 
   uint64_t start_time = clock->NowMicros();
+  uint64_t start_cpu_nanos = clock->CPUNanos();
   for (int i = 0; i < FLAGS_num_records; i++) {
     uint64_t start_nanos = clock->NowNanos();
-    writer->Append(record);
-    writer->Flush();
+    writer.AddRecord(records[i % records.size()]);
     if (FLAGS_enable_sync) {
-      writer->Sync(false);
+      writer.file()->Sync(false);
     }
     hist.Add(clock->NowNanos() - start_nanos);
 
@@ -70,9 +122,21 @@ void RunBenchmark() {
       clock->SleepForMicroseconds(time_to_sleep);
     }
   }
+  uint64_t cpu_nanos = clock->CPUNanos() - start_cpu_nanos;
+  double elapsed_secs =
+      std::max<uint64_t>(clock->NowMicros() - start_time, 1) / 1e6;
+  uint64_t record_bytes =
+      static_cast<uint64_t>(FLAGS_num_records) * FLAGS_record_size;
+  uint64_t wal_bytes = writer.file()->GetFileSize();
 
   fprintf(stderr, "Distribution of latency of append+flush: \n%s",
           hist.ToString().c_str());
+  fprintf(stderr,
+          "Record bytes/sec: %.0f\nWAL bytes/sec: %.0f\n"
+          "WAL bytes per record byte: %.3f\nCPU nanos per record: %.0f\n",
+          record_bytes / elapsed_secs, wal_bytes / elapsed_secs,
+          static_cast<double>(wal_bytes) / std::max<uint64_t>(record_bytes, 1),
+          static_cast<double>(cpu_nanos) / std::max(FLAGS_num_records, 1));
 }
 }  // namespace rocksdb
 
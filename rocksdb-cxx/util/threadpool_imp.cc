@@ -60,6 +60,8 @@ struct ThreadPoolImpl::Impl {
 
   void LowerCPUPriority(rocksdb_rs::port_defs::CpuPriority pri);
 
+  void SetWorkStealing(bool enabled);
+
   void WakeUpAllThreads() { bgsignal_.notify_all(); }
 
   void BGThread(size_t thread_id);
@@ -108,6 +110,7 @@ struct ThreadPoolImpl::Impl {
         std::min(std::max(num_waiting_threads_ - reserved_threads_, 0),
                  threads_to_be_reserved);
     reserved_threads_ += reserved_threads_in_success;
+    UpdateStealingThreadsLimit();
     return reserved_threads_in_success;
   }
 
@@ -117,6 +120,7 @@ struct ThreadPoolImpl::Impl {
     int released_threads_in_success =
         std::min(reserved_threads_, threads_to_be_released);
     reserved_threads_ -= released_threads_in_success;
+    UpdateStealingThreadsLimit();
     WakeUpAllThreads();
     return released_threads_in_success;
   }
@@ -124,13 +128,33 @@ struct ThreadPoolImpl::Impl {
  private:
   static void BGThreadWrapper(void* arg);
 
-  bool low_io_priority_;
-  rocksdb_rs::port_defs::CpuPriority cpu_priority_;
+  void SubmitToShard(std::function<void()>&& schedule,
+                     std::function<void()>&& unschedule, void* tag);
+
+  // Takes the oldest job of the thread's own shard, or else steals the oldest
+  // job of another shard. Returns false if all the shards are empty.
+  bool TakeFromShards(size_t thread_id, std::function<void()>* func);
+
+  // Must be called with mu_ held whenever one of the inputs of
+  // stealing_threads_limit_ changes
+  void UpdateStealingThreadsLimit() {
+    stealing_threads_limit_.store(
+        work_stealing_ && !exit_all_threads_ && reserved_threads_ == 0
+            ? total_threads_limit_
+            : 0,
+        std::memory_order_release);
+  }
+
+  // Read by the threads without holding mu_ when work stealing is enabled
+  std::atomic<bool> low_io_priority_;
+  std::atomic<rocksdb_rs::port_defs::CpuPriority> cpu_priority_;
   Env::Priority priority_;
   Env* env_;
 
   int total_threads_limit_;
-  std::atomic_uint queue_len_;  // Queue length. Used for stats reporting
+  // Number of jobs in queue_ and in the shards. Used for stats reporting, and
+  // by the threads to tell whether there is a job to wait for.
+  std::atomic_uint queue_len_;
   // Number of reserved threads, managed by ReserveThreads(..) and
   // ReleaseThreads(..), if num_waiting_threads_ is no larger than
   // reserved_threads_, its thread will be blocked to ensure the reservation
@@ -140,8 +164,8 @@ struct ThreadPoolImpl::Impl {
   // reserved), in rare cases, num_waiting_threads_ could be less than
   // reserved_threads due to SetBackgroundThreadInternal or last
   // excessive threads.
-  int num_waiting_threads_;
-  bool exit_all_threads_;
+  std::atomic<int> num_waiting_threads_;
+  std::atomic<bool> exit_all_threads_;
   bool wait_for_jobs_to_complete_;
 
   // Entry per Schedule()/Submit() call
@@ -154,11 +178,38 @@ struct ThreadPoolImpl::Impl {
   using BGQueue = std::deque<BGItem>;
   BGQueue queue_;
 
+  // Work stealing mode, see ThreadPoolImpl::SetWorkStealing(). New jobs go to
+  // the shards instead of queue_, without holding mu_, and each thread takes
+  // its jobs from its own shard first. A thread whose id is below
+  // stealing_threads_limit_ takes its next job without going through mu_, as
+  // it is neither excessive nor held back by a reservation; the others, and
+  // the threads that find all the shards empty, wait under mu_ as usual.
+  // Lock order is mu_, then the shard mutexes.
+  struct ALIGN_AS(CACHE_LINE_SIZE) Shard {
+    std::mutex mu;
+    BGQueue queue;
+  };
+  std::atomic<bool> work_stealing_;
+  std::atomic<int> stealing_threads_limit_;
+  std::atomic<size_t> next_shard_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+
   std::mutex mu_;
   std::condition_variable bgsignal_;
   std::vector<port::Thread> bgthreads_;
 };
 
+namespace {
+// The pool and thread id of the background thread running on this thread, if
+// any, so that the jobs it submits go to its own shard
+thread_local ThreadPoolImpl::Impl* current_pool = nullptr;
+thread_local size_t current_thread_id = 0;
+
+// Upper bound on the number of shards of a pool, so that finding all of them
+// empty stays cheap on hosts with many cores
+constexpr unsigned int kMaxWorkStealingShards = 64;
+}  // namespace
+
 inline ThreadPoolImpl::Impl::Impl()
     : low_io_priority_(false),
       cpu_priority_(rocksdb_rs::port_defs::CpuPriority::kNormal),
@@ -171,9 +222,19 @@ inline ThreadPoolImpl::Impl::Impl()
       exit_all_threads_(false),
       wait_for_jobs_to_complete_(false),
       queue_(),
+      work_stealing_(false),
+      stealing_threads_limit_(0),
+      next_shard_(0),
+      shards_(),
       mu_(),
       bgsignal_(),
-      bgthreads_() {}
+      bgthreads_() {
+  unsigned int num_shards = std::min(
+      std::max(std::thread::hardware_concurrency(), 1U), kMaxWorkStealingShards);
+  for (unsigned int i = 0; i < num_shards; ++i) {
+    shards_.emplace_back(new Shard());
+  }
+}
 
 inline ThreadPoolImpl::Impl::~Impl() { assert(bgthreads_.size() == 0U); }
 
@@ -188,6 +249,7 @@ void ThreadPoolImpl::Impl::JoinThreads(bool wait_for_jobs_to_complete) {
   total_threads_limit_ = 0;
   reserved_threads_ = 0;
   num_waiting_threads_ = 0;
+  UpdateStealingThreadsLimit();
 
   lock.unlock();
 
@@ -214,66 +276,105 @@ inline void ThreadPoolImpl::Impl::LowerCPUPriority(
   cpu_priority_ = pri;
 }
 
+void ThreadPoolImpl::Impl::SetWorkStealing(bool enabled) {
+  std::lock_guard<std::mutex> lock(mu_);
+  // The jobs already queued stay where they are. The threads look for jobs
+  // both in queue_ and in the shards, whatever the mode.
+  work_stealing_ = enabled;
+  UpdateStealingThreadsLimit();
+}
+
+bool ThreadPoolImpl::Impl::TakeFromShards(size_t thread_id,
+                                          std::function<void()>* func) {
+  if (queue_len_.load(std::memory_order_relaxed) == 0) {
+    return false;
+  }
+  size_t num_shards = shards_.size();
+  for (size_t i = 0; i < num_shards; ++i) {
+    Shard& shard = *shards_[(thread_id + i) % num_shards];
+    std::lock_guard<std::mutex> lock(shard.mu);
+    if (!shard.queue.empty()) {
+      *func = std::move(shard.queue.front().function);
+      shard.queue.pop_front();
+      queue_len_.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  return false;
+}
+
 void ThreadPoolImpl::Impl::BGThread(size_t thread_id) {
   bool low_io_priority = false;
   rocksdb_rs::port_defs::CpuPriority current_cpu_priority =
       rocksdb_rs::port_defs::CpuPriority::kNormal;
+  current_pool = this;
+  current_thread_id = thread_id;
 
   while (true) {
-    // Wait until there is an item that is ready to run
-    std::unique_lock<std::mutex> lock(mu_);
-    // Stop waiting if the thread needs to do work or needs to terminate.
-    // Increase num_waiting_threads_ once this task has started waiting
-    num_waiting_threads_++;
-
-    TEST_SYNC_POINT("ThreadPoolImpl::BGThread::WaitingThreadsInc");
-    TEST_IDX_SYNC_POINT("ThreadPoolImpl::BGThread::Start:th", thread_id);
-    // When not exist_all_threads and the current thread id is not the last
-    // excessive thread, it may be blocked due to 3 reasons: 1) queue is empty
-    // 2) it is the excessive thread (not the last one)
-    // 3) the number of waiting threads is not greater than reserved threads
-    // (i.e, no available threads due to full reservation")
-    while (!exit_all_threads_ && !IsLastExcessiveThread(thread_id) &&
-           (queue_.empty() || IsExcessiveThread(thread_id) ||
-            num_waiting_threads_ <= reserved_threads_)) {
-      bgsignal_.wait(lock);
-    }
-    // Decrease num_waiting_threads_ once the thread is not waiting
-    num_waiting_threads_--;
+    std::function<void()> func;
+    if (static_cast<int>(thread_id) >=
+            stealing_threads_limit_.load(std::memory_order_acquire) ||
+        !TakeFromShards(thread_id, &func)) {
+      // Wait until there is an item that is ready to run
+      std::unique_lock<std::mutex> lock(mu_);
+      // Stop waiting if the thread needs to do work or needs to terminate.
+      // Increase num_waiting_threads_ once this task has started waiting
+      num_waiting_threads_++;
+
+      TEST_SYNC_POINT("ThreadPoolImpl::BGThread::WaitingThreadsInc");
+      TEST_IDX_SYNC_POINT("ThreadPoolImpl::BGThread::Start:th", thread_id);
+      // When not exist_all_threads and the current thread id is not the last
+      // excessive thread, it may be blocked due to 3 reasons: 1) queue is
+      // empty 2) it is the excessive thread (not the last one)
+      // 3) the number of waiting threads is not greater than reserved threads
+      // (i.e, no available threads due to full reservation")
+      while (!exit_all_threads_ && !IsLastExcessiveThread(thread_id) &&
+             (queue_len_.load() == 0 || IsExcessiveThread(thread_id) ||
+              num_waiting_threads_ <= reserved_threads_)) {
+        bgsignal_.wait(lock);
+      }
+      // Decrease num_waiting_threads_ once the thread is not waiting
+      num_waiting_threads_--;
 
-    if (exit_all_threads_) {  // mechanism to let BG threads exit safely
+      if (exit_all_threads_) {  // mechanism to let BG threads exit safely
 
-      if (!wait_for_jobs_to_complete_ || queue_.empty()) {
+        if (!wait_for_jobs_to_complete_ || queue_len_.load() == 0) {
+          break;
+        }
+      } else if (IsLastExcessiveThread(thread_id)) {
+        // Current thread is the last generated one and is excessive.
+        // We always terminate excessive thread in the reverse order of
+        // generation time. But not when `exit_all_threads_ == true`,
+        // otherwise `JoinThreads()` could try to `join()` a `detach()`ed
+        // thread.
+        auto& terminating_thread = bgthreads_.back();
+        terminating_thread.detach();
+        bgthreads_.pop_back();
+        if (HasExcessiveThread()) {
+          // There is still at least more excessive thread to terminate.
+          WakeUpAllThreads();
+        }
+        TEST_IDX_SYNC_POINT("ThreadPoolImpl::BGThread::Termination:th",
+                            thread_id);
+        TEST_SYNC_POINT("ThreadPoolImpl::BGThread::Termination");
         break;
       }
-    } else if (IsLastExcessiveThread(thread_id)) {
-      // Current thread is the last generated one and is excessive.
-      // We always terminate excessive thread in the reverse order of
-      // generation time. But not when `exit_all_threads_ == true`,
-      // otherwise `JoinThreads()` could try to `join()` a `detach()`ed
-      // thread.
-      auto& terminating_thread = bgthreads_.back();
-      terminating_thread.detach();
-      bgthreads_.pop_back();
-      if (HasExcessiveThread()) {
-        // There is still at least more excessive thread to terminate.
-        WakeUpAllThreads();
+
+      if (!queue_.empty()) {
+        func = std::move(queue_.front().function);
+        queue_.pop_front();
+        queue_len_.fetch_sub(1, std::memory_order_relaxed);
+      } else if (!TakeFromShards(thread_id, &func)) {
+        // queue_len_ counted a job that another thread is taking out of its
+        // shard without holding mu_
+        continue;
       }
-      TEST_IDX_SYNC_POINT("ThreadPoolImpl::BGThread::Termination:th",
-                          thread_id);
-      TEST_SYNC_POINT("ThreadPoolImpl::BGThread::Termination");
-      break;
     }
 
-    auto func = std::move(queue_.front().function);
-    queue_.pop_front();
-
-    queue_len_.store(static_cast<unsigned int>(queue_.size()),
-                     std::memory_order_relaxed);
-
-    bool decrease_io_priority = (low_io_priority != low_io_priority_);
-    rocksdb_rs::port_defs::CpuPriority cpu_priority = cpu_priority_;
-    lock.unlock();
+    bool decrease_io_priority =
+        (low_io_priority != low_io_priority_.load(std::memory_order_relaxed));
+    rocksdb_rs::port_defs::CpuPriority cpu_priority =
+        cpu_priority_.load(std::memory_order_relaxed);
 
     if (cpu_priority < current_cpu_priority) {
       TEST_SYNC_POINT_CALLBACK("ThreadPoolImpl::BGThread::BeforeSetCpuPriority",
@@ -368,6 +469,7 @@ void ThreadPoolImpl::Impl::SetBackgroundThreadsInternal(int num,
   if (num > total_threads_limit_ ||
       (num < total_threads_limit_ && allow_reduce)) {
     total_threads_limit_ = std::max(0, num);
+    UpdateStealingThreadsLimit();
     WakeUpAllThreads();
     StartBGThreads();
   }
@@ -404,6 +506,11 @@ void ThreadPoolImpl::Impl::StartBGThreads() {
 void ThreadPoolImpl::Impl::Submit(std::function<void()>&& schedule,
                                   std::function<void()>&& unschedule,
                                   void* tag) {
+  if (work_stealing_.load(std::memory_order_relaxed)) {
+    SubmitToShard(std::move(schedule), std::move(unschedule), tag);
+    return;
+  }
+
   std::lock_guard<std::mutex> lock(mu_);
 
   if (exit_all_threads_) {
@@ -420,8 +527,7 @@ void ThreadPoolImpl::Impl::Submit(std::function<void()>&& schedule,
   item.function = std::move(schedule);
   item.unschedFunction = std::move(unschedule);
 
-  queue_len_.store(static_cast<unsigned int>(queue_.size()),
-                   std::memory_order_relaxed);
+  queue_len_.fetch_add(1, std::memory_order_relaxed);
 
   if (!HasExcessiveThread()) {
     // Wake up at least one waiting thread.
@@ -433,6 +539,42 @@ void ThreadPoolImpl::Impl::Submit(std::function<void()>&& schedule,
   }
 }
 
+void ThreadPoolImpl::Impl::SubmitToShard(std::function<void()>&& schedule,
+                                         std::function<void()>&& unschedule,
+                                         void* tag) {
+  if (exit_all_threads_) {
+    return;
+  }
+
+  size_t shard_id = current_pool == this
+                        ? current_thread_id
+                        : next_shard_.fetch_add(1, std::memory_order_relaxed);
+  Shard& shard = *shards_[shard_id % shards_.size()];
+  {
+    std::lock_guard<std::mutex> lock(shard.mu);
+    // Counted before the job can be taken, so that queue_len_ never goes
+    // below zero. Sequentially consistent, so that either a thread about to
+    // wait sees the new job, or the waiting thread is seen below and woken
+    // up; a thread seeing the count waits on shard.mu for the job.
+    queue_len_.fetch_add(1);
+    shard.queue.push_back(BGItem());
+    TEST_SYNC_POINT("ThreadPoolImpl::Submit::Enqueue");
+    auto& item = shard.queue.back();
+    item.tag = tag;
+    item.function = std::move(schedule);
+    item.unschedFunction = std::move(unschedule);
+  }
+
+  if (num_waiting_threads_.load() > 0) {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (!HasExcessiveThread()) {
+      bgsignal_.notify_one();
+    } else {
+      WakeUpAllThreads();
+    }
+  }
+}
+
 int ThreadPoolImpl::Impl::UnSchedule(void* arg) {
   int count = 0;
 
@@ -440,21 +582,27 @@ int ThreadPoolImpl::Impl::UnSchedule(void* arg) {
   {
     std::lock_guard<std::mutex> lock(mu_);
 
-    // Remove from priority queue
-    BGQueue::iterator it = queue_.begin();
-    while (it != queue_.end()) {
-      if (arg == (*it).tag) {
-        if (it->unschedFunction) {
-          candidates.push_back(std::move(it->unschedFunction));
+    // Remove from priority queue, and from the shards
+    auto remove_from = [&](BGQueue& queue) {
+      BGQueue::iterator it = queue.begin();
+      while (it != queue.end()) {
+        if (arg == (*it).tag) {
+          if (it->unschedFunction) {
+            candidates.push_back(std::move(it->unschedFunction));
+          }
+          it = queue.erase(it);
+          count++;
+          queue_len_.fetch_sub(1, std::memory_order_relaxed);
+        } else {
+          ++it;
         }
-        it = queue_.erase(it);
-        count++;
-      } else {
-        ++it;
       }
+    };
+    remove_from(queue_);
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> shard_lock(shard->mu);
+      remove_from(shard->queue);
     }
-    queue_len_.store(static_cast<unsigned int>(queue_.size()),
-                     std::memory_order_relaxed);
   }
 
   // Run unschedule functions outside the mutex
@@ -493,6 +641,10 @@ void ThreadPoolImpl::LowerCPUPriority(rocksdb_rs::port_defs::CpuPriority pri) {
   impl_->LowerCPUPriority(pri);
 }
 
+void ThreadPoolImpl::SetWorkStealing(bool enabled) {
+  impl_->SetWorkStealing(enabled);
+}
+
 void ThreadPoolImpl::IncBackgroundThreadsIfNeeded(int num) {
   impl_->SetBackgroundThreadsInternal(num, false);
 }
@@ -53,6 +53,15 @@ class ThreadPoolImpl : public ThreadPool {
   // Currently only has effect on Linux
   void LowerCPUPriority(rocksdb_rs::port_defs::CpuPriority pri);
 
+  // Switch between a single FIFO queue (the default) and work stealing.
+  // With work stealing, every thread has a queue of its own, jobs submitted
+  // from outside the pool are spread over the queues and jobs submitted by a
+  // pool thread go to its own queue. A thread takes the jobs of its queue in
+  // order, steals from the other queues when its own is empty, and does not
+  // touch the lock shared by the pool unless it runs out of jobs. Jobs are
+  // then no longer guaranteed to start in submission order.
+  void SetWorkStealing(bool enabled);
+
   // Ensure there is at aleast num threads in the pool
   // but do not kill threads if there are more
   void IncBackgroundThreadsIfNeeded(int num);
@@ -20,6 +20,7 @@
 #include <functional>
 #include <mutex>
 #include <queue>
+#include <utility>
 
 namespace rocksdb {
 
@@ -102,7 +103,7 @@ class WorkQueue {
         assert(done_);
         return false;
       }
-      item = queue_.front();
+      item = std::move(queue_.front());
       queue_.pop();
     }
     writerCv_.notify_one();